@@ -7,9 +7,9 @@
 
 using namespace BSDS500;
 
-static std::mt19937 s_oMT(std::chrono::system_clock::now().time_since_epoch().count());
-static std::uniform_real_distribution<double> s_oURDistrib_0_1(0,std::nextafter(1,std::numeric_limits<double>::max()));
-static auto s_oRand_0_1_Funct = std::bind(s_oURDistrib_0_1,s_oMT);
+static thread_local std::mt19937 s_oMT(std::chrono::system_clock::now().time_since_epoch().count());
+static thread_local std::uniform_real_distribution<double> s_oURDistrib_0_1(0,std::nextafter(1,std::numeric_limits<double>::max()));
+static thread_local auto s_oRand_0_1_Funct = std::bind(s_oURDistrib_0_1,s_oMT);
 
 // O(n) implementation.
 static void
@@ -0,0 +1,119 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/video.hpp"
+
+////////////////////////////////
+#define DEFAULT_FRAME_COUNT     30
+#define DEFAULT_RNG_SEED        42
+////////////////////////////////
+#if !PLATFORMUTILS_COUNT_HEAP_ALLOCS
+#error "This check requires the heap allocation counter (configure with USE_HEAP_ALLOC_COUNTER)."
+#endif //!PLATFORMUTILS_COUNT_HEAP_ALLOCS
+
+namespace {
+
+    /// returns a sequence of noisy frames showing a smooth random background, a moving box, and a global illumination change halfway through
+    std::vector<cv::Mat> getRandomSequence(cv::RNG& oRNG, const cv::Size& oSize, int nChannels, size_t nFrameCount) {
+        cv::Mat oSmallBG(std::max(oSize.height/8,1),std::max(oSize.width/8,1),CV_8UC(nChannels));
+        oRNG.fill(oSmallBG,cv::RNG::UNIFORM,cv::Scalar::all(0),cv::Scalar::all(256));
+        cv::Mat oBG;
+        cv::resize(oSmallBG,oBG,oSize,0,0,cv::INTER_CUBIC);
+        const cv::Size oBoxSize(std::max(oSize.width/5,1),std::max(oSize.height/4,1));
+        std::vector<cv::Mat> voFrames(nFrameCount);
+        for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx) {
+            cv::Mat oNoise(oSize,CV_16SC(nChannels));
+            oRNG.fill(oNoise,cv::RNG::NORMAL,cv::Scalar::all(0),cv::Scalar::all(4));
+            cv::Mat oFrame;
+            cv::add(oBG,oNoise,oFrame,cv::noArray(),CV_8U);
+            if(nFrameIdx>=nFrameCount/2)
+                oFrame += cv::Scalar::all(20);
+            const int nBoxX = int((nFrameIdx*7)%size_t(std::max(oSize.width-oBoxSize.width,1)));
+            const int nBoxY = int((nFrameIdx*3)%size_t(std::max(oSize.height-oBoxSize.height,1)));
+            cv::rectangle(oFrame,cv::Rect(cv::Point(nBoxX,nBoxY),oBoxSize),cv::Scalar::all(oRNG.uniform(0,256)),-1);
+            voFrames[nFrameIdx] = oFrame;
+        }
+        return voFrames;
+    }
+
+    /// runs the given bgs algo over a sequence and returns the number of heap allocations its tiles made past the first frame (should be zero)
+    template<typename TAlgo>
+    size_t checkSequence(const std::vector<cv::Mat>& voFrames, const cv::Mat& oROI) {
+        std::shared_ptr<TAlgo> pAlgo = std::make_shared<TAlgo>();
+        pAlgo->initialize(voFrames[0],oROI);
+        cv::Mat oFGMask(voFrames[0].size(),CV_8UC1,cv::Scalar_<uchar>(0));
+        // the per-tile buffers are sized during the first call, so only later ones must leave the heap alone
+        pAlgo->apply(voFrames[0],oFGMask,1.0);
+        const size_t nInitHeapAllocCount = pAlgo->getTileHeapAllocCount();
+        for(size_t nFrameIdx=1; nFrameIdx<voFrames.size(); ++nFrameIdx)
+            pAlgo->apply(voFrames[nFrameIdx],oFGMask,1.0); // full learning rate, so every px goes through the model (and neighbor) update paths
+        return pAlgo->getTileHeapAllocCount()-nInitHeapAllocCount;
+    }
+
+    /// runs 'checkSequence' for one algo type, and prints the result; returns whether the check passed
+    template<typename TAlgo>
+    bool checkAlgo(const char* sAlgoName, const std::vector<cv::Mat>& voFrames, const cv::Mat& oROI) {
+        const size_t nHeapAllocCount = checkSequence<TAlgo>(voFrames,oROI);
+        std::cout << "\t" << sAlgoName << ": " << nHeapAllocCount << " heap allocation(s) past the first frame" << std::endl;
+        return nHeapAllocCount==0;
+    }
+
+} // anonymous namespace
+
+// checks that the SuBSENSE/LOBSTER pixel loops (in both their non-parallel and cpu-threaded impls) make no heap allocations past the first frame,
+// on any thread; allocations made by the thread pool workers are accounted to the calling thread (see lv::IIParallelAlgo::getTileHeapAllocCount)
+// usage: bgsalloccheck [frame_count] [rng_seed]
+int main(int argc, char** argv) {
+    try {
+        const size_t nFrameCount = argc>1?(size_t)std::stoul(argv[1]):size_t(DEFAULT_FRAME_COUNT);
+        const uint64_t nRNGSeed = argc>2?(uint64_t)std::stoull(argv[2]):uint64_t(DEFAULT_RNG_SEED);
+        lvAssert_(nFrameCount>1,"frame count must be greater than one");
+        std::cout << "Thread pool size: " << lv::ThreadPool::get().getThreadCount() << std::endl;
+        // large frames are split in several tiles by the cpu-threaded impls, and small ones with a partial roi cover the tile & border edge cases
+        const std::vector<cv::Size> voSizes = {cv::Size(640,480),cv::Size(320,240),cv::Size(67,43)};
+        const std::vector<int> vnChannels = {1,3};
+        cv::RNG oRNG(nRNGSeed);
+        size_t nFailedChecks = 0, nTotChecks = 0;
+        for(const cv::Size& oSize : voSizes) {
+            for(int nChannels : vnChannels) {
+                for(bool bPartialROI : {false,true}) {
+                    std::cout << "Checking " << nFrameCount << " frame(s) of size [" << oSize.width << "," << oSize.height << "] w/ " << nChannels << " channel(s)" << (bPartialROI?" and partial roi":"") << "..." << std::endl;
+                    const std::vector<cv::Mat> voFrames = getRandomSequence(oRNG,oSize,nChannels,nFrameCount);
+                    cv::Mat oROI(oSize,CV_8UC1,cv::Scalar_<uchar>(255));
+                    if(bPartialROI)
+                        cv::circle(oROI,cv::Point(oSize.width/3,oSize.height/2),std::max(oSize.height/4,1),cv::Scalar_<uchar>(0),-1);
+                    const std::array<bool,4> abPassed = {
+                        checkAlgo<BackgroundSubtractorSuBSENSE_<lv::NonParallel>>("SuBSENSE (NonParallel)",voFrames,oROI),
+                        checkAlgo<BackgroundSubtractorSuBSENSE_<lv::CPUThreaded>>("SuBSENSE (CPUThreaded)",voFrames,oROI),
+                        checkAlgo<BackgroundSubtractorLOBSTER_<lv::NonParallel>>("LOBSTER (NonParallel)",voFrames,oROI),
+                        checkAlgo<BackgroundSubtractorLOBSTER_<lv::CPUThreaded>>("LOBSTER (CPUThreaded)",voFrames,oROI),
+                    };
+                    for(bool bPassed : abPassed)
+                        nFailedChecks += size_t(!bPassed);
+                    nTotChecks += abPassed.size();
+                }
+            }
+        }
+        std::cout << (nTotChecks-nFailedChecks) << "/" << nTotChecks << " check(s) passed." << std::endl;
+        if(nFailedChecks)
+            return 1;
+    }
+    catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(const std::exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught std::exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(...) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught unhandled exception\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    return 0;
+}
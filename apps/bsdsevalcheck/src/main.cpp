@@ -0,0 +1,421 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/datasets.hpp"
+#include "litiv/imgproc.hpp"
+#if USE_BSDS500_BENCHMARK
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wwrite-strings"
+#pragma clang diagnostic ignored "-Wunused-but-set-variable"
+#pragma clang diagnostic ignored "-Wformat="
+#pragma clang diagnostic ignored "-Wparentheses"
+#pragma clang diagnostic ignored "-Wformat-security"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wshadow"
+#endif //__clang__
+#if (defined(__GNUC__) || defined(__GNUG__))
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#pragma GCC diagnostic ignored "-Wformat="
+#pragma GCC diagnostic ignored "-Wparentheses"
+#pragma GCC diagnostic ignored "-Wformat-security"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wshadow"
+#endif //(defined(__GNUC__) || defined(__GNUG__))
+#ifdef _MSC_VER
+#pragma warning(push,0)
+#endif //defined(_MSC_VER)
+#include "litiv/3rdparty/BSDS500/csa.hpp"
+#include "litiv/3rdparty/BSDS500/kofn.hpp"
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif //defined(_MSC_VER)
+#if (defined(__GNUC__) || defined(__GNUG__))
+#pragma GCC diagnostic pop
+#endif //(defined(__GNUC__) || defined(__GNUG__))
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif //__clang__
+#endif //USE_BSDS500_BENCHMARK
+
+////////////////////////////////
+#define DEFAULT_IMAGE_COUNT     4
+#define DEFAULT_RNG_SEED        42
+#if USE_BSDS500_BENCHMARK
+#define REFERENCE_RUN_COUNT     3 // the reference outlier graph is random, so its tie-breaking may vary between runs
+#else //(!USE_BSDS500_BENCHMARK)
+#define REFERENCE_RUN_COUNT     1
+#endif //(!USE_BSDS500_BENCHMARK)
+////////////////////////////////
+
+namespace {
+
+    using BSDS500Accumulator = lv::MetricsAccumulator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>;
+
+#if USE_BSDS500_BENCHMARK
+
+    /// reference matcher for a single gt mask, solving the assignment over the whole image (kept as-is from the original match.cc-derived implementation)
+    uint64_t matchEdgeMaps_Reference(const cv::Mat& oCurrSegmMask, const cv::Mat& oCurrGTSegmMask, double dMaxDist, cv::Mat& oSegmTPAccumulator) {
+        const double dMaxDistSqr = dMaxDist*dMaxDist;
+        const int nMaxDist = (int)ceil(dMaxDist);
+        const double dOutlierCost = 100*dMaxDist;
+        lvAssert(dOutlierCost>1);
+        static constexpr int multiplier = 100;
+        static constexpr int degree = 6;
+        uint64_t nIndivTP = 0;
+        cv::Mat oMatchable_SEGM(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
+        cv::Mat oMatchable_GT(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
+        // Figure out which nodes are matchable, i.e. within maxDist
+        // of another node.
+        for(int i=0; i<oCurrSegmMask.rows; ++i) {
+            for(int j=0; j<oCurrSegmMask.cols; ++j) {
+                if(!oCurrGTSegmMask.at<uchar>(i,j)) continue;
+                for(int u=-nMaxDist; u<=nMaxDist; ++u) {
+                    if(i+u<0) continue;
+                    if(i+u>=oCurrSegmMask.rows) continue;
+                    if(double(u)>dMaxDist) continue;
+                    for(int v=-nMaxDist; v<=nMaxDist; ++v) {
+                        if(j+v<0) continue;
+                        if(j+v>=oCurrSegmMask.cols) continue;
+                        if(double(v)>dMaxDist) continue;
+                        const double dCurrDistSqr = u*u+v*v;
+                        if(dCurrDistSqr>dMaxDistSqr) continue;
+                        if(oCurrSegmMask.at<uchar>(i+u,j+v)) {
+                            oMatchable_SEGM.at<uchar>(i+u,j+v) = UCHAR_MAX;
+                            oMatchable_GT.at<uchar>(i,j) = UCHAR_MAX;
+                        }
+                    }
+                }
+            }
+        }
+        int nNodeCount_SEGM=0, nNodeCount_GT=0;
+        std::vector<cv::Point2i> voNodeToPxLUT_SEGM;
+        cv::Mat oPxToNodeLUT_SEGM(oCurrSegmMask.size(),CV_32SC1,cv::Scalar_<int>(-1));
+        cv::Mat oPxToNodeLUT_GT(oCurrSegmMask.size(),CV_32SC1,cv::Scalar_<int>(-1));
+        // Count the number of nodes on each side of the match.
+        // Construct nodeID->pixel and pixel->nodeID maps.
+        for(int i=0; i<oCurrSegmMask.rows; ++i) {
+            for(int j=0; j<oCurrSegmMask.cols; ++j) {
+                cv::Point2i px(j,i);
+                if(oMatchable_SEGM.at<uchar>(px)) {
+                    oPxToNodeLUT_SEGM.at<int>(px) = nNodeCount_SEGM;
+                    voNodeToPxLUT_SEGM.push_back(px);
+                    ++nNodeCount_SEGM;
+                }
+                if(oMatchable_GT.at<uchar>(px))
+                    oPxToNodeLUT_GT.at<int>(px) = nNodeCount_GT++;
+            }
+        }
+        struct Edge {
+            int nNodeIdx_SEGM;
+            int nNodeIdx_GT;
+            double dEdgeDist;
+        };
+        std::vector<Edge> voEdges;
+        // Construct the list of edges between pixels within maxDist.
+        for(int i=0; i<oCurrSegmMask.rows; ++i) {
+            for(int j=0; j<oCurrSegmMask.cols; ++j) {
+                if(!oMatchable_GT.at<uchar>(i,j)) continue;
+                for(int u=-nMaxDist; u<=nMaxDist; ++u) {
+                    if(i+u<0) continue;
+                    if(i+u>=oCurrSegmMask.rows) continue;
+                    if(double(u)>dMaxDist) continue;
+                    for(int v=-nMaxDist; v<=nMaxDist; ++v) {
+                        if(j+v<0) continue;
+                        if(j+v>=oCurrSegmMask.cols) continue;
+                        if(double(v)>dMaxDist) continue;
+                        if(!oMatchable_SEGM.at<uchar>(i+u,j+v)) continue;
+                        const double dCurrDistSqr = u*u+v*v;
+                        if(dCurrDistSqr>dMaxDistSqr) continue;
+                        voEdges.push_back(Edge{oPxToNodeLUT_SEGM.at<int>(i+u,j+v),oPxToNodeLUT_GT.at<int>(i,j),sqrt(dCurrDistSqr)});
+                    }
+                }
+            }
+        }
+        // The cardinality of the match is n.
+        const int n = nNodeCount_SEGM+nNodeCount_GT;
+        const int nmin = std::min(nNodeCount_SEGM,nNodeCount_GT);
+        const int nmax = std::max(nNodeCount_SEGM,nNodeCount_GT);
+        // Compute the degree of various outlier connections.
+        const int degree_SEGM = std::max(0,std::min(degree,nNodeCount_SEGM-1)); // from map1
+        const int degree_GT = std::max(0,std::min(degree,nNodeCount_GT-1)); // from map2
+        const int degree_mix = std::min(degree,std::min(nNodeCount_SEGM,nNodeCount_GT)); // between outliers
+        const int dmax = std::max(degree_SEGM,std::max(degree_GT,degree_mix));
+        // Count the number of edges.
+        int m = 0;
+        m += (int)voEdges.size();         // real connections
+        m += degree_SEGM*nNodeCount_SEGM; // outlier connections
+        m += degree_GT*nNodeCount_GT;     // outlier connections
+        m += degree_mix*nmax;             // outlier-outlier connections
+        m += n;                           // high-cost perfect match overlay
+        // If the graph is empty, then there's nothing to do.
+        if(m==0)
+            return nIndivTP;
+        // Weight of outlier connections.
+        const int nOutlierWeight = (int)ceil(dOutlierCost*multiplier);
+        // Scratch array for outlier edges.
+        std::vector<int> vnOutliers(dmax);
+        // Construct the input graph for the assignment problem.
+        cv::Mat oGraph(m,3,CV_32SC1);
+        int nGraphIdx = 0;
+        // real edges
+        for(const Edge& oEdge : voEdges) {
+            oGraph.at<int>(nGraphIdx,0) = oEdge.nNodeIdx_SEGM;
+            oGraph.at<int>(nGraphIdx,1) = oEdge.nNodeIdx_GT;
+            oGraph.at<int>(nGraphIdx,2) = (int)rint(oEdge.dEdgeDist*multiplier);
+            nGraphIdx++;
+        }
+        // outliers edges for map1, exclude diagonal
+        for(int nNodeIdx_SEGM=0; nNodeIdx_SEGM<nNodeCount_SEGM; ++nNodeIdx_SEGM) {
+            BSDS500::kOfN(degree_SEGM,nNodeCount_SEGM-1,vnOutliers.data());
+            for(int a=0; a<degree_SEGM; a++) {
+                int j = vnOutliers[a];
+                if(j>=nNodeIdx_SEGM) {j++;}
+                oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
+                oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
+                nGraphIdx++;
+            }
+        }
+        // outliers edges for map2, exclude diagonal
+        for(int nNodeIdx_GT=0; nNodeIdx_GT<nNodeCount_GT; nNodeIdx_GT++) {
+            BSDS500::kOfN(degree_GT,nNodeCount_GT-1,vnOutliers.data());
+            for(int a=0; a<degree_GT; a++) {
+                int i = vnOutliers[a];
+                if(i>=nNodeIdx_GT) {i++;}
+                oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
+                oGraph.at<int>(nGraphIdx,1) = nNodeIdx_GT;
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
+                nGraphIdx++;
+            }
+        }
+        // outlier-to-outlier edges
+        for(int i=0; i<nmax; i++) {
+            BSDS500::kOfN(degree_mix,nmin,vnOutliers.data());
+            for(int a=0; a<degree_mix; a++) {
+                const int j = vnOutliers[a];
+                if(nNodeCount_SEGM<nNodeCount_GT) {
+                    oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
+                    oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
+                }
+                else {
+                    oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+j;
+                    oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
+                }
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
+                nGraphIdx++;
+            }
+        }
+        // perfect match overlay (diagonal)
+        for(int i=0; i<nNodeCount_SEGM; i++) {
+            oGraph.at<int>(nGraphIdx,0) = i;
+            oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
+            oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
+            nGraphIdx++;
+        }
+        for(int i=0; i<nNodeCount_GT; i++) {
+            oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
+            oGraph.at<int>(nGraphIdx,1) = i;
+            oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
+            nGraphIdx++;
+        }
+        lvAssert(nGraphIdx==m);
+        // Set the values up for CSA.
+        for(int i=0; i<m; i++) {
+            oGraph.at<int>(i,0) += 1;
+            oGraph.at<int>(i,1) += 1+n;
+        }
+        // Solve the assignment problem.
+        BSDS500::CSA oCSASolver(2*n,m,(int*)oGraph.data);
+        lvAssert(oCSASolver.edges()==n);
+        // Compute match arrays.
+        for(int a=0; a<n; a++) {
+            int i,j,c;
+            oCSASolver.edge(a,i,j,c);
+            i -= 1;
+            j -= 1+n;
+            // skip outlier edges
+            if(i>=nNodeCount_SEGM) {continue;}
+            if(j>=nNodeCount_GT) {continue;}
+            oSegmTPAccumulator.at<uchar>(voNodeToPxLUT_SEGM[i]) = UCHAR_MAX;
+            ++nIndivTP;
+        }
+        return nIndivTP;
+    }
+
+#else //(!USE_BSDS500_BENCHMARK)
+
+    /// reference matcher for a single gt mask, scanning a window around each gt pixel (kept as-is from the original implementation)
+    uint64_t matchEdgeMaps_Reference(const cv::Mat& oCurrSegmMask, const cv::Mat& oCurrGTSegmMask, double dMaxDist, cv::Mat& oSegmTPAccumulator) {
+        const double dMaxDistSqr = dMaxDist*dMaxDist;
+        const int nMaxDist = (int)ceil(dMaxDist);
+        uint64_t nIndivTP = 0;
+        for(int i=0; i<oCurrSegmMask.rows; ++i) {
+            for(int j=0; j<oCurrSegmMask.cols; ++j) {
+                if(!oCurrGTSegmMask.at<uchar>(i,j)) continue;
+                bool bFoundMatch = false;
+                for(int u=-nMaxDist; u<=nMaxDist && !bFoundMatch; ++u) {
+                    if(i+u<0) continue;
+                    if(i+u>=oCurrSegmMask.rows) continue;
+                    if(double(u)>dMaxDist) continue;
+                    for(int v=-nMaxDist; v<=nMaxDist && !bFoundMatch; ++v) {
+                        if(j+v<0) continue;
+                        if(j+v>=oCurrSegmMask.cols) continue;
+                        if(double(v)>dMaxDist) continue;
+                        const double dCurrDistSqr = u*u+v*v;
+                        if(dCurrDistSqr>dMaxDistSqr) continue;
+                        if(oCurrSegmMask.at<uchar>(i+u,j+v)) {
+                            ++nIndivTP;
+                            oSegmTPAccumulator.at<uchar>(i+u,j+v) = UCHAR_MAX;
+                            bFoundMatch = true;
+                        }
+                    }
+                }
+            }
+        }
+        return nIndivTP;
+    }
+
+#endif //(!USE_BSDS500_BENCHMARK)
+
+    /// computes the counters of all threshold bins with the reference matcher (no bin skipping, no component decomposition, no caching)
+    lv::BSDS500Counters getReferenceCounters(const cv::Mat& oClassif, const cv::Mat& oGT, size_t nThresholdBins) {
+        const double dMaxDist = DATASETS_BSDS500_EVAL_IMAGE_DIAG_RATIO_DIST*sqrt(double(oClassif.cols*oClassif.cols+oClassif.rows*oClassif.rows));
+        lv::BSDS500Counters oCounters(nThresholdBins);
+        cv::Mat oCurrSegmMask, oTmpSegmMask;
+        for(size_t nThresholdBinIdx=0; nThresholdBinIdx<nThresholdBins; ++nThresholdBinIdx) {
+            cv::compare(oClassif,oCounters.vnThresholds[nThresholdBinIdx],oTmpSegmMask,cv::CMP_GE);
+            lv::thinning(oTmpSegmMask,oCurrSegmMask);
+            cv::Mat oSegmTPAccumulator(oClassif.size(),CV_8UC1,cv::Scalar_<uchar>(0));
+            uint64_t nIndivTP = 0, nGTPosCount = 0;
+            for(size_t nGTMaskIdx=0; nGTMaskIdx<size_t(oGT.rows/oClassif.rows); ++nGTMaskIdx) {
+                const cv::Mat oCurrGTSegmMask = oGT(cv::Rect(0,int(oClassif.rows*nGTMaskIdx),oClassif.cols,oClassif.rows));
+                nIndivTP += matchEdgeMaps_Reference(oCurrSegmMask,oCurrGTSegmMask,dMaxDist,oSegmTPAccumulator);
+                nGTPosCount += uint64_t(cv::countNonZero(oCurrGTSegmMask));
+            }
+            oCounters.vnIndivTP[nThresholdBinIdx] = nIndivTP;
+            oCounters.vnIndivTPFN[nThresholdBinIdx] = nGTPosCount;
+            oCounters.vnTotalTP[nThresholdBinIdx] = uint64_t(cv::countNonZero(oSegmTPAccumulator));
+            oCounters.vnTotalTPFP[nThresholdBinIdx] = uint64_t(cv::countNonZero(oCurrSegmMask));
+        }
+        return oCounters;
+    }
+
+    /// returns a random edge probability map (smooth noise quantized on a few levels, so that many threshold bins give identical masks)
+    cv::Mat getRandomClassif(cv::RNG& oRNG, const cv::Size& oSize) {
+        cv::Mat oNoise(std::max(oSize.height/8,2),std::max(oSize.width/8,2),CV_8UC1), oClassif;
+        oRNG.fill(oNoise,cv::RNG::UNIFORM,0,256);
+        cv::resize(oNoise,oClassif,oSize,0,0,cv::INTER_CUBIC);
+        const int nQuantStep = oRNG.uniform(1,33);
+        for(int i=0; i<oClassif.rows; ++i)
+            for(int j=0; j<oClassif.cols; ++j)
+                oClassif.at<uchar>(i,j) = uchar((oClassif.at<uchar>(i,j)/nQuantStep)*nQuantStep);
+        return oClassif;
+    }
+
+    /// returns randomly jittered copies of the thinned classif edges, plus random lines, stacked vertically as the BSDS500 evaluator expects
+    cv::Mat getRandomGT(cv::RNG& oRNG, const cv::Mat& oClassif, size_t nGTMaskCount) {
+        cv::Mat oGT(oClassif.rows*int(nGTMaskCount),oClassif.cols,CV_8UC1,cv::Scalar_<uchar>(0));
+        for(size_t nGTMaskIdx=0; nGTMaskIdx<nGTMaskCount; ++nGTMaskIdx) {
+            cv::Mat oGTMask = oGT(cv::Rect(0,oClassif.rows*int(nGTMaskIdx),oClassif.cols,oClassif.rows)), oTmpMask, oEdgeMask;
+            cv::compare(oClassif,oRNG.uniform(64,192),oTmpMask,cv::CMP_GE);
+            lv::thinning(oTmpMask,oEdgeMask);
+            const cv::Mat oShift = (cv::Mat_<double>(2,3) << 1,0,oRNG.uniform(-3,4),0,1,oRNG.uniform(-3,4));
+            cv::warpAffine(oEdgeMask,oGTMask,oShift,oGTMask.size(),cv::INTER_NEAREST);
+            for(int nLineIdx=oRNG.uniform(0,8); nLineIdx>0; --nLineIdx)
+                cv::line(oGTMask,cv::Point(oRNG.uniform(0,oGTMask.cols),oRNG.uniform(0,oGTMask.rows)),cv::Point(oRNG.uniform(0,oGTMask.cols),oRNG.uniform(0,oGTMask.rows)),cv::Scalar_<uchar>(UCHAR_MAX),1,cv::LINE_8);
+            for(int nDropIdx=oRNG.uniform(0,oGTMask.cols*oGTMask.rows/50); nDropIdx>0; --nDropIdx)
+                oGTMask.at<uchar>(oRNG.uniform(0,oGTMask.rows),oRNG.uniform(0,oGTMask.cols)) = 0;
+        }
+        return oGT;
+    }
+
+    /// checks the counters of the BSDS500 evaluator against the reference ones for a single image; returns the mismatch count
+    size_t checkImage(const cv::Mat& oClassif, const cv::Mat& oGT, size_t& nTieDependentBins) {
+        std::shared_ptr<BSDS500Accumulator> pAccumulator = lv::IIMetricsAccumulator::create<BSDS500Accumulator>();
+        pAccumulator->accumulate(oClassif,oGT,cv::Mat());
+        lvAssert_(pAccumulator->m_voMetricsBase.size()==1,"unexpected counter block count");
+        const lv::BSDS500Counters& oCounters = pAccumulator->m_voMetricsBase[0];
+        std::vector<lv::BSDS500Counters> voRefCounters;
+        for(size_t nRunIdx=0; nRunIdx<REFERENCE_RUN_COUNT; ++nRunIdx)
+            voRefCounters.push_back(getReferenceCounters(oClassif,oGT,pAccumulator->m_nThresholdBins));
+        size_t nMismatches = 0;
+        for(size_t nBinIdx=0; nBinIdx<pAccumulator->m_nThresholdBins; ++nBinIdx) {
+            // match counts (recall) and mask sizes must always be identical
+            bool bMismatch = false;
+            for(const lv::BSDS500Counters& oRefCounters : voRefCounters)
+                bMismatch |= oCounters.vnIndivTP[nBinIdx]!=oRefCounters.vnIndivTP[nBinIdx] ||
+                             oCounters.vnIndivTPFN[nBinIdx]!=oRefCounters.vnIndivTPFN[nBinIdx] ||
+                             oCounters.vnTotalTPFP[nBinIdx]!=oRefCounters.vnTotalTPFP[nBinIdx];
+            // matched segm pixels (precision numerator) depend on which equal-cost assignment is picked; they must be identical unless
+            // the reference itself picked different ones between runs, in which case they must stay within the reference range
+            const auto pRefTotalTPRange = std::minmax_element(voRefCounters.begin(),voRefCounters.end(),[nBinIdx](const lv::BSDS500Counters& a, const lv::BSDS500Counters& b) {
+                return a.vnTotalTP[nBinIdx]<b.vnTotalTP[nBinIdx];
+            });
+            const uint64_t nRefTotalTPMin = pRefTotalTPRange.first->vnTotalTP[nBinIdx], nRefTotalTPMax = pRefTotalTPRange.second->vnTotalTP[nBinIdx];
+            if(nRefTotalTPMin!=nRefTotalTPMax)
+                ++nTieDependentBins;
+            bMismatch |= oCounters.vnTotalTP[nBinIdx]<nRefTotalTPMin || oCounters.vnTotalTP[nBinIdx]>nRefTotalTPMax;
+            if(bMismatch) {
+                const lv::BSDS500Counters& oRefCounters = voRefCounters[0];
+                std::cout << "\tthreshold bin #" << nBinIdx << " (" << (int)oCounters.vnThresholds[nBinIdx] << ") mismatch:"
+                          << "  new=[" << oCounters.vnIndivTP[nBinIdx] << "," << oCounters.vnIndivTPFN[nBinIdx] << "," << oCounters.vnTotalTP[nBinIdx] << "," << oCounters.vnTotalTPFP[nBinIdx] << "]"
+                          << "  ref=[" << oRefCounters.vnIndivTP[nBinIdx] << "," << oRefCounters.vnIndivTPFN[nBinIdx] << "," << nRefTotalTPMin << "-" << nRefTotalTPMax << "," << oRefCounters.vnTotalTPFP[nBinIdx] << "]" << std::endl;
+                ++nMismatches;
+            }
+        }
+        return nMismatches;
+    }
+
+} // anonymous namespace
+
+// checks that the BSDS500 evaluator (grid-based candidates, per-component assignment, cached & parallel threshold sweeps) gives the same
+// counters as the original whole-image match.cc-derived matcher on random edge maps, for every threshold bin
+// usage: bsdsevalcheck [image_count] [rng_seed]
+int main(int argc, char** argv) {
+    try {
+        const size_t nImageCount = argc>1?(size_t)std::stoul(argv[1]):size_t(DEFAULT_IMAGE_COUNT);
+        const uint64_t nRNGSeed = argc>2?(uint64_t)std::stoull(argv[2]):uint64_t(DEFAULT_RNG_SEED);
+        lvAssert_(nImageCount>0,"image count must be positive");
+        // the first size is the one used in BSDS500 itself; the others cover smaller match distances and partial grid cells
+        const std::vector<cv::Size> voSizes = {cv::Size(481,321),cv::Size(200,150),cv::Size(67,43)};
+        cv::RNG oRNG(nRNGSeed);
+        size_t nFailedChecks = 0, nTotChecks = 0, nTieDependentBins = 0;
+        for(const cv::Size& oSize : voSizes) {
+            for(size_t nImageIdx=0; nImageIdx<nImageCount; ++nImageIdx) {
+                const size_t nGTMaskCount = (size_t)oRNG.uniform(1,6);
+                std::cout << "Checking image #" << nImageIdx << " of size [" << oSize.width << "," << oSize.height << "] w/ " << nGTMaskCount << " gt mask(s)..." << std::endl;
+                const cv::Mat oClassif = getRandomClassif(oRNG,oSize);
+                const cv::Mat oGT = getRandomGT(oRNG,oClassif,nGTMaskCount);
+                const size_t nMismatches = checkImage(oClassif,oGT,nTieDependentBins);
+                nFailedChecks += size_t(nMismatches>0);
+                ++nTotChecks;
+            }
+        }
+        if(nTieDependentBins)
+            std::cout << "(" << nTieDependentBins << " threshold bin(s) had a tie-dependent reference precision)" << std::endl;
+        std::cout << (nTotChecks-nFailedChecks) << "/" << nTotChecks << " check(s) passed." << std::endl;
+        if(nFailedChecks)
+            return 1;
+    }
+    catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(const std::exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught std::exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(...) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught unhandled exception\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    return 0;
+}
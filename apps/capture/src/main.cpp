@@ -115,7 +115,7 @@ int main() {
 #endif //WRITE_OUTPUT
 
         CComPtr<IMultiSourceFrame> pMultiFrame;
-        lv::WorkerPool<nStreamCount> oPool;
+        lv::ThreadPool oPool(nStreamCount);
         std::array<std::future<bool>,nStreamCount> abGrabResults;
         const std::array<std::function<bool()>,nStreamCount> alGrabTasks = {
             [&]{
@@ -16,7 +16,6 @@
 // limitations under the License.
 
 // @@@ imgproc gpu algo does not support mipmapping binding yet
-// @@@ test compute shader group size vs shared mem usage
 // @@@ support non-integer textures top level (alg)? need to replace all ui-stores by float-stores, rest is ok
 
 #include "litiv/datasets.hpp"
@@ -24,6 +23,7 @@
 
 ////////////////////////////////
 #define WRITE_IMG_OUTPUT        0
+#define WRITE_PACKED_OUTPUT     0 // if writing, masks are RLE-packed in one container file per batch instead of individual png files
 #define EVALUATE_OUTPUT         0
 #define DISPLAY_OUTPUT          1
 ////////////////////////////////
@@ -34,6 +34,8 @@
 #define USE_GLSL_IMPL           0
 #define USE_CUDA_IMPL           0
 #define USE_OPENCL_IMPL         0
+#define USE_CPUTHREADED_IMPL    0 // splits the pixel loop of each frame over the shared thread pool (LOBSTER & SuBSENSE only)
+#define USE_GLSL_WG_AUTOTUNING  1 // times candidate compute work group sizes over the first frames (results cached per device/frame size)
 ////////////////////////////////
 #define DATASET_ID              Dataset_CDnet // comment this line to fall back to custom dataset definition
 #define DATASET_OUTPUT_PATH     "results_test" // will be created in the app's working directory if using a custom dataset
@@ -41,10 +43,12 @@
 #define DATASET_SCALE_FACTOR    1.0
 ////////////////////////////////
 #define USE_GPU_IMPL (USE_GLSL_IMPL||USE_CUDA_IMPL||USE_OPENCL_IMPL)
-#if (USE_GLSL_IMPL+USE_CUDA_IMPL+USE_OPENCL_IMPL)>1
+#if (USE_GLSL_IMPL+USE_CUDA_IMPL+USE_OPENCL_IMPL+USE_CPUTHREADED_IMPL)>1
 #error "Must specify a single impl."
 #elif (USE_LOBSTER+USE_SUBSENSE+USE_PAWCS)!=1
 #error "Must specify a single algorithm."
+#elif (USE_CPUTHREADED_IMPL && USE_PAWCS)
+#error "PAWCS only offers a non-parallel impl."
 #endif //USE_...
 #ifndef DATASET_ID
 #define DATASET_ID Dataset_Custom
@@ -73,24 +77,35 @@
 void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch);
 #if USE_GLSL_IMPL
 constexpr lv::ParallelAlgoType eImplTypeEnum = lv::GLSL;
+#define IMPL_NAME "GLSL"
+#elif USE_CPUTHREADED_IMPL
+constexpr lv::ParallelAlgoType eImplTypeEnum = lv::CPUThreaded;
+#define IMPL_NAME "CPUThreaded"
 #else // USE_..._IMPL
 constexpr lv::ParallelAlgoType eImplTypeEnum = lv::NonParallel;
+#define IMPL_NAME "NonParallel"
 #endif // USE_..._IMPL
-using DatasetType = lv::Dataset_<lv::DatasetTask_Segm,lv::DATASET_ID,eImplTypeEnum>;
+// the evaluators only come in gpu and non-parallel flavors; cpu-threaded algos are evaluated on the calling thread
+constexpr lv::ParallelAlgoType eEvalImplTypeEnum = (eImplTypeEnum==lv::CPUThreaded)?lv::NonParallel:eImplTypeEnum;
+using DatasetType = lv::Dataset_<lv::DatasetTask_Segm,lv::DATASET_ID,eEvalImplTypeEnum>;
+// the load model key names the algorithm, its impl, and the (default) parameters that affect its processing cost, so stats are only reused when comparable
 #if USE_LOBSTER
 using BackgroundSubtractorType = BackgroundSubtractorLOBSTER_<eImplTypeEnum>;
+#define LOAD_MODEL_KEY cv::format("LOBSTER_" IMPL_NAME "(scale=%g,nbs=%d,nreq=%d,rlbsp=%g,lbspo=%d)",double(DATASET_SCALE_FACTOR),int(BGSLOBSTER_DEFAULT_NB_BG_SAMPLES),int(BGSLOBSTER_DEFAULT_REQUIRED_NB_BG_SAMPLES),double(BGSLBSP_DEFAULT_LBSP_REL_SIMILARITY_THRESHOLD),int(BGSLBSP_DEFAULT_LBSP_OFFSET_SIMILARITY_THRESHOLD))
 #elif USE_SUBSENSE
 using BackgroundSubtractorType = BackgroundSubtractorSuBSENSE_<eImplTypeEnum>;
+#define LOAD_MODEL_KEY cv::format("SuBSENSE_" IMPL_NAME "(scale=%g,nbs=%d,nreq=%d,rlbsp=%g,nmvs=%d)",double(DATASET_SCALE_FACTOR),int(BGSSUBSENSE_DEFAULT_NB_BG_SAMPLES),int(BGSSUBSENSE_DEFAULT_REQUIRED_NB_BG_SAMPLES),double(BGSLBSP_DEFAULT_LBSP_REL_SIMILARITY_THRESHOLD),int(BGSSUBSENSE_DEFAULT_N_SAMPLES_FOR_MV_AVGS))
 #elif USE_PAWCS
 using BackgroundSubtractorType = BackgroundSubtractorPAWCS_<eImplTypeEnum>;
+#define LOAD_MODEL_KEY cv::format("PAWCS_" IMPL_NAME "(scale=%g,nwords=%d,rlbsp=%g,nmvs=%d)",double(DATASET_SCALE_FACTOR),int(BGSPAWCS_DEFAULT_MAX_NB_WORDS),double(BGSLBSP_DEFAULT_LBSP_REL_SIMILARITY_THRESHOLD),int(BGSPAWCS_DEFAULT_N_SAMPLES_FOR_MV_AVGS))
 #endif //USE_...
-std::atomic_size_t g_nActiveThreads(0);
 const size_t g_nMaxThreads = USE_GPU_IMPL?1:std::thread::hardware_concurrency()>0?std::thread::hardware_concurrency():DEFAULT_NB_THREADS;
 
 int main(int, char**) {
     try {
         lv::IDatasetPtr pDataset = DatasetType::create(DATASET_PARAMS);
-        lv::IDataHandlerPtrQueue vpBatches = pDataset->getSortedBatches(false);
+        lv::WorkBatchLoadModel oLoadModel(pDataset->getOutputPath()+"/load_stats.txt",LOAD_MODEL_KEY);
+        lv::IDataHandlerPtrQueue vpBatches = oLoadModel.getSortedBatches(pDataset->getBatches(false));
         const size_t nTotPackets = pDataset->getInputCount();
         const size_t nTotBatches = vpBatches.size();
         if(nTotBatches==0 || nTotPackets==0)
@@ -98,20 +113,15 @@ int main(int, char**) {
         std::cout << "Parsing complete. [" << nTotBatches << " batch(es)]" << std::endl;
         std::cout << "\n[" << lv::getTimeStamp() << "]\n" << std::endl;
         std::cout << "Executing background subtraction with " << ((g_nMaxThreads>nTotBatches)?nTotBatches:g_nMaxThreads) << " thread(s)..." << std::endl;
-        size_t nProcessedBatches = 0;
-        while(!vpBatches.empty()) {
-            while(g_nActiveThreads>=g_nMaxThreads)
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            lv::IDataHandlerPtr pBatch = vpBatches.top();
-            std::cout << "\tProcessing [" << ++nProcessedBatches << "/" << nTotBatches << "] (" << pBatch->getRelativePath() << ", L=" << std::scientific << std::setprecision(2) << pBatch->getExpectedLoad() << ")" << std::endl;
-            if(DATASET_PRECACHING)
-                pBatch->startPrecaching(EVALUATE_OUTPUT);
-            ++g_nActiveThreads;
-            std::thread(Analyze,(int)nProcessedBatches,pBatch).detach();
-            vpBatches.pop();
-        }
-        while(g_nActiveThreads>0) // @@@ check if thread crashed?
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        std::atomic_size_t nProcessedBatches(0);
+        lv::WorkBatchScheduler oScheduler(g_nMaxThreads,bool(DATASET_PRECACHING),bool(EVALUATE_OUTPUT));
+        oScheduler.start(std::move(vpBatches),[&](size_t nWorkerIdx, const lv::IDataHandlerPtr& pBatch) {
+            std::cout << "\tProcessing [" << ++nProcessedBatches << "/" << nTotBatches << "] (" << pBatch->getRelativePath() << ", L=" << std::scientific << std::setprecision(2) << oLoadModel.getExpectedLoad(pBatch) << ")" << std::endl;
+            Analyze((int)nWorkerIdx,pBatch);
+            oLoadModel.record(pBatch);
+        },[&](const lv::IDataHandlerPtr& pBatch){return oLoadModel.getExpectedLoad(pBatch);});
+        oScheduler.wait();
+        oLoadModel.write();
         if(pDataset->getProcessedOutputCountPromise()==nTotPackets)
             pDataset->writeEvalReport();
     }
@@ -135,6 +145,7 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
         const size_t nTotPacketCount = oBatch.getFrameCount();
         GLContext oContext(oBatch.getFrameSize(),std::string("[GPU] ")+oBatch.getRelativePath(),DISPLAY_OUTPUT==0);
         std::shared_ptr<IBackgroundSubtractor_<lv::GLSL>> pAlgo = std::make_shared<BackgroundSubtractorType>();
+        pAlgo->setWorkGroupSizeAutoTuning(USE_GLSL_WG_AUTOTUNING!=0);
 #if DISPLAY_OUTPUT>1
         cv::DisplayHelperPtr pDisplayHelper = cv::DisplayHelper::create(oBatch.getName(),oBatch.getOutputPath()+"/../");
         pAlgo->m_pDisplayHelper = pDisplayHelper;
@@ -179,7 +190,6 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
     catch(const cv::Exception& e) {std::cout << "\nAnalyze caught cv::Exception:\n" << e.what() << "\n" << std::endl;}
     catch(const std::exception& e) {std::cout << "\nAnalyze caught std::exception:\n" << e.what() << "\n" << std::endl;}
     catch(...) {std::cout << "\nAnalyze caught unhandled exception\n" << std::endl;}
-    --g_nActiveThreads;
     try {
         if(pBatch->isProcessing())
             dynamic_cast<DatasetType::WorkBatch&>(*pBatch).stopProcessing();
@@ -207,7 +217,7 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
         cv::Mat oCurrInput = oBatch.getInput(nCurrIdx).clone();
         lvAssert(!oCurrInput.empty() && oCurrInput.isContinuous());
         cv::Mat oCurrFGMask(oBatch.getFrameSize(),CV_8UC1,cv::Scalar_<uchar>(0));
-        std::shared_ptr<IBackgroundSubtractor> pAlgo = std::make_shared<BackgroundSubtractorType>();
+        std::shared_ptr<IBackgroundSubtractor_<eImplTypeEnum>> pAlgo = std::make_shared<BackgroundSubtractorType>();
         const double dDefaultLearningRate = pAlgo->getDefaultLearningRate();
         pAlgo->initialize(oCurrInput,oROI);
 #if DISPLAY_OUTPUT>0
@@ -233,7 +243,7 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
             if(nKeyPressed==(int)'q')
                 break;
 #endif //DISPLAY_OUTPUT>0
-            oBatch.push(oCurrFGMask,nCurrIdx++);
+            oBatch.push(oCurrFGMask,nCurrIdx++,lv::Archiver_BinaryMask|(WRITE_PACKED_OUTPUT?lv::Archiver_Container:0));
         }
         oBatch.stopProcessing();
         const double dTimeElapsed = oBatch.getProcessTime();
@@ -244,7 +254,6 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
     catch(const cv::Exception& e) {std::cout << "\nAnalyze caught cv::Exception:\n" << e.what() << "\n" << std::endl;}
     catch(const std::exception& e) {std::cout << "\nAnalyze caught std::exception:\n" << e.what() << "\n" << std::endl;}
     catch(...) {std::cout << "\nAnalyze caught unhandled exception\n" << std::endl;}
-    --g_nActiveThreads;
     try {
         if(pBatch->isProcessing())
             dynamic_cast<DatasetType::WorkBatch&>(*pBatch).stopProcessing();
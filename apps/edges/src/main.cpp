@@ -31,6 +31,7 @@
 #define USE_GLSL_IMPL           0
 #define USE_CUDA_IMPL           0
 #define USE_OPENCL_IMPL         0
+#define USE_CPUTHREADED_IMPL    0 // splits the threshold sweep of each image over the shared thread pool (LBSP only)
 ////////////////////////////////
 #define DATASET_ID              Dataset_BSDS500 // comment this line to fall back to custom dataset definition
 #define DATASET_OUTPUT_PATH     "results_test" // will be created in the app's working directory if using a custom dataset
@@ -38,10 +39,12 @@
 #define DATASET_SCALE_FACTOR    1.0
 ////////////////////////////////
 #define USE_GPU_IMPL (USE_GLSL_IMPL||USE_CUDA_IMPL||USE_OPENCL_IMPL)
-#if (USE_GLSL_IMPL+USE_CUDA_IMPL+USE_OPENCL_IMPL)>1
+#if (USE_GLSL_IMPL+USE_CUDA_IMPL+USE_OPENCL_IMPL+USE_CPUTHREADED_IMPL)>1
 #error "Must specify a single impl."
 #elif (USE_CANNY+USE_LBSP)!=1
 #error "Must specify a single algorithm."
+#elif (USE_CPUTHREADED_IMPL && USE_CANNY)
+#error "Canny only offers a non-parallel impl."
 #endif //USE_...
 #ifndef DATASET_ID
 #define DATASET_ID Dataset_Custom
@@ -71,22 +74,32 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch);
 #if USE_GLSL_IMPL
 static_assert(false,"Missing impl");
 constexpr lv::ParallelAlgoType eImplTypeEnum = lv::GLSL;
+#define IMPL_NAME "GLSL"
+#elif USE_CPUTHREADED_IMPL
+constexpr lv::ParallelAlgoType eImplTypeEnum = lv::CPUThreaded;
+#define IMPL_NAME "CPUThreaded"
 #else // USE_..._IMPL
 constexpr lv::ParallelAlgoType eImplTypeEnum = lv::NonParallel;
+#define IMPL_NAME "NonParallel"
 #endif // USE_..._IMPL
-using DatasetType = lv::Dataset_<lv::DatasetTask_EdgDet,lv::DATASET_ID,eImplTypeEnum>;
+// the evaluators only come in gpu and non-parallel flavors; cpu-threaded algos are evaluated on the calling thread
+constexpr lv::ParallelAlgoType eEvalImplTypeEnum = (eImplTypeEnum==lv::CPUThreaded)?lv::NonParallel:eImplTypeEnum;
+using DatasetType = lv::Dataset_<lv::DatasetTask_EdgDet,lv::DATASET_ID,eEvalImplTypeEnum>;
+// the load model key names the algorithm, its impl, and the (default) parameters that affect its processing cost, so stats are only reused when comparable
 #if USE_CANNY
 using EdgeDetectorType = EdgeDetectorCanny;
+#define LOAD_MODEL_KEY cv::format("Canny_" IMPL_NAME "(scale=%g,fullthresh=%d)",double(DATASET_SCALE_FACTOR),int(FULL_THRESH_ANALYSIS))
 #elif USE_LBSP
-using EdgeDetectorType = EdgeDetectorLBSP;
+using EdgeDetectorType = EdgeDetectorLBSP_<eImplTypeEnum>;
+#define LOAD_MODEL_KEY cv::format("LBSP_" IMPL_NAME "(scale=%g,fullthresh=%d,nlevels=%d)",double(DATASET_SCALE_FACTOR),int(FULL_THRESH_ANALYSIS),int(EDGLBSP_DEFAULT_LEVEL_COUNT))
 #endif //USE_...
-std::atomic_size_t g_nActiveThreads(0);
 const size_t g_nMaxThreads = USE_GPU_IMPL?1:std::thread::hardware_concurrency()>0?std::thread::hardware_concurrency():DEFAULT_NB_THREADS;
 
 int main(int, char**) {
     try {
         lv::IDatasetPtr pDataset = DatasetType::create(DATASET_PARAMS);
-        lv::IDataHandlerPtrQueue vpBatches = pDataset->getSortedBatches(false);
+        lv::WorkBatchLoadModel oLoadModel(pDataset->getOutputPath()+"/load_stats.txt",LOAD_MODEL_KEY);
+        lv::IDataHandlerPtrQueue vpBatches = oLoadModel.getSortedBatches(pDataset->getBatches(false));
         const size_t nTotPackets = pDataset->getInputCount();
         const size_t nTotBatches = vpBatches.size();
         if(nTotBatches==0 || nTotPackets==0)
@@ -94,20 +107,15 @@ int main(int, char**) {
         std::cout << "Parsing complete. [" << nTotBatches << " batch(es)]" << std::endl;
         std::cout << "\n[" << lv::getTimeStamp() << "]\n" << std::endl;
         std::cout << "Executing edge detection with " << ((g_nMaxThreads>nTotBatches)?nTotBatches:g_nMaxThreads) << " thread(s)..." << std::endl;
-        size_t nProcessedBatches = 0;
-        while(!vpBatches.empty()) {
-            while(g_nActiveThreads>=g_nMaxThreads)
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            lv::IDataHandlerPtr pBatch = vpBatches.top();
-            std::cout << "\tProcessing [" << ++nProcessedBatches << "/" << nTotBatches << "] (" << pBatch->getRelativePath() << ", L=" << std::scientific << std::setprecision(2) << pBatch->getExpectedLoad() << ")" << std::endl;
-            if(DATASET_PRECACHING)
-                pBatch->startPrecaching(EVALUATE_OUTPUT);
-            ++g_nActiveThreads;
-            std::thread(Analyze,(int)nProcessedBatches,pBatch).detach();
-            vpBatches.pop();
-        }
-        while(g_nActiveThreads>0)
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        std::atomic_size_t nProcessedBatches(0);
+        lv::WorkBatchScheduler oScheduler(g_nMaxThreads,bool(DATASET_PRECACHING),bool(EVALUATE_OUTPUT));
+        oScheduler.start(std::move(vpBatches),[&](size_t nWorkerIdx, const lv::IDataHandlerPtr& pBatch) {
+            std::cout << "\tProcessing [" << ++nProcessedBatches << "/" << nTotBatches << "] (" << pBatch->getRelativePath() << ", L=" << std::scientific << std::setprecision(2) << oLoadModel.getExpectedLoad(pBatch) << ")" << std::endl;
+            Analyze((int)nWorkerIdx,pBatch);
+            oLoadModel.record(pBatch);
+        },[&](const lv::IDataHandlerPtr& pBatch){return oLoadModel.getExpectedLoad(pBatch);});
+        oScheduler.wait();
+        oLoadModel.write();
         if(pDataset->getProcessedOutputCountPromise()==nTotPackets)
             pDataset->writeEvalReport();
     }
@@ -180,7 +188,6 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
     catch(const cv::Exception& e) {std::cout << "\nAnalyze caught cv::Exception:\n" << e.what() << "\n" << std::endl;}
     catch(const std::exception& e) {std::cout << "\nAnalyze caught std::exception:\n" << e.what() << "\n" << std::endl;}
     catch(...) {std::cout << "\nAnalyze caught unhandled exception\n" << std::endl;}
-    --g_nActiveThreads;
     try {
         if(pBatch->isProcessing())
             dynamic_cast<DatasetType::WorkBatch&>(*pBatch).stopProcessing();
@@ -208,7 +215,7 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
         cv::Mat oCurrInput = oBatch.getInput(nCurrIdx).clone();
         lvAssert(!oCurrInput.empty() && oCurrInput.isContinuous());
         cv::Mat oCurrEdgeMask(oBatch.getInputMaxSize(),CV_8UC1,cv::Scalar_<uchar>(0));
-        std::shared_ptr<IEdgeDetector> pAlgo = std::make_shared<EdgeDetectorType>();
+        std::shared_ptr<IEdgeDetector_<eImplTypeEnum>> pAlgo = std::make_shared<EdgeDetectorType>();
 #if !FULL_THRESH_ANALYSIS
         const double dDefaultThreshold = pAlgo->getDefaultThreshold();
 #endif //(!FULL_THRESH_ANALYSIS)
@@ -243,7 +250,6 @@ void Analyze(int nThreadIdx, lv::IDataHandlerPtr pBatch) {
     catch(const cv::Exception& e) {std::cout << "\nAnalyze caught cv::Exception:\n" << e.what() << "\n" << std::endl;}
     catch(const std::exception& e) {std::cout << "\nAnalyze caught std::exception:\n" << e.what() << "\n" << std::endl;}
     catch(...) {std::cout << "\nAnalyze caught unhandled exception\n" << std::endl;}
-    --g_nActiveThreads;
     try {
         if(pBatch->isProcessing())
             dynamic_cast<DatasetType::WorkBatch&>(*pBatch).stopProcessing();
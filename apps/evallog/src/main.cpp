@@ -0,0 +1,65 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/datasets.hpp"
+
+////////////////////////////////
+#define DEFAULT_WINDOW_SIZE     100
+#define FOLLOW_POLL_DELAY_MS    1000
+////////////////////////////////
+
+// prints the windowed F-Measure of a per-packet binary classification log (see DATASETUTILS_EVAL_STREAM_LOG)
+// usage: evallog <log_file_path> [window_size] [follow]
+int main(int argc, char** argv) {
+    try {
+        if(argc<2) {
+            std::cout << "Usage: " << argv[0] << " <log_file_path> [window_size=" << DEFAULT_WINDOW_SIZE << "] [follow=0]" << std::endl;
+            return 1;
+        }
+        const size_t nWindowSize = argc>2?(size_t)std::stoul(argv[2]):size_t(DEFAULT_WINDOW_SIZE);
+        const bool bFollow = argc>3 && std::stoi(argv[3])!=0;
+        lv::BinClassifLogReader oReader(argv[1]);
+        // the reader keeps its position, so following a live log only parses the newly appended records
+        std::deque<lv::BinClassifLogRecord> qoWindow;
+        lv::BinClassif oWindowCounters;
+        lv::BinClassifLogRecord oRecord;
+        do {
+            while(oReader.read(oRecord)) {
+                qoWindow.push_back(oRecord);
+                oWindowCounters.accumulate(oRecord.oCounters);
+                if(qoWindow.size()>nWindowSize) {
+                    const lv::BinClassif& oOldCounters = qoWindow.front().oCounters;
+                    oWindowCounters.nTP -= oOldCounters.nTP; oWindowCounters.nTN -= oOldCounters.nTN; oWindowCounters.nFP -= oOldCounters.nFP;
+                    oWindowCounters.nFN -= oOldCounters.nFN; oWindowCounters.nSE -= oOldCounters.nSE; oWindowCounters.nDC -= oOldCounters.nDC;
+                    qoWindow.pop_front();
+                }
+                if(qoWindow.size()==nWindowSize) {
+                    const double dWindowTime_sec = qoWindow.back().dTimestamp_sec-qoWindow.front().dTimestamp_sec;
+                    std::cout << "[" << std::setw(8) << qoWindow.front().nIdx << "," << std::setw(8) << qoWindow.back().nIdx << "]  FM=" << std::fixed << std::setprecision(4) << lv::BinClassifMetrics::CalcFMeasure(oWindowCounters)
+                              << "  Rcl=" << lv::BinClassifMetrics::CalcRecall(oWindowCounters) << "  Prc=" << lv::BinClassifMetrics::CalcPrecision(oWindowCounters)
+                              << "  Hz=" << std::setprecision(2) << (dWindowTime_sec>0?(nWindowSize-1)/dWindowTime_sec:0.0) << std::endl;
+                }
+            }
+            if(bFollow)
+                std::this_thread::sleep_for(std::chrono::milliseconds(FOLLOW_POLL_DELAY_MS));
+        } while(bFollow);
+    }
+    catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(const std::exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught std::exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(...) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught unhandled exception\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    return 0;
+}
@@ -0,0 +1,128 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/datasets.hpp"
+
+////////////////////////////////
+#define DEFAULT_FRAME_COUNT     8
+#define DEFAULT_RNG_SEED        42
+////////////////////////////////
+
+namespace {
+
+    /// returns a random 8UC1 mat whose values are picked among 'vnVals'
+    cv::Mat getRandomMat(cv::RNG& oRNG, const cv::Size& oSize, const std::vector<uchar>& vnVals) {
+        cv::Mat oMat(oSize,CV_8UC1);
+        for(int i=0; i<oMat.rows; ++i)
+            for(int j=0; j<oMat.cols; ++j)
+                oMat.at<uchar>(i,j) = vnVals[oRNG.uniform(0,(int)vnVals.size())];
+        return oMat;
+    }
+
+    /// runs the glsl evaluator over a random sequence (w/ pass-through parent) and compares its per-frame counters to BinClassif::accumulate; returns the mismatch count
+    size_t checkSequence(cv::RNG& oRNG, const cv::Size& oSize, const glm::uvec2& vWorkGroupSize, size_t nFrameCount) {
+        // inputs also carry non-binary values, as those must be counted as negatives on both sides
+        const std::vector<uchar> vnInputVals = {DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL,DATASETUTILS_SHADOW_VAL,uchar(1),uchar(254)};
+        const std::vector<uchar> vnGTVals = {DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL,DATASETUTILS_OUTOFSCOPE_VAL,DATASETUTILS_UNKNOWN_VAL,DATASETUTILS_SHADOW_VAL};
+        const std::vector<uchar> vnROIVals = {DATASETUTILS_POSITIVE_VAL,DATASETUTILS_POSITIVE_VAL,DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL};
+        const cv::Mat oROI = getRandomMat(oRNG,oSize,vnROIVals);
+        std::vector<cv::Mat> voInputs(nFrameCount),voGTs(nFrameCount);
+        for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx) {
+            voInputs[nFrameIdx] = getRandomMat(oRNG,oSize,vnInputVals);
+            voGTs[nFrameIdx] = getRandomMat(oRNG,oSize,vnGTVals);
+        }
+        std::shared_ptr<GLImageProcAlgo> pParent = std::make_shared<GLImagePassThroughAlgo>(CV_8UC1,false,false,true);
+        std::shared_ptr<lv::GLBinaryClassifierEvaluator> pEvalAlgo = std::make_shared<lv::GLBinaryClassifierEvaluator>(pParent,nFrameCount);
+        pParent->setWorkGroupSizeAutoTuning(false);
+        pEvalAlgo->setWorkGroupSizeAutoTuning(false);
+        pParent->setWorkGroupSize(vWorkGroupSize);
+        pEvalAlgo->setWorkGroupSize(vWorkGroupSize);
+        pEvalAlgo->initialize_gl(voInputs[0],voGTs[0],oROI);
+        // apply_gl uploads the next frame while processing the current one, so the last call only flushes the pipeline
+        for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx) {
+            if(nFrameIdx+1<nFrameCount)
+                pEvalAlgo->apply_gl(voInputs[nFrameIdx+1],voGTs[nFrameIdx+1]);
+            else
+                pEvalAlgo->apply_gl(cv::Mat(),cv::Mat());
+        }
+        glErrorCheck;
+        const cv::Mat& oCountersBuffer = pEvalAlgo->getEvaluationAtomicCounterBuffer();
+        lvAssert_(oCountersBuffer.rows==(int)nFrameCount && oCountersBuffer.cols==(int)lv::BinClassif::nCountersCount,"unexpected gpu counters buffer size");
+        size_t nMismatches = 0;
+        lv::BinClassif oTotCounters;
+        for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx) {
+            lv::BinClassif oCPUCounters,oGPUCounters;
+            oCPUCounters.accumulate(voInputs[nFrameIdx],voGTs[nFrameIdx],oROI);
+            oTotCounters.accumulate(oCPUCounters);
+            oGPUCounters.nTP = (uint32_t)oCountersBuffer.at<int32_t>((int)nFrameIdx,lv::BinClassif::Counter_TP);
+            oGPUCounters.nTN = (uint32_t)oCountersBuffer.at<int32_t>((int)nFrameIdx,lv::BinClassif::Counter_TN);
+            oGPUCounters.nFP = (uint32_t)oCountersBuffer.at<int32_t>((int)nFrameIdx,lv::BinClassif::Counter_FP);
+            oGPUCounters.nFN = (uint32_t)oCountersBuffer.at<int32_t>((int)nFrameIdx,lv::BinClassif::Counter_FN);
+            oGPUCounters.nSE = (uint32_t)oCountersBuffer.at<int32_t>((int)nFrameIdx,lv::BinClassif::Counter_SE);
+            oGPUCounters.nDC = (uint32_t)oCountersBuffer.at<int32_t>((int)nFrameIdx,lv::BinClassif::Counter_DC);
+            if(!oGPUCounters.isEqual(oCPUCounters)) {
+                std::cout << "\tframe #" << nFrameIdx << " mismatch:  cpu=[" << oCPUCounters.nTP << "," << oCPUCounters.nTN << "," << oCPUCounters.nFP << "," << oCPUCounters.nFN << "," << oCPUCounters.nSE << "," << oCPUCounters.nDC << "]"
+                          << "  gpu=[" << oGPUCounters.nTP << "," << oGPUCounters.nTN << "," << oGPUCounters.nFP << "," << oGPUCounters.nFN << "," << oGPUCounters.nSE << "," << oGPUCounters.nDC << "]" << std::endl;
+                ++nMismatches;
+            }
+        }
+        // the summed counters are also what the async evaluator reports, so they are checked separately
+        if(!pEvalAlgo->getMetricsBase()->m_oCounters.isEqual(oTotCounters)) {
+            std::cout << "\tsummed counters mismatch" << std::endl;
+            ++nMismatches;
+        }
+        return nMismatches;
+    }
+
+} // anonymous namespace
+
+// checks that the glsl binary classification evaluator counts exactly what BinClassif::accumulate counts on the cpu
+// (see DATASETUTILS_GLSL_EVAL_GROUP_REDUCTION); the context is headless if EGL is enabled, so this can run on display-less machines
+// usage: glevalcheck [frame_count] [rng_seed]
+int main(int argc, char** argv) {
+    try {
+        const size_t nFrameCount = argc>1?(size_t)std::stoul(argv[1]):size_t(DEFAULT_FRAME_COUNT);
+        const uint64_t nRNGSeed = argc>2?(uint64_t)std::stoull(argv[2]):uint64_t(DEFAULT_RNG_SEED);
+        lvAssert_(nFrameCount>0,"frame count must be positive");
+#if HAVE_EGL
+        lv::gl::Context oContext(cv::Size(1,1),"glevalcheck",true,TARGET_GL_VER_MAJOR,TARGET_GL_VER_MINOR,lv::gl::ContextBackend_Headless);
+#else //!HAVE_EGL
+        lv::gl::Context oContext(cv::Size(1,1),"glevalcheck",true);
+#endif //!HAVE_EGL
+        std::cout << "GL renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+        // frame sizes that are not multiples of the work group sizes cover the partial group (out-of-frame invocation) paths
+        const std::vector<cv::Size> voSizes = {cv::Size(320,240),cv::Size(333,217),cv::Size(1,1),cv::Size(1023,769)};
+        const std::vector<glm::uvec2> vvWorkGroupSizes = {glm::uvec2(12,8),glm::uvec2(32,32),glm::uvec2(5,3),glm::uvec2(1,1)};
+        cv::RNG oRNG(nRNGSeed);
+        size_t nFailedChecks = 0, nTotChecks = 0;
+        for(const cv::Size& oSize : voSizes) {
+            for(const glm::uvec2& vWorkGroupSize : vvWorkGroupSizes) {
+                std::cout << "Checking " << nFrameCount << " frame(s) of size [" << oSize.width << "," << oSize.height << "] w/ work group size [" << vWorkGroupSize.x << "," << vWorkGroupSize.y << "]..." << std::endl;
+                const size_t nMismatches = checkSequence(oRNG,oSize,vWorkGroupSize,nFrameCount);
+                nFailedChecks += size_t(nMismatches>0);
+                ++nTotChecks;
+            }
+        }
+        std::cout << (nTotChecks-nFailedChecks) << "/" << nTotChecks << " check(s) passed." << std::endl;
+        if(nFailedChecks)
+            return 1;
+    }
+    catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(const std::exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught std::exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(...) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught unhandled exception\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    return 0;
+}
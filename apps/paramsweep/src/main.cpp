@@ -0,0 +1,73 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/datasets.hpp"
+#include "litiv/video.hpp"
+
+////////////////////////////////
+#define DATASET_OUTPUT_PATH     "results_sweep"
+#define DATASET_SCALE_FACTOR    1.0
+#define SWEEP_REPORT_NAME       "sweep_report.txt"
+////////////////////////////////
+
+// decodes each CDnet packet once, and runs a grid of SuBSENSE configurations on it in parallel (one thread per configuration)
+using DatasetType = lv::Dataset_<lv::DatasetTask_Segm,lv::Dataset_CDnet,lv::NonParallel>;
+using BackgroundSubtractorType = BackgroundSubtractorSuBSENSE_<lv::NonParallel>;
+const std::vector<size_t> g_vnDescDistThresholdOffsets = {1,3,5};
+const std::vector<size_t> g_vnMinColorDistThresholds = {20,30,40};
+
+int main(int, char**) {
+    try {
+        lv::IDatasetPtr pDataset = DatasetType::create(DATASET_OUTPUT_PATH,false,true,false,DATASET_SCALE_FACTOR);
+        lv::IDataHandlerPtrArray vpBatches = pDataset->getBatches(false);
+        if(vpBatches.empty() || pDataset->getInputCount()==0)
+            lvError_("Could not parse any data for dataset '%s'",pDataset->getName().c_str());
+        std::vector<std::pair<size_t,size_t>> vConfigs;
+        std::vector<std::string> vsConfigNames;
+        for(size_t nDescDistThresholdOffset : g_vnDescDistThresholdOffsets) {
+            for(size_t nMinColorDistThreshold : g_vnMinColorDistThresholds) {
+                vConfigs.emplace_back(nDescDistThresholdOffset,nMinColorDistThreshold);
+                vsConfigNames.push_back("D"+std::to_string(nDescDistThresholdOffset)+"_C"+std::to_string(nMinColorDistThreshold));
+            }
+        }
+        std::cout << "Parsing complete. [" << vpBatches.size() << " batch(es), " << vConfigs.size() << " config(s)]" << std::endl;
+        std::cout << "\n[" << lv::getTimeStamp() << "]\n" << std::endl;
+        lv::BinClassifParamSweep oSweep(vsConfigNames);
+        std::vector<std::shared_ptr<IBackgroundSubtractor>> vpAlgos(vConfigs.size());
+        size_t nProcessedBatches = 0;
+        for(const auto& pBatch : vpBatches) {
+            std::cout << "\tProcessing [" << ++nProcessedBatches << "/" << vpBatches.size() << "] (" << pBatch->getRelativePath() << ")" << std::endl;
+            lv::StopWatch oStopWatch;
+            oSweep.processBatch(pBatch,[&](size_t nConfigIdx, const cv::Mat& oInitInput, const cv::Mat& oROI) {
+                vpAlgos[nConfigIdx] = std::make_shared<BackgroundSubtractorType>(vConfigs[nConfigIdx].first,vConfigs[nConfigIdx].second);
+                vpAlgos[nConfigIdx]->initialize(oInitInput,oROI);
+            },[&](size_t nConfigIdx, const cv::Mat& oInput, size_t nIdx, cv::Mat& oFGMask) {
+                const double dCurrLearningRate = nIdx<=100?1:vpAlgos[nConfigIdx]->getDefaultLearningRate();
+                vpAlgos[nConfigIdx]->apply(oInput,oFGMask,dCurrLearningRate);
+            });
+            const double dTimeElapsed = oStopWatch.tock();
+            std::cout << "\t\t" << lv::clampString(pBatch->getName(),12) << " @ F:" << pBatch->getInputCount() << "   (" << std::fixed << std::setw(4) << dTimeElapsed << " sec, " << std::setw(4) << pBatch->getInputCount()*vConfigs.size()/dTimeElapsed << " config-Hz)" << std::endl;
+        }
+        oSweep.writeReport(lv::AddDirSlashIfMissing(pDataset->getOutputPath())+SWEEP_REPORT_NAME);
+    }
+    catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(const std::exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught std::exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(...) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught unhandled exception\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    std::cout << "\n[" << lv::getTimeStamp() << "]\n" << std::endl;
+    std::cout << "All done." << std::endl;
+    return 0;
+}
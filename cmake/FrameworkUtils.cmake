@@ -63,9 +63,12 @@ macro(target_link_litiv_dependencies name)
     if(USE_GLSL)
         if(USE_GLFW)
             target_link_libraries(${name} ${GLFW_LIBRARIES})
-        else(USE_FREEGLUT)
+        elseif(USE_FREEGLUT)
             target_link_libraries(${name} ${FREEGLUT_LIBRARY})
         endif()
+        if(USE_EGL)
+            target_link_libraries(${name} ${EGL_LIBRARIES})
+        endif()
         target_link_libraries(${name} ${OPENGL_LIBRARIES})
         target_link_libraries(${name} ${GLEW_LIBRARIES})
         target_link_libraries(${name} ${GLM_LIBRARIES})
@@ -0,0 +1,50 @@
+# FindEGL.cmake - attempts to locate the EGL library (used to create headless OpenGL contexts).
+#
+# This module defines the following variables (on success):
+#   EGL_INCLUDE_DIRS  - where to find EGL/egl.h
+#   EGL_LIBRARIES     - the EGL library to link against
+#   EGL_FOUND         - if the library was successfully located
+#
+# It is trying a few standard installation locations, but can be customized
+# with the EGL_ROOT_DIR cmake or environment variable (e.g. to point at a
+# Mesa build providing the surfaceless platform).
+
+find_path(EGL_INCLUDE_DIR
+    NAMES
+        EGL/egl.h
+    HINTS
+        "${EGL_ROOT_DIR}/include"
+        "$ENV{EGL_ROOT_DIR}/include"
+    PATHS
+        /usr/include
+        /usr/local/include
+        /opt/graphics/OpenGL/include
+    DOC
+        "The directory where EGL/egl.h resides"
+)
+
+find_library(EGL_LIBRARY
+    NAMES
+        EGL
+        libEGL
+    HINTS
+        "${EGL_ROOT_DIR}/lib"
+        "$ENV{EGL_ROOT_DIR}/lib"
+    PATHS
+        /usr/lib
+        /usr/lib64
+        /usr/local/lib
+        /usr/local/lib64
+    DOC
+        "The EGL library"
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(EGL DEFAULT_MSG EGL_LIBRARY EGL_INCLUDE_DIR)
+
+if(EGL_FOUND)
+    set(EGL_INCLUDE_DIRS ${EGL_INCLUDE_DIR})
+    set(EGL_LIBRARIES ${EGL_LIBRARY})
+endif()
+
+mark_as_advanced(EGL_INCLUDE_DIR EGL_LIBRARY)
@@ -114,6 +114,8 @@ namespace lv {
                 if(!this->m_bIsProcessing) {
                     this->startProcessing_impl();
                     this->m_bIsProcessing = true;
+                    this->resetIOWaitTime();
+                    this->startPacketTiming();
                     this->m_oStopWatch.tick();
                 }
             }
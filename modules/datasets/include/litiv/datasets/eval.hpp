@@ -18,6 +18,12 @@
 #pragma once
 
 #define DATASETUTILS_VALIDATE_ASYNC_EVALUATORS 0
+#define DATASETUTILS_GLSL_EVAL_GROUP_REDUCTION 1 // use 0 to always increment global eval counters per invocation (otherwise only done when atomic counter ops are unsupported; can be faster on software implementations)
+#define DATASETUTILS_EVAL_QUEUE_WORKER_COUNT   4 // use 0 to evaluate packets synchronously on the processing thread
+#define DATASETUTILS_EVAL_QUEUE_MAX_PENDING    32
+#define DATASETUTILS_EVAL_STREAM_LOG           0 // use 1 to stream per-packet classification counters to a binary log in each batch output folder
+#define DATASETUTILS_SWEEP_WINDOW_SIZE          16 // max number of decoded packets kept in memory by the parameter sweep driver
+#define DATASETUTILS_EVAL_ARRAY_PARALLEL      1 // use 0 to evaluate array packet streams serially on the processing thread (instead of on the shared thread pool)
 
 #include "litiv/datasets/metrics.hpp"
 
@@ -31,6 +37,11 @@ namespace lv {
     template<DatasetEvalList eDatasetEval, DatasetList eDataset>
     struct DatasetReporter_;
 
+    /// accumulates per-packet latencies & input/gt waiting times from all work batches under the given data handler (recursively)
+    void accumulateTimingStats(const IDataHandler& oHandler, LatencyHistogram& oLatencies, double& dIOWaitTime_sec);
+    /// returns the timing summary appended to eval reports (throughput, per-packet latency percentiles and i/o wait share)
+    std::string writeTimingReport(size_t nPacketCount, double dTimeElapsed_sec, const LatencyHistogram& oLatencies, double dIOWaitTime_sec);
+
     /// metric retriever interface; exposes utility functions to recursively parse metrics through all work batches
     template<typename IDataInterface>
     struct IMetricRetriever_ : public virtual IDataInterface {
@@ -123,6 +134,119 @@ namespace lv {
         friend struct DatasetReporter_<eDatasetEval,eDataset>;
     };
 
+    /// evaluation queue used to offload packet-level metrics accumulation from the processing thread to a pool of workers
+    struct EvaluationQueue {
+        /// metrics accumulator creation function signature
+        using CreateFunc = std::function<IIMetricsAccumulatorPtr()>;
+        /// packet evaluation function signature (accumulates the evaluation of a single packet into the provided accumulator)
+        using EvalFunc = std::function<void(const IIMetricsAccumulatorPtr& /*pMetrics*/, const cv::Mat& /*oClassif*/, const cv::Mat& /*oGT*/, const cv::Mat& /*oROI*/)>;
+        /// packet evaluation function signature for bit-packed gt labels (see 'IIDataLoader::getPackedGT')
+        using PackedEvalFunc = std::function<void(const IIMetricsAccumulatorPtr& /*pMetrics*/, const cv::Mat& /*oClassif*/, const PackedLabels& /*oGT*/, const cv::Mat& /*oROI*/)>;
+        /// per-packet results callback signature (called in push order, with the push timestamp relative to queue creation/reset)
+        using PacketFunc = std::function<void(size_t /*nIdx*/, double /*dPushTime_sec*/, const IIMetricsAccumulatorConstPtr& /*pPacketMetrics*/)>;
+        /// creates the base metrics accumulator; workers (if any) are only started on the first push, and each keeps its own accumulator unless
+        /// 'bOrderedMerge' is set, in which case packets are evaluated in their own accumulators and merged in push order (for per-packet lists)
+        EvaluationQueue(CreateFunc lCreateFunc, EvalFunc lEvalFunc, bool bOrderedMerge=false, size_t nWorkers=DATASETUTILS_EVAL_QUEUE_WORKER_COUNT);
+        /// creates the base metrics accumulator, with an additional evaluation function for packets pushed with bit-packed gt labels
+        EvaluationQueue(CreateFunc lCreateFunc, EvalFunc lEvalFunc, PackedEvalFunc lPackedEvalFunc, bool bOrderedMerge=false, size_t nWorkers=DATASETUTILS_EVAL_QUEUE_WORKER_COUNT);
+        /// waits for all queued packets to be evaluated, and joins the workers
+        ~EvaluationQueue();
+        /// queues a copy of a packet for evaluation (in pooled buffers); blocks while too many packets are pending (evaluates in place if there are no workers)
+        void push(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI, size_t nIdx);
+        /// queues a copy of a packet w/ bit-packed gt labels for evaluation (the queue must have been created with a packed evaluation function)
+        void push(const cv::Mat& oClassif, const PackedLabels& oGT, const cv::Mat& oROI, size_t nIdx);
+        /// sets the callback to receive per-packet evaluation results as they are merged (e.g. for streaming logs; forces ordered merging)
+        void setPacketCallback(PacketFunc lPacketFunc);
+        /// waits for all queued packets to be evaluated, and returns the base metrics accumulator (with the workers' accumulators merged in)
+        IIMetricsAccumulatorPtr getMetricsBase();
+        /// waits for all queued packets to be evaluated, and resets the base metrics accumulator
+        void reset();
+        /// waits for all queued packets to be evaluated, and joins the workers (they will be restarted by the next push, if any)
+        void stop();
+    private:
+        /// packet evaluation task slot (its buffers are kept between uses, so steady-state queueing does not allocate)
+        struct Task {
+            size_t nSeqIdx;
+            size_t nIdx;
+            double dPushTime_sec;
+            cv::Mat oClassif,oGT,oROI;
+            PackedLabels oPackedGT; ///< only used if 'bPackedGT' is set
+            bool bPackedGT;
+            IIMetricsAccumulatorPtr pPacketMetrics; ///< only used for ordered merging
+        };
+        /// queues a packet for evaluation (w/ either a regular or bit-packed gt, based on which pointer is non-null)
+        void push(const cv::Mat& oClassif, const cv::Mat* pGT, const PackedLabels* pPackedGT, const cv::Mat& oROI, size_t nIdx);
+        /// evaluates a packet into the given accumulator via the appropriate evaluation function
+        void evaluate(const IIMetricsAccumulatorPtr& pMetrics, const cv::Mat& oClassif, const cv::Mat* pGT, const PackedLabels* pPackedGT, const cv::Mat& oROI);
+        /// worker thread entry point; evaluates packets in its own accumulator (or in per-packet ones, merged back in push order)
+        void entry(size_t nWorkerIdx);
+        /// waits for all queued packets to be evaluated (must be called with the sync mutex locked)
+        void wait(std::mutex_unique_lock& oLock);
+        /// merges the workers' accumulators into the base one, and resets them (must be called with the sync mutex locked, and no packet pending)
+        void mergeWorkerMetrics();
+        const CreateFunc m_lCreateFunc;
+        const EvalFunc m_lEvalFunc;
+        const PackedEvalFunc m_lPackedEvalFunc;
+        const bool m_bOrderedMerge;
+        const size_t m_nWorkers;
+        PacketFunc m_lPacketFunc;
+        lv::StopWatch m_oStopWatch;
+        std::mutex m_oSyncMutex;
+        std::condition_variable m_oTaskCondVar;
+        std::condition_variable m_oDoneCondVar;
+        std::array<Task,DATASETUTILS_EVAL_QUEUE_MAX_PENDING> m_aTasks;
+        std::vector<size_t> m_vnFreeTaskIdxs; ///< stack of free task slots
+        std::queue<size_t> m_qnPendingTaskIdxs; ///< filled task slots, in push order
+        std::array<size_t,DATASETUTILS_EVAL_QUEUE_MAX_PENDING> m_anDoneTaskIdxs; ///< evaluated task slots waiting to be merged, indexed by sequence index (ordered merging only)
+        std::vector<IIMetricsAccumulatorPtr> m_vpWorkerMetrics; ///< per-worker accumulators (null until used)
+        IIMetricsAccumulatorPtr m_pMetricsBase;
+        std::exception_ptr m_pException;
+        size_t m_nNextPushSeqIdx;
+        size_t m_nNextMergeSeqIdx; ///< number of packets fully evaluated & merged so far (in push order if merging is ordered)
+        bool m_bIsActive;
+        std::vector<std::thread> m_vhWorkers;
+        EvaluationQueue(const EvaluationQueue&) = delete;
+        EvaluationQueue& operator=(const EvaluationQueue&) = delete;
+    };
+
+    /// parameter sweep driver for binary classifiers; decodes each packet once and fans it out to one algorithm instance per configuration (each on its own thread, w/ its own evaluation queue)
+    struct BinClassifParamSweep {
+        /// algorithm initialization callback signature (called on the configuration's thread at the start of each batch, with the first input packet)
+        using InitFunc = std::function<void(size_t /*nConfigIdx*/, const cv::Mat& /*oInitInput*/, const cv::Mat& /*oROI*/)>;
+        /// algorithm processing callback signature (called on the configuration's thread, in packet order; the output mask is evaluated once the call returns)
+        using ProcessFunc = std::function<void(size_t /*nConfigIdx*/, const cv::Mat& /*oInput*/, size_t /*nIdx*/, cv::Mat& /*oClassif*/)>;
+        /// creates the evaluation queues for all named configurations
+        BinClassifParamSweep(const std::vector<std::string>& vsConfigNames, size_t nWindowSize=DATASETUTILS_SWEEP_WINDOW_SIZE);
+        /// processes all packets of a work batch with every configuration, blocking until done (exceptions thrown by callbacks are rethrown here)
+        void processBatch(const IDataHandlerPtr& pBatch, InitFunc lInitFunc, ProcessFunc lProcessFunc);
+        /// returns the number of configurations being swept
+        inline size_t getConfigCount() const {return m_vpConfigs.size();}
+        /// returns the classification counters accumulated for a configuration over all processed batches
+        const BinClassif& getCounters(size_t nConfigIdx) const;
+        /// writes a consolidated report listing overall & batch-averaged metrics for each configuration (sorted by F-Measure), and returns the best configuration index
+        size_t writeReport(const std::string& sFilePath) const;
+    private:
+        /// per-configuration evaluation state, accumulated over all processed batches
+        struct ConfigState {
+            std::string sName;
+            EvaluationQueue oEvalQueue;
+            BinClassif oCounters;
+            double dBatchFMeasureSum;
+            size_t nBatchCount;
+            size_t nPacketCount;
+            double dProcessTime_sec;
+            ConfigState(const std::string& sName);
+        };
+        /// decoded packet shared by all configuration threads (released once they all processed it)
+        struct Packet {
+            cv::Mat oInput,oGT,oROI;
+        };
+        const size_t m_nWindowSize;
+        std::vector<std::unique_ptr<ConfigState>> m_vpConfigs;
+        BinClassifParamSweep(const BinClassifParamSweep&) = delete;
+        BinClassifParamSweep& operator=(const BinClassifParamSweep&) = delete;
+    };
+
     /// data reporter full (default) specialization --- can be overridden by dataset type in 'impl' headers
     template<DatasetEvalList eDatasetEval, DatasetList eDataset>
     struct DataReporter_ : public DataReporterWrapper_<eDatasetEval,eDataset> {};
@@ -148,26 +272,55 @@ namespace lv {
         /// resets internal metrics counters to zero
         virtual void resetMetrics() {
             resetProcessedOutputCount();
-            m_pMetricsBase = IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>();
+            m_oEvalQueue.reset();
         }
     protected:
         /// overrides 'getMetricsBase' from IMetricRetriever_ for non-group-impl (as always required)
         virtual IIMetricsAccumulatorConstPtr getMetricsBase() const override {
-            return m_pMetricsBase;
+            return m_oEvalQueue.getMetricsBase();
         }
-        /// overrides 'processOutput' from IDataConsumer_ to evaluate the provided output packet
+        /// overrides 'processOutput' from IDataConsumer_ to queue the provided output packet for evaluation
         virtual void processOutput(const cv::Mat& oClassif, size_t nIdx) override {
             if(getDatasetInfo()->isUsingEvaluator()) {
                 lvAssert_(!oClassif.empty(),"output must be non-empty for evaluation");
                 auto pLoader = shared_from_this_cast<IIDataLoader>(true);
                 lvAssert_(pLoader->getOutputPacketType()==ImagePacket && pLoader->getGTPacketType()==ImagePacket && pLoader->getGTMappingType()==PixelMapping,"default impl cannot evaluate without 1:1 image pixel mapping");
-                m_pMetricsBase->m_oCounters.accumulate(oClassif,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx));
+#if DATASETUTILS_EVAL_STREAM_LOG
+                if(!m_pEvalLog) {
+                    m_pEvalLog = std::make_shared<BinClassifLogWriter>(lv::AddDirSlashIfMissing(getOutputPath())+"eval_log.bin");
+                    m_oEvalQueue.setPacketCallback([pEvalLog=m_pEvalLog](size_t nPacketIdx, double dPushTime_sec, const IIMetricsAccumulatorConstPtr& pPacketMetrics) {
+                        pEvalLog->write(BinClassifLogRecord{nPacketIdx,dPushTime_sec,std::static_pointer_cast<const BinClassifMetricsAccumulator>(pPacketMetrics)->m_oCounters});
+                    });
+                }
+#endif //DATASETUTILS_EVAL_STREAM_LOG
+                // once the gt cache is complete, packets are evaluated straight from their packed labels (no gt decoding or full-size gt copy)
+                if(pLoader->getPackedGT(nIdx,m_oPackedGT))
+                    m_oEvalQueue.push(oClassif,m_oPackedGT,pLoader->getGTROI(nIdx),nIdx);
+                else
+                    m_oEvalQueue.push(oClassif,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx),nIdx);
             }
         }
-        /// default constructor; automatically creates an instance of the base metrics accumulator object
-        inline DataEvaluator_() : m_pMetricsBase(IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>()) {}
-        /// contains low-level metric accumulation logic
-        BinClassifMetricsAccumulatorPtr m_pMetricsBase;
+        /// overrides 'stopProcessing_impl' from IDataHandler to release the evaluation workers once all queued packets are evaluated
+        virtual void stopProcessing_impl() override {
+            m_oEvalQueue.stop();
+        }
+        /// default constructor; automatically creates the evaluation queue (and its base metrics accumulator object)
+        inline DataEvaluator_() :
+                m_oEvalQueue([](){return IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>();},
+                             [](const IIMetricsAccumulatorPtr& pMetrics, const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI) {
+                                 std::static_pointer_cast<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>(pMetrics)->m_oCounters.accumulate(oClassif,oGT,oROI);
+                             },
+                             [](const IIMetricsAccumulatorPtr& pMetrics, const cv::Mat& oClassif, const PackedLabels& oGT, const cv::Mat& oROI) {
+                                 std::static_pointer_cast<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>(pMetrics)->m_oCounters.accumulate(oClassif,oGT,oROI);
+                             }) {}
+        /// packed gt buffer reused between packets (see 'IIDataLoader::getPackedGT')
+        PackedLabels m_oPackedGT;
+#if DATASETUTILS_EVAL_STREAM_LOG
+        /// per-packet classification counters log (opened on first evaluated packet)
+        std::shared_ptr<BinClassifLogWriter> m_pEvalLog;
+#endif //DATASETUTILS_EVAL_STREAM_LOG
+        /// contains low-level metric accumulation logic, offloaded to worker threads
+        mutable EvaluationQueue m_oEvalQueue;
     };
 
     /// data evaluator specialization for binary classification array work batch performance evaluation
@@ -208,12 +361,25 @@ namespace lv {
                 const std::vector<cv::Mat>& vGTArray = pLoader->getGTArray(nIdx);
                 const std::vector<cv::Mat>& vGTROIArray = pLoader->getGTROIArray(nIdx);
                 lvAssert_(vClassif.size()==vGTArray.size() && (vGTROIArray.empty() || vClassif.size()==vGTROIArray.size()),"gt/output array size mistmatch");
+                // each stream only touches its own counters, and the unpacked gt views stay valid until all streams are done
+                const auto lAccumulate = [&](size_t nStreamIdx) {
+                    m_pMetricsBase->m_vCounters[nStreamIdx].accumulate(vClassif[nStreamIdx],vGTArray[nStreamIdx],vGTROIArray.empty()?cv::Mat():vGTROIArray[nStreamIdx]);
+                };
+#if DATASETUTILS_EVAL_ARRAY_PARALLEL
+                // the processing thread also evaluates streams while waiting, and the first stream exception is rethrown here
+                lv::ThreadPool::get().parallel_for(vClassif.size(),1,[&](size_t /*nTileIdx*/, size_t nBegin, size_t nEnd) {
+                    for(size_t s=nBegin; s<nEnd; ++s)
+                        lAccumulate(s);
+                });
+#else //(!DATASETUTILS_EVAL_ARRAY_PARALLEL)
                 for(size_t s=0; s<vClassif.size(); ++s)
-                    m_pMetricsBase->m_vCounters[s].accumulate(vClassif[s],vGTArray[s],vGTROIArray.empty()?cv::Mat():vGTROIArray[s]);
+                    lAccumulate(s);
+#endif //(!DATASETUTILS_EVAL_ARRAY_PARALLEL)
             }
         }
         /// default constructor; automatically creates an instance of the base metrics accumulator object
-        inline DataEvaluator_() : m_pMetricsBase(IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifierArray,eDataset>>()) {}
+        inline DataEvaluator_() :
+                m_pMetricsBase(IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifierArray,eDataset>>()) {}
         /// contains low-level metric accumulation logic
         BinClassifMetricsArrayAccumulatorPtr m_pMetricsBase;
     };
@@ -270,12 +270,14 @@ namespace lv {
     protected:
         /// overrides 'getMetricsBase' from IMetricRetriever for non-group-impl (as always required)
         virtual IIMetricsAccumulatorConstPtr getMetricsBase() const override;
-        /// overrides 'processOutput' from IDataConsumer_ to evaluate the provided output packet
+        /// overrides 'processOutput' from IDataConsumer_ to queue the provided output packet for evaluation
         virtual void processOutput(const cv::Mat& oClassif, size_t nIdx) override;
-        /// default constructor; automatically creates an instance of the base metrics accumulator object
-        inline DataEvaluator_() : m_pMetricsBase(IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,Dataset_BSDS500>>()) {}
-        /// contains low-level metric accumulation logic
-        std::shared_ptr<MetricsAccumulator_<DatasetEval_BinaryClassifier,Dataset_BSDS500>> m_pMetricsBase;
+        /// overrides 'stopProcessing_impl' from IDataHandler to release the evaluation workers once all queued packets are evaluated
+        virtual void stopProcessing_impl() override;
+        /// default constructor; automatically creates the evaluation queue (and its base metrics accumulator object)
+        DataEvaluator_();
+        /// contains low-level metric accumulation logic, offloaded to worker threads
+        mutable EvaluationQueue m_oEvalQueue;
     };
 
 } // namespace lv
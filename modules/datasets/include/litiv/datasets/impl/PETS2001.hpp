@@ -83,8 +83,7 @@ namespace lv {
             lv::GetSubDirsFromDir(this->getDataPath(),vsGTSubdirPaths);
             if(vsGTSubdirPaths.size()!=1)
                 lvError_("PETS2006D3TC1 sequence '%s': bad subdirectory for parsing (should contain only one GT subdir)",this->getName().c_str());
-            this->m_voVideoReader.open(vsVideoSeqPaths[0]);
-            if(!this->m_voVideoReader.isOpened())
+            if(!this->m_oVideoDecoder.open(vsVideoSeqPaths[0]))
                 lvError_("PETS2006D3TC1 sequence '%s': video file could not be opened",this->getName().c_str());
             lv::GetFilesFromDir(vsGTSubdirPaths[0],this->m_vsGTPaths);
             if(this->m_vsGTPaths.empty())
@@ -103,8 +102,7 @@ namespace lv {
                 cv::resize(this->m_oInputROI,this->m_oInputROI,cv::Size(),dScale,dScale,cv::INTER_NEAREST);
             this->m_oGTROI = this->m_oInputROI;
             this->m_oInputSize = this->m_oGTSize = this->m_oInputROI.size();
-            this->m_nNextExpectedVideoReaderFrameIdx = 0;
-            this->m_nFrameCount = (size_t)this->m_voVideoReader.get(cv::CAP_PROP_FRAME_COUNT);
+            this->m_nFrameCount = this->m_oVideoDecoder.getFrameCount();
             lvAssert_(this->m_nFrameCount>0,"could not find any input frames");
         }
     };
@@ -26,6 +26,8 @@
 #define DATASETUTILS_UNKNOWN_VAL     uchar(170)
 #define DATASETUTILS_SHADOW_VAL      uchar(50)
 
+#define DATASETUTILS_EVAL_LOG_FLUSH_PERIOD 64
+
 namespace lv {
 
     // classfication counters list for binary classifiers (not all counters have to be used)
@@ -60,6 +62,8 @@ namespace lv {
         }
         /// accumulates the pixel-level classification counts of 'oClassif' vs 'oGT' into the internal counts
         void accumulate(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI=cv::Mat());
+        /// accumulates the pixel-level classification counts of 'oClassif' vs the bit-packed 'oGT' into the internal counts (gt rows are unpacked on the fly)
+        void accumulate(const cv::Mat& oClassif, const PackedLabels& oGT, const cv::Mat& oROI=cv::Mat());
         /// returns a colored classification mask for visualization based on good/bad classifcations of 'oClassif' vs 'oGT'
         static cv::Mat getColoredMask(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI=cv::Mat());
         /// default constructor; sets all counters to zero
@@ -209,6 +213,37 @@ namespace lv {
         inline BinClassifMetrics(const BinClassif& m) : dRecall(CalcRecall(m)),dSpecificity(CalcSpecificity(m)),dFPR(CalcFalsePositiveRate(m)),dFNR(CalcFalseNegativeRate(m)),dPBC(CalcPercentBadClassifs(m)),dPrecision(CalcPrecision(m)),dFMeasure(CalcFMeasure(m)),dMCC(CalcMatthewsCorrCoeff(m)) {}
     };
 
+    /// per-packet binary classification log record (packet index, timestamp & counters)
+    struct BinClassifLogRecord {
+        uint64_t nIdx; ///< packet index
+        double dTimestamp_sec; ///< packet timestamp (typically relative to the start of processing)
+        BinClassif oCounters; ///< packet classification counters
+    };
+
+    /// append-only binary log writer for per-packet binary classification counters (useful to monitor long-running evaluations)
+    struct BinClassifLogWriter {
+        /// opens (and truncates, unless appending) the given log file; records are flushed to disk every 'nFlushPeriod' packets
+        BinClassifLogWriter(const std::string& sFilePath, bool bAppend=false, size_t nFlushPeriod=DATASETUTILS_EVAL_LOG_FLUSH_PERIOD);
+        /// appends a record to the log file (only a stream buffer is kept in memory)
+        void write(const BinClassifLogRecord& oRecord);
+        /// flushes all pending records to disk
+        void flush();
+    private:
+        std::ofstream m_oLogFile;
+        const size_t m_nFlushPeriod;
+        size_t m_nPendingRecords;
+    };
+
+    /// binary log reader for logs written by BinClassifLogWriter (can be used while the log is still being written)
+    struct BinClassifLogReader {
+        /// opens the given log file, and validates its header
+        BinClassifLogReader(const std::string& sFilePath);
+        /// reads the next record from the log file; returns false if no complete record is available
+        bool read(BinClassifLogRecord& oRecord);
+    private:
+        std::ifstream m_oLogFile;
+    };
+
     /// high-level metrics calculator super-interface (relies on IIMetricsAccumulator internally)
     struct IIMetricsCalculator : lv::enable_shared_from_this<IIMetricsCalculator> {
         /// virtual destructor for adequate cleanup from IIMetricsCalculator pointers
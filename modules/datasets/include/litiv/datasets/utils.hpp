@@ -24,6 +24,8 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
 
+#define DATASETUTILS_GTCACHE_DIR_ENV_VAR "LITIV_GT_CACHE_DIR" // env variable used to override the gt cache directory (default: the dataset dir, or $XDG_CACHE_HOME/litiv/gtcache if read-only; "none" disables the cache)
+
 namespace lv {
 
     enum DatasetTaskList { // from the task type, we can derive the source and eval types
@@ -411,6 +413,112 @@ namespace lv {
         DataPrecacher(const DataPrecacher&) = delete;
     };
 
+    /// general-purpose video frame decoder w/ read-ahead thread & seek index, fully implemented (i.e. can be used stand-alone)
+    struct VideoDecoder {
+        /// default constructor (no video opened)
+        VideoDecoder();
+        /// default destructor (joins the decoding thread, if still running)
+        ~VideoDecoder();
+        /// opens a video file and scans it once to count frames & build the seek index (stops the decoding thread, if running)
+        bool open(const std::string& sFilePath, bool bBuildSeekIndex=true);
+        /// closes the video file (stops the decoding thread, if running)
+        void release();
+        /// returns whether a video file is currently opened or not
+        inline bool isOpened() const {return m_oReader.isOpened();}
+        /// returns the total frame count of the opened video (exact if the seek index was built, approximated via the container otherwise)
+        inline size_t getFrameCount() const {return m_nFrameCount;}
+        /// fetches a frame, with or without read-ahead enabled (should never be called concurrently); out-of-order requests seek to the nearest indexed position and decode forward
+        cv::Mat getFrame(size_t nIdx);
+        /// initializes read-ahead decoding with a given max decoded frame count (starts up thread)
+        bool startAsyncDecoding(size_t nQueueSize);
+        /// joins decoding thread and clears all internal buffers
+        void stopAsyncDecoding();
+        /// returns whether the decoding thread has already been started or not
+        inline bool isActive() const {return m_bIsActive;}
+    private:
+        void entry();
+        /// returns whether frame 'nIdx' can be reached by decoding forward from the current reader position
+        bool isReachable(size_t nIdx) const;
+        /// positions the reader on the nearest indexed frame preceding 'nIdx' (the caller must then decode forward)
+        void seek(size_t nIdx);
+        /// decodes forward up to frame 'nIdx' (intermediate frames are only grabbed), and retrieves it if needed
+        bool decode(size_t nIdx, cv::Mat& oFrame, bool bRetrieve=true);
+        cv::VideoCapture m_oReader;
+        std::vector<double> m_vdSeekIndexTimestamps; ///< reader timestamps (in msec) of every N-th frame, recorded during the initial scan
+        size_t m_nFrameCount;
+        size_t m_nNextGrabIdx; ///< index of the frame that will be returned by the next reader grab
+        size_t m_nLastGrabIdx; ///< index of the frame that can still be retrieved from the reader (size_t(-1) if none)
+        std::thread m_hWorker;
+        std::mutex m_oSyncMutex;
+        std::condition_variable m_oFrameCondVar;
+        std::condition_variable m_oSpaceCondVar;
+        std::atomic_bool m_bIsActive;
+        std::deque<std::pair<size_t,cv::Mat>> m_qoFrames;
+        size_t m_nQueueMaxCount;
+        size_t m_nReqIdx,m_nNextQueueIdx;
+        VideoDecoder& operator=(const VideoDecoder&) = delete;
+        VideoDecoder(const VideoDecoder&) = delete;
+    };
+
+    /// label image bit-packed using 1, 2 or 3 bits per label (w/ a palette of at most 8 distinct values), as stored in packed label caches
+    struct PackedLabels {
+        /// label image size (empty for empty images)
+        cv::Size oSize;
+        /// number of bits used per label (1 to 3)
+        int nBitsPerLabel;
+        /// number of valid palette entries
+        int nPaletteSize;
+        /// original label values, indexed by packed label
+        std::array<uchar,8> anPalette;
+        /// packed labels, stored as 'nBitsPerLabel' bytes per group of 8 labels (w/ groups padded at the end of each row)
+        std::vector<uchar> vcPayload;
+        /// default constructor (empty image)
+        PackedLabels();
+        /// returns whether the packed image is empty or not
+        inline bool empty() const {return oSize.area()==0;}
+        /// returns the number of payload bytes used per row
+        inline size_t getRowStep() const {return size_t((oSize.width+7)/8)*size_t(nBitsPerLabel);}
+        /// packs an 8-bit single-channel image w/ at most 8 distinct values (returns false if the image cannot be packed; reuses the payload buffer)
+        bool pack(const cv::Mat& oLabels);
+        /// unpacks a single row of labels into 'pRow', which must hold 'oSize.width' values
+        void unpackRow(int nRowIdx, uchar* pRow) const;
+        /// unpacks the whole image into an 8-bit single-channel mat
+        void unpack(cv::Mat& oLabels) const;
+    };
+
+    /// general-purpose on-disk cache for bit-packed label images (e.g. gt masks w/ at most 8 distinct values), shared between instances & processes, fully implemented (i.e. can be used stand-alone)
+    struct PackedLabelCache {
+        /// default constructor (no cache file opened)
+        PackedLabelCache();
+        /// default destructor (discards the temporary cache file, if it was not completed)
+        ~PackedLabelCache();
+        /// opens an existing (complete) cache file for reading if its packet count, scale factor & source key match, or prepares a temporary one to be filled & committed once all 'nPacketCount' packets are added
+        bool open(const std::string& sFilePath, size_t nPacketCount, double dScaleFactor, uint64_t nSourceKey);
+        /// closes the cache file (the temporary cache file is discarded if it was not completed)
+        void release();
+        /// returns whether packets can currently be fetched from or added to the cache
+        inline bool isOpened() const {return m_bIsReadable || m_oWriteStream.is_open();}
+        /// fetches a packet from a complete cache file, returning false if the packet could not be found (should never be called concurrently)
+        bool getPacket(size_t nIdx, cv::Mat& oPacket);
+        /// fetches a packet from a complete cache file in its packed form, returning false if the packet could not be found (should never be called concurrently)
+        bool getPacket(size_t nIdx, PackedLabels& oPacket);
+        /// adds a packet to the temporary cache file (which is committed once full, and discarded if any packet cannot be packed)
+        void addPacket(size_t nIdx, const cv::Mat& oPacket);
+    private:
+        std::string m_sFilePath,m_sTempFilePath;
+        size_t m_nPacketCount;
+        double m_dScaleFactor;
+        uint64_t m_nSourceKey;
+        bool m_bIsReadable;
+        std::ifstream m_oReadStream;
+        std::ofstream m_oWriteStream;
+        std::vector<std::streamoff> m_vnChunkOffsets; ///< byte offsets of each packet chunk in the cache file (-1 if not yet available)
+        size_t m_nChunkCount;
+        PackedLabels m_oPackedLabels;
+        PackedLabelCache& operator=(const PackedLabelCache&) = delete;
+        PackedLabelCache(const PackedLabelCache&) = delete;
+    };
+
     /// data loader super-interface for work batch, exposes basic packet get functions and internal precacher wiring
     struct IIDataLoader : public virtual IDataHandler {
         /// returns the input data packet type policy (used for internal packet auto-transformations)
@@ -431,6 +539,10 @@ namespace lv {
         const cv::Mat& getInput(size_t nPacketIdx);
         /// returns a gt packet by index (works both with and without precaching enabled)
         const cv::Mat& getGT(size_t nPacketIdx);
+        /// fetches a gt packet by index in its bit-packed form, straight from the gt cache (returns false if it is not cached yet, or if it would need transformations)
+        bool getPackedGT(size_t nPacketIdx, PackedLabels& oPackedGT);
+        /// returns the total time spent waiting for input/gt packets since the last reset (i.e. time not hidden by the precachers)
+        inline double getIOWaitTime() const {return m_dIOWaitTime_sec;}
         /// returns the ROI associated with an input packet by index (returns empty mat by default)
         virtual const cv::Mat& getInputROI(size_t nPacketIdx) const;
         /// returns the ROI associated with a gt packet by index (returns empty mat by default)
@@ -454,9 +566,23 @@ namespace lv {
         virtual const cv::Mat& getInput_redirect(size_t nPacketIdx);
         /// gt packet transformation function (used e.g. for rescaling and color space conversion)
         virtual const cv::Mat& getGT_redirect(size_t nPacketIdx);
+        /// resets the input/gt packet waiting time counter
+        inline void resetIOWaitTime() {m_dIOWaitTime_sec = 0.0;}
+        /// returns a key identifying the current state of the gt source files, used to invalidate the gt cache (0 = unknown, which disables caching)
+        virtual uint64_t getGTSourceKey() const {return 0;}
     private:
+        /// opens the gt cache on first use (must be called with the gt cache mutex locked)
+        void initGTCache();
         /// holds the loaded copies of the latest input/gt packets queried by the precachers
         cv::Mat m_oLatestInput,m_oLatestGT;
+        /// total time spent in input/gt packet getters since the last reset
+        double m_dIOWaitTime_sec;
+        /// bit-packed gt cache shared across instances (opened on the first gt packet query)
+        PackedLabelCache m_oGTCache;
+        /// defines whether the gt cache was already opened (or skipped) or not
+        bool m_bGTCacheInitialized;
+        /// guards the gt cache, as gt packets may be queried from the precacher thread & the caller's thread
+        std::mutex m_oGTCacheMutex;
         /// precacher objects which may spin up a thread to pre-fetch data packets
         DataPrecacher m_oInputPrecacher,m_oGTPrecacher;
         /// input/gt/output packet policy types
@@ -517,9 +643,9 @@ namespace lv {
         using IIDataLoader::getInputSize;
         /// hides useless non-array-only function from public interface (can be unhidden by derived class)
         using IIDataLoader::getGTSize;
-        /// input 'unpacking' function, which essentially unmerges the streams in a packet and assigns them to individual mats in the vector
+        /// input 'unpacking' function, which essentially unmerges the streams in a packet and assigns them to individual mats in the vector (as views on the packed data, not copies)
         virtual void unpackInput(size_t nPacketIdx, std::vector<cv::Mat>& vUnpackedInput);
-        /// gt 'unpacking' function, which essentially unmerges the streams in a packet and assigns them to individual mats in the vector
+        /// gt 'unpacking' function, which essentially unmerges the streams in a packet and assigns them to individual mats in the vector (as views on the packed data, not copies)
         virtual void unpackGT(size_t nPacketIdx, std::vector<cv::Mat>& vUnpackedGT);
     private:
         std::vector<cv::Mat> m_vLatestUnpackedInput,m_vLatestUnpackedGT;
@@ -545,8 +671,10 @@ namespace lv {
         virtual size_t getGTCount() const override;
         /// compute the expected CPU load for this data batch based on frame size, frame count, and channel count
         virtual double getExpectedLoad() const override;
-        /// initializes data spooling by starting an asynchronyzed precacher to pre-fetch data packets based on queried ids
+        /// initializes data spooling by starting an asynchronyzed precacher to pre-fetch data packets based on queried ids (also starts video read-ahead decoding)
         virtual void startPrecaching(bool bPrecacheGT=false, size_t nSuggestedBufferSize=SIZE_MAX) override;
+        /// kills the asynchronyzed precacher and the video read-ahead decoder, and clears internal buffers
+        virtual void stopPrecaching() override;
     protected:
         /// specialized constructor; still need to specify gt type, output type, and mappings
         IDataProducer_(PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType);
@@ -558,12 +686,12 @@ namespace lv {
         virtual const cv::Size& getGTMaxSize() const override;
         virtual cv::Mat getRawInput(size_t nPacketIdx) override;
         virtual cv::Mat getRawGT(size_t nPacketIdx) override;
+        virtual uint64_t getGTSourceKey() const override;
         virtual void parseData() override;
         size_t m_nFrameCount; ///< needed as a separate variable for VideoCapture+imread support
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::string> m_vsInputPaths,m_vsGTPaths;
-        cv::VideoCapture m_voVideoReader;
-        size_t m_nNextExpectedVideoReaderFrameIdx;
+        VideoDecoder m_oVideoDecoder;
         cv::Mat m_oInputROI,m_oGTROI;
         cv::Size m_oInputSize,m_oGTSize;
     };
@@ -597,6 +725,7 @@ namespace lv {
         virtual const cv::Size& getGTMaxSize() const override;
         virtual cv::Mat getRawInput(size_t nPacketIdx) override; ///< loads and returns a 'packed' input packet
         virtual cv::Mat getRawGT(size_t nPacketIdx) override; ///< loads and returns a 'packed' gt packet
+        virtual uint64_t getGTSourceKey() const override;
         //virtual void parseData() override;
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::vector<std::string>> m_vvsInputPaths,m_vvsGTPaths; // first dimension is packet index, 2nd is stream index
@@ -638,6 +767,7 @@ namespace lv {
         IDataProducer_(PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType);
         virtual cv::Mat getRawInput(size_t nPacketIdx) override;
         virtual cv::Mat getRawGT(size_t nPacketIdx) override;
+        virtual uint64_t getGTSourceKey() const override;
         virtual void parseData() override;
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::string> m_vsInputPaths,m_vsGTPaths;
@@ -677,6 +807,7 @@ namespace lv {
         IDataProducer_(PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType);
         virtual cv::Mat getRawInput(size_t nPacketIdx) override; ///< loads and returns a 'packed' input packet
         virtual cv::Mat getRawGT(size_t nPacketIdx) override; ///< loads and returns a 'packed' gt packet
+        virtual uint64_t getGTSourceKey() const override;
         //virtual void parseData() override;
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::vector<std::string>> m_vvsInputPaths,m_vvsGTPaths; ///< one path per packet per stream
@@ -695,34 +826,65 @@ namespace lv {
     template<DatasetTaskList eDatasetTask, DatasetSourceList eDatasetSource, DatasetList eDataset>
     struct DataProducer_ : public IDataProducerWrapper_<eDatasetTask,eDatasetSource,eDataset> {};
 
-    /// general-purpose, stand-alone data packet writer
+    /// general-purpose, stand-alone data packet writer (w/ lock-free bounded queue, and parallel encoding w/ in-order writing)
     struct DataWriter {
-        /// attaches to data archiver (the callback is the actual 'writing' action, with a signature similar to 'queue')
-        DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback);
-        /// default destructor (joins the writing thread, if still running)
+        /// packet encoding function signature (fills the byte buffer, whose capacity is kept between packets, with the encoded packet)
+        using EncodeFunc = std::function<void(const cv::Mat& /*oPacket*/, size_t /*nIdx*/, std::vector<uchar>& /*vEncodedPacket*/)>;
+        /// attaches to data archiver (the callback is the actual 'writing' action, with a signature similar to 'queue'), with an optional encoding step that
+        /// runs in parallel on all workers (if given, the archiver receives the encoded bytes as a 1xN CV_8UC1 matrix; otherwise, it does all the work in queue order)
+        DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback, EncodeFunc lDataEncoderCallback=nullptr);
+        /// default destructor (joins the writing threads, if still running)
         ~DataWriter();
-        /// queues a packet, with or without async writing enabled, and returns its position in queue
+        /// queues a packet, with or without async writing enabled, and returns its position in queue (i.e. number of packets to be written before it)
         size_t queue(const cv::Mat& oPacket, size_t nIdx);
         /// returns the current queue size, in packets
         inline size_t getCurrentQueueCount() const {return m_nQueueCount;}
         /// returns the current queue size, in bytes
         inline size_t getCurrentQueueSize() const {return m_nQueueSize;}
-        /// initializes async writing with a given queue size (in bytes) and a number of threads
-        bool startAsyncWriting(size_t nSuggestedQueueSize, bool bDropPacketsIfFull=false, size_t nWorkers=1);
-        /// joins writing thread and clears all internal buffers
+        /// initializes async writing with a given queue size (in bytes) and a number of threads (multi-producer mode must be enabled if 'queue' is called concurrently)
+        bool startAsyncWriting(size_t nSuggestedQueueSize, bool bDropPacketsIfFull=false, size_t nWorkers=1, bool bMultiProducer=false);
+        /// joins writing threads and clears all internal buffers (queued packets are all written first)
         void stopAsyncWriting();
         /// returns whether the wariting thread has already been started or not
         inline bool isActive() const {return m_bIsActive;}
     private:
+        /// ring buffer slot; packet buffers are kept between uses, so steady-state queueing does not allocate
+        struct PacketSlot {
+            std::atomic_size_t nSeq; ///< ring sequence number (pos = free for producer, pos+1 = filled, pos+N = freed for next lap)
+            std::atomic_bool bReady; ///< set once the packet is encoded (if needed) and can be written
+            size_t nIdx,nSize;
+            cv::Mat oPacket;
+            std::vector<uchar> vEncodedPacket;
+        };
+        /// reorder window entry; holds a packet released from the ring until it can be written in packet index order (buffers are swapped with ring slots, never copied)
+        struct PendingPacket {
+            size_t nIdx,nSize;
+            cv::Mat oPacket;
+            std::vector<uchar> vEncodedPacket;
+        };
         void entry();
+        /// moves all encoded packets at the head of the ring to the reorder window, and writes them in packet index order (only one thread at a time may do so, and only this part is serialized)
+        void commit();
+        /// writes packets from the reorder window while the lowest index is the next expected one (or, if forced, while room is needed or all packets must be written)
+        void flush(bool bFlushAll);
+        /// calls the archiver callback with the packet, or with its encoded bytes if an encoder is used
+        size_t write(const cv::Mat& oPacket, const std::vector<uchar>& vEncodedPacket, size_t nIdx);
         const std::function<size_t(const cv::Mat&,size_t)> m_lCallback;
+        const EncodeFunc m_lEncoder;
         std::vector<std::thread> m_vhWorkers;
         std::mutex m_oSyncMutex;
+        std::mutex m_oCommitMutex;
         std::condition_variable m_oQueueCondVar;
         std::condition_variable m_oClearCondVar;
-        std::map<size_t,cv::Mat> m_mQueue;
+        std::unique_ptr<PacketSlot[]> m_aSlots;
+        std::unique_ptr<PendingPacket[]> m_aReorderWindow; ///< packets waiting for lower indices (the first 'm_nReorderCount' entries are used; only accessed while committing)
+        size_t m_nReorderCount;
+        size_t m_nNextWriteIdx; ///< lowest packet index not written yet (only accessed while committing)
+        std::atomic_bool m_bQueueStalled; ///< set by producers that have to wait (or drop packets) for room, so the reorder window stops holding packets back
+        std::atomic_size_t m_nEnqueuePos,m_nDequeuePos,m_nCommitPos;
         std::atomic_bool m_bIsActive;
         bool m_bAllowPacketDrop;
+        bool m_bMultiProducer,m_bMultiConsumer; ///< ring positions only need a CAS if multiple threads may advance them at once
         size_t m_nQueueMaxSize;
         std::atomic_size_t m_nQueueSize;
         std::atomic_size_t m_nQueueCount;
@@ -730,6 +892,85 @@ namespace lv {
         DataWriter(const DataWriter&) = delete;
     };
 
+    /// general-purpose work batch scheduler; runs a batch processing function over a fixed pool of threads w/ batch stealing & pipelined precaching
+    struct WorkBatchScheduler {
+        /// batch processing function signature (receives the index of the worker thread it is called from)
+        using BatchFunc = std::function<void(size_t /*nWorkerIdx*/, const IDataHandlerPtr& /*pBatch*/)>;
+        /// batch load estimation function signature (defaults to IDataHandler::getExpectedLoad)
+        using LoadFunc = std::function<double(const IDataHandlerPtr& /*pBatch*/)>;
+        /// initializes the scheduler with a worker count and precaching options (each worker precaches up to 'nPrecacheLookahead' of its next batches, all within one global cache budget)
+        WorkBatchScheduler(size_t nWorkers, bool bPrecache=true, bool bPrecacheGT=false, size_t nPrecacheLookahead=1);
+        /// default destructor (waits for all batches to be processed, if still running)
+        ~WorkBatchScheduler();
+        /// distributes batches to workers (heaviest first, balancing expected loads) and starts processing them asynchronously
+        void start(IDataHandlerPtrQueue vpBatches, BatchFunc lBatchFunc, LoadFunc lLoadFunc=nullptr);
+        /// blocks until all batches have been processed, and joins worker threads
+        void wait();
+        /// blocks until all batches have been processed or until the timeout expires, and returns whether processing is complete
+        bool waitFor(size_t nTimeout_ms);
+        /// returns the total number of batches given to the scheduler
+        inline size_t getBatchCount() const {return m_nBatchCount;}
+        /// returns the number of batches that have been fully processed so far
+        inline size_t getCompletedBatchCount() const {return m_nCompletedBatchCount;}
+        /// returns the overall progress, i.e. the processed/expected output packet ratio over all batches (approximate while running)
+        double getProgress() const;
+        /// returns the batches currently being processed along with their progress ratio (approximate while running)
+        std::vector<std::pair<IDataHandlerPtr,double>> getActiveBatchesProgress() const;
+    private:
+        void entry(size_t nWorkerIdx);
+        /// pops the worker's next batch, or steals the lightest pending batch of the most loaded worker (must hold the sync lock)
+        IDataHandlerPtr popNextBatch(size_t nWorkerIdx);
+        /// starts precaching of a batch if it is not already precaching (must hold the sync lock)
+        void startPrecaching(const IDataHandlerPtr& pBatch);
+        const size_t m_nWorkers;
+        const bool m_bPrecache,m_bPrecacheGT;
+        const size_t m_nPrecacheLookahead;
+        size_t m_nPrecacheBufferSize; ///< per-precacher share of the global cache budget
+        BatchFunc m_lBatchFunc;
+        LoadFunc m_lLoadFunc;
+        std::vector<std::thread> m_vhWorkers;
+        mutable std::mutex m_oSyncMutex;
+        std::condition_variable m_oDoneCondVar;
+        std::vector<std::deque<IDataHandlerPtr>> m_vqpWorkerBatches;
+        std::vector<IDataHandlerPtr> m_vpActiveBatches;
+        IDataHandlerPtrArray m_vpAllBatches;
+        std::unordered_set<const IDataHandler*> m_spPrecachingBatches;
+        std::atomic_size_t m_nBatchCount,m_nCompletedBatchCount;
+        WorkBatchScheduler& operator=(const WorkBatchScheduler&) = delete;
+        WorkBatchScheduler(const WorkBatchScheduler&) = delete;
+    };
+
+    /// work batch load model calibrated from recorded processing times (kept in a persistent stats file, per algorithm & batch)
+    struct WorkBatchLoadModel {
+        /// loads previously recorded stats (if any) from the given file for the given algorithm name (should be stable across builds, and include the params that affect processing cost)
+        WorkBatchLoadModel(const std::string& sStatsFilePath, const std::string& sAlgoName);
+        /// returns the expected processing time of a batch (in seconds if any stats are available, otherwise in default load units)
+        double getExpectedLoad(const IDataHandlerPtr& pBatch) const;
+        /// returns the array of work batches sorted by calibrated expected load (for longest-processing-time-first scheduling)
+        IDataHandlerPtrQueue getSortedBatches(const IDataHandlerPtrArray& vpBatches) const;
+        /// records the processing time and output packet count of a (processed) work batch
+        void record(const IDataHandlerPtr& pBatch);
+        /// writes all recorded stats back to the stats file (stats for other algorithms are kept as-is)
+        void write() const;
+    private:
+        /// per-batch stats, as recorded at the end of processing
+        struct BatchStats {
+            size_t nPacketCount; ///< number of processed output packets
+            double dProcessTime_sec; ///< total processing time
+            double dLoad; ///< default load estimation (pixels x frames x channels) at the time of recording
+        };
+        const std::string m_sStatsFilePath;
+        const std::string m_sAlgoName;
+        mutable std::mutex m_oSyncMutex;
+        std::map<std::string,std::map<std::string,BatchStats>> m_mmStats;
+    };
+
+    enum ArchiverFlags { // used to override data archiver defaults when saving/loading packets (can be combined; -1 = internal defaults)
+        Archiver_BinaryMask=1, // packet is known to be a binary mask (0/255 inside ROI), skips the binarity check on save
+        Archiver_Container=2, // packet is RLE-encoded in a chunked per-batch container file instead of an individual image file
+        Archiver_MaxCompression=4, // packet image file is written with max PNG compression (slow, legacy behavior)
+    };
+
     /// default (specializable) forward declaration of the data archiver interface (used to save/load outputs)
     template<ArrayPolicy ePolicy>
     struct IDataArchiver_;
@@ -738,10 +979,16 @@ namespace lv {
     template<>
     struct IDataArchiver_<NotArray> : public virtual IDataHandler {
     protected:
-        /// saves a processed data packet locally based on idx and packet name (if available), with optional flags (-1 = internal defaults)
+        /// saves a processed data packet locally based on idx and packet name (if available), with optional flags (-1 = internal defaults, see ArchiverFlags)
         virtual void save(const cv::Mat& oOutput, size_t nIdx, int nFlags=-1);
-        /// loads a processed data packet based on idx and packet name (if available), with optional flags (-1 = internal defaults)
+        /// loads a processed data packet based on idx and packet name (if available), with optional flags (-1 = internal defaults, see ArchiverFlags)
         virtual cv::Mat load(size_t nIdx, int nFlags=-1);
+    private:
+        /// returns the path of the chunked container file used by this work batch for RLE-encoded packets
+        std::string getContainerPath() const;
+        std::mutex m_oContainerMutex;
+        std::ofstream m_oContainerStream;
+        std::unordered_map<size_t,std::streamoff> m_mContainerIndex;
     };
 
     /// data archiver specialization for array output processing
@@ -754,6 +1001,32 @@ namespace lv {
         virtual std::vector<cv::Mat> loadArray(size_t nIdx, int nFlags=-1);
     };
 
+    /// low-overhead log-linear (HDR-style) duration histogram, w/ exact buckets up to 32 usec and ~3% relative precision above (up to ~300 hours)
+    struct LatencyHistogram {
+        /// default constructor (all buckets empty)
+        LatencyHistogram();
+        /// records a single duration sample
+        void record(double dDuration_sec);
+        /// accumulates all the samples of another histogram into this one
+        void accumulate(const LatencyHistogram& oHist);
+        /// returns the approximate duration (in seconds) below which the given fraction [0,1] of samples fall
+        double getPercentile(double dFraction) const;
+        /// returns the maximum duration (in seconds) recorded so far
+        inline double getMax() const {return m_dMax_sec;}
+        /// returns the number of samples recorded so far
+        inline size_t getCount() const {return (size_t)m_nCount;}
+        /// clears all recorded samples
+        void reset();
+        /// number of sub-buckets per power of two (also the size of the exact, linear range in usec)
+        static constexpr size_t s_nSubBucketCount = 32;
+        /// number of powers of two covered above the linear range
+        static constexpr size_t s_nMagnitudeCount = 35;
+    private:
+        std::array<uint64_t,s_nSubBucketCount*(s_nMagnitudeCount+1)> m_anCounts;
+        uint64_t m_nCount;
+        double m_dMax_sec;
+    };
+
     /// default (specializable) forward declaration of the data counter interface (used only for packet counting)
     template<GroupPolicy ePolicy>
     struct IDataCounter_;
@@ -761,9 +1034,13 @@ namespace lv {
     /// data counter specialization for individual work batches (exposes counting logic)
     template<>
     struct IDataCounter_<NotGroup> : public virtual IDataHandler {
+        /// returns the histogram of per-packet processing latencies (i.e. durations between consecutive output packets, including input fetching)
+        inline const LatencyHistogram& getPacketLatencies() const {return m_oPacketLatencies;}
     protected:
-        /// increments processed packets count
-        inline void countOutput(size_t nPacketIdx) {m_mProcessedPackets.insert(nPacketIdx);}
+        /// increments processed packets count, and records the time elapsed since the previous packet
+        inline void countOutput(size_t nPacketIdx) {m_mProcessedPackets.insert(nPacketIdx); m_oPacketLatencies.record(m_oPacketStopWatch.tock());}
+        /// resets the per-packet latency histogram, and starts timing the first packet
+        inline void startPacketTiming() {m_oPacketLatencies.reset(); m_oPacketStopWatch.tick();}
         /// sets the processed packets count promise for async implementations
         inline void setProcessedOutputCountPromise() {m_nProcessedPacketsPromise.set_value(m_mProcessedPackets.size());}
         /// resets the processed packets count
@@ -775,6 +1052,8 @@ namespace lv {
     private:
         std::unordered_set<size_t> m_mProcessedPackets;
         std::promise<size_t> m_nProcessedPacketsPromise;
+        LatencyHistogram m_oPacketLatencies;
+        lv::StopWatch m_oPacketStopWatch;
     };
 
     /// data counter specialization for work batch groups (exposes recursive counting logic)
@@ -801,13 +1080,13 @@ namespace lv {
         virtual size_t getExpectedOutputCount() const override {
             return getGTCount();
         }
-        /// pushes an output (processed) data packet array for writing and/or evaluation
-        inline void push(const cv::Mat& oOutput, size_t nPacketIdx) {
+        /// pushes an output (processed) data packet array for writing and/or evaluation (save flags are forwarded to the data archiver)
+        inline void push(const cv::Mat& oOutput, size_t nPacketIdx, int nSaveFlags=-1) {
             lvAssert_(isProcessing(),"data processing must be toggled via 'startProcessing()' before pushing packets");
             countOutput(nPacketIdx);
             processOutput(oOutput,nPacketIdx);
             if(getDatasetInfo()->isSavingOutput() && !oOutput.empty())
-                this->save(oOutput,nPacketIdx);
+                this->save(oOutput,nPacketIdx,nSaveFlags);
         }
     protected:
         /// processes an output packet (does nothing by default, but may be overridden for evaluation/pipelining)
@@ -834,14 +1113,14 @@ namespace lv {
         virtual std::string getOutputStreamName(size_t nStreamIdx) const {
             return cv::format("out[%02d]",(int)nStreamIdx);
         }
-        /// pushes an output (processed) data packet array for writing and/or evaluation
-        inline void push(const std::vector<cv::Mat>& vOutput, size_t nPacketIdx) {
+        /// pushes an output (processed) data packet array for writing and/or evaluation (save flags are forwarded to the data archiver)
+        inline void push(const std::vector<cv::Mat>& vOutput, size_t nPacketIdx, int nSaveFlags=-1) {
             lvAssert_(isProcessing(),"data processing must be toggled via 'startProcessing()' before pushing packets");
             lvAssert_(vOutput.empty() || vOutput.size()==getOutputStreamCount(),"bad output array size");
             countOutput(nPacketIdx);
             processOutput(vOutput,nPacketIdx);
             if(getDatasetInfo()->isSavingOutput() && !vOutput.empty())
-                this->saveArray(vOutput,nPacketIdx);
+                this->saveArray(vOutput,nPacketIdx,nSaveFlags);
         }
     protected:
         /// processes an output array packet (does nothing by default, but may be overridden for evaluation/pipelining)
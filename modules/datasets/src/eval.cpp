@@ -18,6 +18,31 @@
 #include "litiv/datasets/eval.hpp"
 //#include "litiv/utils/console.hpp" @@@@@ reuse later?
 
+void lv::accumulateTimingStats(const IDataHandler& oHandler, LatencyHistogram& oLatencies, double& dIOWaitTime_sec) {
+    if(oHandler.isGroup()) {
+        for(const auto& pBatch : oHandler.getBatches(true))
+            accumulateTimingStats(*pBatch,oLatencies,dIOWaitTime_sec);
+        return;
+    }
+    const auto pCounter = dynamic_cast<const IDataCounter_<NotGroup>*>(&oHandler);
+    if(pCounter)
+        oLatencies.accumulate(pCounter->getPacketLatencies());
+    const auto pLoader = dynamic_cast<const IIDataLoader*>(&oHandler);
+    if(pLoader)
+        dIOWaitTime_sec += pLoader->getIOWaitTime();
+}
+
+std::string lv::writeTimingReport(size_t nPacketCount, double dTimeElapsed_sec, const LatencyHistogram& oLatencies, double dIOWaitTime_sec) {
+    std::stringstream ssStr;
+    ssStr << std::fixed;
+    ssStr << "\nHz: " << (dTimeElapsed_sec>0?nPacketCount/dTimeElapsed_sec:0.0) << "\n";
+    ssStr << "Latency (ms): p50=" << oLatencies.getPercentile(0.50)*1000 << " p95=" << oLatencies.getPercentile(0.95)*1000 << " p99=" << oLatencies.getPercentile(0.99)*1000 << " max=" << oLatencies.getMax()*1000 << "\n";
+    ssStr << "I/O wait: " << (dTimeElapsed_sec>0?100*dIOWaitTime_sec/dTimeElapsed_sec:0.0) << "%\n";
+    return ssStr.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void lv::IDataReporter_<lv::DatasetEval_None>::writeEvalReport() const {
     if(getProcessedOutputCount()==0) {
         std::cout << "No report to write for '" << getName() << "', skipping..." << std::endl;
@@ -34,6 +59,10 @@ void lv::IDataReporter_<lv::DatasetEval_None>::writeEvalReport() const {
         oMetricsOutput << "            |   Packets  |   Seconds  |     Hz     \n";
         oMetricsOutput << "------------|------------|------------|------------\n";
         oMetricsOutput << IDataReporter_<DatasetEval_None>::writeInlineEvalReport(0);
+        lv::LatencyHistogram oLatencies;
+        double dIOWaitTime_sec = 0.0;
+        accumulateTimingStats(*this,oLatencies,dIOWaitTime_sec);
+        oMetricsOutput << writeTimingReport(getProcessedOutputCount(),getProcessTime(),oLatencies,dIOWaitTime_sec);
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -76,7 +105,10 @@ void lv::IDataReporter_<lv::DatasetEval_BinaryClassifier>::writeEvalReport() con
         oMetricsOutput << "            |     Rcl    |     Spc    |     FPR    |     FNR    |     PBC    |     Prc    |     FM     |     MCC    \n";
         oMetricsOutput << "------------|------------|------------|------------|------------|------------|------------|------------|------------\n";
         oMetricsOutput << IDataReporter_<DatasetEval_BinaryClassifier>::writeInlineEvalReport(0);
-        oMetricsOutput << "\nHz: " << getProcessedOutputCount()/getProcessTime() << "\n";
+        lv::LatencyHistogram oLatencies;
+        double dIOWaitTime_sec = 0.0;
+        accumulateTimingStats(*this,oLatencies,dIOWaitTime_sec);
+        oMetricsOutput << writeTimingReport(getProcessedOutputCount(),getProcessTime(),oLatencies,dIOWaitTime_sec);
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -129,7 +161,10 @@ void lv::IDataReporter_<lv::DatasetEval_BinaryClassifierArray>::writeEvalReport(
         oMetricsOutput << "            |   Stream   ||     Rcl    |     Spc    |     FPR    |     FNR    |     PBC    |     Prc    |     FM     |     MCC    \n";
         oMetricsOutput << "------------|------------||------------|------------|------------|------------|------------|------------|------------|------------\n";
         oMetricsOutput << IDataReporter_<DatasetEval_BinaryClassifierArray>::writeInlineEvalReport(0);
-        oMetricsOutput << "\nHz: " << getProcessedOutputCount()/getProcessTime() << "\n";
+        lv::LatencyHistogram oLatencies;
+        double dIOWaitTime_sec = 0.0;
+        accumulateTimingStats(*this,oLatencies,dIOWaitTime_sec);
+        oMetricsOutput << writeTimingReport(getProcessedOutputCount(),getProcessTime(),oLatencies,dIOWaitTime_sec);
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -166,6 +201,360 @@ std::string lv::IDataReporter_<lv::DatasetEval_BinaryClassifierArray>::writeInli
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+lv::EvaluationQueue::EvaluationQueue(CreateFunc lCreateFunc, EvalFunc lEvalFunc, bool bOrderedMerge, size_t nWorkers) :
+        EvaluationQueue(lCreateFunc,lEvalFunc,PackedEvalFunc(),bOrderedMerge,nWorkers) {}
+
+lv::EvaluationQueue::EvaluationQueue(CreateFunc lCreateFunc, EvalFunc lEvalFunc, PackedEvalFunc lPackedEvalFunc, bool bOrderedMerge, size_t nWorkers) :
+        m_lCreateFunc(lCreateFunc),
+        m_lEvalFunc(lEvalFunc),
+        m_lPackedEvalFunc(lPackedEvalFunc),
+        m_bOrderedMerge(bOrderedMerge),
+        m_nWorkers(nWorkers),
+        m_vpWorkerMetrics(nWorkers),
+        m_pMetricsBase(lCreateFunc?lCreateFunc():nullptr),
+        m_nNextPushSeqIdx(0),
+        m_nNextMergeSeqIdx(0),
+        m_bIsActive(false) {
+    lvAssert_(m_lCreateFunc && m_lEvalFunc && m_pMetricsBase,"invalid evaluation queue functions");
+    for(size_t nTaskIdx=0; nTaskIdx<m_aTasks.size(); ++nTaskIdx)
+        m_vnFreeTaskIdxs.push_back(m_aTasks.size()-nTaskIdx-1);
+    m_anDoneTaskIdxs.fill(SIZE_MAX);
+}
+
+lv::EvaluationQueue::~EvaluationQueue() {
+    stop();
+}
+
+void lv::EvaluationQueue::push(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI, size_t nIdx) {
+    push(oClassif,&oGT,nullptr,oROI,nIdx);
+}
+
+void lv::EvaluationQueue::push(const cv::Mat& oClassif, const PackedLabels& oGT, const cv::Mat& oROI, size_t nIdx) {
+    lvAssert_(m_lPackedEvalFunc,"evaluation queue was not created with a packed gt evaluation function");
+    push(oClassif,nullptr,&oGT,oROI,nIdx);
+}
+
+void lv::EvaluationQueue::push(const cv::Mat& oClassif, const cv::Mat* pGT, const PackedLabels* pPackedGT, const cv::Mat& oROI, size_t nIdx) {
+    lvDbgAssert((pGT!=nullptr)!=(pPackedGT!=nullptr));
+    if(m_nWorkers==0) {
+        std::mutex_lock_guard sync_lock(m_oSyncMutex);
+        if(!m_lPacketFunc) {
+            evaluate(m_pMetricsBase,oClassif,pGT,pPackedGT,oROI);
+            return;
+        }
+        const double dPushTime_sec = m_oStopWatch.tock(false);
+        IIMetricsAccumulatorPtr pPacketMetrics = m_lCreateFunc();
+        evaluate(pPacketMetrics,oClassif,pGT,pPackedGT,oROI);
+        m_pMetricsBase->accumulate(pPacketMetrics);
+        m_lPacketFunc(nIdx,dPushTime_sec,pPacketMetrics);
+        return;
+    }
+    size_t nTaskIdx;
+    {
+        std::mutex_unique_lock sync_lock(m_oSyncMutex);
+        if(!m_bIsActive) {
+            // workers only live while packets are being pushed, so idle evaluators (e.g. unprocessed batches) hold no threads
+            m_bIsActive = true;
+            for(size_t nWorkerIdx=0; nWorkerIdx<m_nWorkers; ++nWorkerIdx)
+                m_vhWorkers.emplace_back(&EvaluationQueue::entry,this,nWorkerIdx);
+        }
+        m_oDoneCondVar.wait(sync_lock,[&]{return !m_vnFreeTaskIdxs.empty();});
+        nTaskIdx = m_vnFreeTaskIdxs.back();
+        m_vnFreeTaskIdxs.pop_back();
+    }
+    // packets are copied since output/gt mats are typically reused by their producers once this call returns; slot buffers are only
+    // reallocated if the packet size or type changes, and the slot is owned by this thread until it is queued below
+    Task& oTask = m_aTasks[nTaskIdx];
+    oClassif.copyTo(oTask.oClassif);
+    oTask.bPackedGT = (pPackedGT!=nullptr);
+    if(oTask.bPackedGT) {
+        oTask.oPackedGT.oSize = pPackedGT->oSize;
+        oTask.oPackedGT.nBitsPerLabel = pPackedGT->nBitsPerLabel;
+        oTask.oPackedGT.nPaletteSize = pPackedGT->nPaletteSize;
+        oTask.oPackedGT.anPalette = pPackedGT->anPalette;
+        oTask.oPackedGT.vcPayload.assign(pPackedGT->vcPayload.begin(),pPackedGT->vcPayload.end()); // reuses the slot's capacity
+    }
+    else
+        pGT->copyTo(oTask.oGT);
+    oROI.copyTo(oTask.oROI);
+    oTask.nIdx = nIdx;
+    std::mutex_lock_guard sync_lock(m_oSyncMutex);
+    oTask.dPushTime_sec = m_oStopWatch.tock(false);
+    oTask.nSeqIdx = m_nNextPushSeqIdx++;
+    m_qnPendingTaskIdxs.push(nTaskIdx);
+    m_oTaskCondVar.notify_one();
+}
+
+void lv::EvaluationQueue::evaluate(const IIMetricsAccumulatorPtr& pMetrics, const cv::Mat& oClassif, const cv::Mat* pGT, const PackedLabels* pPackedGT, const cv::Mat& oROI) {
+    if(pPackedGT)
+        m_lPackedEvalFunc(pMetrics,oClassif,*pPackedGT,oROI);
+    else
+        m_lEvalFunc(pMetrics,oClassif,*pGT,oROI);
+}
+
+lv::IIMetricsAccumulatorPtr lv::EvaluationQueue::getMetricsBase() {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    wait(sync_lock);
+    mergeWorkerMetrics();
+    if(m_pException)
+        std::rethrow_exception(m_pException);
+    return m_pMetricsBase;
+}
+
+void lv::EvaluationQueue::setPacketCallback(PacketFunc lPacketFunc) {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    wait(sync_lock);
+    m_lPacketFunc = lPacketFunc;
+}
+
+void lv::EvaluationQueue::reset() {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    wait(sync_lock);
+    for(IIMetricsAccumulatorPtr& pWorkerMetrics : m_vpWorkerMetrics)
+        pWorkerMetrics = nullptr;
+    m_pMetricsBase = m_lCreateFunc();
+    m_pException = nullptr;
+    m_oStopWatch.tick();
+}
+
+void lv::EvaluationQueue::stop() {
+    {
+        std::mutex_unique_lock sync_lock(m_oSyncMutex);
+        wait(sync_lock);
+        m_bIsActive = false;
+        m_oTaskCondVar.notify_all();
+    }
+    for(std::thread& hWorker : m_vhWorkers)
+        hWorker.join();
+    m_vhWorkers.clear();
+}
+
+void lv::EvaluationQueue::wait(std::mutex_unique_lock& oLock) {
+    m_oDoneCondVar.wait(oLock,[&]{return m_nNextMergeSeqIdx==m_nNextPushSeqIdx;});
+}
+
+void lv::EvaluationQueue::mergeWorkerMetrics() {
+    for(IIMetricsAccumulatorPtr& pWorkerMetrics : m_vpWorkerMetrics) {
+        if(pWorkerMetrics) {
+            m_pMetricsBase->accumulate(pWorkerMetrics);
+            pWorkerMetrics = nullptr;
+        }
+    }
+}
+
+void lv::EvaluationQueue::entry(size_t nWorkerIdx) {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    while(true) {
+        m_oTaskCondVar.wait(sync_lock,[&]{return !m_bIsActive || !m_qnPendingTaskIdxs.empty();});
+        if(m_qnPendingTaskIdxs.empty())
+            break;
+        const size_t nTaskIdx = m_qnPendingTaskIdxs.front();
+        m_qnPendingTaskIdxs.pop();
+        Task& oTask = m_aTasks[nTaskIdx];
+        // packets only need their own accumulator if they must be merged in push order (order-dependent accumulators, or per-packet callbacks)
+        const bool bPerPacketMetrics = m_bOrderedMerge || m_lPacketFunc;
+        if(!bPerPacketMetrics && !m_vpWorkerMetrics[nWorkerIdx])
+            m_vpWorkerMetrics[nWorkerIdx] = m_lCreateFunc();
+        const IIMetricsAccumulatorPtr pMetrics = bPerPacketMetrics?m_lCreateFunc():m_vpWorkerMetrics[nWorkerIdx];
+        bool bSuccess = true;
+        {
+            std::unlock_guard<std::mutex_unique_lock> oUnlock(sync_lock);
+            try {
+                evaluate(pMetrics,oTask.oClassif,oTask.bPackedGT?nullptr:&oTask.oGT,oTask.bPackedGT?&oTask.oPackedGT:nullptr,oTask.oROI);
+            }
+            catch(...) {
+                std::mutex_lock_guard oExceptionLock(m_oSyncMutex);
+                if(!m_pException)
+                    m_pException = std::current_exception();
+                bSuccess = false;
+            }
+        }
+        if(!bPerPacketMetrics) {
+            m_vnFreeTaskIdxs.push_back(nTaskIdx);
+            ++m_nNextMergeSeqIdx;
+        }
+        else {
+            // partial results are merged in push order, so order-dependent accumulators (e.g. per-image lists) stay consistent
+            oTask.pPacketMetrics = bSuccess?pMetrics:nullptr;
+            m_anDoneTaskIdxs[oTask.nSeqIdx%m_anDoneTaskIdxs.size()] = nTaskIdx;
+            while(true) {
+                size_t& nNextTaskIdx = m_anDoneTaskIdxs[m_nNextMergeSeqIdx%m_anDoneTaskIdxs.size()];
+                if(nNextTaskIdx==SIZE_MAX)
+                    break;
+                Task& oNextTask = m_aTasks[nNextTaskIdx];
+                if(oNextTask.pPacketMetrics) {
+                    m_pMetricsBase->accumulate(oNextTask.pPacketMetrics);
+                    if(m_lPacketFunc)
+                        m_lPacketFunc(oNextTask.nIdx,oNextTask.dPushTime_sec,oNextTask.pPacketMetrics);
+                    oNextTask.pPacketMetrics = nullptr;
+                }
+                m_vnFreeTaskIdxs.push_back(nNextTaskIdx);
+                nNextTaskIdx = SIZE_MAX;
+                ++m_nNextMergeSeqIdx;
+            }
+        }
+        m_oDoneCondVar.notify_all();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::BinClassifParamSweep::ConfigState::ConfigState(const std::string& sName_) :
+        sName(sName_),
+        // configurations already run on their own threads, so a single evaluation worker each is enough to keep up
+        oEvalQueue([](){return IIMetricsAccumulator::create<BinClassifMetricsAccumulator>();},
+                   [](const IIMetricsAccumulatorPtr& pMetrics, const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI) {
+                       std::static_pointer_cast<BinClassifMetricsAccumulator>(pMetrics)->m_oCounters.accumulate(oClassif,oGT,oROI);
+                   },false,1),
+        dBatchFMeasureSum(0.0),nBatchCount(0),nPacketCount(0),dProcessTime_sec(0.0) {}
+
+lv::BinClassifParamSweep::BinClassifParamSweep(const std::vector<std::string>& vsConfigNames, size_t nWindowSize) :
+        m_nWindowSize(nWindowSize) {
+    lvAssert_(!vsConfigNames.empty(),"parameter sweep requires at least one configuration");
+    lvAssert_(nWindowSize>0,"parameter sweep window size must be positive");
+    for(const std::string& sConfigName : vsConfigNames)
+        m_vpConfigs.push_back(std::make_unique<ConfigState>(sConfigName));
+}
+
+void lv::BinClassifParamSweep::processBatch(const IDataHandlerPtr& pBatch, InitFunc lInitFunc, ProcessFunc lProcessFunc) {
+    lvAssert_(pBatch && !pBatch->isGroup(),"parameter sweep must be given a valid work batch");
+    lvAssert_(lInitFunc && lProcessFunc,"invalid parameter sweep callbacks");
+    auto pLoader = pBatch->shared_from_this_cast<IIDataLoader>(true);
+    lvAssert_(pLoader->getInputPacketType()==ImagePacket && pLoader->getGTPacketType()==ImagePacket && pLoader->getGTMappingType()==PixelMapping,"parameter sweep cannot evaluate without 1:1 image pixel mapping");
+    const size_t nPacketCount = pBatch->getInputCount();
+    if(nPacketCount==0)
+        return;
+    const size_t nConfigCount = m_vpConfigs.size();
+    for(const auto& pConfig : m_vpConfigs)
+        pConfig->oEvalQueue.reset();
+    // packets are decoded once on this thread, and kept in a shared window until every configuration is done with them
+    std::mutex oSyncMutex;
+    std::condition_variable oPacketCondVar,oDoneCondVar;
+    std::deque<Packet> qWindow;
+    size_t nWindowFirstIdx = 0;
+    std::vector<size_t> vnNextIdxs(nConfigCount,0);
+    std::exception_ptr pException;
+    std::vector<std::thread> vhWorkers;
+    for(size_t nConfigIdx=0; nConfigIdx<nConfigCount; ++nConfigIdx) {
+        vhWorkers.emplace_back([&,nConfigIdx]() {
+            ConfigState& oConfig = *m_vpConfigs[nConfigIdx];
+            try {
+                cv::Mat oClassif;
+                lv::StopWatch oStopWatch;
+                for(size_t nIdx=0; nIdx<nPacketCount; ++nIdx) {
+                    const Packet* pPacket;
+                    {
+                        std::mutex_unique_lock sync_lock(oSyncMutex);
+                        oPacketCondVar.wait(sync_lock,[&]{return pException || nIdx<nWindowFirstIdx+qWindow.size();});
+                        if(pException)
+                            return;
+                        pPacket = &qWindow[nIdx-nWindowFirstIdx]; // deque references stay valid while other packets are pushed/popped
+                    }
+                    if(nIdx==0) {
+                        lInitFunc(nConfigIdx,pPacket->oInput,pPacket->oROI);
+                        oStopWatch.tick();
+                    }
+                    lProcessFunc(nConfigIdx,pPacket->oInput,nIdx,oClassif);
+                    if(!pPacket->oGT.empty()) {
+                        lvAssert_(!oClassif.empty(),"output must be non-empty for evaluation");
+                        oConfig.oEvalQueue.push(oClassif,pPacket->oGT,pPacket->oROI,nIdx);
+                    }
+                    std::mutex_lock_guard sync_lock(oSyncMutex);
+                    vnNextIdxs[nConfigIdx] = nIdx+1;
+                    oDoneCondVar.notify_one();
+                }
+                oConfig.dProcessTime_sec += oStopWatch.tock();
+            }
+            catch(...) {
+                std::mutex_lock_guard sync_lock(oSyncMutex);
+                if(!pException)
+                    pException = std::current_exception();
+                oPacketCondVar.notify_all();
+                oDoneCondVar.notify_one();
+            }
+        });
+    }
+    try {
+        pBatch->startPrecaching(true);
+        for(size_t nIdx=0; nIdx<nPacketCount; ++nIdx) {
+            Packet oPacket{pLoader->getInput(nIdx).clone(),pLoader->getGT(nIdx).clone(),pLoader->getGTROI(nIdx)};
+            std::mutex_unique_lock sync_lock(oSyncMutex);
+            oDoneCondVar.wait(sync_lock,[&]{return pException || nIdx-*std::min_element(vnNextIdxs.begin(),vnNextIdxs.end())<m_nWindowSize;});
+            if(pException)
+                break;
+            const size_t nMinNextIdx = *std::min_element(vnNextIdxs.begin(),vnNextIdxs.end());
+            while(nWindowFirstIdx<nMinNextIdx) {
+                qWindow.pop_front();
+                ++nWindowFirstIdx;
+            }
+            qWindow.push_back(std::move(oPacket));
+            oPacketCondVar.notify_all();
+        }
+    }
+    catch(...) {
+        std::mutex_lock_guard sync_lock(oSyncMutex);
+        if(!pException)
+            pException = std::current_exception();
+        oPacketCondVar.notify_all();
+    }
+    for(std::thread& hWorker : vhWorkers)
+        hWorker.join();
+    pBatch->stopPrecaching();
+    for(const auto& pConfig : m_vpConfigs)
+        pConfig->oEvalQueue.stop();
+    if(pException)
+        std::rethrow_exception(pException);
+    for(const auto& pConfig : m_vpConfigs) {
+        const BinClassif& oBatchCounters = std::static_pointer_cast<BinClassifMetricsAccumulator>(pConfig->oEvalQueue.getMetricsBase())->m_oCounters;
+        pConfig->oCounters.accumulate(oBatchCounters);
+        pConfig->dBatchFMeasureSum += BinClassifMetrics::CalcFMeasure(oBatchCounters);
+        ++pConfig->nBatchCount;
+        pConfig->nPacketCount += nPacketCount;
+    }
+}
+
+const lv::BinClassif& lv::BinClassifParamSweep::getCounters(size_t nConfigIdx) const {
+    lvAssert_(nConfigIdx<m_vpConfigs.size(),"configuration index out of range");
+    return m_vpConfigs[nConfigIdx]->oCounters;
+}
+
+size_t lv::BinClassifParamSweep::writeReport(const std::string& sFilePath) const {
+    std::vector<size_t> vnConfigIdxs(m_vpConfigs.size());
+    std::iota(vnConfigIdxs.begin(),vnConfigIdxs.end(),size_t(0));
+    std::stable_sort(vnConfigIdxs.begin(),vnConfigIdxs.end(),[&](size_t a, size_t b) {
+        return BinClassifMetrics::CalcFMeasure(m_vpConfigs[a]->oCounters)>BinClassifMetrics::CalcFMeasure(m_vpConfigs[b]->oCounters);
+    });
+    const ConfigState& oBestConfig = *m_vpConfigs[vnConfigIdxs[0]];
+    std::cout << "\tBest sweep config: " << oBestConfig.sName << " => FM=" << std::fixed << std::setprecision(4) << BinClassifMetrics::CalcFMeasure(oBestConfig.oCounters) << std::endl;
+    std::ofstream oMetricsOutput(sFilePath);
+    if(oMetricsOutput.is_open()) {
+        const size_t nCellSize = 12;
+        oMetricsOutput << std::fixed;
+        oMetricsOutput << "Parameter sweep evaluation report for " << m_vpConfigs.size() << " configuration(s) :\n\n";
+        oMetricsOutput << "            |     Rcl    |     Spc    |     Prc    |     FM     |     MCC    |   Avg FM   |     Hz     \n";
+        oMetricsOutput << "------------|------------|------------|------------|------------|------------|------------|------------\n";
+        for(size_t nConfigIdx : vnConfigIdxs) {
+            const ConfigState& oConfig = *m_vpConfigs[nConfigIdx];
+            const BinClassifMetrics oMetrics(oConfig.oCounters);
+            oMetricsOutput << lv::clampString(oConfig.sName,nCellSize) << "|" <<
+                              std::setw(nCellSize) << oMetrics.dRecall << "|" <<
+                              std::setw(nCellSize) << oMetrics.dSpecificity << "|" <<
+                              std::setw(nCellSize) << oMetrics.dPrecision << "|" <<
+                              std::setw(nCellSize) << oMetrics.dFMeasure << "|" <<
+                              std::setw(nCellSize) << oMetrics.dMCC << "|" <<
+                              std::setw(nCellSize) << (oConfig.nBatchCount?oConfig.dBatchFMeasureSum/oConfig.nBatchCount:0.0) << "|" <<
+                              std::setw(nCellSize) << (oConfig.dProcessTime_sec>0?oConfig.nPacketCount/oConfig.dProcessTime_sec:0.0) << "\n";
+        }
+        oMetricsOutput << lv::getLogStamp();
+    }
+    return vnConfigIdxs[0];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 #if HAVE_GLSL
 
 lv::GLBinaryClassifierEvaluator::GLBinaryClassifierEvaluator(const std::shared_ptr<GLImageProcAlgo>& pParent,size_t nTotFrameCount) :
@@ -181,8 +570,17 @@ std::string lv::GLBinaryClassifierEvaluator::getComputeShaderSource(size_t nStag
             "#define VAL_OUTOFSCOPE   " << (uint)DATASETUTILS_OUTOFSCOPE_VAL << "\n"
             "#define VAL_UNKNOWN      " << (uint)DATASETUTILS_UNKNOWN_VAL << "\n"
             "#define VAL_SHADOW       " << (uint)DATASETUTILS_SHADOW_VAL << "\n";
+    if(DATASETUTILS_GLSL_EVAL_GROUP_REDUCTION) { ssSrc <<
+            "#extension GL_ARB_shader_atomic_counter_ops : enable\n"
+            "#extension GL_KHR_shader_subgroup_basic : enable\n"
+            "#extension GL_KHR_shader_subgroup_arithmetic : enable\n"
+            "#ifdef GL_ARB_shader_atomic_counter_ops\n"
+            "#define USE_GROUP_REDUCTION\n"
+            "#define atomicCounterAdd atomicCounterAddARB\n"
+            "#endif //def(GL_ARB_shader_atomic_counter_ops)\n";
+    }
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ssSrc <<"layout(local_size_x=" << m_vDefaultWorkGroupSize.x << ",local_size_y=" << m_vDefaultWorkGroupSize.y << ") in;\n"
+    ssSrc <<"layout(local_size_x=" << m_vWorkGroupSize.x << ",local_size_y=" << m_vWorkGroupSize.y << ") in;\n"
             "layout(binding=" << GLImageProcAlgo::Image_ROIBinding << ", r8ui) readonly uniform uimage2D imgROI;\n"
             "layout(binding=" << GLImageProcAlgo::Image_OutputBinding << ", r8ui) readonly uniform uimage2D imgInput;\n"
             "layout(binding=" << GLImageProcAlgo::Image_GTBinding << ", r8ui) readonly uniform uimage2D imgGT;\n";
@@ -193,39 +591,70 @@ std::string lv::GLBinaryClassifierEvaluator::getComputeShaderSource(size_t nStag
             "layout(binding=" << GLImageProcAlgo::AtomicCounterBuffer_EvalBinding << ", offset=" << BinClassif::Counter_FP*4 << ") uniform atomic_uint nFP;\n"
             "layout(binding=" << GLImageProcAlgo::AtomicCounterBuffer_EvalBinding << ", offset=" << BinClassif::Counter_FN*4 << ") uniform atomic_uint nFN;\n"
             "layout(binding=" << GLImageProcAlgo::AtomicCounterBuffer_EvalBinding << ", offset=" << BinClassif::Counter_SE*4 << ") uniform atomic_uint nSE;\n"
-            "layout(binding=" << GLImageProcAlgo::AtomicCounterBuffer_EvalBinding << ", offset=" << BinClassif::Counter_DC*4 << ") uniform atomic_uint nDC;\n";
+            "layout(binding=" << GLImageProcAlgo::AtomicCounterBuffer_EvalBinding << ", offset=" << BinClassif::Counter_DC*4 << ") uniform atomic_uint nDC;\n"
+            "#define COUNTER_TP " << (int)BinClassif::Counter_TP << "\n"
+            "#define COUNTER_TN " << (int)BinClassif::Counter_TN << "\n"
+            "#define COUNTER_FP " << (int)BinClassif::Counter_FP << "\n"
+            "#define COUNTER_FN " << (int)BinClassif::Counter_FN << "\n"
+            "#define COUNTER_SE " << (int)BinClassif::Counter_SE << "\n"
+            "#define COUNTER_DC " << (int)BinClassif::Counter_DC << "\n"
+            "#define COUNTERS_COUNT " << (int)BinClassif::nCountersCount << "\n"
+            "#ifdef USE_GROUP_REDUCTION\n"
+            "shared uint anGroupCounters[COUNTERS_COUNT];\n"
+            "#endif //def(USE_GROUP_REDUCTION)\n";
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ssSrc <<"void main() {\n"
             "    ivec2 imgCoord = ivec2(gl_GlobalInvocationID.xy);\n"
             "    uint nInputSegmVal = imageLoad(imgInput,imgCoord).r;\n"
             "    uint nGTSegmVal = imageLoad(imgGT,imgCoord).r;\n"
             "    uint nROIVal = imageLoad(imgROI,imgCoord).r;\n"
-            "    if(nROIVal!=VAL_NEGATIVE && nGTSegmVal!=VAL_OUTOFSCOPE && nGTSegmVal!=VAL_UNKNOWN) {\n"
-            "        if(nInputSegmVal==VAL_POSITIVE) {\n"
-            "            if(nGTSegmVal==VAL_POSITIVE) {\n"
-            "                atomicCounterIncrement(nTP);\n"
-            "            }\n"
-            "            else { // nGTSegmVal==VAL_NEGATIVE\n"
-            "                atomicCounterIncrement(nFP);\n"
-            "            }\n"
-            "        }\n"
-            "        else { // nInputSegmVal==VAL_NEGATIVE\n"
-            "            if(nGTSegmVal==VAL_POSITIVE) {\n"
-            "                atomicCounterIncrement(nFN);\n"
-            "            }\n"
-            "            else { // nGTSegmVal==VAL_NEGATIVE\n"
-            "                atomicCounterIncrement(nTN);\n"
-            "            }\n"
-            "        }\n"
-            "        if(nGTSegmVal==VAL_SHADOW) {\n"
-            "            if(nInputSegmVal==VAL_POSITIVE) {\n"
-            "               atomicCounterIncrement(nSE);\n"
-            "            }\n"
-            "        }\n"
+            "    // invocations outside the frame (in partial work groups) must not be counted, not even as 'dont care'\n"
+            "    uint nInside = uint(all(lessThan(imgCoord,imageSize(imgGT))));\n"
+            "    uint nValid = nInside&uint(nROIVal!=VAL_NEGATIVE && nGTSegmVal!=VAL_OUTOFSCOPE && nGTSegmVal!=VAL_UNKNOWN);\n"
+            "    uint nPos = uint(nInputSegmVal==VAL_POSITIVE);\n"
+            "    uint nGTPos = uint(nGTSegmVal==VAL_POSITIVE);\n"
+            "    uint anLocalCounters[COUNTERS_COUNT];\n"
+            "    anLocalCounters[COUNTER_TP] = nValid&nPos&nGTPos;\n"
+            "    anLocalCounters[COUNTER_TN] = nValid&(nPos^1u)&(nGTPos^1u);\n"
+            "    anLocalCounters[COUNTER_FP] = nValid&nPos&(nGTPos^1u);\n"
+            "    anLocalCounters[COUNTER_FN] = nValid&(nPos^1u)&nGTPos;\n"
+            "    anLocalCounters[COUNTER_SE] = nValid&nPos&uint(nGTSegmVal==VAL_SHADOW);\n"
+            "    anLocalCounters[COUNTER_DC] = nInside&(nValid^1u);\n"
+            "#ifdef USE_GROUP_REDUCTION\n"
+            "    // counts are first reduced per subgroup (if supported) and per work group, so that each group only hits the global counters once\n"
+            "    for(uint nCounterIdx=gl_LocalInvocationIndex; nCounterIdx<COUNTERS_COUNT; nCounterIdx+=gl_WorkGroupSize.x*gl_WorkGroupSize.y)\n"
+            "        anGroupCounters[nCounterIdx] = 0u;\n"
+            "    memoryBarrierShared();\n"
+            "    barrier();\n"
+            "#ifdef GL_KHR_shader_subgroup_arithmetic\n"
+            "    for(int nCounterIdx=0; nCounterIdx<COUNTERS_COUNT; ++nCounterIdx)\n"
+            "        anLocalCounters[nCounterIdx] = subgroupAdd(anLocalCounters[nCounterIdx]);\n"
+            "    if(subgroupElect()) {\n"
+            "#endif //def(GL_KHR_shader_subgroup_arithmetic)\n"
+            "        for(int nCounterIdx=0; nCounterIdx<COUNTERS_COUNT; ++nCounterIdx)\n"
+            "            if(anLocalCounters[nCounterIdx]!=0u)\n"
+            "                atomicAdd(anGroupCounters[nCounterIdx],anLocalCounters[nCounterIdx]);\n"
+            "#ifdef GL_KHR_shader_subgroup_arithmetic\n"
+            "    }\n"
+            "#endif //def(GL_KHR_shader_subgroup_arithmetic)\n"
+            "    memoryBarrierShared();\n"
+            "    barrier();\n"
+            "    if(gl_LocalInvocationIndex==0u) {\n"
+            "        if(anGroupCounters[COUNTER_TP]!=0u) atomicCounterAdd(nTP,anGroupCounters[COUNTER_TP]);\n"
+            "        if(anGroupCounters[COUNTER_TN]!=0u) atomicCounterAdd(nTN,anGroupCounters[COUNTER_TN]);\n"
+            "        if(anGroupCounters[COUNTER_FP]!=0u) atomicCounterAdd(nFP,anGroupCounters[COUNTER_FP]);\n"
+            "        if(anGroupCounters[COUNTER_FN]!=0u) atomicCounterAdd(nFN,anGroupCounters[COUNTER_FN]);\n"
+            "        if(anGroupCounters[COUNTER_SE]!=0u) atomicCounterAdd(nSE,anGroupCounters[COUNTER_SE]);\n"
+            "        if(anGroupCounters[COUNTER_DC]!=0u) atomicCounterAdd(nDC,anGroupCounters[COUNTER_DC]);\n"
             "    }\n"
-            "    else {\n"
-            "        atomicCounterIncrement(nDC);\n"
-            "    }\n";
+            "#else //ndef(USE_GROUP_REDUCTION)\n"
+            "    if(anLocalCounters[COUNTER_TP]!=0u) atomicCounterIncrement(nTP);\n"
+            "    if(anLocalCounters[COUNTER_TN]!=0u) atomicCounterIncrement(nTN);\n"
+            "    if(anLocalCounters[COUNTER_FP]!=0u) atomicCounterIncrement(nFP);\n"
+            "    if(anLocalCounters[COUNTER_FN]!=0u) atomicCounterIncrement(nFN);\n"
+            "    if(anLocalCounters[COUNTER_SE]!=0u) atomicCounterIncrement(nSE);\n"
+            "    if(anLocalCounters[COUNTER_DC]!=0u) atomicCounterIncrement(nDC);\n"
+            "#endif //ndef(USE_GROUP_REDUCTION)\n";
     if(m_bUsingDebug) { ssSrc <<
             "    uvec4 out_color = uvec4(0,0,0,255);\n"
             "    if(nGTSegmVal!=VAL_OUTOFSCOPE && nGTSegmVal!=VAL_UNKNOWN && nROIVal!=VAL_NEGATIVE) {\n"
@@ -300,16 +729,20 @@ void lv::IDatasetReporter_<lv::DatasetEval_None>::writeEvalReport() const {
         oMetricsOutput << "------------|------------|------------|------------\n";
         size_t nOverallPacketCount = 0;
         double dOverallTimeElapsed = 0.0;
+        lv::LatencyHistogram oLatencies;
+        double dIOWaitTime_sec = 0.0;
         for(const auto& pGroupIter : getBatches(true)) {
             oMetricsOutput << pGroupIter->shared_from_this_cast<const IDataReporter_<DatasetEval_None>>(true)->IDataReporter_<DatasetEval_None>::writeInlineEvalReport(0);
             nOverallPacketCount += pGroupIter->getProcessedOutputCount();
             dOverallTimeElapsed += pGroupIter->getProcessTime();
+            accumulateTimingStats(*pGroupIter,oLatencies,dIOWaitTime_sec);
         }
         oMetricsOutput << "------------|------------|------------|------------\n";
         oMetricsOutput << "     overall|" <<
                        std::setw(12) << nOverallPacketCount << "|" <<
                        std::setw(12) << dOverallTimeElapsed << "|" <<
                        std::setw(12) << nOverallPacketCount/dOverallTimeElapsed << "\n";
+        oMetricsOutput << writeTimingReport(nOverallPacketCount,dOverallTimeElapsed,oLatencies,dIOWaitTime_sec);
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -335,10 +768,13 @@ void lv::IDatasetReporter_<lv::DatasetEval_BinaryClassifier>::writeEvalReport()
         oMetricsOutput << "------------|------------|------------|------------|------------|------------|------------|------------|------------\n";
         size_t nOverallPacketCount = 0;
         double dOverallTimeElapsed = 0.0;
+        lv::LatencyHistogram oLatencies;
+        double dIOWaitTime_sec = 0.0;
         for(const auto& pGroupIter : getBatches(true)) {
             oMetricsOutput << pGroupIter->shared_from_this_cast<const IDataReporter_<DatasetEval_BinaryClassifier>>(true)->IDataReporter_<DatasetEval_BinaryClassifier>::writeInlineEvalReport(0);
             nOverallPacketCount += pGroupIter->getProcessedOutputCount();
             dOverallTimeElapsed += pGroupIter->getProcessTime();
+            accumulateTimingStats(*pGroupIter,oLatencies,dIOWaitTime_sec);
         }
         oMetricsOutput << "------------|------------|------------|------------|------------|------------|------------|------------|------------\n";
         oMetricsOutput << "     overall|" <<
@@ -350,7 +786,7 @@ void lv::IDatasetReporter_<lv::DatasetEval_BinaryClassifier>::writeEvalReport()
                        std::setw(12) << oMetrics.dPrecision << "|" <<
                        std::setw(12) << oMetrics.dFMeasure << "|" <<
                        std::setw(12) << oMetrics.dMCC << "\n";
-        oMetricsOutput << "\nHz: " << nOverallPacketCount/dOverallTimeElapsed << "\n";
+        oMetricsOutput << writeTimingReport(nOverallPacketCount,dOverallTimeElapsed,oLatencies,dIOWaitTime_sec);
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -380,6 +816,8 @@ void lv::IDatasetReporter_<lv::DatasetEval_BinaryClassifierArray>::writeEvalRepo
         std::vector<std::string> vsStreamNames;
         size_t nOverallPacketCount = 0;
         double dOverallTimeElapsed = 0.0;
+        lv::LatencyHistogram oLatencies;
+        double dIOWaitTime_sec = 0.0;
         for(const auto& pGroupIter : getBatches(true)) {
             const auto pReporter = pGroupIter->shared_from_this_cast<const IDataReporter_<DatasetEval_BinaryClassifierArray>>(true);
             oMetricsOutput << pReporter->IDataReporter_<DatasetEval_BinaryClassifierArray>::writeInlineEvalReport(0);
@@ -396,6 +834,7 @@ void lv::IDatasetReporter_<lv::DatasetEval_BinaryClassifierArray>::writeEvalRepo
             }
             nOverallPacketCount += pGroupIter->getProcessedOutputCount();
             dOverallTimeElapsed += pGroupIter->getProcessTime();
+            accumulateTimingStats(*pGroupIter,oLatencies,dIOWaitTime_sec);
         }
         oMetricsOutput << "------------|------------||------------|------------|------------|------------|------------|------------|------------|------------\n";
         lvAssert_(oMetrics.m_vMetrics.size()==vsStreamNames.size(),"output stream count mismatch");
@@ -420,7 +859,7 @@ void lv::IDatasetReporter_<lv::DatasetEval_BinaryClassifierArray>::writeEvalRepo
                        std::setw(12) << oOverallMetrics.dPrecision << "|" <<
                        std::setw(12) << oOverallMetrics.dFMeasure << "|" <<
                        std::setw(12) << oOverallMetrics.dMCC << "\n";
-        oMetricsOutput << "\nHz: " << nOverallPacketCount/dOverallTimeElapsed << "\n";
+        oMetricsOutput << writeTimingReport(nOverallPacketCount,dOverallTimeElapsed,oLatencies,dIOWaitTime_sec);
         oMetricsOutput << lv::getLogStamp();
     }
 }
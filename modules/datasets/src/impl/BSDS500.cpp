@@ -71,366 +71,445 @@ std::shared_ptr<lv::IIMetricsAccumulator> lv::MetricsAccumulator_<lv::DatasetEva
     return shared_from_this();
 }
 
-void lv::MetricsAccumulator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>::accumulate(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& /*oROI*/) {
-    if(oGT.empty())
-        return;
-    lvAssert(oClassif.type()==CV_8UC1 && oGT.type()==CV_8UC1);
-    lvAssert(oClassif.isContinuous() && oGT.isContinuous());
-    lvAssert(oClassif.cols==oGT.cols && (oGT.rows%oClassif.rows)==0 && (oGT.rows/oClassif.rows)>=1);
-    lvAssert(oClassif.step.p[0]==oGT.step.p[0]);
-
-    const double dMaxDist = DATASETS_BSDS500_EVAL_IMAGE_DIAG_RATIO_DIST*sqrt(double(oClassif.cols*oClassif.cols+oClassif.rows*oClassif.rows));
-    const double dMaxDistSqr = dMaxDist*dMaxDist;
-    const int nMaxDist = (int)ceil(dMaxDist);
-    lvAssert(dMaxDist>0 && nMaxDist>0);
+namespace {
+
+    /// assignment results of previously solved match components (key: segm pixel indices of the component, value: matched segm pixel indices)
+    using MatchCache = std::map<std::vector<int>,std::vector<int>>;
+
+    /// returns the (raster-ordered) coordinates of all non-null pixels of 'oMask'
+    std::vector<cv::Point2i> getEdgePixels(const cv::Mat& oMask) {
+        std::vector<cv::Point2i> voPts;
+        for(int i=0; i<oMask.rows; ++i) {
+            const uchar* pMaskRow = oMask.ptr<uchar>(i);
+            for(int j=0; j<oMask.cols; ++j)
+                if(pMaskRow[j])
+                    voPts.emplace_back(j,i);
+        }
+        return voPts;
+    }
 
-    BSDS500Counters oMetricsBase(m_nThresholdBins);
-    const std::vector<uchar> vuEvalUniqueVals = lv::unique<uchar>(oClassif);
-    cv::Mat oCurrSegmMask(oClassif.size(),CV_8UC1), oTmpSegmMask(oClassif.size(),CV_8UC1);
-    cv::Mat oSegmTPAccumulator(oClassif.size(),CV_8UC1);
-    size_t nNextEvalUniqueValIdx = 0;
-    size_t nThresholdBinIdx = 0;
-    while(nThresholdBinIdx<oMetricsBase.vnThresholds.size()) {
-        cv::compare(oClassif,oMetricsBase.vnThresholds[nThresholdBinIdx],oTmpSegmMask,cv::CMP_GE);
-        lv::thinning(oTmpSegmMask,oCurrSegmMask);
+    /// spatial grid of (raster-ordered) edge pixels bucketed in square cells; used to enumerate match candidates without window scans
+    struct EdgePixelGrid {
+        /// builds the grid for all non-null pixels of 'oMask' (cell size should be the max match distance, rounded up)
+        EdgePixelGrid(const cv::Mat& oMask, int nCellSize) :
+                m_nCellSize(nCellSize),
+                m_nGridCols((oMask.cols+nCellSize-1)/nCellSize),
+                m_nGridRows((oMask.rows+nCellSize-1)/nCellSize),
+                m_nImageCols(oMask.cols),
+                m_voPts(getEdgePixels(oMask)) {
+            lvDbgAssert(oMask.type()==CV_8UC1 && nCellSize>0);
+            std::vector<int> vnPtCellIdxs(m_voPts.size());
+            for(size_t nPtIdx=0; nPtIdx<m_voPts.size(); ++nPtIdx)
+                vnPtCellIdxs[nPtIdx] = (m_voPts[nPtIdx].y/m_nCellSize)*m_nGridCols+(m_voPts[nPtIdx].x/m_nCellSize);
+            // stable counting sort of pixel indices by cell (keeps raster order within each cell)
+            m_vnCellOffsets.assign(size_t(m_nGridCols*m_nGridRows+1),0);
+            for(int nCellIdx : vnPtCellIdxs)
+                ++m_vnCellOffsets[nCellIdx+1];
+            for(size_t nCellIdx=1; nCellIdx<m_vnCellOffsets.size(); ++nCellIdx)
+                m_vnCellOffsets[nCellIdx] += m_vnCellOffsets[nCellIdx-1];
+            std::vector<int> vnCellFillCounts(m_vnCellOffsets.begin(),m_vnCellOffsets.end()-1);
+            m_vnCellPtIdxs.resize(m_voPts.size());
+            for(size_t nPtIdx=0; nPtIdx<m_voPts.size(); ++nPtIdx)
+                m_vnCellPtIdxs[vnCellFillCounts[vnPtCellIdxs[nPtIdx]]++] = (int)nPtIdx;
+        }
+        /// calls 'lFunc(nPtIdx,nDistSqr)' for every grid pixel located within sqrt(dMaxDistSqr) of 'oPt'
+        template<typename Tfunc>
+        void forEachNeighbor(const cv::Point2i& oPt, double dMaxDistSqr, Tfunc&& lFunc) const {
+            const int nCellRow = oPt.y/m_nCellSize, nCellCol = oPt.x/m_nCellSize;
+            for(int nRow=std::max(nCellRow-1,0); nRow<=std::min(nCellRow+1,m_nGridRows-1); ++nRow) {
+                for(int nCol=std::max(nCellCol-1,0); nCol<=std::min(nCellCol+1,m_nGridCols-1); ++nCol) {
+                    const int nCellIdx = nRow*m_nGridCols+nCol;
+                    for(int nOffset=m_vnCellOffsets[nCellIdx]; nOffset<m_vnCellOffsets[nCellIdx+1]; ++nOffset) {
+                        const int nPtIdx = m_vnCellPtIdxs[nOffset];
+                        const int u = m_voPts[nPtIdx].y-oPt.y, v = m_voPts[nPtIdx].x-oPt.x;
+                        const int nDistSqr = u*u+v*v;
+                        if(double(nDistSqr)<=dMaxDistSqr)
+                            lFunc(nPtIdx,nDistSqr);
+                    }
+                }
+            }
+        }
+        /// returns the linear image index of the given grid pixel
+        inline int getLinearIdx(int nPtIdx) const {
+            return m_voPts[nPtIdx].y*m_nImageCols+m_voPts[nPtIdx].x;
+        }
+        const int m_nCellSize,m_nGridCols,m_nGridRows,m_nImageCols;
+        const std::vector<cv::Point2i> m_voPts; ///< all edge pixels, in raster order
+        std::vector<int> m_vnCellPtIdxs; ///< edge pixel indices, bucketed by cell
+        std::vector<int> m_vnCellOffsets; ///< bucket offsets in m_vnCellPtIdxs (one per cell, plus end offset)
+    };
 
 #if USE_BSDS500_BENCHMARK
 
-        ///////////////////////////////////////////////////////
-        // code below is adapted from match.cc::matchEdgeMaps()
-        ///////////////////////////////////////////////////////
-
-        const double dOutlierCost = 100*dMaxDist;
-        lvAssert(dOutlierCost>1);
-        oSegmTPAccumulator = cv::Scalar_<uchar>(0);
-        cv::Mat oGTAccumulator(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
-        uint64_t nIndivTP = 0;
-        uint64_t nGTPosCount = 0;
+    /// candidate match between an edge pixel of the segmentation mask and one of the gt mask
+    struct MatchEdge {
+        int nNodeIdx_SEGM;
+        int nNodeIdx_GT;
+        double dEdgeDist;
+    };
 
+    /// min-cost assignment for a single connected match subgraph (adapted from match.cc::matchEdgeMaps()); returns the matched segm node indices
+    std::vector<int> solveMatchAssignment(const std::vector<MatchEdge>& voEdges, const int nNodeCount_SEGM, const int nNodeCount_GT, const double dOutlierCost) {
         static constexpr int multiplier = 100;
         static constexpr int degree = 6;
         static_assert(degree>0,"csa config bad; degree of outlier connections should be > 0");
         static_assert(multiplier>0,"csa config bad; floating-point weights to integers should be > 0");
-
-        for(size_t nGTMaskIdx=0; nGTMaskIdx<size_t(oGT.rows/oCurrSegmMask.rows); ++nGTMaskIdx) {
-            cv::Mat oCurrGTSegmMask = oGT(cv::Rect(0,int(oCurrSegmMask.rows*nGTMaskIdx),oCurrSegmMask.cols,oCurrSegmMask.rows));
-            cv::Mat oMatchable_SEGM(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
-            cv::Mat oMatchable_GT(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
-            // Figure out which nodes are matchable, i.e. within maxDist
-            // of another node.
-            for(int i=0; i<oCurrSegmMask.rows; ++i) {
-                for(int j=0; j<oCurrSegmMask.cols; ++j) {
-                    if(!oCurrGTSegmMask.at<uchar>(i,j)) continue;
-                    for(int u=-nMaxDist; u<=nMaxDist; ++u) {
-                        if(i+u<0) continue;
-                        if(i+u>=oCurrSegmMask.rows) continue;
-                        if(double(u)>dMaxDist) continue;
-                        for(int v=-nMaxDist; v<=nMaxDist; ++v) {
-                            if(j+v<0) continue;
-                            if(j+v>=oCurrSegmMask.cols) continue;
-                            if(double(v)>dMaxDist) continue;
-                            const double dCurrDistSqr = u*u+v*v;
-                            if(dCurrDistSqr>dMaxDistSqr) continue;
-                            if(oCurrSegmMask.at<uchar>(i+u,j+v)) {
-                                oMatchable_SEGM.at<uchar>(i+u,j+v) = UCHAR_MAX;
-                                oMatchable_GT.at<uchar>(i,j) = UCHAR_MAX;
-                            }
-                        }
-                    }
-                }
-            }
-
-            int nNodeCount_SEGM=0, nNodeCount_GT=0;
-            std::vector<cv::Point2i> voNodeToPxLUT_SEGM,voNodeToPxLUT_GT;
-            cv::Mat oPxToNodeLUT_SEGM(oCurrSegmMask.size(),CV_32SC1,cv::Scalar_<int>(-1));
-            cv::Mat oPxToNodeLUT_GT(oCurrSegmMask.size(),CV_32SC1,cv::Scalar_<int>(-1));
-            // Count the number of nodes on each side of the match.
-            // Construct nodeID->pixel and pixel->nodeID maps.
-            // Node IDs range from [0,nNodeCount_SEGM) and [0,nNodeCount_GT).
-            for(int i=0; i<oCurrSegmMask.rows; ++i) {
-                for(int j=0; j<oCurrSegmMask.cols; ++j) {
-                    cv::Point2i px(j,i);
-                    if(oMatchable_SEGM.at<uchar>(px)) {
-                        oPxToNodeLUT_SEGM.at<int>(px) = nNodeCount_SEGM;
-                        voNodeToPxLUT_SEGM.push_back(px);
-                        ++nNodeCount_SEGM;
-                    }
-                    if(oMatchable_GT.at<uchar>(px)) {
-                        oPxToNodeLUT_GT.at<int>(px) = nNodeCount_GT;
-                        voNodeToPxLUT_GT.push_back(px);
-                        ++nNodeCount_GT;
-                    }
-                }
+        std::vector<int> vnMatchedNodes_SEGM;
+
+        // The cardinality of the match is n.
+        const int n = nNodeCount_SEGM+nNodeCount_GT;
+        const int nmin = std::min(nNodeCount_SEGM,nNodeCount_GT);
+        const int nmax = std::max(nNodeCount_SEGM,nNodeCount_GT);
+
+        // Compute the degree of various outlier connections.
+        const int degree_SEGM = std::max(0,std::min(degree,nNodeCount_SEGM-1)); // from map1
+        const int degree_GT = std::max(0,std::min(degree,nNodeCount_GT-1)); // from map2
+        const int degree_mix = std::min(degree,std::min(nNodeCount_SEGM,nNodeCount_GT)); // between outliers
+        const int dmax = std::max(degree_SEGM,std::max(degree_GT,degree_mix));
+
+        lvDbgAssert(nNodeCount_SEGM==0 || (degree_SEGM>=0 && degree_SEGM<nNodeCount_SEGM));
+        lvDbgAssert(nNodeCount_GT==0 || (degree_GT>=0 && degree_GT<nNodeCount_GT));
+        lvDbgAssert(degree_mix>=0 && degree_mix<=nmin);
+
+        // Count the number of edges.
+        int m = 0;
+        m += (int)voEdges.size();         // real connections
+        m += degree_SEGM*nNodeCount_SEGM; // outlier connections
+        m += degree_GT*nNodeCount_GT;     // outlier connections
+        m += degree_mix*nmax;             // outlier-outlier connections
+        m += n;                           // high-cost perfect match overlay
+        // If the graph is empty, then there's nothing to do.
+        if(m==0)
+            return vnMatchedNodes_SEGM;
+        // Weight of outlier connections.
+        const int nOutlierWeight = (int)ceil(dOutlierCost*multiplier);
+        // Scratch array for outlier edges.
+        std::vector<int> vnOutliers(dmax);
+        // Construct the input graph for the assignment problem.
+        cv::Mat oGraph(m,3,CV_32SC1);
+        int nGraphIdx = 0;
+        // real edges
+        for(int a=0; a<(int)voEdges.size(); ++a) {
+            lvDbgAssert(voEdges[a].nNodeIdx_SEGM>=0 && voEdges[a].nNodeIdx_SEGM<nNodeCount_SEGM);
+            lvDbgAssert(voEdges[a].nNodeIdx_GT>=0 && voEdges[a].nNodeIdx_GT<nNodeCount_GT);
+            oGraph.at<int>(nGraphIdx,0) = voEdges[a].nNodeIdx_SEGM;
+            oGraph.at<int>(nGraphIdx,1) = voEdges[a].nNodeIdx_GT;
+            oGraph.at<int>(nGraphIdx,2) = (int)rint(voEdges[a].dEdgeDist*multiplier);
+            nGraphIdx++;
+        }
+        // outliers edges for map1, exclude diagonal
+        for(int nNodeIdx_SEGM=0; nNodeIdx_SEGM<nNodeCount_SEGM; ++nNodeIdx_SEGM) {
+            BSDS500::kOfN(degree_SEGM,nNodeCount_SEGM-1,vnOutliers.data());
+            for(int a=0; a<degree_SEGM; a++) {
+                int j = vnOutliers[a];
+                if(j>=nNodeIdx_SEGM) {j++;}
+                lvDbgAssert(nNodeIdx_SEGM!=j);
+                lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
+                oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
+                oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
+                nGraphIdx++;
             }
-
-            struct Edge {
-                int nNodeIdx_SEGM;
-                int nNodeIdx_GT;
-                double dEdgeDist;
-            };
-            std::vector<Edge> voEdges;
-            // Construct the list of edges between pixels within maxDist.
-            for(int i=0; i<oCurrSegmMask.rows; ++i) {
-                for(int j=0; j<oCurrSegmMask.cols; ++j) {
-                    if(!oMatchable_GT.at<uchar>(i,j)) continue;
-                    for(int u=-nMaxDist; u<=nMaxDist; ++u) {
-                        if(i+u<0) continue;
-                        if(i+u>=oCurrSegmMask.rows) continue;
-                        if(double(u)>dMaxDist) continue;
-                        for(int v=-nMaxDist; v<=nMaxDist; ++v) {
-                            if(j+v<0) continue;
-                            if(j+v>=oCurrSegmMask.cols) continue;
-                            if(double(v)>dMaxDist) continue;
-                            if(!oMatchable_SEGM.at<uchar>(i+u,j+v)) continue;
-                            const double dCurrDistSqr = u*u+v*v;
-                            if(dCurrDistSqr>dMaxDistSqr) continue;
-                            Edge e;
-                            e.nNodeIdx_SEGM = oPxToNodeLUT_SEGM.at<int>(i+u,j+v);
-                            e.nNodeIdx_GT = oPxToNodeLUT_GT.at<int>(i,j);
-                            e.dEdgeDist = sqrt(dCurrDistSqr);
-                            lvDbgAssert(e.nNodeIdx_SEGM>=0 && e.nNodeIdx_SEGM<nNodeCount_SEGM);
-                            lvDbgAssert(e.nNodeIdx_GT>=0 && e.nNodeIdx_GT<nNodeCount_GT);
-                            voEdges.push_back(e);
-                        }
-                    }
-                }
+        }
+        // outliers edges for map2, exclude diagonal
+        for(int nNodeIdx_GT = 0; nNodeIdx_GT<nNodeCount_GT; nNodeIdx_GT++) {
+            BSDS500::kOfN(degree_GT,nNodeCount_GT-1,vnOutliers.data());
+            for(int a = 0; a<degree_GT; a++) {
+                int i = vnOutliers[a];
+                if(i>=nNodeIdx_GT) {i++;}
+                lvDbgAssert(i!=nNodeIdx_GT);
+                lvDbgAssert(i>=0 && i<nNodeCount_GT);
+                oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
+                oGraph.at<int>(nGraphIdx,1) = nNodeIdx_GT;
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
+                nGraphIdx++;
             }
-
-            // The cardinality of the match is n.
-            const int n = nNodeCount_SEGM+nNodeCount_GT;
-            const int nmin = std::min(nNodeCount_SEGM,nNodeCount_GT);
-            const int nmax = std::max(nNodeCount_SEGM,nNodeCount_GT);
-
-            // Compute the degree of various outlier connections.
-            const int degree_SEGM = std::max(0,std::min(degree,nNodeCount_SEGM-1)); // from map1
-            const int degree_GT = std::max(0,std::min(degree,nNodeCount_GT-1)); // from map2
-            const int degree_mix = std::min(degree,std::min(nNodeCount_SEGM,nNodeCount_GT)); // between outliers
-            const int dmax = std::max(degree_SEGM,std::max(degree_GT,degree_mix));
-
-            lvDbgAssert(nNodeCount_SEGM==0 || (degree_SEGM>=0 && degree_SEGM<nNodeCount_SEGM));
-            lvDbgAssert(nNodeCount_GT==0 || (degree_GT>=0 && degree_GT<nNodeCount_GT));
-            lvDbgAssert(degree_mix>=0 && degree_mix<=nmin);
-
-            // Count the number of edges.
-            int m = 0;
-            m += (int)voEdges.size();         // real connections
-            m += degree_SEGM*nNodeCount_SEGM; // outlier connections
-            m += degree_GT*nNodeCount_GT;     // outlier connections
-            m += degree_mix*nmax;             // outlier-outlier connections
-            m += n;                           // high-cost perfect match overlay
-                                              // If the graph is empty, then there's nothing to do.
-            if(m>0) {
-                // Weight of outlier connections.
-                const int nOutlierWeight = (int)ceil(dOutlierCost*multiplier);
-                // Scratch array for outlier edges.
-                std::vector<int> vnOutliers(dmax);
-                // Construct the input graph for the assignment problem.
-                cv::Mat oGraph(m,3,CV_32SC1);
-                int nGraphIdx = 0;
-                // real edges
-                for(int a=0; a<(int)voEdges.size(); ++a) {
-                    int nNodeIdx_SEGM = voEdges[a].nNodeIdx_SEGM;
-                    int nNodeIdx_GT = voEdges[a].nNodeIdx_GT;
-                    lvDbgAssert(nNodeIdx_SEGM>=0 && nNodeIdx_SEGM<nNodeCount_SEGM);
-                    lvDbgAssert(nNodeIdx_GT>=0 && nNodeIdx_GT<nNodeCount_GT);
-                    oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
-                    oGraph.at<int>(nGraphIdx,1) = nNodeIdx_GT;
-                    oGraph.at<int>(nGraphIdx,2) = (int)rint(voEdges[a].dEdgeDist*multiplier);
-                    nGraphIdx++;
-                }
-                // outliers edges for map1, exclude diagonal
-                for(int nNodeIdx_SEGM=0; nNodeIdx_SEGM<nNodeCount_SEGM; ++nNodeIdx_SEGM) {
-                    BSDS500::kOfN(degree_SEGM,nNodeCount_SEGM-1,vnOutliers.data());
-                    for(int a=0; a<degree_SEGM; a++) {
-                        int j = vnOutliers[a];
-                        if(j>=nNodeIdx_SEGM) {j++;}
-                        lvDbgAssert(nNodeIdx_SEGM!=j);
-                        lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
-                        oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
-                        oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
-                        oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
-                        nGraphIdx++;
-                    }
-                }
-                // outliers edges for map2, exclude diagonal
-                for(int nNodeIdx_GT = 0; nNodeIdx_GT<nNodeCount_GT; nNodeIdx_GT++) {
-                    BSDS500::kOfN(degree_GT,nNodeCount_GT-1,vnOutliers.data());
-                    for(int a = 0; a<degree_GT; a++) {
-                        int i = vnOutliers[a];
-                        if(i>=nNodeIdx_GT) {i++;}
-                        lvDbgAssert(i!=nNodeIdx_GT);
-                        lvDbgAssert(i>=0 && i<nNodeCount_GT);
-                        oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
-                        oGraph.at<int>(nGraphIdx,1) = nNodeIdx_GT;
-                        oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
-                        nGraphIdx++;
-                    }
-                }
-                // outlier-to-outlier edges
-                for(int i = 0; i<nmax; i++) {
-                    BSDS500::kOfN(degree_mix,nmin,vnOutliers.data());
-                    for(int a = 0; a<degree_mix; a++) {
-                        const int j = vnOutliers[a];
-                        lvDbgAssert(j>=0 && j<nmin);
-                        if(nNodeCount_SEGM<nNodeCount_GT) {
-                            lvDbgAssert(i>=0 && i<nNodeCount_GT);
-                            lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
-                            oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
-                            oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
-                        }
-                        else {
-                            lvDbgAssert(i>=0 && i<nNodeCount_SEGM);
-                            lvDbgAssert(j>=0 && j<nNodeCount_GT);
-                            oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+j;
-                            oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
-                        }
-                        oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
-                        nGraphIdx++;
-                    }
-                }
-                // perfect match overlay (diagonal)
-                for(int i = 0; i<nNodeCount_SEGM; i++) {
-                    oGraph.at<int>(nGraphIdx,0) = i;
-                    oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
-                    oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
-                    nGraphIdx++;
-                }
-                for(int i = 0; i<nNodeCount_GT; i++) {
+        }
+        // outlier-to-outlier edges
+        for(int i = 0; i<nmax; i++) {
+            BSDS500::kOfN(degree_mix,nmin,vnOutliers.data());
+            for(int a = 0; a<degree_mix; a++) {
+                const int j = vnOutliers[a];
+                lvDbgAssert(j>=0 && j<nmin);
+                if(nNodeCount_SEGM<nNodeCount_GT) {
+                    lvDbgAssert(i>=0 && i<nNodeCount_GT);
+                    lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
                     oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
-                    oGraph.at<int>(nGraphIdx,1) = i;
-                    oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
-                    nGraphIdx++;
+                    oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
                 }
-                lvDbgAssert(nGraphIdx==m);
-
-                // Check all the edges, and set the values up for CSA.
-                for(int i = 0; i<m; i++) {
-                    lvDbgAssert(oGraph.at<int>(i,0)>=0 && oGraph.at<int>(i,0)<n);
-                    lvDbgAssert(oGraph.at<int>(i,1)>=0 && oGraph.at<int>(i,1)<n);
-                    oGraph.at<int>(i,0) += 1;
-                    oGraph.at<int>(i,1) += 1+n;
+                else {
+                    lvDbgAssert(i>=0 && i<nNodeCount_SEGM);
+                    lvDbgAssert(j>=0 && j<nNodeCount_GT);
+                    oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+j;
+                    oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
                 }
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
+                nGraphIdx++;
+            }
+        }
+        // perfect match overlay (diagonal)
+        for(int i = 0; i<nNodeCount_SEGM; i++) {
+            oGraph.at<int>(nGraphIdx,0) = i;
+            oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
+            oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
+            nGraphIdx++;
+        }
+        for(int i = 0; i<nNodeCount_GT; i++) {
+            oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
+            oGraph.at<int>(nGraphIdx,1) = i;
+            oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
+            nGraphIdx++;
+        }
+        lvDbgAssert(nGraphIdx==m);
+
+        // Check all the edges, and set the values up for CSA.
+        for(int i = 0; i<m; i++) {
+            lvDbgAssert(oGraph.at<int>(i,0)>=0 && oGraph.at<int>(i,0)<n);
+            lvDbgAssert(oGraph.at<int>(i,1)>=0 && oGraph.at<int>(i,1)<n);
+            oGraph.at<int>(i,0) += 1;
+            oGraph.at<int>(i,1) += 1+n;
+        }
 
-                // Solve the assignment problem.
-                BSDS500::CSA oCSASolver(2*n,m,(int*)oGraph.data);
-                lvAssert(oCSASolver.edges()==n);
-
-                cv::Mat oOutGraph(n,3,CV_32SC1);
-                for(int i = 0; i<n; i++) {
-                    int a,b,c;
-                    oCSASolver.edge(i,a,b,c);
-                    oOutGraph.at<int>(i,0) = a-1;
-                    oOutGraph.at<int>(i,1) = b-1-n;
-                    oOutGraph.at<int>(i,2) = c;
-                }
+        // Solve the assignment problem.
+        BSDS500::CSA oCSASolver(2*n,m,(int*)oGraph.data);
+        lvAssert(oCSASolver.edges()==n);
+
+        // Count the number of high-cost edges from the perfect match
+        // overlay that were used in the match, and record real matches.
+        int nOverlayCount = 0;
+        for(int a = 0; a<n; a++) {
+            int i,j,c;
+            oCSASolver.edge(a,i,j,c);
+            i -= 1;
+            j -= 1+n;
+            lvDbgAssert(i>=0 && i<n);
+            lvDbgAssert(j>=0 && j<n);
+            lvDbgAssert(c>=0);
+            // edge from high-cost perfect match overlay
+            if(c==nOutlierWeight*multiplier) {nOverlayCount++;}
+            // skip outlier edges
+            if(i>=nNodeCount_SEGM) {continue;}
+            if(j>=nNodeCount_GT) {continue;}
+            vnMatchedNodes_SEGM.push_back(i);
+        }
 
-                // Check the solution.
-                // Count the number of high-cost edges from the perfect match
-                // overlay that were used in the match.
-                int nOverlayCount = 0;
-                for(int a = 0; a<n; a++) {
-                    const int i = oOutGraph.at<int>(a,0);
-                    const int j = oOutGraph.at<int>(a,1);
-                    const int c = oOutGraph.at<int>(a,2);
-                    lvDbgAssert(i>=0 && i<n);
-                    lvDbgAssert(j>=0 && j<n);
-                    lvDbgAssert(c>=0);
-                    // edge from high-cost perfect match overlay
-                    if(c==nOutlierWeight*multiplier) {nOverlayCount++;}
-                    // skip outlier edges
-                    if(i>=nNodeCount_SEGM) {continue;}
-                    if(j>=nNodeCount_GT) {continue;}
-                    // for edges between real nodes, check the edge weight
-                    lvDbgAssert((int)rint(sqrt((voNodeToPxLUT_SEGM[i].x-voNodeToPxLUT_GT[j].x)*(voNodeToPxLUT_SEGM[i].x-voNodeToPxLUT_GT[j].x)+(voNodeToPxLUT_SEGM[i].y-voNodeToPxLUT_GT[j].y)*(voNodeToPxLUT_SEGM[i].y-voNodeToPxLUT_GT[j].y))*multiplier)==c);
-                }
+        // Print a warning if any of the edges from the perfect match overlay
+        // were used.  This should happen rarely.  If it happens frequently,
+        // then the outlier connectivity should be increased.
+        if(nOverlayCount>5) {
+            fprintf(stderr,"%s:%d: WARNING: The match includes %d outlier(s) from the perfect match overlay.\n",__FILE__,__LINE__,nOverlayCount);
+        }
+        return vnMatchedNodes_SEGM;
+    }
 
-                // Print a warning if any of the edges from the perfect match overlay
-                // were used.  This should happen rarely.  If it happens frequently,
-                // then the outlier connectivity should be increased.
-                if(nOverlayCount>5) {
-                    fprintf(stderr,"%s:%d: WARNING: The match includes %d outlier(s) from the perfect match overlay.\n",__FILE__,__LINE__,nOverlayCount);
-                }
+    /// returns the root of the given union-find node, with path halving
+    inline int findRoot(std::vector<int>& vnParents, int nNodeIdx) {
+        while(vnParents[nNodeIdx]!=nNodeIdx)
+            nNodeIdx = vnParents[nNodeIdx] = vnParents[vnParents[nNodeIdx]];
+        return nNodeIdx;
+    }
 
-                // Compute match arrays.
-                for(int a = 0; a<n; a++) {
-                    // node ids
-                    const int i = oOutGraph.at<int>(a,0);
-                    const int j = oOutGraph.at<int>(a,1);
-                    // skip outlier edges
-                    if(i>=nNodeCount_SEGM) {continue;}
-                    if(j>=nNodeCount_GT) {continue;}
-                    // for edges between real nodes, check the edge weight
-                    const cv::Point2i oPx_SEGM = voNodeToPxLUT_SEGM[i];
-                    const cv::Point2i oPx_GT = voNodeToPxLUT_GT[j];
-                    // record edges
-                    lvAssert(oCurrSegmMask.at<uchar>(oPx_SEGM) && oCurrGTSegmMask.at<uchar>(oPx_GT));
-                    oSegmTPAccumulator.at<uchar>(oPx_SEGM) = UCHAR_MAX;
-                    ++nIndivTP;
-                }
+    /// matches segm edge pixels to gt edge pixels via min-cost assignment; marks matched segm pixels in 'oSegmTPAccumulator' and returns their count
+    /// (components found unchanged in 'oPrevCache' are not re-solved; all solved components are stored in 'oCurrCache' for the next threshold)
+    uint64_t matchEdgeMaps(const EdgePixelGrid& oSegmGrid, const std::vector<cv::Point2i>& voPts_GT, const double dMaxDist,
+                           const MatchCache& oPrevCache, MatchCache& oCurrCache, cv::Mat& oSegmTPAccumulator) {
+        const double dMaxDistSqr = dMaxDist*dMaxDist;
+        const double dOutlierCost = 100*dMaxDist;
+        lvAssert(dOutlierCost>1);
+        const int nPtCount_SEGM = (int)oSegmGrid.m_voPts.size();
+        // Construct the list of edges between pixels within maxDist (matchable nodes are the ones with at least one edge).
+        std::vector<MatchEdge> voEdges;
+        for(int nPtIdx_GT=0; nPtIdx_GT<(int)voPts_GT.size(); ++nPtIdx_GT) {
+            oSegmGrid.forEachNeighbor(voPts_GT[nPtIdx_GT],dMaxDistSqr,[&](int nPtIdx_SEGM, int nDistSqr) {
+                voEdges.push_back(MatchEdge{nPtIdx_SEGM,nPtIdx_GT,sqrt(double(nDistSqr))});
+            });
+        }
+        if(voEdges.empty())
+            return 0;
+        // Split the bipartite graph into connected components (segm nodes first, gt nodes offset by the segm count).
+        const int nPtCount_GT = (int)voPts_GT.size();
+        std::vector<int> vnParents(size_t(nPtCount_SEGM+nPtCount_GT));
+        std::iota(vnParents.begin(),vnParents.end(),0);
+        for(const MatchEdge& oEdge : voEdges) {
+            const int nRoot_SEGM = findRoot(vnParents,oEdge.nNodeIdx_SEGM);
+            const int nRoot_GT = findRoot(vnParents,nPtCount_SEGM+oEdge.nNodeIdx_GT);
+            if(nRoot_SEGM!=nRoot_GT)
+                vnParents[std::max(nRoot_SEGM,nRoot_GT)] = std::min(nRoot_SEGM,nRoot_GT);
+        }
+        std::vector<int> vnCompIdxs(vnParents.size(),-1), vnLocalNodeIdxs(vnParents.size(),-1);
+        std::vector<int> vnCompNodeCounts_GT;
+        std::vector<std::vector<int>> vvnCompNodes_SEGM;
+        std::vector<bool> vbMatchable(vnParents.size(),false);
+        for(const MatchEdge& oEdge : voEdges)
+            vbMatchable[oEdge.nNodeIdx_SEGM] = vbMatchable[nPtCount_SEGM+oEdge.nNodeIdx_GT] = true;
+        // Node IDs within each component range from [0,nCompNodeCount_SEGM) and [0,nCompNodeCount_GT), in raster order.
+        for(int nNodeIdx=0; nNodeIdx<(int)vnParents.size(); ++nNodeIdx) {
+            if(!vbMatchable[nNodeIdx])
+                continue;
+            int& nCompIdx = vnCompIdxs[findRoot(vnParents,nNodeIdx)];
+            if(nCompIdx<0) {
+                nCompIdx = (int)vvnCompNodes_SEGM.size();
+                vvnCompNodes_SEGM.emplace_back();
+                vnCompNodeCounts_GT.push_back(0);
+            }
+            if(nNodeIdx<nPtCount_SEGM) {
+                vnLocalNodeIdxs[nNodeIdx] = (int)vvnCompNodes_SEGM[nCompIdx].size();
+                vvnCompNodes_SEGM[nCompIdx].push_back(nNodeIdx);
+            }
+            else
+                vnLocalNodeIdxs[nNodeIdx] = vnCompNodeCounts_GT[nCompIdx]++;
+        }
+        // Bucket the edges by component, and solve each (independent) assignment subproblem.
+        const size_t nCompCount = vvnCompNodes_SEGM.size();
+        std::vector<std::vector<MatchEdge>> vvoCompEdges(nCompCount);
+        for(const MatchEdge& oEdge : voEdges)
+            vvoCompEdges[vnCompIdxs[findRoot(vnParents,oEdge.nNodeIdx_SEGM)]].push_back(MatchEdge{vnLocalNodeIdxs[oEdge.nNodeIdx_SEGM],vnLocalNodeIdxs[nPtCount_SEGM+oEdge.nNodeIdx_GT],oEdge.dEdgeDist});
+        uint64_t nIndivTP = 0;
+        for(size_t nCompIdx=0; nCompIdx<nCompCount; ++nCompIdx) {
+            const std::vector<int>& vnCompNodes_SEGM = vvnCompNodes_SEGM[nCompIdx];
+            const std::vector<MatchEdge>& voCompEdges = vvoCompEdges[nCompIdx];
+            if(vnCompNodes_SEGM.size()==1 || vnCompNodeCounts_GT[nCompIdx]==1) {
+                // star-shaped component; the optimal assignment is the single shortest edge
+                const MatchEdge& oBestEdge = *std::min_element(voCompEdges.begin(),voCompEdges.end(),[](const MatchEdge& a, const MatchEdge& b) {
+                    return a.dEdgeDist<b.dEdgeDist;
+                });
+                oSegmTPAccumulator.at<uchar>(oSegmGrid.m_voPts[vnCompNodes_SEGM[oBestEdge.nNodeIdx_SEGM]]) = UCHAR_MAX;
+                ++nIndivTP;
+                continue;
             }
-            nGTPosCount += cv::countNonZero(oCurrGTSegmMask);
-            oGTAccumulator |= oCurrGTSegmMask;
+            // since the gt mask is fixed, a component is fully determined by its segm pixels; if it existed at the previous threshold, reuse its assignment
+            std::vector<int> vnCompPxIdxs_SEGM(vnCompNodes_SEGM.size());
+            for(size_t nNodeIdx=0; nNodeIdx<vnCompNodes_SEGM.size(); ++nNodeIdx)
+                vnCompPxIdxs_SEGM[nNodeIdx] = oSegmGrid.getLinearIdx(vnCompNodes_SEGM[nNodeIdx]);
+            const auto pPrevResult = oPrevCache.find(vnCompPxIdxs_SEGM);
+            std::vector<int> vnMatchedPxIdxs_SEGM;
+            if(pPrevResult!=oPrevCache.end())
+                vnMatchedPxIdxs_SEGM = pPrevResult->second;
+            else
+                for(int nLocalNodeIdx_SEGM : solveMatchAssignment(voCompEdges,(int)vnCompNodes_SEGM.size(),vnCompNodeCounts_GT[nCompIdx],dOutlierCost))
+                    vnMatchedPxIdxs_SEGM.push_back(vnCompPxIdxs_SEGM[nLocalNodeIdx_SEGM]);
+            for(int nMatchedPxIdx_SEGM : vnMatchedPxIdxs_SEGM)
+                oSegmTPAccumulator.at<uchar>(nMatchedPxIdx_SEGM/oSegmTPAccumulator.cols,nMatchedPxIdx_SEGM%oSegmTPAccumulator.cols) = UCHAR_MAX;
+            nIndivTP += vnMatchedPxIdxs_SEGM.size();
+            oCurrCache.emplace(std::move(vnCompPxIdxs_SEGM),std::move(vnMatchedPxIdxs_SEGM));
         }
+        return nIndivTP;
+    }
 
 #else //(!USE_BSDS500_BENCHMARK)
 
-        oSegmTPAccumulator = cv::Scalar_<uchar>(0); // accP |= ...
+    /// matches each gt edge pixel to the first segm edge pixel (in raster order) within max distance; marks matched segm pixels in 'oSegmTPAccumulator' and returns the match count
+    /// (greedy matches are cheap to recompute, so the component caches are not used here)
+    uint64_t matchEdgeMaps(const EdgePixelGrid& oSegmGrid, const std::vector<cv::Point2i>& voPts_GT, const double dMaxDist,
+                           const MatchCache& /*oPrevCache*/, MatchCache& /*oCurrCache*/, cv::Mat& oSegmTPAccumulator) {
+        const double dMaxDistSqr = dMaxDist*dMaxDist;
         uint64_t nIndivTP = 0; // cntR += ...
-        uint64_t nGTPosCount = 0; // sumR += ...
-        for(size_t nGTMaskIdx = 0; nGTMaskIdx<size_t(oGT.rows/oCurrSegmMask.rows); ++nGTMaskIdx) {
-            cv::Mat oCurrGTSegmMask = oGT(cv::Rect(0,int(oCurrSegmMask.rows*nGTMaskIdx),oCurrSegmMask.cols,oCurrSegmMask.rows));
-            for(int i = 0; i<oCurrSegmMask.rows; ++i) {
-                for(int j = 0; j<oCurrSegmMask.cols; ++j) {
-                    if(!oCurrGTSegmMask.at<uchar>(i,j)) continue;
-                    ++nGTPosCount;
-                    bool bFoundMatch = false;
-                    for(int u = -nMaxDist; u<=nMaxDist && !bFoundMatch; ++u) {
-                        if(i+u<0) continue;
-                        if(i+u>=oCurrSegmMask.rows) continue;
-                        if(double(u)>dMaxDist) continue;
-                        for(int v = -nMaxDist; v<=nMaxDist && !bFoundMatch; ++v) {
-                            if(j+v<0) continue;
-                            if(j+v>=oCurrSegmMask.cols) continue;
-                            if(double(v)>dMaxDist) continue;
-                            const double dCurrDistSqr = u*u+v*v;
-                            if(dCurrDistSqr>dMaxDistSqr) continue;
-                            if(oCurrSegmMask.at<uchar>(i+u,j+v)) {
-                                ++nIndivTP;
-                                oSegmTPAccumulator.at<uchar>(i+u,j+v) = UCHAR_MAX;
-                                bFoundMatch = true;
-                            }
-                        }
-                    }
-                }
+        for(const cv::Point2i& oPt_GT : voPts_GT) {
+            int nBestPtIdx_SEGM = INT_MAX; // grid pixel indices follow raster order, so the min index is the first one a window scan would hit
+            oSegmGrid.forEachNeighbor(oPt_GT,dMaxDistSqr,[&](int nPtIdx_SEGM, int) {
+                nBestPtIdx_SEGM = std::min(nBestPtIdx_SEGM,nPtIdx_SEGM);
+            });
+            if(nBestPtIdx_SEGM!=INT_MAX) {
+                ++nIndivTP;
+                oSegmTPAccumulator.at<uchar>(oSegmGrid.m_voPts[nBestPtIdx_SEGM]) = UCHAR_MAX;
             }
         }
+        return nIndivTP;
+    }
 
 #endif //(!USE_BSDS500_BENCHMARK)
 
+} // anonymous namespace
+
+void lv::MetricsAccumulator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>::accumulate(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& /*oROI*/) {
+    if(oGT.empty())
+        return;
+    lvAssert(oClassif.type()==CV_8UC1 && oGT.type()==CV_8UC1);
+    lvAssert(oClassif.isContinuous() && oGT.isContinuous());
+    lvAssert(oClassif.cols==oGT.cols && (oGT.rows%oClassif.rows)==0 && (oGT.rows/oClassif.rows)>=1);
+    lvAssert(oClassif.step.p[0]==oGT.step.p[0]);
+
+    const double dMaxDist = DATASETS_BSDS500_EVAL_IMAGE_DIAG_RATIO_DIST*sqrt(double(oClassif.cols*oClassif.cols+oClassif.rows*oClassif.rows));
+    const int nMaxDist = (int)ceil(dMaxDist);
+    lvAssert(dMaxDist>0 && nMaxDist>0);
+
+    BSDS500Counters oMetricsBase(m_nThresholdBins);
+    const std::vector<uchar> vuEvalUniqueVals = lv::unique<uchar>(oClassif);
+    const size_t nGTMaskCount = size_t(oGT.rows/oClassif.rows);
+    // thresholds between two unique classif values give identical masks; only the first bin of each such range is evaluated
+    std::vector<size_t> vnEvalThresholdBinIdxs;
+    size_t nNextEvalUniqueValIdx = 0;
+    size_t nThresholdBinIdx = 0;
+    while(nThresholdBinIdx<oMetricsBase.vnThresholds.size()) {
+        vnEvalThresholdBinIdxs.push_back(nThresholdBinIdx);
+        while(nNextEvalUniqueValIdx+1<vuEvalUniqueVals.size() && vuEvalUniqueVals[nNextEvalUniqueValIdx]<=oMetricsBase.vnThresholds[nThresholdBinIdx])
+            ++nNextEvalUniqueValIdx;
+        while(++nThresholdBinIdx<oMetricsBase.vnThresholds.size() && oMetricsBase.vnThresholds[nThresholdBinIdx]<=vuEvalUniqueVals[nNextEvalUniqueValIdx]);
+    }
+    // gt masks are shared by all thresholds; their edge pixels are only extracted once
+    std::vector<std::vector<cv::Point2i>> vvoPts_GT(nGTMaskCount);
+    uint64_t nGTPosCount = 0; // sumR += ...
+    for(size_t nGTMaskIdx=0; nGTMaskIdx<nGTMaskCount; ++nGTMaskIdx) {
+        vvoPts_GT[nGTMaskIdx] = getEdgePixels(oGT(cv::Rect(0,int(oClassif.rows*nGTMaskIdx),oClassif.cols,oClassif.rows)));
+        nGTPosCount += vvoPts_GT[nGTMaskIdx].size();
+    }
+    const auto lEvalThresholdBin = [&](size_t nEvalThresholdBinIdx, const std::vector<MatchCache>& voPrevCaches, std::vector<MatchCache>& voCurrCaches) {
+        cv::Mat oCurrSegmMask, oTmpSegmMask;
+        cv::compare(oClassif,oMetricsBase.vnThresholds[nEvalThresholdBinIdx],oTmpSegmMask,cv::CMP_GE);
+        lv::thinning(oTmpSegmMask,oCurrSegmMask);
+        const EdgePixelGrid oSegmGrid(oCurrSegmMask,nMaxDist);
+        cv::Mat oSegmTPAccumulator(oClassif.size(),CV_8UC1,cv::Scalar_<uchar>(0)); // accP |= ...
+        uint64_t nIndivTP = 0; // cntR += ...
+        for(size_t nGTMaskIdx=0; nGTMaskIdx<nGTMaskCount; ++nGTMaskIdx)
+            nIndivTP += matchEdgeMaps(oSegmGrid,vvoPts_GT[nGTMaskIdx],dMaxDist,voPrevCaches[nGTMaskIdx],voCurrCaches[nGTMaskIdx],oSegmTPAccumulator);
+
         //re = TP / (TP + FN)
         lvAssert(nGTPosCount>=nIndivTP);
-        oMetricsBase.vnIndivTP[nThresholdBinIdx] = nIndivTP;
-        oMetricsBase.vnIndivTPFN[nThresholdBinIdx] = nGTPosCount;
+        oMetricsBase.vnIndivTP[nEvalThresholdBinIdx] = nIndivTP;
+        oMetricsBase.vnIndivTPFN[nEvalThresholdBinIdx] = nGTPosCount;
 
         //pr = TP / (TP + FP)
         uint64_t nSegmTPAccCount = uint64_t(cv::countNonZero(oSegmTPAccumulator));
-        uint64_t nSegmPosCount = uint64_t(cv::countNonZero(oCurrSegmMask));
+        uint64_t nSegmPosCount = uint64_t(oSegmGrid.m_voPts.size());
         lvAssert(nSegmPosCount>=nSegmTPAccCount);
-        oMetricsBase.vnTotalTP[nThresholdBinIdx] = nSegmTPAccCount;
-        oMetricsBase.vnTotalTPFP[nThresholdBinIdx] = nSegmPosCount;
-        while(nNextEvalUniqueValIdx+1<vuEvalUniqueVals.size() && vuEvalUniqueVals[nNextEvalUniqueValIdx]<=oMetricsBase.vnThresholds[nThresholdBinIdx])
-            ++nNextEvalUniqueValIdx;
-        while(++nThresholdBinIdx<oMetricsBase.vnThresholds.size() && oMetricsBase.vnThresholds[nThresholdBinIdx]<=vuEvalUniqueVals[nNextEvalUniqueValIdx]) {
+        oMetricsBase.vnTotalTP[nEvalThresholdBinIdx] = nSegmTPAccCount;
+        oMetricsBase.vnTotalTPFP[nEvalThresholdBinIdx] = nSegmPosCount;
+    };
+    // each tile sweeps a contiguous range of threshold bins from high to low, so that most match components can be reused from the previous
+    // (stricter) threshold; reused assignments are identical to re-solved ones, so results do not depend on how the range is tiled, and each
+    // threshold bin only ever writes its own counters; tiles are sized so that each thread gets a single run (cache reuse stops at tile borders)
+    const size_t nEvalCount = vnEvalThresholdBinIdxs.size();
+    const size_t nThreadCount = lv::ThreadPool::get().getThreadCount();
+    const size_t nMinTileSize = (nEvalCount+nThreadCount-1)/nThreadCount;
+    std::atomic_size_t nDoneEvalCount(0);
+    std::atomic_bool bAbort(false);
+    lv::ThreadPool::get().parallel_for(nEvalCount,nMinTileSize,[&](size_t nTileIdx, size_t nEvalIdxBegin, size_t nEvalIdxEnd) {
+        std::vector<MatchCache> voPrevCaches(nGTMaskCount), voCurrCaches(nGTMaskCount);
+        for(size_t nEvalIdx=nEvalIdxEnd; nEvalIdx>nEvalIdxBegin && !bAbort; --nEvalIdx) {
+            try {
+                lEvalThresholdBin(vnEvalThresholdBinIdxs[nEvalIdx-1],voPrevCaches,voCurrCaches);
+            }
+            catch(...) {
+                bAbort = true; // remaining tiles bail out early; the pool rethrows the first exception
+                throw;
+            }
+            std::swap(voPrevCaches,voCurrCaches);
+            for(MatchCache& oCache : voCurrCaches)
+                oCache.clear();
+            const size_t nCurrDoneEvalCount = ++nDoneEvalCount;
+            if(nTileIdx==0)
+                lv::updateConsoleProgressBar("BSDS500 eval:",float(nCurrDoneEvalCount)/nEvalCount);
+        }
+    });
+    lv::cleanConsoleRow();
+    for(nThresholdBinIdx=1; nThresholdBinIdx<oMetricsBase.vnThresholds.size(); ++nThresholdBinIdx) {
+        if(!std::binary_search(vnEvalThresholdBinIdxs.begin(),vnEvalThresholdBinIdxs.end(),nThresholdBinIdx)) {
             oMetricsBase.vnIndivTP[nThresholdBinIdx] = oMetricsBase.vnIndivTP[nThresholdBinIdx-1];
             oMetricsBase.vnIndivTPFN[nThresholdBinIdx] = oMetricsBase.vnIndivTPFN[nThresholdBinIdx-1];
             oMetricsBase.vnTotalTP[nThresholdBinIdx] = oMetricsBase.vnTotalTP[nThresholdBinIdx-1];
             oMetricsBase.vnTotalTPFP[nThresholdBinIdx] = oMetricsBase.vnTotalTPFP[nThresholdBinIdx-1];
         }
-
-        const float fCompltRatio = float(nThresholdBinIdx)/oMetricsBase.vnThresholds.size();
-        lv::updateConsoleProgressBar("BSDS500 eval:",fCompltRatio);
     }
-    lv::cleanConsoleRow();
     m_voMetricsBase.push_back(oMetricsBase);
 }
 
@@ -626,10 +705,13 @@ void lv::DatasetReporter_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>:
         oMetricsOutput << "------------||------------|------------|------------||------------|------------|------------|------------\n";
         size_t nOverallPacketCount = 0;
         double dOverallTimeElapsed = 0.0;
+        lv::LatencyHistogram oLatencies;
+        double dIOWaitTime_sec = 0.0;
         for(const auto& pGroupIter : getBatches(true)) {
             oMetricsOutput << pGroupIter->shared_from_this_cast<const DataReporter_<DatasetEval_BinaryClassifier,Dataset_BSDS500>>(true)->DataReporter_<DatasetEval_BinaryClassifier,Dataset_BSDS500>::writeInlineEvalReport(0);
             nOverallPacketCount += pGroupIter->getProcessedOutputCount();
             dOverallTimeElapsed += pGroupIter->getProcessTime();
+            accumulateTimingStats(*pGroupIter,oLatencies,dIOWaitTime_sec);
         }
         oMetricsOutput << "------------||------------|------------|------------||------------|------------|------------|------------\n";
         oMetricsOutput << "     overall||" <<
@@ -640,7 +722,7 @@ void lv::DatasetReporter_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>:
             std::setw(12) << oMetrics.oBestScore.dPrecision << "|" <<
             std::setw(12) << oMetrics.oBestScore.dFMeasure << "|" <<
             std::setw(12) << oMetrics.oBestScore.dThreshold << "\n";
-        oMetricsOutput << "\nHz: " << nOverallPacketCount/dOverallTimeElapsed << "\n";
+        oMetricsOutput << writeTimingReport(nOverallPacketCount,dOverallTimeElapsed,oLatencies,dIOWaitTime_sec);
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -707,17 +789,28 @@ cv::Mat lv::DataEvaluator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500,
 
 void lv::DataEvaluator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500,lv::NonParallel>::resetMetrics() {
     resetProcessedOutputCount();
-    m_pMetricsBase = IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,Dataset_BSDS500>>();
+    m_oEvalQueue.reset();
 }
 
 lv::IIMetricsAccumulatorConstPtr lv::DataEvaluator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500,lv::NonParallel>::getMetricsBase() const {
-    return m_pMetricsBase;
+    return m_oEvalQueue.getMetricsBase();
 }
 
 void lv::DataEvaluator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500,lv::NonParallel>::processOutput(const cv::Mat& oClassif, size_t nIdx) {
     if(getDatasetInfo()->isUsingEvaluator()) {
         lvAssert_(!oClassif.empty(),"output must be non-empty for evaluation");
         auto pLoader = shared_from_this_cast<IDataLoader_<NotArray>>(true);
-        m_pMetricsBase->accumulate(oClassif,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx));
+        m_oEvalQueue.push(oClassif,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx),nIdx);
     }
 }
+
+void lv::DataEvaluator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500,lv::NonParallel>::stopProcessing_impl() {
+    m_oEvalQueue.stop();
+}
+
+lv::DataEvaluator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500,lv::NonParallel>::DataEvaluator_() :
+        // the accumulator keeps one counter block per image, listed in the per-image report; packets must thus be merged in push order
+        m_oEvalQueue([](){return IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,Dataset_BSDS500>>();},
+                     [](const IIMetricsAccumulatorPtr& pMetrics, const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI) {
+                         std::static_pointer_cast<MetricsAccumulator_<DatasetEval_BinaryClassifier,Dataset_BSDS500>>(pMetrics)->accumulate(oClassif,oGT,oROI);
+                     },true) {}
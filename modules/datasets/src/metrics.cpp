@@ -18,6 +18,287 @@
 #include <litiv/datasets/metrics.hpp>
 #include "litiv/datasets/metrics.hpp"
 
+namespace {
+
+    /// indices of the partial counters accumulated per row (TN and DC are derived from these afterwards)
+    enum PartialCountersList {
+        PartialCounter_Valid,
+        PartialCounter_TP,
+        PartialCounter_FP,
+        PartialCounter_FN,
+        PartialCounter_SE,
+        nPartialCountersCount,
+    };
+
+    /// branchless scalar accumulation of partial counts over [nBegin,nEnd) (roi pointer may be null)
+    inline void accumulateRow_scalar(const uchar* pClassif, const uchar* pGT, const uchar* pROI, size_t nBegin, size_t nEnd, uint64_t* anCounts) {
+        for(size_t j=nBegin; j<nEnd; ++j) {
+            const uint64_t bValid = uint64_t(pGT[j]!=DATASETUTILS_OUTOFSCOPE_VAL && pGT[j]!=DATASETUTILS_UNKNOWN_VAL && (!pROI || pROI[j]!=DATASETUTILS_NEGATIVE_VAL));
+            const uint64_t bPos = uint64_t(pClassif[j]==DATASETUTILS_POSITIVE_VAL);
+            const uint64_t bGTPos = uint64_t(pGT[j]==DATASETUTILS_POSITIVE_VAL);
+            anCounts[PartialCounter_Valid] += bValid;
+            anCounts[PartialCounter_TP] += bValid&bPos&bGTPos;
+            anCounts[PartialCounter_FP] += bValid&bPos&(bGTPos^1);
+            anCounts[PartialCounter_FN] += bValid&(bPos^1)&bGTPos;
+            anCounts[PartialCounter_SE] += bValid&bPos&uint64_t(pGT[j]==DATASETUTILS_SHADOW_VAL);
+        }
+    }
+
+#if HAVE_SIMD_DISPATCH
+    /// horizontal sum of the 16 unsigned bytes of each partial byte counter, added to the 64-bit counts
+    lvSIMDTarget("sse2") inline void flushCounters_16ub(__m128i* aanByteCounts, uint64_t* anCounts) {
+        const __m128i anZero = _mm_setzero_si128();
+        for(size_t n=0; n<nPartialCountersCount; ++n) {
+            const __m128i anSums = _mm_sad_epu8(aanByteCounts[n],anZero);
+            anCounts[n] += uint64_t(_mm_cvtsi128_si32(anSums))+uint64_t(_mm_cvtsi128_si32(_mm_srli_si128(anSums,8)));
+            aanByteCounts[n] = anZero;
+        }
+    }
+
+    /// sse2 version of the partial count accumulation; returns the number of columns processed (the rest must be done in scalar)
+    lvSIMDTarget("sse2") size_t accumulateRow_sse2(const uchar* pClassif, const uchar* pGT, const uchar* pROI, size_t nCols, uint64_t* anCounts) {
+        size_t j = 0;
+        const __m128i anPosVal = _mm_set1_epi8(char(DATASETUTILS_POSITIVE_VAL));
+        const __m128i anNegVal = _mm_set1_epi8(char(DATASETUTILS_NEGATIVE_VAL));
+        const __m128i anOutOfScopeVal = _mm_set1_epi8(char(DATASETUTILS_OUTOFSCOPE_VAL));
+        const __m128i anUnknownVal = _mm_set1_epi8(char(DATASETUTILS_UNKNOWN_VAL));
+        const __m128i anShadowVal = _mm_set1_epi8(char(DATASETUTILS_SHADOW_VAL));
+        __m128i aanByteCounts[nPartialCountersCount];
+        for(size_t n=0; n<nPartialCountersCount; ++n)
+            aanByteCounts[n] = _mm_setzero_si128();
+        size_t nBlocksSinceFlush = 0;
+        for(; j+16<=nCols; j+=16) {
+            const __m128i anClassif = _mm_loadu_si128((const __m128i*)(pClassif+j));
+            const __m128i anGT = _mm_loadu_si128((const __m128i*)(pGT+j));
+            __m128i anInvalid = _mm_or_si128(_mm_cmpeq_epi8(anGT,anOutOfScopeVal),_mm_cmpeq_epi8(anGT,anUnknownVal));
+            if(pROI)
+                anInvalid = _mm_or_si128(anInvalid,_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pROI+j)),anNegVal));
+            const __m128i anPos = _mm_andnot_si128(anInvalid,_mm_cmpeq_epi8(anClassif,anPosVal));
+            const __m128i anNeg = _mm_andnot_si128(_mm_or_si128(anInvalid,anPos),_mm_set1_epi8(char(-1)));
+            const __m128i anGTPos = _mm_cmpeq_epi8(anGT,anPosVal);
+            // masks are 0xFF where set, so subtracting them increments the byte counters
+            aanByteCounts[PartialCounter_Valid] = _mm_sub_epi8(aanByteCounts[PartialCounter_Valid],_mm_andnot_si128(anInvalid,_mm_set1_epi8(char(-1))));
+            aanByteCounts[PartialCounter_TP] = _mm_sub_epi8(aanByteCounts[PartialCounter_TP],_mm_and_si128(anPos,anGTPos));
+            aanByteCounts[PartialCounter_FP] = _mm_sub_epi8(aanByteCounts[PartialCounter_FP],_mm_andnot_si128(anGTPos,anPos));
+            aanByteCounts[PartialCounter_FN] = _mm_sub_epi8(aanByteCounts[PartialCounter_FN],_mm_and_si128(anNeg,anGTPos));
+            aanByteCounts[PartialCounter_SE] = _mm_sub_epi8(aanByteCounts[PartialCounter_SE],_mm_and_si128(anPos,_mm_cmpeq_epi8(anGT,anShadowVal)));
+            if(++nBlocksSinceFlush==UCHAR_MAX) {
+                flushCounters_16ub(aanByteCounts,anCounts);
+                nBlocksSinceFlush = 0;
+            }
+        }
+        flushCounters_16ub(aanByteCounts,anCounts);
+        return j;
+    }
+
+    /// horizontal sum of the 32 unsigned bytes of each partial byte counter, added to the 64-bit counts
+    lvSIMDTarget("avx2") inline void flushCounters_32ub(__m256i* aanByteCounts, uint64_t* anCounts) {
+        const __m256i anZero = _mm256_setzero_si256();
+        for(size_t n=0; n<nPartialCountersCount; ++n) {
+            const __m256i anSums = _mm256_sad_epu8(aanByteCounts[n],anZero);
+            const __m128i anHalfSums = _mm_add_epi64(_mm256_castsi256_si128(anSums),_mm256_extracti128_si256(anSums,1));
+            anCounts[n] += uint64_t(_mm_cvtsi128_si32(anHalfSums))+uint64_t(_mm_cvtsi128_si32(_mm_srli_si128(anHalfSums,8)));
+            aanByteCounts[n] = anZero;
+        }
+    }
+
+    /// avx2 version of the partial count accumulation; returns the number of columns processed (the rest must be done in scalar)
+    lvSIMDTarget("avx2") size_t accumulateRow_avx2(const uchar* pClassif, const uchar* pGT, const uchar* pROI, size_t nCols, uint64_t* anCounts) {
+        size_t j = 0;
+        const __m256i anPosVal = _mm256_set1_epi8(char(DATASETUTILS_POSITIVE_VAL));
+        const __m256i anNegVal = _mm256_set1_epi8(char(DATASETUTILS_NEGATIVE_VAL));
+        const __m256i anOutOfScopeVal = _mm256_set1_epi8(char(DATASETUTILS_OUTOFSCOPE_VAL));
+        const __m256i anUnknownVal = _mm256_set1_epi8(char(DATASETUTILS_UNKNOWN_VAL));
+        const __m256i anShadowVal = _mm256_set1_epi8(char(DATASETUTILS_SHADOW_VAL));
+        __m256i aanByteCounts[nPartialCountersCount];
+        for(size_t n=0; n<nPartialCountersCount; ++n)
+            aanByteCounts[n] = _mm256_setzero_si256();
+        size_t nBlocksSinceFlush = 0;
+        for(; j+32<=nCols; j+=32) {
+            const __m256i anClassif = _mm256_loadu_si256((const __m256i*)(pClassif+j));
+            const __m256i anGT = _mm256_loadu_si256((const __m256i*)(pGT+j));
+            __m256i anInvalid = _mm256_or_si256(_mm256_cmpeq_epi8(anGT,anOutOfScopeVal),_mm256_cmpeq_epi8(anGT,anUnknownVal));
+            if(pROI)
+                anInvalid = _mm256_or_si256(anInvalid,_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(pROI+j)),anNegVal));
+            const __m256i anPos = _mm256_andnot_si256(anInvalid,_mm256_cmpeq_epi8(anClassif,anPosVal));
+            const __m256i anNeg = _mm256_andnot_si256(_mm256_or_si256(anInvalid,anPos),_mm256_set1_epi8(char(-1)));
+            const __m256i anGTPos = _mm256_cmpeq_epi8(anGT,anPosVal);
+            // masks are 0xFF where set, so subtracting them increments the byte counters
+            aanByteCounts[PartialCounter_Valid] = _mm256_sub_epi8(aanByteCounts[PartialCounter_Valid],_mm256_andnot_si256(anInvalid,_mm256_set1_epi8(char(-1))));
+            aanByteCounts[PartialCounter_TP] = _mm256_sub_epi8(aanByteCounts[PartialCounter_TP],_mm256_and_si256(anPos,anGTPos));
+            aanByteCounts[PartialCounter_FP] = _mm256_sub_epi8(aanByteCounts[PartialCounter_FP],_mm256_andnot_si256(anGTPos,anPos));
+            aanByteCounts[PartialCounter_FN] = _mm256_sub_epi8(aanByteCounts[PartialCounter_FN],_mm256_and_si256(anNeg,anGTPos));
+            aanByteCounts[PartialCounter_SE] = _mm256_sub_epi8(aanByteCounts[PartialCounter_SE],_mm256_and_si256(anPos,_mm256_cmpeq_epi8(anGT,anShadowVal)));
+            if(++nBlocksSinceFlush==UCHAR_MAX) {
+                flushCounters_32ub(aanByteCounts,anCounts);
+                nBlocksSinceFlush = 0;
+            }
+        }
+        flushCounters_32ub(aanByteCounts,anCounts);
+        return j;
+    }
+
+#if TARGET_PLATFORM_x64
+    /// avx512bw version of the partial count accumulation (comparisons give bit masks, which are counted directly); returns the number of columns processed
+    lvSIMDTarget("avx512f,avx512bw,popcnt") size_t accumulateRow_avx512bw(const uchar* pClassif, const uchar* pGT, const uchar* pROI, size_t nCols, uint64_t* anCounts) {
+        size_t j = 0;
+        const __m512i anPosVal = _mm512_set1_epi8(char(DATASETUTILS_POSITIVE_VAL));
+        const __m512i anNegVal = _mm512_set1_epi8(char(DATASETUTILS_NEGATIVE_VAL));
+        const __m512i anOutOfScopeVal = _mm512_set1_epi8(char(DATASETUTILS_OUTOFSCOPE_VAL));
+        const __m512i anUnknownVal = _mm512_set1_epi8(char(DATASETUTILS_UNKNOWN_VAL));
+        const __m512i anShadowVal = _mm512_set1_epi8(char(DATASETUTILS_SHADOW_VAL));
+        for(; j+64<=nCols; j+=64) {
+            const __m512i anClassif = _mm512_loadu_si512((const void*)(pClassif+j));
+            const __m512i anGT = _mm512_loadu_si512((const void*)(pGT+j));
+            uint64_t nInvalid = uint64_t(_mm512_cmpeq_epi8_mask(anGT,anOutOfScopeVal)|_mm512_cmpeq_epi8_mask(anGT,anUnknownVal));
+            if(pROI)
+                nInvalid |= uint64_t(_mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void*)(pROI+j)),anNegVal));
+            const uint64_t nValid = ~nInvalid;
+            const uint64_t nPos = nValid&uint64_t(_mm512_cmpeq_epi8_mask(anClassif,anPosVal));
+            const uint64_t nGTPos = uint64_t(_mm512_cmpeq_epi8_mask(anGT,anPosVal));
+            anCounts[PartialCounter_Valid] += uint64_t(_mm_popcnt_u64(nValid));
+            anCounts[PartialCounter_TP] += uint64_t(_mm_popcnt_u64(nPos&nGTPos));
+            anCounts[PartialCounter_FP] += uint64_t(_mm_popcnt_u64(nPos&~nGTPos));
+            anCounts[PartialCounter_FN] += uint64_t(_mm_popcnt_u64(nValid&~nPos&nGTPos));
+            anCounts[PartialCounter_SE] += uint64_t(_mm_popcnt_u64(nPos&uint64_t(_mm512_cmpeq_epi8_mask(anGT,anShadowVal))));
+        }
+        return j;
+    }
+#endif //TARGET_PLATFORM_x64
+#endif //HAVE_SIMD_DISPATCH
+
+    /// accumulates partial counts for a full row (vectorized for the simd level picked at runtime, if any)
+    inline void accumulateRow(const uchar* pClassif, const uchar* pGT, const uchar* pROI, size_t nCols, uint64_t* anCounts) {
+        size_t j = 0;
+#if HAVE_SIMD_DISPATCH
+        const lv::SIMDLevel eSIMDLevel = lv::getSIMDLevel();
+#if TARGET_PLATFORM_x64
+        if(eSIMDLevel>=lv::SIMDLevel_AVX512BW)
+            j = accumulateRow_avx512bw(pClassif,pGT,pROI,nCols,anCounts);
+        else
+#endif //TARGET_PLATFORM_x64
+        if(eSIMDLevel>=lv::SIMDLevel_AVX2)
+            j = accumulateRow_avx2(pClassif,pGT,pROI,nCols,anCounts);
+        else if(eSIMDLevel>=lv::SIMDLevel_SSE2)
+            j = accumulateRow_sse2(pClassif,pGT,pROI,nCols,anCounts);
+#endif //HAVE_SIMD_DISPATCH
+        accumulateRow_scalar(pClassif,pGT,pROI,j,nCols,anCounts);
+    }
+
+    /// colored mask lookup keys are built as (gt category)*2 + (classif is positive), or set to the ROI key if outside the ROI
+    enum ColoredMaskKeysList {
+        ColoredMaskKey_GTPositive=0,
+        ColoredMaskKey_GTNegative=2,
+        ColoredMaskKey_GTShadow=4,
+        ColoredMaskKey_GTInvalid=6,
+        ColoredMaskKey_GTOther=8,
+        ColoredMaskKey_OutOfROI=15,
+        nColoredMaskKeysCount,
+    };
+
+    /// colored mask lookup table entry; output channels are given by (aBGR | (input & nCopyMask))
+    struct ColoredMaskEntry {
+        uchar aBGR[3];
+        uchar nCopyMask;
+    };
+
+    /// returns the (static) colored mask lookup table, indexed by key
+    inline const std::array<ColoredMaskEntry,nColoredMaskKeysCount>& getColoredMaskLUT() {
+        static const std::array<ColoredMaskEntry,nColoredMaskKeysCount> s_aLUT = [](){
+            std::array<ColoredMaskEntry,nColoredMaskKeysCount> aLUT = {};
+            aLUT[ColoredMaskKey_GTPositive] = {{UCHAR_MAX/2,0,UCHAR_MAX},0}; // FN
+            aLUT[ColoredMaskKey_GTPositive+1] = {{0,UCHAR_MAX,0},0}; // TP
+            aLUT[ColoredMaskKey_GTNegative+1] = {{0,0,UCHAR_MAX},0}; // FP
+            aLUT[ColoredMaskKey_GTShadow+1] = {{0,UCHAR_MAX/2,UCHAR_MAX},0}; // SE
+            aLUT[ColoredMaskKey_GTInvalid] = {{0,0,0},UCHAR_MAX}; // DC, copy input
+            aLUT[ColoredMaskKey_GTInvalid+1] = {{0,0,0},UCHAR_MAX}; // DC, copy input
+            aLUT[ColoredMaskKey_GTOther+1] = {{UCHAR_MAX/3,UCHAR_MAX/3,UCHAR_MAX/3},0};
+            aLUT[ColoredMaskKey_OutOfROI] = {{UCHAR_MAX/2,UCHAR_MAX/2,UCHAR_MAX/2},0};
+            return aLUT;
+        }();
+        return s_aLUT;
+    }
+
+    /// returns the (static) gt value to gt key category lookup table
+    inline const std::array<uchar,UCHAR_MAX+1>& getColoredMaskGTLUT() {
+        static const std::array<uchar,UCHAR_MAX+1> s_aLUT = [](){
+            std::array<uchar,UCHAR_MAX+1> aLUT;
+            aLUT.fill(uchar(ColoredMaskKey_GTOther));
+            aLUT[DATASETUTILS_POSITIVE_VAL] = uchar(ColoredMaskKey_GTPositive);
+            aLUT[DATASETUTILS_NEGATIVE_VAL] = uchar(ColoredMaskKey_GTNegative);
+            aLUT[DATASETUTILS_SHADOW_VAL] = uchar(ColoredMaskKey_GTShadow);
+            aLUT[DATASETUTILS_OUTOFSCOPE_VAL] = uchar(ColoredMaskKey_GTInvalid);
+            aLUT[DATASETUTILS_UNKNOWN_VAL] = uchar(ColoredMaskKey_GTInvalid);
+            return aLUT;
+        }();
+        return s_aLUT;
+    }
+
+#if HAVE_SIMD_DISPATCH
+    /// sse2 version of the colored mask key computation & lookup; returns the number of columns processed (the rest must be done in scalar)
+    lvSIMDTarget("sse2") size_t colorizeRow_sse2(const uchar* pClassif, const uchar* pGT, const uchar* pROI, size_t nCols, uchar* pResult) {
+        const std::array<ColoredMaskEntry,nColoredMaskKeysCount>& aLUT = getColoredMaskLUT();
+        size_t j = 0;
+        alignas(16) uchar anKeyBuffer[16];
+        const __m128i anPosVal = _mm_set1_epi8(char(DATASETUTILS_POSITIVE_VAL));
+        const __m128i anNegVal = _mm_set1_epi8(char(DATASETUTILS_NEGATIVE_VAL));
+        const __m128i anShadowVal = _mm_set1_epi8(char(DATASETUTILS_SHADOW_VAL));
+        const __m128i anOutOfScopeVal = _mm_set1_epi8(char(DATASETUTILS_OUTOFSCOPE_VAL));
+        const __m128i anUnknownVal = _mm_set1_epi8(char(DATASETUTILS_UNKNOWN_VAL));
+        const __m128i anOne = _mm_set1_epi8(1);
+        for(; j+16<=nCols; j+=16) {
+            const __m128i anClassif = _mm_loadu_si128((const __m128i*)(pClassif+j));
+            const __m128i anGT = _mm_loadu_si128((const __m128i*)(pGT+j));
+            const __m128i anGTPos = _mm_cmpeq_epi8(anGT,anPosVal);
+            const __m128i anGTNeg = _mm_cmpeq_epi8(anGT,anNegVal);
+            const __m128i anGTShadow = _mm_cmpeq_epi8(anGT,anShadowVal);
+            const __m128i anGTInvalid = _mm_or_si128(_mm_cmpeq_epi8(anGT,anOutOfScopeVal),_mm_cmpeq_epi8(anGT,anUnknownVal));
+            const __m128i anGTOther = _mm_andnot_si128(_mm_or_si128(_mm_or_si128(anGTPos,anGTNeg),_mm_or_si128(anGTShadow,anGTInvalid)),_mm_set1_epi8(char(-1)));
+            // positive gt category is zero, so it does not need to be or'd in
+            __m128i anKeys = _mm_or_si128(_mm_and_si128(anGTNeg,_mm_set1_epi8(char(ColoredMaskKey_GTNegative))),_mm_and_si128(anGTShadow,_mm_set1_epi8(char(ColoredMaskKey_GTShadow))));
+            anKeys = _mm_or_si128(anKeys,_mm_and_si128(anGTInvalid,_mm_set1_epi8(char(ColoredMaskKey_GTInvalid))));
+            anKeys = _mm_or_si128(anKeys,_mm_and_si128(anGTOther,_mm_set1_epi8(char(ColoredMaskKey_GTOther))));
+            anKeys = _mm_or_si128(anKeys,_mm_and_si128(_mm_cmpeq_epi8(anClassif,anPosVal),anOne));
+            if(pROI) {
+                const __m128i anOutOfROI = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pROI+j)),anNegVal);
+                anKeys = _mm_or_si128(_mm_andnot_si128(anOutOfROI,anKeys),_mm_and_si128(anOutOfROI,_mm_set1_epi8(char(ColoredMaskKey_OutOfROI))));
+            }
+            _mm_store_si128((__m128i*)anKeyBuffer,anKeys);
+            for(size_t k=0; k<16; ++k) {
+                const ColoredMaskEntry& oEntry = aLUT[anKeyBuffer[k]];
+                const uchar nCopy = uchar(pClassif[j+k]&oEntry.nCopyMask);
+                uchar* pOutput = pResult+(j+k)*3;
+                pOutput[0] = uchar(oEntry.aBGR[0]|nCopy);
+                pOutput[1] = uchar(oEntry.aBGR[1]|nCopy);
+                pOutput[2] = uchar(oEntry.aBGR[2]|nCopy);
+            }
+        }
+        return j;
+    }
+#endif //HAVE_SIMD_DISPATCH
+
+    /// writes the colored mask pixels of a full row in a single pass (keys are vectorized for the simd level picked at runtime, then resolved via the LUT)
+    inline void colorizeRow(const uchar* pClassif, const uchar* pGT, const uchar* pROI, size_t nCols, uchar* pResult) {
+        const std::array<ColoredMaskEntry,nColoredMaskKeysCount>& aLUT = getColoredMaskLUT();
+        const std::array<uchar,UCHAR_MAX+1>& aGTLUT = getColoredMaskGTLUT();
+        size_t j = 0;
+#if HAVE_SIMD_DISPATCH
+        if(lv::getSIMDLevel()>=lv::SIMDLevel_SSE2)
+            j = colorizeRow_sse2(pClassif,pGT,pROI,nCols,pResult);
+#endif //HAVE_SIMD_DISPATCH
+        for(; j<nCols; ++j) {
+            const uchar nKey = (pROI && pROI[j]==DATASETUTILS_NEGATIVE_VAL)?uchar(ColoredMaskKey_OutOfROI):uchar(aGTLUT[pGT[j]]|uchar(pClassif[j]==DATASETUTILS_POSITIVE_VAL));
+            const ColoredMaskEntry& oEntry = aLUT[nKey];
+            const uchar nCopy = uchar(pClassif[j]&oEntry.nCopyMask);
+            uchar* pOutput = pResult+j*3;
+            pOutput[0] = uchar(oEntry.aBGR[0]|nCopy);
+            pOutput[1] = uchar(oEntry.aBGR[1]|nCopy);
+            pOutput[2] = uchar(oEntry.aBGR[2]|nCopy);
+        }
+    }
+
+} // anonymous namespace
+
 void lv::BinClassif::accumulate(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI) {
     lvAssert_(!oClassif.empty() && oClassif.type()==CV_8UC1,"binary classifier results must be non-empty and of type 8UC1");
     lvAssert_(oGT.empty() || oGT.type()==CV_8UC1,"gt mat must be empty, or of type 8UC1")
@@ -27,37 +308,39 @@ void lv::BinClassif::accumulate(const cv::Mat& oClassif, const cv::Mat& oGT, con
         nDC += oClassif.size().area();
         return;
     }
-    const size_t step_row = oClassif.step.p[0];
-    for(size_t i = 0; i<(size_t)oClassif.rows; ++i) {
-        const size_t idx_nstep = step_row*i;
-        const uchar* input_step_ptr = oClassif.data+idx_nstep;
-        const uchar* gt_step_ptr = oGT.data+idx_nstep;
-        const uchar* roi_step_ptr = oROI.data+idx_nstep;
-        for(int j = 0; j<oClassif.cols; ++j) {
-            if(gt_step_ptr[j]!=DATASETUTILS_OUTOFSCOPE_VAL &&
-               gt_step_ptr[j]!=DATASETUTILS_UNKNOWN_VAL &&
-               (oROI.empty() || roi_step_ptr[j]!=DATASETUTILS_NEGATIVE_VAL)) {
-                if(input_step_ptr[j]==DATASETUTILS_POSITIVE_VAL) {
-                    if(gt_step_ptr[j]==DATASETUTILS_POSITIVE_VAL)
-                        ++nTP;
-                    else // gt_step_ptr[j]==s_nSegmNegative
-                        ++nFP;
-                }
-                else { // input_step_ptr[j]==s_nSegmNegative
-                    if(gt_step_ptr[j]==DATASETUTILS_POSITIVE_VAL)
-                        ++nFN;
-                    else // gt_step_ptr[j]==s_nSegmNegative
-                        ++nTN;
-                }
-                if(gt_step_ptr[j]==DATASETUTILS_SHADOW_VAL) {
-                    if(input_step_ptr[j]==DATASETUTILS_POSITIVE_VAL)
-                        ++nSE;
-                }
-            }
-            else
-                ++nDC;
-        }
+    // single streaming pass over classif/gt/roi; only valid/TP/FP/FN/SE are counted, TN & DC are derived from them
+    uint64_t anCounts[nPartialCountersCount] = {};
+    for(int i=0; i<oClassif.rows; ++i)
+        accumulateRow(oClassif.ptr<uchar>(i),oGT.ptr<uchar>(i),oROI.empty()?nullptr:oROI.ptr<uchar>(i),(size_t)oClassif.cols,anCounts);
+    nTP += anCounts[PartialCounter_TP];
+    nFP += anCounts[PartialCounter_FP];
+    nFN += anCounts[PartialCounter_FN];
+    nTN += anCounts[PartialCounter_Valid]-anCounts[PartialCounter_TP]-anCounts[PartialCounter_FP]-anCounts[PartialCounter_FN];
+    nSE += anCounts[PartialCounter_SE];
+    nDC += uint64_t(oClassif.size().area())-anCounts[PartialCounter_Valid];
+}
+
+void lv::BinClassif::accumulate(const cv::Mat& oClassif, const PackedLabels& oGT, const cv::Mat& oROI) {
+    lvAssert_(!oClassif.empty() && oClassif.type()==CV_8UC1,"binary classifier results must be non-empty and of type 8UC1");
+    lvAssert_(oROI.empty() || oROI.type()==CV_8UC1,"ROI mat must be empty, or of type 8UC1");
+    lvAssert_((oGT.empty() || oClassif.size()==oGT.oSize) && (oROI.empty() || oClassif.size()==oROI.size()),"all input mat sizes must match");
+    if(oGT.empty()) {
+        nDC += oClassif.size().area();
+        return;
     }
+    // gt rows are unpacked one at a time into a small (usually stack-based) buffer, and then go through the same row counter as regular gt mats
+    cv::AutoBuffer<uchar,4096> acGTRow((size_t)oClassif.cols);
+    uint64_t anCounts[nPartialCountersCount] = {};
+    for(int i=0; i<oClassif.rows; ++i) {
+        oGT.unpackRow(i,acGTRow);
+        accumulateRow(oClassif.ptr<uchar>(i),acGTRow,oROI.empty()?nullptr:oROI.ptr<uchar>(i),(size_t)oClassif.cols,anCounts);
+    }
+    nTP += anCounts[PartialCounter_TP];
+    nFP += anCounts[PartialCounter_FP];
+    nFN += anCounts[PartialCounter_FN];
+    nTN += anCounts[PartialCounter_Valid]-anCounts[PartialCounter_TP]-anCounts[PartialCounter_FP]-anCounts[PartialCounter_FN];
+    nSE += anCounts[PartialCounter_SE];
+    nDC += uint64_t(oClassif.size().area())-anCounts[PartialCounter_Valid];
 }
 
 cv::Mat lv::BinClassif::getColoredMask(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI) {
@@ -70,49 +353,10 @@ cv::Mat lv::BinClassif::getColoredMask(const cv::Mat& oClassif, const cv::Mat& o
         cv::cvtColor(oClassif,oResult,cv::COLOR_GRAY2BGR);
         return oResult;
     }
-    cv::Mat oResult(oClassif.size(),CV_8UC3,cv::Scalar_<uchar>(0));
-    const size_t step_row = oClassif.step.p[0];
-    for(size_t i=0; i<(size_t)oClassif.rows; ++i) {
-        const size_t idx_nstep = step_row*i;
-        const uchar* input_step_ptr = oClassif.data+idx_nstep;
-        const uchar* gt_step_ptr = oGT.data+idx_nstep;
-        const uchar* roi_step_ptr = oROI.data+idx_nstep;
-        uchar* res_step_ptr = oResult.data+idx_nstep*3;
-        for(int j=0; j<oClassif.cols; ++j) {
-            if(gt_step_ptr[j]!=DATASETUTILS_OUTOFSCOPE_VAL &&
-               gt_step_ptr[j]!=DATASETUTILS_UNKNOWN_VAL &&
-               (oROI.empty() || roi_step_ptr[j]!=DATASETUTILS_NEGATIVE_VAL)) {
-                if(input_step_ptr[j]==DATASETUTILS_POSITIVE_VAL) {
-                    if(gt_step_ptr[j]==DATASETUTILS_POSITIVE_VAL)
-                        res_step_ptr[j*3+1] = UCHAR_MAX;
-                    else if(gt_step_ptr[j]==DATASETUTILS_NEGATIVE_VAL)
-                        res_step_ptr[j*3+2] = UCHAR_MAX;
-                    else if(gt_step_ptr[j]==DATASETUTILS_SHADOW_VAL) {
-                        res_step_ptr[j*3+1] = UCHAR_MAX/2;
-                        res_step_ptr[j*3+2] = UCHAR_MAX;
-                    }
-                    else {
-                        for(size_t c=0; c<3; ++c)
-                            res_step_ptr[j*3+c] = UCHAR_MAX/3;
-                    }
-                }
-                else { // input_step_ptr[j]==s_nSegmNegative
-                    if(gt_step_ptr[j]==DATASETUTILS_POSITIVE_VAL) {
-                        res_step_ptr[j*3] = UCHAR_MAX/2;
-                        res_step_ptr[j*3+2] = UCHAR_MAX;
-                    }
-                }
-            }
-            else if(!oROI.empty() && roi_step_ptr[j]==DATASETUTILS_NEGATIVE_VAL) {
-                for(size_t c=0; c<3; ++c)
-                    res_step_ptr[j*3+c] = UCHAR_MAX/2;
-            }
-            else {
-                for(size_t c=0; c<3; ++c)
-                    res_step_ptr[j*3+c] = input_step_ptr[j];
-            }
-        }
-    }
+    // every output pixel is written by the row colorizer, no need to zero-init
+    cv::Mat oResult(oClassif.size(),CV_8UC3);
+    for(int i=0; i<oClassif.rows; ++i)
+        colorizeRow(oClassif.ptr<uchar>(i),oGT.ptr<uchar>(i),oROI.empty()?nullptr:oROI.ptr<uchar>(i),(size_t)oClassif.cols,oResult.ptr<uchar>(i));
     return oResult;
 }
 
@@ -120,6 +364,81 @@ cv::Mat lv::BinClassif::getColoredMask(const cv::Mat& oClassif, const cv::Mat& o
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+    // log layout: 4-byte magic & 4-byte version, followed by fixed-size records of eight 8-byte fields (idx, timestamp, tp, tn, fp, fn, se, dc)
+    constexpr char s_acBinClassifLogMagic[4] = {'L','V','B','C'};
+    constexpr uint32_t s_nBinClassifLogVersion = 1;
+    constexpr size_t s_nBinClassifLogHeaderSize = sizeof(s_acBinClassifLogMagic)+sizeof(s_nBinClassifLogVersion);
+    constexpr size_t s_nBinClassifLogRecordSize = sizeof(uint64_t)*8;
+
+} // anonymous namespace
+
+lv::BinClassifLogWriter::BinClassifLogWriter(const std::string& sFilePath, bool bAppend, size_t nFlushPeriod) :
+        m_oLogFile(sFilePath,std::ios::out|std::ios::binary|(bAppend?std::ios::app:std::ios::trunc)),
+        m_nFlushPeriod(std::max(nFlushPeriod,size_t(1))),
+        m_nPendingRecords(0) {
+    lvAssert_(m_oLogFile.is_open(),"could not open binary classification log file for writing");
+    m_oLogFile.seekp(0,std::ios::end);
+    if(m_oLogFile.tellp()==std::streampos(0)) {
+        m_oLogFile.write(s_acBinClassifLogMagic,sizeof(s_acBinClassifLogMagic));
+        m_oLogFile.write((const char*)&s_nBinClassifLogVersion,sizeof(s_nBinClassifLogVersion));
+        m_oLogFile.flush();
+    }
+}
+
+void lv::BinClassifLogWriter::write(const BinClassifLogRecord& oRecord) {
+    uint64_t anFields[8] = {
+        oRecord.nIdx,0,
+        oRecord.oCounters.nTP,oRecord.oCounters.nTN,oRecord.oCounters.nFP,oRecord.oCounters.nFN,oRecord.oCounters.nSE,oRecord.oCounters.nDC
+    };
+    static_assert(sizeof(anFields)==s_nBinClassifLogRecordSize && sizeof(double)==sizeof(uint64_t),"bad log record size");
+    std::memcpy(&anFields[1],&oRecord.dTimestamp_sec,sizeof(double));
+    m_oLogFile.write((const char*)anFields,s_nBinClassifLogRecordSize);
+    if(++m_nPendingRecords>=m_nFlushPeriod)
+        flush();
+}
+
+void lv::BinClassifLogWriter::flush() {
+    m_oLogFile.flush();
+    m_nPendingRecords = 0;
+}
+
+lv::BinClassifLogReader::BinClassifLogReader(const std::string& sFilePath) :
+        m_oLogFile(sFilePath,std::ios::in|std::ios::binary) {
+    lvAssert_(m_oLogFile.is_open(),"could not open binary classification log file for reading");
+    char acMagic[sizeof(s_acBinClassifLogMagic)];
+    uint32_t nVersion = 0;
+    m_oLogFile.read(acMagic,sizeof(acMagic));
+    m_oLogFile.read((char*)&nVersion,sizeof(nVersion));
+    lvAssert_(m_oLogFile.good() && std::equal(acMagic,acMagic+sizeof(acMagic),s_acBinClassifLogMagic),"bad binary classification log file header");
+    lvAssert_(nVersion==s_nBinClassifLogVersion,"unsupported binary classification log file version");
+}
+
+bool lv::BinClassifLogReader::read(BinClassifLogRecord& oRecord) {
+    const std::streampos nRecordPos = m_oLogFile.tellg();
+    uint64_t anFields[8];
+    if(!m_oLogFile.read((char*)anFields,s_nBinClassifLogRecordSize)) {
+        // incomplete trailing record (e.g. still being written); rewind so it can be read again later
+        m_oLogFile.clear();
+        m_oLogFile.seekg(nRecordPos);
+        return false;
+    }
+    oRecord.nIdx = anFields[0];
+    std::memcpy(&oRecord.dTimestamp_sec,&anFields[1],sizeof(double));
+    oRecord.oCounters.nTP = anFields[2];
+    oRecord.oCounters.nTN = anFields[3];
+    oRecord.oCounters.nFP = anFields[4];
+    oRecord.oCounters.nFN = anFields[5];
+    oRecord.oCounters.nSE = anFields[6];
+    oRecord.oCounters.nDC = anFields[7];
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool lv::IMetricsAccumulator_<lv::DatasetEval_BinaryClassifier>::isEqual(const IIMetricsAccumulatorConstPtr& m) const {
     const auto& m2 = dynamic_cast<const IMetricsAccumulator_<lv::DatasetEval_BinaryClassifier>&>(*m.get());
     return this->m_oCounters.isEqual(m2.m_oCounters);
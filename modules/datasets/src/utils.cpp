@@ -17,6 +17,7 @@
 
 #include <litiv/datasets/utils.hpp>
 #include "litiv/datasets/utils.hpp"
+#include <random>
 
 #define HARDCODE_IMAGE_PACKET_INDEX        0 // for sync debug only! will corrupt data for non-image packets
 #define CONSOLE_DEBUG                      0
@@ -24,6 +25,19 @@
 #define PRECACHE_QUERY_TIMEOUT_MS          10
 #define PRECACHE_QUERY_END_TIMEOUT_MS      500
 #define PRECACHE_REFILL_TIMEOUT_MS         10000
+#define VIDEODECODER_QUERY_TIMEOUT_MS      10
+#define DATAWRITER_QUERY_TIMEOUT_MS        10
+#define DATAWRITER_CLEAR_TIMEOUT_MS        1
+#define DATAWRITER_SLOT_COUNT              size_t(256) // must be a power of two
+#define DATAWRITER_REORDER_WINDOW_SIZE     size_t(32) // max number of packets held back while waiting for a lower packet index
+#define DATAARCHIVER_FAST_PNG_COMPRESSION  1
+#define DATAARCHIVER_CONTAINER_NAME        "packets.rle"
+#define VIDEODECODER_QUEUE_SIZE            16
+#define VIDEODECODER_SEEK_INDEX_STRIDE     32
+#define VIDEODECODER_MAX_FORWARD_DECODE    64
+#define GTCACHE_ENABLED                    1
+#define GTCACHE_DIR_NAME                   "gtcache" // created in the dataset dir (shared by all runs), or in the user cache dir if the former is read-only
+#define GTCACHE_FILE_SUFFIX                ".lvgt"
 #if (!(defined(_M_X64) || defined(__amd64__)) && CACHE_MAX_SIZE_GB>2)
 #error "Cache max size exceeds system limit (x86)."
 #endif //(!(defined(_M_X64) || defined(__amd64__)) && CACHE_MAX_SIZE_GB>2)
@@ -94,8 +108,11 @@ lv::IDataHandlerPtrArray lv::IGroupDataParser::getBatches(bool bWithHierarchy) c
 }
 
 void lv::IGroupDataParser::startPrecaching(bool bPrecacheGT, size_t nSuggestedBufferSize) {
-    for(const auto& pBatch : getBatches(true))
-        pBatch->startPrecaching(bPrecacheGT,nSuggestedBufferSize);
+    const IDataHandlerPtrArray vpBatches = getBatches(true);
+    // an explicit buffer size is a budget for the whole group, so it is split between its children
+    const size_t nBatchBufferSize = (nSuggestedBufferSize==SIZE_MAX || vpBatches.empty())?nSuggestedBufferSize:nSuggestedBufferSize/vpBatches.size();
+    for(const auto& pBatch : vpBatches)
+        pBatch->startPrecaching(bPrecacheGT,nBatchBufferSize);
 }
 
 void lv::IGroupDataParser::stopPrecaching() {
@@ -331,6 +348,453 @@ void lv::DataPrecacher::entry(const size_t nBufferSize) {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+lv::VideoDecoder::VideoDecoder() :
+        m_nFrameCount(0),m_nNextGrabIdx(0),m_nLastGrabIdx(size_t(-1)),m_nQueueMaxCount(0),m_nReqIdx(0),m_nNextQueueIdx(0) {
+    m_bIsActive = false;
+}
+
+lv::VideoDecoder::~VideoDecoder() {
+    stopAsyncDecoding();
+}
+
+bool lv::VideoDecoder::open(const std::string& sFilePath, bool bBuildSeekIndex) {
+    release();
+    if(!m_oReader.open(sFilePath))
+        return false;
+    m_nFrameCount = (size_t)std::max(m_oReader.get(cv::CAP_PROP_FRAME_COUNT),0.0);
+    if(bBuildSeekIndex) {
+        // container frame counts are often approximated, so we count grabs instead (no retrieval = no color conversion)
+        size_t nScannedFrameCount = 0;
+        while(m_oReader.grab()) {
+            if((nScannedFrameCount%VIDEODECODER_SEEK_INDEX_STRIDE)==0)
+                m_vdSeekIndexTimestamps.push_back(m_oReader.get(cv::CAP_PROP_POS_MSEC));
+            ++nScannedFrameCount;
+        }
+#if CONSOLE_DEBUG
+        std::cout << "video decoder [" << uintptr_t(this) << "] scanned " << nScannedFrameCount << " frames (container reported " << m_nFrameCount << ")" << std::endl;
+#endif //CONSOLE_DEBUG
+        m_nFrameCount = nScannedFrameCount;
+        m_oReader.release();
+        if(!m_oReader.open(sFilePath))
+            return false;
+    }
+    m_nNextGrabIdx = 0;
+    m_nLastGrabIdx = size_t(-1);
+    return m_nFrameCount>0;
+}
+
+void lv::VideoDecoder::release() {
+    stopAsyncDecoding();
+    m_oReader.release();
+    m_vdSeekIndexTimestamps.clear();
+    m_nFrameCount = 0;
+    m_nNextGrabIdx = 0;
+    m_nLastGrabIdx = size_t(-1);
+}
+
+cv::Mat lv::VideoDecoder::getFrame(size_t nIdx) {
+    if(nIdx>=m_nFrameCount)
+        return cv::Mat();
+    if(!m_bIsActive) {
+        cv::Mat oFrame;
+        if(!isReachable(nIdx))
+            seek(nIdx);
+        decode(nIdx,oFrame);
+        return oFrame;
+    }
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    m_nReqIdx = nIdx;
+    while(!m_qoFrames.empty() && m_qoFrames.front().first<nIdx)
+        m_qoFrames.pop_front();
+    if((!m_qoFrames.empty() && m_qoFrames.front().first>nIdx) || (m_qoFrames.empty() && m_nNextQueueIdx>nIdx)) {
+#if CONSOLE_DEBUG
+        std::cout << "video decoder [" << uintptr_t(this) << "] out-of-order request, destroying queue" << std::endl;
+#endif //CONSOLE_DEBUG
+        m_qoFrames.clear();
+        m_nNextQueueIdx = nIdx;
+    }
+    m_oSpaceCondVar.notify_one();
+    m_oFrameCondVar.wait(sync_lock,[&]{return !m_bIsActive || (!m_qoFrames.empty() && m_qoFrames.front().first==nIdx);});
+    if(m_qoFrames.empty() || m_qoFrames.front().first!=nIdx)
+        return cv::Mat();
+    // frame is kept in the queue until a later index is requested, so that duplicate requests do not trigger a seek
+    return m_qoFrames.front().second;
+}
+
+bool lv::VideoDecoder::startAsyncDecoding(size_t nQueueSize) {
+    if(m_bIsActive)
+        stopAsyncDecoding();
+    if(nQueueSize>0 && m_oReader.isOpened()) {
+        m_bIsActive = true;
+        m_nQueueMaxCount = nQueueSize;
+        m_nReqIdx = m_nNextQueueIdx = 0;
+        m_qoFrames.clear();
+        m_hWorker = std::thread(&VideoDecoder::entry,this);
+    }
+    return m_bIsActive;
+}
+
+void lv::VideoDecoder::stopAsyncDecoding() {
+    if(m_bIsActive) {
+        {
+            std::mutex_lock_guard sync_lock(m_oSyncMutex);
+            m_bIsActive = false;
+        }
+        m_oSpaceCondVar.notify_all();
+        m_oFrameCondVar.notify_all();
+        m_hWorker.join();
+        m_qoFrames.clear();
+    }
+}
+
+void lv::VideoDecoder::entry() {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+#if CONSOLE_DEBUG
+    std::cout << "video decoder [" << uintptr_t(this) << "] init w/ max queue size = " << m_nQueueMaxCount << " frames" << std::endl;
+#endif //CONSOLE_DEBUG
+    while(m_bIsActive) {
+        if(m_nNextQueueIdx<m_nReqIdx)
+            m_nNextQueueIdx = m_nReqIdx; // consumer skipped ahead; frames in-between will only be grabbed
+        if(m_qoFrames.size()>=m_nQueueMaxCount || m_nNextQueueIdx>=m_nFrameCount) {
+            m_oSpaceCondVar.wait_for(sync_lock,std::chrono::milliseconds(VIDEODECODER_QUERY_TIMEOUT_MS));
+            continue;
+        }
+        const size_t nDecodeIdx = m_nNextQueueIdx;
+        cv::Mat oFrame;
+        {
+            // the reader itself is only ever touched by this thread while decoding is active
+            std::unlock_guard<std::mutex_unique_lock> oUnlock(sync_lock);
+            if(!isReachable(nDecodeIdx))
+                seek(nDecodeIdx);
+            if(!decode(nDecodeIdx,oFrame))
+                oFrame = cv::Mat(); // will be forwarded as-is, same as a failed sequential read
+        }
+        if(nDecodeIdx==m_nNextQueueIdx) { // otherwise, consumer requested a jump back while we were decoding
+            if(nDecodeIdx>=m_nReqIdx) { // otherwise, consumer skipped past this frame while we were decoding
+                m_qoFrames.emplace_back(nDecodeIdx,oFrame);
+                m_oFrameCondVar.notify_one();
+            }
+            ++m_nNextQueueIdx;
+        }
+    }
+}
+
+bool lv::VideoDecoder::isReachable(size_t nIdx) const {
+    return nIdx==m_nLastGrabIdx || (nIdx>=m_nNextGrabIdx && nIdx-m_nNextGrabIdx<VIDEODECODER_MAX_FORWARD_DECODE);
+}
+
+void lv::VideoDecoder::seek(size_t nIdx) {
+    m_nLastGrabIdx = size_t(-1);
+    if(!m_vdSeekIndexTimestamps.empty()) {
+        const size_t nSeekPointIdx = std::min(nIdx/VIDEODECODER_SEEK_INDEX_STRIDE,m_vdSeekIndexTimestamps.size()-1);
+        const double dSeekTimestamp = m_vdSeekIndexTimestamps[nSeekPointIdx];
+        const double dFPS = m_oReader.get(cv::CAP_PROP_FPS);
+        const double dTimestampTolerance = dFPS>0?500.0/dFPS:1.0; // half a frame
+        // landing is validated via the timestamp recorded during the initial scan, as not all backends seek accurately
+        if(m_oReader.set(cv::CAP_PROP_POS_MSEC,dSeekTimestamp) && m_oReader.grab() && std::abs(m_oReader.get(cv::CAP_PROP_POS_MSEC)-dSeekTimestamp)<=dTimestampTolerance) {
+            m_nLastGrabIdx = nSeekPointIdx*VIDEODECODER_SEEK_INDEX_STRIDE;
+            m_nNextGrabIdx = m_nLastGrabIdx+1;
+            return;
+        }
+#if CONSOLE_DEBUG
+        std::cout << "video decoder [" << uintptr_t(this) << "] seek index lookup failed for frame #" << nIdx << ", falling back to frame-based seek" << std::endl;
+#endif //CONSOLE_DEBUG
+    }
+    m_oReader.set(cv::CAP_PROP_POS_FRAMES,(double)nIdx);
+    m_nNextGrabIdx = nIdx;
+}
+
+bool lv::VideoDecoder::decode(size_t nIdx, cv::Mat& oFrame, bool bRetrieve) {
+    lvDbgAssert(nIdx==m_nLastGrabIdx || nIdx>=m_nNextGrabIdx);
+    while(m_nLastGrabIdx!=nIdx) {
+        if(!m_oReader.grab()) {
+            m_nLastGrabIdx = size_t(-1);
+            return false;
+        }
+        m_nLastGrabIdx = m_nNextGrabIdx++;
+    }
+    return !bRetrieve || m_oReader.retrieve(oFrame);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+    /// packed label chunk header (each chunk then holds 'nBitsPerLabel' bytes per group of 8 labels, w/ groups padded at the end of each row)
+    struct PackedLabelChunkHeader {
+        uint64_t nIdx;
+        int32_t nRows,nCols;
+        uint8_t nBitsPerLabel,nPaletteSize;
+        std::array<uchar,8> anPalette;
+    };
+
+    /// cache header magic & version (followed by [packet count:u64][scale factor:f64][source key:u64], then by chunks, in native byte order)
+    const std::array<char,4> g_acLabelCacheMagic = {'L','V','G','T'};
+    const uint32_t g_nLabelCacheVersion = 2;
+
+    /// folds the path, size & last write time of the given files into a (fnv-1a) key; returns 0 if any file cannot be stat'd
+    uint64_t getFileListKey(const std::vector<std::string>& vsFilePaths, uint64_t nKey=14695981039346656037ull) {
+        const auto lFold = [&](const void* pData, size_t nBytes) {
+            for(size_t nByteIdx=0; nByteIdx<nBytes; ++nByteIdx)
+                nKey = (nKey^((const uchar*)pData)[nByteIdx])*1099511628211ull;
+        };
+        for(const std::string& sFilePath : vsFilePaths) {
+            size_t nFileSize;
+            int64_t nLastWriteTime;
+            if(!lv::GetFileInfo(sFilePath,nFileSize,nLastWriteTime))
+                return 0;
+            const uint64_t nFileSize64 = nFileSize;
+            lFold(sFilePath.data(),sFilePath.size());
+            lFold(&nFileSize64,sizeof(nFileSize64));
+            lFold(&nLastWriteTime,sizeof(nLastWriteTime));
+        }
+        return nKey?nKey:1;
+    }
+
+    /// returns the packed payload size of a label image w/ the given dimensions
+    inline size_t getPackedLabelPayloadSize(int nRows, int nCols, int nBitsPerLabel) {
+        return size_t(nRows)*size_t((nCols+7)/8)*size_t(nBitsPerLabel);
+    }
+
+    /// reads a packed label chunk header from the stream (returns false on failure)
+    bool readPackedLabelChunkHeader(std::istream& oStream, PackedLabelChunkHeader& oHeader) {
+        oStream.read((char*)&oHeader.nIdx,sizeof(oHeader.nIdx));
+        oStream.read((char*)&oHeader.nRows,sizeof(oHeader.nRows));
+        oStream.read((char*)&oHeader.nCols,sizeof(oHeader.nCols));
+        oStream.read((char*)&oHeader.nBitsPerLabel,sizeof(oHeader.nBitsPerLabel));
+        oStream.read((char*)&oHeader.nPaletteSize,sizeof(oHeader.nPaletteSize));
+        oStream.read((char*)oHeader.anPalette.data(),oHeader.anPalette.size());
+        return oStream.good() && oHeader.nRows>=0 && oHeader.nCols>=0 && oHeader.nBitsPerLabel<=3 && oHeader.nPaletteSize<=oHeader.anPalette.size();
+    }
+
+    /// writes a packed label chunk header to the stream
+    void writePackedLabelChunkHeader(std::ostream& oStream, const PackedLabelChunkHeader& oHeader) {
+        oStream.write((const char*)&oHeader.nIdx,sizeof(oHeader.nIdx));
+        oStream.write((const char*)&oHeader.nRows,sizeof(oHeader.nRows));
+        oStream.write((const char*)&oHeader.nCols,sizeof(oHeader.nCols));
+        oStream.write((const char*)&oHeader.nBitsPerLabel,sizeof(oHeader.nBitsPerLabel));
+        oStream.write((const char*)&oHeader.nPaletteSize,sizeof(oHeader.nPaletteSize));
+        oStream.write((const char*)oHeader.anPalette.data(),oHeader.anPalette.size());
+    }
+
+} // anonymous namespace
+
+lv::PackedLabels::PackedLabels() :
+        nBitsPerLabel(0),nPaletteSize(0) {
+    anPalette.fill(0);
+}
+
+bool lv::PackedLabels::pack(const cv::Mat& oLabels) {
+    if(oLabels.type()!=CV_8UC1)
+        return false;
+    std::array<uchar,256> anLUT;
+    anLUT.fill(UCHAR_MAX);
+    nPaletteSize = 0;
+    anPalette.fill(0);
+    for(int nRowIdx=0; nRowIdx<oLabels.rows; ++nRowIdx) {
+        const uchar* pRow = oLabels.ptr<uchar>(nRowIdx);
+        for(int nColIdx=0; nColIdx<oLabels.cols; ++nColIdx) {
+            if(anLUT[pRow[nColIdx]]==UCHAR_MAX) {
+                if(nPaletteSize==(int)anPalette.size())
+                    return false;
+                anPalette[nPaletteSize] = pRow[nColIdx];
+                anLUT[pRow[nColIdx]] = uchar(nPaletteSize++);
+            }
+        }
+    }
+    oSize = oLabels.size();
+    nBitsPerLabel = nPaletteSize<=2?1:nPaletteSize<=4?2:3;
+    vcPayload.resize(getPackedLabelPayloadSize(oSize.height,oSize.width,nBitsPerLabel));
+    uchar* pPayload = vcPayload.data();
+    for(int nRowIdx=0; nRowIdx<oLabels.rows; ++nRowIdx) {
+        const uchar* pRow = oLabels.ptr<uchar>(nRowIdx);
+        for(int nColIdx=0; nColIdx<oLabels.cols; nColIdx+=8) {
+            const int nGroupSize = std::min(8,oLabels.cols-nColIdx);
+            uint32_t nGroup = 0;
+            for(int nLabelIdx=0; nLabelIdx<nGroupSize; ++nLabelIdx)
+                nGroup |= uint32_t(anLUT[pRow[nColIdx+nLabelIdx]])<<(nLabelIdx*nBitsPerLabel);
+            for(int nByteIdx=0; nByteIdx<nBitsPerLabel; ++nByteIdx)
+                *pPayload++ = uchar(nGroup>>(nByteIdx*8));
+        }
+    }
+    return true;
+}
+
+void lv::PackedLabels::unpackRow(int nRowIdx, uchar* pRow) const {
+    lvDbgAssert(nRowIdx>=0 && nRowIdx<oSize.height && pRow);
+    lvDbgAssert(vcPayload.size()==getPackedLabelPayloadSize(oSize.height,oSize.width,nBitsPerLabel));
+    const uint32_t nLabelMask = (1u<<nBitsPerLabel)-1;
+    const uchar* pPayload = vcPayload.data()+getRowStep()*size_t(nRowIdx);
+    for(int nColIdx=0; nColIdx<oSize.width; nColIdx+=8) {
+        uint32_t nGroup = 0;
+        for(int nByteIdx=0; nByteIdx<nBitsPerLabel; ++nByteIdx)
+            nGroup |= uint32_t(*pPayload++)<<(nByteIdx*8);
+        const int nGroupSize = std::min(8,oSize.width-nColIdx);
+        for(int nLabelIdx=0; nLabelIdx<nGroupSize; ++nLabelIdx)
+            pRow[nColIdx+nLabelIdx] = anPalette[(nGroup>>(nLabelIdx*nBitsPerLabel))&nLabelMask];
+    }
+}
+
+void lv::PackedLabels::unpack(cv::Mat& oLabels) const {
+    if(empty()) {
+        oLabels = cv::Mat();
+        return;
+    }
+    lvAssert_(vcPayload.size()==getPackedLabelPayloadSize(oSize.height,oSize.width,nBitsPerLabel),"corrupted packed label payload (bad size)");
+    oLabels.create(oSize,CV_8UC1);
+    for(int nRowIdx=0; nRowIdx<oSize.height; ++nRowIdx)
+        unpackRow(nRowIdx,oLabels.ptr<uchar>(nRowIdx));
+}
+
+lv::PackedLabelCache::PackedLabelCache() :
+        m_nPacketCount(0),m_dScaleFactor(1.0),m_nSourceKey(0),m_bIsReadable(false),m_nChunkCount(0) {}
+
+lv::PackedLabelCache::~PackedLabelCache() {
+    release();
+}
+
+bool lv::PackedLabelCache::open(const std::string& sFilePath, size_t nPacketCount, double dScaleFactor, uint64_t nSourceKey) {
+    release();
+    lvAssert_(!sFilePath.empty() && nPacketCount>0,"bad packed label cache parameters");
+    m_sFilePath = sFilePath;
+    m_nPacketCount = nPacketCount;
+    m_dScaleFactor = dScaleFactor;
+    m_nSourceKey = nSourceKey;
+    m_vnChunkOffsets.assign(nPacketCount,std::streamoff(-1));
+    m_nChunkCount = 0;
+    m_oReadStream.open(sFilePath,std::ios::in|std::ios::binary);
+    if(m_oReadStream.is_open()) { // file was committed by a previous instance; scan chunk headers once to build the index
+        std::array<char,4> acMagic;
+        uint32_t nVersion;
+        uint64_t nFilePacketCount;
+        double dFileScaleFactor;
+        uint64_t nFileSourceKey;
+        m_oReadStream.read(acMagic.data(),acMagic.size());
+        m_oReadStream.read((char*)&nVersion,sizeof(nVersion));
+        m_oReadStream.read((char*)&nFilePacketCount,sizeof(nFilePacketCount));
+        m_oReadStream.read((char*)&dFileScaleFactor,sizeof(dFileScaleFactor));
+        m_oReadStream.read((char*)&nFileSourceKey,sizeof(nFileSourceKey));
+        if(m_oReadStream.good() && acMagic==g_acLabelCacheMagic && nVersion==g_nLabelCacheVersion && nFilePacketCount==nPacketCount && dFileScaleFactor==dScaleFactor && nFileSourceKey==nSourceKey) {
+            PackedLabelChunkHeader oHeader;
+            while(true) {
+                const std::streamoff nChunkOffset = m_oReadStream.tellg();
+                if(!readPackedLabelChunkHeader(m_oReadStream,oHeader) || oHeader.nIdx>=nPacketCount)
+                    break;
+                if(m_vnChunkOffsets[(size_t)oHeader.nIdx]<0)
+                    ++m_nChunkCount;
+                m_vnChunkOffsets[(size_t)oHeader.nIdx] = nChunkOffset;
+                m_oReadStream.seekg((std::streamoff)getPackedLabelPayloadSize(oHeader.nRows,oHeader.nCols,oHeader.nBitsPerLabel),std::ios::cur);
+            }
+            m_oReadStream.clear();
+        }
+        m_bIsReadable = (m_nChunkCount==nPacketCount);
+        if(m_bIsReadable)
+            return true;
+        m_oReadStream.close(); // stale or corrupted cache file; it will be overwritten once the new one is complete
+        m_vnChunkOffsets.assign(nPacketCount,std::streamoff(-1));
+        m_nChunkCount = 0;
+    }
+    // packets are written to a uniquely named temp file, and renamed once complete so that concurrent readers only ever see full caches
+    std::stringstream ssTempFilePath;
+    ssTempFilePath << sFilePath << ".tmp" << std::hex << std::random_device()();
+    m_sTempFilePath = ssTempFilePath.str();
+    m_oWriteStream.open(m_sTempFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+    if(!m_oWriteStream.is_open())
+        return false;
+    const uint64_t nFilePacketCount = nPacketCount;
+    m_oWriteStream.write(g_acLabelCacheMagic.data(),g_acLabelCacheMagic.size());
+    m_oWriteStream.write((const char*)&g_nLabelCacheVersion,sizeof(g_nLabelCacheVersion));
+    m_oWriteStream.write((const char*)&nFilePacketCount,sizeof(nFilePacketCount));
+    m_oWriteStream.write((const char*)&dScaleFactor,sizeof(dScaleFactor));
+    m_oWriteStream.write((const char*)&nSourceKey,sizeof(nSourceKey));
+    return m_oWriteStream.good();
+}
+
+void lv::PackedLabelCache::release() {
+    m_bIsReadable = false;
+    if(m_oReadStream.is_open())
+        m_oReadStream.close();
+    if(m_oWriteStream.is_open()) {
+        m_oWriteStream.close();
+        std::remove(m_sTempFilePath.c_str());
+    }
+    m_vnChunkOffsets.clear();
+    m_nChunkCount = 0;
+}
+
+bool lv::PackedLabelCache::getPacket(size_t nIdx, cv::Mat& oPacket) {
+    if(!getPacket(nIdx,m_oPackedLabels))
+        return false;
+    m_oPackedLabels.unpack(oPacket);
+    return true;
+}
+
+bool lv::PackedLabelCache::getPacket(size_t nIdx, PackedLabels& oPacket) {
+    if(!m_bIsReadable || nIdx>=m_nPacketCount || m_vnChunkOffsets[nIdx]<0)
+        return false;
+    m_oReadStream.seekg(m_vnChunkOffsets[nIdx]);
+    PackedLabelChunkHeader oHeader;
+    lvAssert_(readPackedLabelChunkHeader(m_oReadStream,oHeader) && oHeader.nIdx==nIdx,"bad packed label cache chunk header");
+    if(oHeader.nRows==0 || oHeader.nCols==0) {
+        oPacket.oSize = cv::Size();
+        oPacket.nBitsPerLabel = oPacket.nPaletteSize = 0;
+        oPacket.vcPayload.clear();
+        return true;
+    }
+    oPacket.oSize = cv::Size(oHeader.nCols,oHeader.nRows);
+    oPacket.nBitsPerLabel = oHeader.nBitsPerLabel;
+    oPacket.nPaletteSize = oHeader.nPaletteSize;
+    oPacket.anPalette = oHeader.anPalette;
+    oPacket.vcPayload.resize(getPackedLabelPayloadSize(oHeader.nRows,oHeader.nCols,oHeader.nBitsPerLabel));
+    m_oReadStream.read((char*)oPacket.vcPayload.data(),oPacket.vcPayload.size());
+    lvAssert_(m_oReadStream.good(),"failed to read packet from packed label cache file");
+    return true;
+}
+
+void lv::PackedLabelCache::addPacket(size_t nIdx, const cv::Mat& oPacket) {
+    if(!m_oWriteStream.is_open() || nIdx>=m_nPacketCount || m_vnChunkOffsets[nIdx]>=0)
+        return;
+    PackedLabelChunkHeader oHeader;
+    oHeader.nIdx = nIdx;
+    oHeader.nRows = oHeader.nCols = 0;
+    oHeader.nBitsPerLabel = oHeader.nPaletteSize = 0;
+    oHeader.anPalette.fill(0);
+    m_oPackedLabels.vcPayload.clear();
+    if(!oPacket.empty()) {
+        if(!m_oPackedLabels.pack(oPacket)) {
+            release(); // packets cannot all be packed; caching is pointless for this sequence
+            return;
+        }
+        oHeader.nRows = m_oPackedLabels.oSize.height;
+        oHeader.nCols = m_oPackedLabels.oSize.width;
+        oHeader.nBitsPerLabel = uint8_t(m_oPackedLabels.nBitsPerLabel);
+        oHeader.nPaletteSize = uint8_t(m_oPackedLabels.nPaletteSize);
+        oHeader.anPalette = m_oPackedLabels.anPalette;
+    }
+    m_vnChunkOffsets[nIdx] = m_oWriteStream.tellp();
+    writePackedLabelChunkHeader(m_oWriteStream,oHeader);
+    m_oWriteStream.write((const char*)m_oPackedLabels.vcPayload.data(),m_oPackedLabels.vcPayload.size());
+    if(!m_oWriteStream.good()) {
+        release();
+        return;
+    }
+    if(++m_nChunkCount==m_nPacketCount) {
+        m_oWriteStream.close();
+        if(std::rename(m_sTempFilePath.c_str(),m_sFilePath.c_str())!=0) { // target might already exist on some platforms (e.g. if committed concurrently by another instance)
+            std::remove(m_sFilePath.c_str());
+            if(std::rename(m_sTempFilePath.c_str(),m_sFilePath.c_str())!=0)
+                std::remove(m_sTempFilePath.c_str());
+        }
+        lvIgnore(open(m_sFilePath,m_nPacketCount,m_dScaleFactor,m_nSourceKey));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void lv::IIDataLoader::startPrecaching(bool bPrecacheGT, size_t nSuggestedBufferSize) {
     lvAssert_(m_oInputPrecacher.startAsyncPrecaching(nSuggestedBufferSize),"could not start precaching input packets");
     lvAssert_(!bPrecacheGT || m_oGTPrecacher.startAsyncPrecaching(nSuggestedBufferSize),"could not start precaching gt packets");
@@ -342,11 +806,17 @@ void lv::IIDataLoader::stopPrecaching() {
 }
 
 const cv::Mat& lv::IIDataLoader::getInput(size_t nPacketIdx) {
-    return m_oInputPrecacher.getPacket(nPacketIdx);
+    lv::StopWatch oStopWatch;
+    const cv::Mat& oPacket = m_oInputPrecacher.getPacket(nPacketIdx);
+    m_dIOWaitTime_sec += oStopWatch.tock();
+    return oPacket;
 }
 
 const cv::Mat& lv::IIDataLoader::getGT(size_t nPacketIdx) {
-    return m_oGTPrecacher.getPacket(nPacketIdx);
+    lv::StopWatch oStopWatch;
+    const cv::Mat& oPacket = m_oGTPrecacher.getPacket(nPacketIdx);
+    m_dIOWaitTime_sec += oStopWatch.tock();
+    return oPacket;
 }
 
 const cv::Mat& lv::IIDataLoader::getInputROI(size_t /*nPacketIdx*/) const {
@@ -374,10 +844,77 @@ const cv::Size& lv::IIDataLoader::getGTMaxSize() const {
 }
 
 lv::IIDataLoader::IIDataLoader(PacketPolicy eInputType, PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType) :
+        m_dIOWaitTime_sec(0.0),
+        m_bGTCacheInitialized(false),
         m_oInputPrecacher(std::bind(&IIDataLoader::getInput_redirect,this,std::placeholders::_1)),
         m_oGTPrecacher(std::bind(&IIDataLoader::getGT_redirect,this,std::placeholders::_1)),
         m_eInputType(eInputType),m_eGTType(eGTType),m_eOutputType(eOutputType),m_eGTMappingType(eGTMappingType),m_eIOMappingType(eIOMappingType) {}
 
+bool lv::IIDataLoader::getPackedGT(size_t nPacketIdx, PackedLabels& oPackedGT) {
+#if GTCACHE_ENABLED && !HARDCODE_IMAGE_PACKET_INDEX
+    if(m_eGTType!=ImagePacket)
+        return false;
+    lv::StopWatch oStopWatch;
+    bool bFound;
+    {
+        std::mutex_lock_guard cache_lock(m_oGTCacheMutex);
+        if(!m_bGTCacheInitialized)
+            initGTCache();
+        bFound = m_oGTCache.getPacket(nPacketIdx,oPackedGT);
+    }
+    m_dIOWaitTime_sec += oStopWatch.tock();
+    if(!bFound)
+        return false;
+    const cv::Size& oPacketSize = getGTSize(nPacketIdx);
+    return oPackedGT.empty() || oPacketSize.area()==0 || oPackedGT.oSize==oPacketSize; // packets that need resizing go through the regular path
+#else //!(GTCACHE_ENABLED && !HARDCODE_IMAGE_PACKET_INDEX)
+    lvIgnore(nPacketIdx);
+    lvIgnore(oPackedGT);
+    return false;
+#endif //!(GTCACHE_ENABLED && !HARDCODE_IMAGE_PACKET_INDEX)
+}
+
+void lv::IIDataLoader::initGTCache() {
+    lvDbgAssert(!m_bGTCacheInitialized);
+    m_bGTCacheInitialized = true;
+    const uint64_t nSourceKey = getGTSourceKey();
+    if(getInputCount()==0 || nSourceKey==0)
+        return;
+    const IDatasetPtr pDataset = getDatasetInfo();
+    std::vector<std::string> vsCacheDirPaths;
+    const char* acOverride = std::getenv(DATASETUTILS_GTCACHE_DIR_ENV_VAR);
+    if(acOverride && *acOverride) {
+        std::string sOverrideLower(acOverride);
+        std::transform(sOverrideLower.begin(),sOverrideLower.end(),sOverrideLower.begin(),tolower);
+        if(sOverrideLower=="none")
+            return;
+        vsCacheDirPaths.push_back(lv::AddDirSlashIfMissing(acOverride));
+    }
+    else {
+        // the dataset dir is shared by all runs (and output dirs) on this dataset, but it may be read-only; the user cache dir is the fallback
+        vsCacheDirPaths.push_back(lv::AddDirSlashIfMissing(pDataset->getDatasetPath())+GTCACHE_DIR_NAME+"/");
+        const char* acXDGCacheHome = std::getenv("XDG_CACHE_HOME");
+        const char* acHome = std::getenv("HOME");
+        std::string sUserCacheDirPath;
+        if(acXDGCacheHome && *acXDGCacheHome)
+            sUserCacheDirPath = lv::AddDirSlashIfMissing(acXDGCacheHome);
+        else if(acHome && *acHome)
+            sUserCacheDirPath = lv::AddDirSlashIfMissing(acHome)+".cache/";
+        if(!sUserCacheDirPath.empty()) {
+            lv::CreateDirIfNotExist(sUserCacheDirPath);
+            sUserCacheDirPath += "litiv/";
+            lv::CreateDirIfNotExist(sUserCacheDirPath);
+            vsCacheDirPaths.push_back(sUserCacheDirPath+GTCACHE_DIR_NAME+"/");
+        }
+    }
+    // cache files are keyed by dataset name & work batch path (and validated via the gt source key), so all these dirs can be shared between datasets
+    std::string sCacheName = pDataset->getName()+"_"+getRelativePath();
+    std::replace_if(sCacheName.begin(),sCacheName.end(),[](char c){return c=='/' || c=='\\' || c==':';},'_');
+    for(const std::string& sCacheDirPath : vsCacheDirPaths)
+        if(lv::CreateDirIfNotExist(sCacheDirPath) && m_oGTCache.open(sCacheDirPath+sCacheName+GTCACHE_FILE_SUFFIX,getInputCount(),pDataset->getScaleFactor(),nSourceKey))
+            return;
+}
+
 const cv::Mat& lv::IIDataLoader::getInput_redirect(size_t nIdx) {
     m_oLatestInput = getRawInput(nIdx);
     if(!m_oLatestInput.empty()) {
@@ -398,7 +935,19 @@ const cv::Mat& lv::IIDataLoader::getInput_redirect(size_t nIdx) {
 }
 
 const cv::Mat& lv::IIDataLoader::getGT_redirect(size_t nIdx) {
+#if GTCACHE_ENABLED
+    {
+        std::mutex_lock_guard cache_lock(m_oGTCacheMutex);
+        if(!m_bGTCacheInitialized)
+            initGTCache();
+        if(!m_oGTCache.getPacket(nIdx,m_oLatestGT)) {
+            m_oLatestGT = getRawGT(nIdx);
+            m_oGTCache.addPacket(nIdx,m_oLatestGT);
+        }
+    }
+#else //!GTCACHE_ENABLED
     m_oLatestGT = getRawGT(nIdx);
+#endif //!GTCACHE_ENABLED
     if(!m_oLatestGT.empty()) {
         if(m_eGTType==ImagePacket) {
 #if HARDCODE_IMAGE_PACKET_INDEX
@@ -491,7 +1040,7 @@ void lv::IDataLoader_<lv::Array>::unpackInput(size_t nPacketIdx, std::vector<cv:
             uintptr_t nCurrPacketIdx = (uintptr_t)oInput.datastart;
             for(size_t s=0; s<vSizes.size(); ++s) {
                 const size_t nCurrPacketSize = oInput.elemSize()*vSizes[s].area();
-                lvAssert_(nCurrPacketIdx+nCurrPacketSize<uintptr_t(oInput.dataend),"unpack out-of-bounds");
+                lvAssert_(nCurrPacketIdx+nCurrPacketSize<=uintptr_t(oInput.dataend),"unpack out-of-bounds");
                 if(nCurrPacketSize>0)
                     vUnpackedInput[s] = cv::Mat(vSizes[s],oInput.type(),(void*)nCurrPacketIdx);
                 else
@@ -524,7 +1073,7 @@ void lv::IDataLoader_<lv::Array>::unpackGT(size_t nPacketIdx, std::vector<cv::Ma
             uintptr_t nCurrPacketIdx = (uintptr_t)oGT.datastart;
             for(size_t s=0; s<vSizes.size(); ++s) {
                 const size_t nCurrPacketSize = oGT.elemSize()*vSizes[s].area();
-                lvAssert_(nCurrPacketIdx+nCurrPacketSize<uintptr_t(oGT.dataend),"unpack out-of-bounds");
+                lvAssert_(nCurrPacketIdx+nCurrPacketSize<=uintptr_t(oGT.dataend),"unpack out-of-bounds");
                 if(nCurrPacketSize>0)
                     vUnpackedGT[s] = cv::Mat(vSizes[s],oGT.type(),(void*)nCurrPacketIdx);
                 else
@@ -563,11 +1112,18 @@ double lv::IDataProducer_<lv::DatasetSource_Video>::getExpectedLoad() const {
 }
 
 void lv::IDataProducer_<lv::DatasetSource_Video>::startPrecaching(bool bPrecacheGT, size_t nSuggestedBufferSize) {
-    return IIDataLoader::startPrecaching(bPrecacheGT,(nSuggestedBufferSize==SIZE_MAX)?m_oInputSize.area()*(m_nFrameCount+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3):nSuggestedBufferSize);
+    if(m_oVideoDecoder.isOpened())
+        lvAssert_(m_oVideoDecoder.startAsyncDecoding(VIDEODECODER_QUEUE_SIZE),"could not start video read-ahead decoding");
+    return IIDataLoader::startPrecaching(bPrecacheGT,std::min(nSuggestedBufferSize,m_oInputSize.area()*(m_nFrameCount+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3)));
+}
+
+void lv::IDataProducer_<lv::DatasetSource_Video>::stopPrecaching() {
+    IIDataLoader::stopPrecaching();
+    m_oVideoDecoder.stopAsyncDecoding();
 }
 
 lv::IDataProducer_<lv::DatasetSource_Video>::IDataProducer_(PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType) :
-        IDataLoader_<NotArray>(ImagePacket,eGTType,eOutputType,eGTMappingType,eIOMappingType),m_nFrameCount(0),m_nNextExpectedVideoReaderFrameIdx(size_t(-1)) {}
+        IDataLoader_<NotArray>(ImagePacket,eGTType,eOutputType,eGTMappingType,eIOMappingType),m_nFrameCount(0) {}
 
 const cv::Mat& lv::IDataProducer_<lv::DatasetSource_Video>::getInputROI(size_t /*nPacketIdx*/) const {
     return m_oInputROI;
@@ -595,20 +1151,17 @@ const cv::Size& lv::IDataProducer_<lv::DatasetSource_Video>::getGTMaxSize() cons
 
 cv::Mat lv::IDataProducer_<lv::DatasetSource_Video>::getRawInput(size_t nPacketIdx) {
     cv::Mat oFrame;
-    if(!m_voVideoReader.isOpened() && nPacketIdx<m_vsInputPaths.size())
+    if(!m_oVideoDecoder.isOpened() && nPacketIdx<m_vsInputPaths.size())
         oFrame = cv::imread(m_vsInputPaths[nPacketIdx],isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
-    else {
-        if(m_nNextExpectedVideoReaderFrameIdx!=nPacketIdx) {
-            m_voVideoReader.set(cv::CAP_PROP_POS_FRAMES,(double)nPacketIdx);
-            m_nNextExpectedVideoReaderFrameIdx = nPacketIdx+1;
-        }
-        else
-            ++m_nNextExpectedVideoReaderFrameIdx;
-        m_voVideoReader >> oFrame;
-    }
+    else
+        oFrame = m_oVideoDecoder.getFrame(nPacketIdx);
     return oFrame;
 }
 
+uint64_t lv::IDataProducer_<lv::DatasetSource_Video>::getGTSourceKey() const {
+    return m_vsGTPaths.empty()?0:getFileListKey(m_vsGTPaths);
+}
+
 cv::Mat lv::IDataProducer_<lv::DatasetSource_Video>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()==ImagePacket,"default impl only works for image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
@@ -621,21 +1174,19 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_Video>::getRawGT(size_t nPacketIdx)
 
 void lv::IDataProducer_<lv::DatasetSource_Video>::parseData() {
     cv::Mat oTempImg;
-    m_voVideoReader.open(getDataPath());
-    if(!m_voVideoReader.isOpened()) {
+    m_oVideoDecoder.open(getDataPath());
+    if(!m_oVideoDecoder.isOpened()) {
         lv::GetFilesFromDir(getDataPath(),m_vsInputPaths);
         if(m_vsInputPaths.size()>1) {
             oTempImg = cv::imread(m_vsInputPaths[0]);
             m_nFrameCount = m_vsInputPaths.size();
         }
         else if(m_vsInputPaths.size()==1)
-            m_voVideoReader.open(m_vsInputPaths[0]);
+            m_oVideoDecoder.open(m_vsInputPaths[0]);
     }
-    if(m_voVideoReader.isOpened()) {
-        m_voVideoReader.set(cv::CAP_PROP_POS_FRAMES,0);
-        m_voVideoReader >> oTempImg;
-        m_voVideoReader.set(cv::CAP_PROP_POS_FRAMES,0);
-        m_nFrameCount = (size_t)m_voVideoReader.get(cv::CAP_PROP_FRAME_COUNT);
+    if(m_oVideoDecoder.isOpened()) {
+        oTempImg = m_oVideoDecoder.getFrame(0);
+        m_nFrameCount = m_oVideoDecoder.getFrameCount();
     }
     if(oTempImg.empty())
         lvError_("Sequence '%s': video could not be opened via VideoReader or imread (you might need to implement your own DataProducer_ interface)",getName().c_str());
@@ -644,7 +1195,6 @@ void lv::IDataProducer_<lv::DatasetSource_Video>::parseData() {
         cv::resize(oTempImg,oTempImg,cv::Size(),dScale,dScale,cv::INTER_NEAREST);
     m_oInputROI = cv::Mat(oTempImg.size(),CV_8UC1,cv::Scalar_<uchar>(255));
     m_oInputSize = oTempImg.size();
-    m_nNextExpectedVideoReaderFrameIdx = 0;
     lvAssert_(m_nFrameCount>0,"could not find any input frames");
 }
 
@@ -675,7 +1225,7 @@ double lv::IDataProducer_<lv::DatasetSource_VideoArray>::getExpectedLoad() const
 }
 
 void lv::IDataProducer_<lv::DatasetSource_VideoArray>::startPrecaching(bool bPrecacheGT, size_t nSuggestedBufferSize) {
-    return IIDataLoader::startPrecaching(bPrecacheGT,(nSuggestedBufferSize==SIZE_MAX)?getInputMaxSize().area()*(m_vvsInputPaths.size()+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3):nSuggestedBufferSize);
+    return IIDataLoader::startPrecaching(bPrecacheGT,std::min(nSuggestedBufferSize,getInputMaxSize().area()*(m_vvsInputPaths.size()+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3)));
 }
 
 lv::IDataProducer_<lv::DatasetSource_VideoArray>::IDataProducer_(PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType) :
@@ -739,6 +1289,14 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_VideoArray>::getRawInput(size_t nPa
     return oPacket;
 }
 
+uint64_t lv::IDataProducer_<lv::DatasetSource_VideoArray>::getGTSourceKey() const {
+    uint64_t nKey = getFileListKey({});
+    for(const auto& vsGTPaths : m_vvsGTPaths)
+        if(!(nKey=getFileListKey(vsGTPaths,nKey)))
+            return 0;
+    return m_vvsGTPaths.empty()?0:nKey;
+}
+
 cv::Mat lv::IDataProducer_<lv::DatasetSource_VideoArray>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()<=ImageArrayPacket,"default impl only works for image array or image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
@@ -801,7 +1359,7 @@ double lv::IDataProducer_<lv::DatasetSource_Image>::getExpectedLoad() const {
 }
 
 void lv::IDataProducer_<lv::DatasetSource_Image>::startPrecaching(bool bPrecacheGT, size_t nSuggestedBufferSize) {
-    return IIDataLoader::startPrecaching(bPrecacheGT,(nSuggestedBufferSize==SIZE_MAX)?m_oInputMaxSize.area()*(m_vsInputPaths.size()+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3):nSuggestedBufferSize);
+    return IIDataLoader::startPrecaching(bPrecacheGT,std::min(nSuggestedBufferSize,m_oInputMaxSize.area()*(m_vsInputPaths.size()+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3)));
 }
 
 const cv::Size& lv::IDataProducer_<lv::DatasetSource_Image>::getInputSize(size_t nPacketIdx) const {
@@ -844,6 +1402,10 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_Image>::getRawInput(size_t nPacketI
     return cv::imread(m_vsInputPaths[nPacketIdx],isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
 }
 
+uint64_t lv::IDataProducer_<lv::DatasetSource_Image>::getGTSourceKey() const {
+    return m_vsGTPaths.empty()?0:getFileListKey(m_vsGTPaths);
+}
+
 cv::Mat lv::IDataProducer_<lv::DatasetSource_Image>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()==ImagePacket,"default impl only works for image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
@@ -910,7 +1472,7 @@ double lv::IDataProducer_<lv::DatasetSource_ImageArray>::getExpectedLoad() const
 }
 
 void lv::IDataProducer_<lv::DatasetSource_ImageArray>::startPrecaching(bool bPrecacheGT, size_t nSuggestedBufferSize) {
-    return IIDataLoader::startPrecaching(bPrecacheGT,(nSuggestedBufferSize==SIZE_MAX)?m_oInputMaxSize.area()*(m_vvsInputPaths.size()+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3):nSuggestedBufferSize);
+    return IIDataLoader::startPrecaching(bPrecacheGT,std::min(nSuggestedBufferSize,m_oInputMaxSize.area()*(m_vvsInputPaths.size()+1)*(isGrayscale()?1:getDatasetInfo()->is4ByteAligned()?4:3)));
 }
 
 const std::vector<cv::Size>& lv::IDataProducer_<lv::DatasetSource_ImageArray>::getInputSizeArray(size_t nPacketIdx) const {
@@ -973,6 +1535,14 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_ImageArray>::getRawInput(size_t nPa
     return oPacket;
 }
 
+uint64_t lv::IDataProducer_<lv::DatasetSource_ImageArray>::getGTSourceKey() const {
+    uint64_t nKey = getFileListKey({});
+    for(const auto& vsGTPaths : m_vvsGTPaths)
+        if(!(nKey=getFileListKey(vsGTPaths,nKey)))
+            return 0;
+    return m_vvsGTPaths.empty()?0:nKey;
+}
+
 cv::Mat lv::IDataProducer_<lv::DatasetSource_ImageArray>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()<=ImageArrayPacket,"default impl only works for image array or image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
@@ -1016,6 +1586,58 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_ImageArray>::getRawGT(size_t nPacke
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+lv::LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void lv::LatencyHistogram::record(double dDuration_sec) {
+    const uint64_t nDuration_usec = (uint64_t)std::max(dDuration_sec*1e6,0.0);
+    size_t nBucketIdx = (size_t)nDuration_usec;
+    if(nDuration_usec>=s_nSubBucketCount) {
+        // the top 5 significant bits (i.e. the leading one plus 4 more) select the sub-bucket within the magnitude
+        size_t nMagnitude = 0;
+        while((nDuration_usec>>nMagnitude)>=2*s_nSubBucketCount)
+            ++nMagnitude;
+        nBucketIdx = std::min((nMagnitude+1)*s_nSubBucketCount+size_t((nDuration_usec>>nMagnitude)-s_nSubBucketCount),m_anCounts.size()-1);
+    }
+    ++m_anCounts[nBucketIdx];
+    ++m_nCount;
+    m_dMax_sec = std::max(m_dMax_sec,dDuration_sec);
+}
+
+void lv::LatencyHistogram::accumulate(const LatencyHistogram& oHist) {
+    for(size_t nBucketIdx=0; nBucketIdx<m_anCounts.size(); ++nBucketIdx)
+        m_anCounts[nBucketIdx] += oHist.m_anCounts[nBucketIdx];
+    m_nCount += oHist.m_nCount;
+    m_dMax_sec = std::max(m_dMax_sec,oHist.m_dMax_sec);
+}
+
+double lv::LatencyHistogram::getPercentile(double dFraction) const {
+    if(m_nCount==0)
+        return 0.0;
+    const uint64_t nTargetCount = std::max((uint64_t)std::ceil(std::min(std::max(dFraction,0.0),1.0)*m_nCount),uint64_t(1));
+    uint64_t nCurrCount = 0;
+    for(size_t nBucketIdx=0; nBucketIdx<m_anCounts.size(); ++nBucketIdx) {
+        nCurrCount += m_anCounts[nBucketIdx];
+        if(nCurrCount>=nTargetCount) {
+            // returns the bucket midpoint (exact in the linear range), never above the actual max
+            const size_t nMagnitude = nBucketIdx/s_nSubBucketCount;
+            const double dLowerBound_usec = nMagnitude==0?double(nBucketIdx):double((s_nSubBucketCount+nBucketIdx%s_nSubBucketCount)<<(nMagnitude-1));
+            const double dWidth_usec = nMagnitude==0?0.0:double(size_t(1)<<(nMagnitude-1));
+            return std::min((dLowerBound_usec+dWidth_usec/2)/1e6,m_dMax_sec);
+        }
+    }
+    return m_dMax_sec;
+}
+
+void lv::LatencyHistogram::reset() {
+    m_anCounts.fill(0);
+    m_nCount = 0;
+    m_dMax_sec = 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 size_t lv::IDataCounter_<lv::NotGroup>::getProcessedOutputCount() const {
     return m_mProcessedPackets.size();
 }
@@ -1042,13 +1664,19 @@ size_t lv::IDataCounter_<lv::Group>::getProcessedOutputCountPromise() {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-lv::DataWriter::DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback) :
-        m_lCallback(lDataArchiverCallback) {
+lv::DataWriter::DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback, EncodeFunc lDataEncoderCallback) :
+        m_lCallback(lDataArchiverCallback),m_lEncoder(lDataEncoderCallback) {
+    static_assert(DATAWRITER_SLOT_COUNT>0 && (DATAWRITER_SLOT_COUNT&(DATAWRITER_SLOT_COUNT-1))==0,"Data writer slot count must be a power of two");
     lvAssert_(m_lCallback,"invalid data writer callback");
     m_bIsActive = false;
     m_bAllowPacketDrop = false;
+    m_bMultiProducer = m_bMultiConsumer = false;
+    m_nReorderCount = 0;
+    m_nNextWriteIdx = 0;
+    m_bQueueStalled = false;
     m_nQueueSize = 0;
     m_nQueueCount = 0;
+    m_nEnqueuePos = m_nDequeuePos = m_nCommitPos = 0;
 }
 
 lv::DataWriter::~DataWriter() {
@@ -1056,47 +1684,106 @@ lv::DataWriter::~DataWriter() {
 }
 
 size_t lv::DataWriter::queue(const cv::Mat& oPacket, size_t nIdx) {
-    if(!m_bIsActive)
-        return m_lCallback(oPacket,nIdx);
-    cv::Mat oPacketCopy = oPacket.clone();
+    if(!m_bIsActive) {
+        if(!m_lEncoder)
+            return m_lCallback(oPacket,nIdx);
+        std::vector<uchar> vEncodedPacket;
+        m_lEncoder(oPacket,nIdx,vEncodedPacket);
+        return write(oPacket,vEncodedPacket,nIdx);
+    }
     const size_t nPacketSize = oPacket.total()*oPacket.elemSize();
-    size_t nPacketPosition;
-    {
+    const auto lWaitForClear = [&]() {
+        m_bQueueStalled = true;
+        m_oQueueCondVar.notify_one();
         std::mutex_unique_lock sync_lock(m_oSyncMutex);
-        if(!m_bAllowPacketDrop && m_nQueueSize+nPacketSize>m_nQueueMaxSize)
-            m_oClearCondVar.wait(sync_lock,[&]{return m_nQueueSize+nPacketSize<=m_nQueueMaxSize;});
-        if(m_nQueueSize+nPacketSize<=m_nQueueMaxSize) {
-            m_mQueue[nIdx] = std::move(oPacketCopy);
-            m_nQueueSize += nPacketSize;
-            // @@@ could cut a find operation here using C++17's map::insert_or_assign above
-            nPacketPosition = std::distance(m_mQueue.begin(),m_mQueue.find(nIdx));
-            ++m_nQueueCount;
+        m_oClearCondVar.wait_for(sync_lock,std::chrono::milliseconds(DATAWRITER_CLEAR_TIMEOUT_MS));
+    };
+    // first, reserve room in the queue byte budget (an oversized packet is still accepted if the queue is empty)
+    size_t nCurrQueueSize = m_nQueueSize;
+    while(true) {
+        if(nCurrQueueSize==0 || nCurrQueueSize+nPacketSize<=m_nQueueMaxSize) {
+            if(m_nQueueSize.compare_exchange_weak(nCurrQueueSize,nCurrQueueSize+nPacketSize))
+                break;
         }
-        else {
+        else if(m_bAllowPacketDrop) {
 #if CONSOLE_DEBUG
             std::cout << "data writer [" << uintptr_t(this) << "] dropping packet #" << nIdx << std::endl;
 #endif //CONSOLE_DEBUG
-            nPacketPosition = SIZE_MAX; // packet dropped
+            m_bQueueStalled = true;
+            return SIZE_MAX; // packet dropped
+        }
+        else {
+            lWaitForClear();
+            nCurrQueueSize = m_nQueueSize;
         }
     }
+    // then, claim a free ring slot (only needs a CAS if multiple producers may be queueing at once)
+    PacketSlot* pSlot;
+    size_t nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+    while(true) {
+        pSlot = &m_aSlots[nPos&(DATAWRITER_SLOT_COUNT-1)];
+        const std::ptrdiff_t nDiff = (std::ptrdiff_t)pSlot->nSeq.load(std::memory_order_acquire)-(std::ptrdiff_t)nPos;
+        if(nDiff==0) {
+            if(!m_bMultiProducer) {
+                m_nEnqueuePos.store(nPos+1,std::memory_order_relaxed);
+                break;
+            }
+            else if(m_nEnqueuePos.compare_exchange_weak(nPos,nPos+1,std::memory_order_relaxed))
+                break;
+        }
+        else if(nDiff<0) { // all slots are in use
+            if(m_bAllowPacketDrop) {
+                m_nQueueSize -= nPacketSize;
+                m_bQueueStalled = true;
+#if CONSOLE_DEBUG
+                std::cout << "data writer [" << uintptr_t(this) << "] dropping packet #" << nIdx << " (out of slots)" << std::endl;
+#endif //CONSOLE_DEBUG
+                return SIZE_MAX; // packet dropped
+            }
+            lWaitForClear();
+            nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+        }
+        else
+            nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+    }
+    // slot buffers are only reallocated if the packet size or type changes (note: callbacks should never keep refs to packets)
+    oPacket.copyTo(pSlot->oPacket);
+    pSlot->nIdx = nIdx;
+    pSlot->nSize = nPacketSize;
+    ++m_nQueueCount; // must be counted before the slot is published, as a worker may write & uncount it right away
+    pSlot->nSeq.store(nPos+1,std::memory_order_release);
     m_oQueueCondVar.notify_one();
 #if CONSOLE_DEBUG
     if((nIdx%50)==0)
         std::cout << "data writer [" << uintptr_t(this) << "] queue @ " << (int)(((float)m_nQueueSize*100)/m_nQueueMaxSize) << "% capacity" << std::endl;
 #endif //CONSOLE_DEBUG
-    return nPacketPosition;
+    const size_t nCommitPos = m_nCommitPos;
+    return nPos>nCommitPos?nPos-nCommitPos:0;
 }
 
-bool lv::DataWriter::startAsyncWriting(size_t nSuggestedQueueSize, bool bDropPacketsIfFull, size_t nWorkers) {
+bool lv::DataWriter::startAsyncWriting(size_t nSuggestedQueueSize, bool bDropPacketsIfFull, size_t nWorkers, bool bMultiProducer) {
     if(m_bIsActive)
         stopAsyncWriting();
-    if(nSuggestedQueueSize>0) {
-        m_bIsActive = true;
+    if(nSuggestedQueueSize>0 && nWorkers>0) {
         m_bAllowPacketDrop = bDropPacketsIfFull;
+        m_bMultiProducer = bMultiProducer;
+        m_bMultiConsumer = nWorkers>1;
         m_nQueueMaxSize = (nSuggestedQueueSize>CACHE_MAX_SIZE)?(CACHE_MAX_SIZE):nSuggestedQueueSize;
         m_nQueueSize = 0;
         m_nQueueCount = 0;
-        m_mQueue.clear();
+        if(!m_aSlots) // slots & reorder window entries (and their packet buffers) are kept across restarts
+            m_aSlots = std::make_unique<PacketSlot[]>(DATAWRITER_SLOT_COUNT);
+        if(!m_aReorderWindow)
+            m_aReorderWindow = std::make_unique<PendingPacket[]>(DATAWRITER_REORDER_WINDOW_SIZE);
+        m_nReorderCount = 0;
+        m_nNextWriteIdx = 0;
+        m_bQueueStalled = false;
+        for(size_t nSlotIdx=0; nSlotIdx<DATAWRITER_SLOT_COUNT; ++nSlotIdx) {
+            m_aSlots[nSlotIdx].nSeq = nSlotIdx;
+            m_aSlots[nSlotIdx].bReady = false;
+        }
+        m_nEnqueuePos = m_nDequeuePos = m_nCommitPos = 0;
+        m_bIsActive = true;
         for(size_t n=0; n<nWorkers; ++n)
             m_vhWorkers.emplace_back(std::bind(&DataWriter::entry,this));
     }
@@ -1109,55 +1796,469 @@ void lv::DataWriter::stopAsyncWriting() {
         m_oQueueCondVar.notify_all();
         for(std::thread& oWorker : m_vhWorkers)
             oWorker.join();
+        m_vhWorkers.clear();
     }
 }
 
 void lv::DataWriter::entry() {
-    std::mutex_unique_lock sync_lock(m_oSyncMutex);
 #if CONSOLE_DEBUG
     std::cout << "data writer [" << uintptr_t(this) << "] init w/ max buffer size = " << (m_nQueueMaxSize/1024)/1024 << " mb" << std::endl;
 #endif //CONSOLE_DEBUG
-    while(m_bIsActive || m_nQueueCount>0) {
-        if(m_nQueueCount==0)
-            m_oQueueCondVar.wait(sync_lock);
-        if(m_nQueueCount>0) {
-            auto pCurrPacket = m_mQueue.begin();
-            lvAssert_(pCurrPacket!=m_mQueue.end(),"data writer notified for missing packet");
-            const cv::Mat oPacketData(std::move(pCurrPacket->second));
-            const size_t nPacketIdx = pCurrPacket->first;
-            const size_t nPacketSize = oPacketData.total()*oPacketData.elemSize();
-            lvAssert_(nPacketSize<=m_nQueueSize,"data writer packet size exceeds queue size");
-            m_nQueueSize -= nPacketSize;
-            m_mQueue.erase(pCurrPacket);
-            --m_nQueueCount;
-            std::unlock_guard<std::mutex_unique_lock> oUnlock(sync_lock);
-            m_lCallback(oPacketData,nPacketIdx);
+    while(true) {
+        PacketSlot* pSlot = nullptr;
+        size_t nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+        while(true) {
+            PacketSlot& oSlot = m_aSlots[nPos&(DATAWRITER_SLOT_COUNT-1)];
+            const std::ptrdiff_t nDiff = (std::ptrdiff_t)oSlot.nSeq.load(std::memory_order_acquire)-(std::ptrdiff_t)(nPos+1);
+            if(nDiff==0) {
+                if(!m_bMultiConsumer) {
+                    m_nDequeuePos.store(nPos+1,std::memory_order_relaxed);
+                    pSlot = &oSlot;
+                    break;
+                }
+                else if(m_nDequeuePos.compare_exchange_weak(nPos,nPos+1,std::memory_order_relaxed)) {
+                    pSlot = &oSlot;
+                    break;
+                }
+            }
+            else if(nDiff<0) // queue is empty
+                break;
+            else
+                nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+        }
+        if(!pSlot) {
+            commit(); // in case a handover was missed while another worker was committing
+            if(!m_bIsActive && m_nCommitPos==m_nEnqueuePos)
+                break;
+            std::mutex_unique_lock sync_lock(m_oSyncMutex);
+            m_oQueueCondVar.wait_for(sync_lock,std::chrono::milliseconds(DATAWRITER_QUERY_TIMEOUT_MS));
+            continue;
+        }
+        // encoding is done out-of-order by all workers (outside of the commit lock), but packets will only be written in packet index order
+        if(m_lEncoder)
+            m_lEncoder(pSlot->oPacket,pSlot->nIdx,pSlot->vEncodedPacket);
+        pSlot->bReady = true;
+        commit();
+    }
+}
+
+void lv::DataWriter::commit() {
+    const auto lIsHeadReady = [&]() {
+        const size_t nPos = m_nCommitPos;
+        const PacketSlot& oSlot = m_aSlots[nPos&(DATAWRITER_SLOT_COUNT-1)];
+        return oSlot.nSeq.load(std::memory_order_acquire)==nPos+1 && oSlot.bReady;
+    };
+    do {
+        std::mutex_unique_lock commit_lock(m_oCommitMutex,std::try_to_lock);
+        if(!commit_lock.owns_lock())
+            return; // current owner will pick up our packet (or an idle worker will, after its timeout)
+        while(lIsHeadReady()) {
+            const size_t nPos = m_nCommitPos;
+            PacketSlot& oSlot = m_aSlots[nPos&(DATAWRITER_SLOT_COUNT-1)];
+            // ring slots are claimed in queue order, which may differ from packet index order (e.g. w/ multiple producers), so packets go through
+            // a small reorder window first; like a map keyed by index, a packet queued again before being written replaces the pending one
+            PendingPacket* pPending = nullptr;
+            for(size_t nPendingIdx=0; nPendingIdx<m_nReorderCount && !pPending; ++nPendingIdx)
+                if(m_aReorderWindow[nPendingIdx].nIdx==oSlot.nIdx)
+                    pPending = &m_aReorderWindow[nPendingIdx];
+            if(pPending) {
+                m_nQueueSize -= pPending->nSize;
+                --m_nQueueCount;
+            }
+            else
+                pPending = &m_aReorderWindow[m_nReorderCount++];
+            pPending->nIdx = oSlot.nIdx;
+            pPending->nSize = oSlot.nSize;
+            std::swap(pPending->oPacket,oSlot.oPacket);
+            std::swap(pPending->vEncodedPacket,oSlot.vEncodedPacket);
+            oSlot.bReady = false;
+            m_nCommitPos = nPos+1;
+            oSlot.nSeq.store(nPos+DATAWRITER_SLOT_COUNT,std::memory_order_release);
             m_oClearCondVar.notify_all();
+            flush(false);
+        }
+        // once stopped, and with all queued packets released from the ring, the window is emptied regardless of gaps in packet indices
+        flush(!m_bIsActive && m_nCommitPos==m_nEnqueuePos);
+    } while(lIsHeadReady());
+}
+
+void lv::DataWriter::flush(bool bFlushAll) {
+    while(m_nReorderCount>0) {
+        size_t nMinPendingIdx = 0;
+        for(size_t nPendingIdx=1; nPendingIdx<m_nReorderCount; ++nPendingIdx)
+            if(m_aReorderWindow[nPendingIdx].nIdx<m_aReorderWindow[nMinPendingIdx].nIdx)
+                nMinPendingIdx = nPendingIdx;
+        PendingPacket& oPending = m_aReorderWindow[nMinPendingIdx];
+        // packets are held back while waiting for a lower index, unless the window is full, or producers are stalled while no other packet is in
+        // flight in the ring (i.e. the missing index was skipped or dropped, or its producer is waiting for the room held by the window)
+        if(!bFlushAll && oPending.nIdx>m_nNextWriteIdx && m_nReorderCount<DATAWRITER_REORDER_WINDOW_SIZE && !(m_nCommitPos==m_nEnqueuePos && m_bQueueStalled.exchange(false)))
+            break;
+        if(oPending.nIdx<=m_nNextWriteIdx)
+            m_bQueueStalled = false; // in-order writes free up room on their own; producers that are still stalled will raise the flag again
+        write(oPending.oPacket,oPending.vEncodedPacket,oPending.nIdx);
+        m_nNextWriteIdx = std::max(m_nNextWriteIdx,oPending.nIdx+1);
+        m_nQueueSize -= oPending.nSize;
+        --m_nQueueCount;
+        if(nMinPendingIdx!=--m_nReorderCount) { // entries stay packed at the front of the window; buffers are swapped so they are kept for reuse
+            PendingPacket& oLast = m_aReorderWindow[m_nReorderCount];
+            std::swap(oPending.nIdx,oLast.nIdx);
+            std::swap(oPending.nSize,oLast.nSize);
+            std::swap(oPending.oPacket,oLast.oPacket);
+            std::swap(oPending.vEncodedPacket,oLast.vEncodedPacket);
+        }
+        m_oClearCondVar.notify_all();
+    }
+}
+
+size_t lv::DataWriter::write(const cv::Mat& oPacket, const std::vector<uchar>& vEncodedPacket, size_t nIdx) {
+    if(!m_lEncoder)
+        return m_lCallback(oPacket,nIdx);
+    // the encoded bytes are wrapped without copy, and stay valid until the slot is released
+    return m_lCallback(vEncodedPacket.empty()?cv::Mat():cv::Mat(1,(int)vEncodedPacket.size(),CV_8UC1,(void*)vEncodedPacket.data()),nIdx);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::WorkBatchScheduler::WorkBatchScheduler(size_t nWorkers, bool bPrecache, bool bPrecacheGT, size_t nPrecacheLookahead) :
+        m_nWorkers(std::max(nWorkers,size_t(1))),m_bPrecache(bPrecache),m_bPrecacheGT(bPrecacheGT),m_nPrecacheLookahead(nPrecacheLookahead),m_nPrecacheBufferSize(SIZE_MAX) {
+    m_nBatchCount = 0;
+    m_nCompletedBatchCount = 0;
+}
+
+lv::WorkBatchScheduler::~WorkBatchScheduler() {
+    wait();
+}
+
+void lv::WorkBatchScheduler::start(IDataHandlerPtrQueue vpBatches, BatchFunc lBatchFunc, LoadFunc lLoadFunc) {
+    lvAssert_(lBatchFunc,"invalid batch processing function");
+    lvAssert_(m_vhWorkers.empty(),"scheduler is already running");
+    m_lBatchFunc = lBatchFunc;
+    m_lLoadFunc = lLoadFunc?lLoadFunc:[](const IDataHandlerPtr& p){return p->getExpectedLoad();};
+    m_vqpWorkerBatches = std::vector<std::deque<IDataHandlerPtr>>(m_nWorkers);
+    m_vpActiveBatches = std::vector<IDataHandlerPtr>(m_nWorkers);
+    m_vpAllBatches.clear();
+    m_spPrecachingBatches.clear();
+    // greedy longest-processing-time-first assignment; each worker's deque stays sorted by decreasing load
+    std::vector<double> vdWorkerLoads(m_nWorkers,0.0);
+    while(!vpBatches.empty()) {
+        const IDataHandlerPtr pBatch = vpBatches.top();
+        vpBatches.pop();
+        const size_t nWorkerIdx = size_t(std::min_element(vdWorkerLoads.begin(),vdWorkerLoads.end())-vdWorkerLoads.begin());
+        vdWorkerLoads[nWorkerIdx] += m_lLoadFunc(pBatch);
+        m_vqpWorkerBatches[nWorkerIdx].push_back(pBatch);
+        m_vpAllBatches.push_back(pBatch);
+    }
+    m_nBatchCount = m_vpAllBatches.size();
+    m_nCompletedBatchCount = 0;
+    // each worker may precache its active batch plus its lookahead batches at once (input & gt), so they all share one global cache budget
+    const size_t nMaxPrecachers = std::max(std::min(m_nWorkers,m_vpAllBatches.size())*(m_nPrecacheLookahead+1)*(m_bPrecacheGT?2:1),size_t(1));
+    m_nPrecacheBufferSize = std::max(CACHE_MAX_SIZE/nMaxPrecachers,CACHE_MIN_SIZE);
+    // batch workers get their own threads, so they never tie up the shared pool workers that pick up the tiles of the algorithms they run
+    for(size_t nWorkerIdx=0; nWorkerIdx<std::min(m_nWorkers,m_vpAllBatches.size()); ++nWorkerIdx)
+        m_vhWorkers.emplace_back(&WorkBatchScheduler::entry,this,nWorkerIdx);
+}
+
+void lv::WorkBatchScheduler::wait() {
+    {
+        std::mutex_unique_lock sync_lock(m_oSyncMutex);
+        m_oDoneCondVar.wait(sync_lock,[&]{return m_nCompletedBatchCount==m_nBatchCount;});
+    }
+    for(std::thread& oWorker : m_vhWorkers)
+        oWorker.join();
+    m_vhWorkers.clear();
+}
+
+bool lv::WorkBatchScheduler::waitFor(size_t nTimeout_ms) {
+    {
+        std::mutex_unique_lock sync_lock(m_oSyncMutex);
+        if(!m_oDoneCondVar.wait_for(sync_lock,std::chrono::milliseconds(nTimeout_ms),[&]{return m_nCompletedBatchCount==m_nBatchCount;}))
+            return false;
+    }
+    wait();
+    return true;
+}
+
+double lv::WorkBatchScheduler::getProgress() const {
+    std::mutex_lock_guard sync_lock(m_oSyncMutex);
+    const size_t nExpectedCount = lv::accumulateMembers<size_t,IDataHandlerPtr>(m_vpAllBatches,[](const IDataHandlerPtr& p){return p->getExpectedOutputCount();});
+    const size_t nProcessedCount = lv::accumulateMembers<size_t,IDataHandlerPtr>(m_vpAllBatches,[](const IDataHandlerPtr& p){return p->getProcessedOutputCount();});
+    return nExpectedCount?std::min(double(nProcessedCount)/nExpectedCount,1.0):(m_nCompletedBatchCount==m_nBatchCount?1.0:0.0);
+}
+
+std::vector<std::pair<lv::IDataHandlerPtr,double>> lv::WorkBatchScheduler::getActiveBatchesProgress() const {
+    std::mutex_lock_guard sync_lock(m_oSyncMutex);
+    std::vector<std::pair<IDataHandlerPtr,double>> vActiveBatchesProgress;
+    for(const IDataHandlerPtr& pBatch : m_vpActiveBatches) {
+        if(pBatch) {
+            const size_t nExpectedCount = pBatch->getExpectedOutputCount();
+            vActiveBatchesProgress.emplace_back(pBatch,nExpectedCount?std::min(double(pBatch->getProcessedOutputCount())/nExpectedCount,1.0):0.0);
+        }
+    }
+    return vActiveBatchesProgress;
+}
+
+void lv::WorkBatchScheduler::entry(size_t nWorkerIdx) {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    while(true) {
+        const IDataHandlerPtr pBatch = popNextBatch(nWorkerIdx);
+        if(!pBatch)
+            break;
+        m_vpActiveBatches[nWorkerIdx] = pBatch;
+        if(m_bPrecache) {
+            // next batches of this worker get a head start, so their first packets are ready when we get to them
+            startPrecaching(pBatch);
+            const std::deque<IDataHandlerPtr>& qpBatches = m_vqpWorkerBatches[nWorkerIdx];
+            for(size_t nLookaheadIdx=0; nLookaheadIdx<std::min(m_nPrecacheLookahead,qpBatches.size()); ++nLookaheadIdx)
+                startPrecaching(qpBatches[nLookaheadIdx]);
+        }
+        {
+            std::unlock_guard<std::mutex_unique_lock> oUnlock(sync_lock);
+            try {
+                m_lBatchFunc(nWorkerIdx,pBatch);
+            }
+            catch(const std::exception& e) {std::cout << "\nWorkBatchScheduler caught std::exception in batch '" << pBatch->getName() << "':\n" << e.what() << "\n" << std::endl;}
+            catch(...) {std::cout << "\nWorkBatchScheduler caught unhandled exception in batch '" << pBatch->getName() << "'\n" << std::endl;}
+            if(m_bPrecache)
+                pBatch->stopPrecaching();
+        }
+        m_spPrecachingBatches.erase(pBatch.get());
+        m_vpActiveBatches[nWorkerIdx] = nullptr;
+        ++m_nCompletedBatchCount;
+        m_oDoneCondVar.notify_all();
+    }
+}
+
+lv::IDataHandlerPtr lv::WorkBatchScheduler::popNextBatch(size_t nWorkerIdx) {
+    std::deque<IDataHandlerPtr>& qpBatches = m_vqpWorkerBatches[nWorkerIdx];
+    if(!qpBatches.empty()) {
+        const IDataHandlerPtr pBatch = qpBatches.front();
+        qpBatches.pop_front();
+        return pBatch;
+    }
+    // own queue is empty; steal the lightest batch from the worker with the most pending load
+    size_t nVictimIdx = SIZE_MAX;
+    double dMaxPendingLoad = 0.0;
+    for(size_t nOtherIdx=0; nOtherIdx<m_nWorkers; ++nOtherIdx) {
+        if(nOtherIdx!=nWorkerIdx && !m_vqpWorkerBatches[nOtherIdx].empty()) {
+            const double dPendingLoad = std::accumulate(m_vqpWorkerBatches[nOtherIdx].begin(),m_vqpWorkerBatches[nOtherIdx].end(),0.0,[&](double dSum, const IDataHandlerPtr& p){return dSum+m_lLoadFunc(p);});
+            if(nVictimIdx==SIZE_MAX || dPendingLoad>dMaxPendingLoad) {
+                nVictimIdx = nOtherIdx;
+                dMaxPendingLoad = dPendingLoad;
+            }
+        }
+    }
+    if(nVictimIdx==SIZE_MAX)
+        return nullptr;
+    const IDataHandlerPtr pBatch = m_vqpWorkerBatches[nVictimIdx].back();
+    m_vqpWorkerBatches[nVictimIdx].pop_back();
+#if CONSOLE_DEBUG
+    std::cout << "work batch scheduler [" << uintptr_t(this) << "] worker #" << nWorkerIdx << " stole batch '" << pBatch->getName() << "' from worker #" << nVictimIdx << std::endl;
+#endif //CONSOLE_DEBUG
+    return pBatch;
+}
+
+void lv::WorkBatchScheduler::startPrecaching(const IDataHandlerPtr& pBatch) {
+    if(m_spPrecachingBatches.insert(pBatch.get()).second)
+        pBatch->startPrecaching(m_bPrecacheGT,m_nPrecacheBufferSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::WorkBatchLoadModel::WorkBatchLoadModel(const std::string& sStatsFilePath, const std::string& sAlgoName) :
+        m_sStatsFilePath(sStatsFilePath),m_sAlgoName(sAlgoName) {
+    lvAssert_(!m_sAlgoName.empty() && m_sAlgoName.find('\t')==std::string::npos,"algorithm name must be non-empty, and cannot contain tabs");
+    // stats file format: one line per batch, with tab-separated 'algo name, batch rel path, packet count, process time (sec), default load'
+    std::ifstream oStatsFile(m_sStatsFilePath);
+    std::string sLine;
+    while(std::getline(oStatsFile,sLine)) {
+        std::istringstream oLineStream(sLine);
+        std::string sLineAlgoName,sBatchPath,sPacketCount,sProcessTime,sLoad;
+        if(std::getline(oLineStream,sLineAlgoName,'\t') && std::getline(oLineStream,sBatchPath,'\t') &&
+           std::getline(oLineStream,sPacketCount,'\t') && std::getline(oLineStream,sProcessTime,'\t') && std::getline(oLineStream,sLoad)) {
+            try {
+                const BatchStats oStats = {(size_t)std::stoull(sPacketCount),std::stod(sProcessTime),std::stod(sLoad)};
+                m_mmStats[sLineAlgoName][sBatchPath] = oStats;
+            }
+            catch(const std::exception&) {
+                std::cerr << "Warning: skipping corrupt line in load stats file '" << m_sStatsFilePath << "':\n\t" << sLine << std::endl;
+            }
         }
     }
 }
 
+double lv::WorkBatchLoadModel::getExpectedLoad(const IDataHandlerPtr& pBatch) const {
+    lvAssert_(pBatch,"invalid batch");
+    const double dDefaultLoad = pBatch->getExpectedLoad();
+    std::mutex_lock_guard sync_lock(m_oSyncMutex);
+    const auto pAlgoStats = m_mmStats.find(m_sAlgoName);
+    if(pAlgoStats==m_mmStats.end() || pAlgoStats->second.empty())
+        return dDefaultLoad; // no stats available for this algo, all batches stay in default load units
+    const auto pBatchStats = pAlgoStats->second.find(pBatch->getRelativePath());
+    if(pBatchStats!=pAlgoStats->second.end() && pBatchStats->second.dLoad>0)
+        return dDefaultLoad*pBatchStats->second.dProcessTime_sec/pBatchStats->second.dLoad; // batch-specific cost factor (captures content-dependent costs)
+    double dTotProcessTime_sec=0.0,dTotLoad=0.0;
+    for(const auto& oBatchStatsPair : pAlgoStats->second) {
+        dTotProcessTime_sec += oBatchStatsPair.second.dProcessTime_sec;
+        dTotLoad += oBatchStatsPair.second.dLoad;
+    }
+    return dTotLoad>0?dDefaultLoad*dTotProcessTime_sec/dTotLoad:dDefaultLoad;
+}
+
+lv::IDataHandlerPtrQueue lv::WorkBatchLoadModel::getSortedBatches(const IDataHandlerPtrArray& vpBatches) const {
+    std::unordered_map<const IDataHandler*,double> mLoads;
+    for(const auto& pBatch : vpBatches)
+        mLoads[pBatch.get()] = getExpectedLoad(pBatch);
+    IDataHandlerPtrQueue vpSortedBatches([mLoads](const IDataHandlerPtr& i, const IDataHandlerPtr& j) {
+        return mLoads.at(i.get())<mLoads.at(j.get());
+    });
+    for(const auto& pBatch : vpBatches)
+        vpSortedBatches.push(pBatch);
+    return vpSortedBatches;
+}
+
+void lv::WorkBatchLoadModel::record(const IDataHandlerPtr& pBatch) {
+    lvAssert_(pBatch,"invalid batch");
+    const size_t nPacketCount = pBatch->getProcessedOutputCount();
+    const double dProcessTime_sec = pBatch->getProcessTime();
+    const double dLoad = pBatch->getExpectedLoad();
+    if(nPacketCount==0 || nPacketCount<pBatch->getExpectedOutputCount() || dProcessTime_sec<=0.0 || dLoad<=0.0)
+        return; // batch was skipped or interrupted; nothing worth keeping
+    std::mutex_lock_guard sync_lock(m_oSyncMutex);
+    m_mmStats[m_sAlgoName][pBatch->getRelativePath()] = BatchStats{nPacketCount,dProcessTime_sec,dLoad};
+}
+
+void lv::WorkBatchLoadModel::write() const {
+    std::mutex_lock_guard sync_lock(m_oSyncMutex);
+    std::ofstream oStatsFile(m_sStatsFilePath,std::ios::out|std::ios::trunc);
+    lvAssert_(oStatsFile.is_open(),"could not open load stats file for writing");
+    oStatsFile << std::setprecision(9);
+    for(const auto& oAlgoStatsPair : m_mmStats)
+        for(const auto& oBatchStatsPair : oAlgoStatsPair.second)
+            oStatsFile << oAlgoStatsPair.first << '\t' << oBatchStatsPair.first << '\t' << oBatchStatsPair.second.nPacketCount << '\t'
+                       << oBatchStatsPair.second.dProcessTime_sec << '\t' << oBatchStatsPair.second.dLoad << '\n';
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void lv::IDataArchiver_<lv::NotArray>::save(const cv::Mat& oOutput, size_t nIdx, int /*nFlags*/) {
+namespace {
+
+    /// returns whether an 8-bit single-channel image only contains 0/255 values (exits on the first non-binary pixel)
+    bool isBinaryMask(const cv::Mat& oImage) {
+        lvDbgAssert(oImage.type()==CV_8UC1);
+        for(int nRowIdx=0; nRowIdx<oImage.rows; ++nRowIdx) {
+            const uchar* pRow = oImage.ptr<uchar>(nRowIdx);
+            for(int nColIdx=0; nColIdx<oImage.cols; ++nColIdx)
+                if(uchar(pRow[nColIdx]+1)>1)
+                    return false;
+        }
+        return true;
+    }
+
+    /// encodes an 8-bit single-channel image as (value,run length) pairs, with run lengths packed as LEB128 varints
+    void encodeRLE(const cv::Mat& oImage, std::vector<uchar>& vcPayload) {
+        lvDbgAssert(oImage.type()==CV_8UC1 && !oImage.empty());
+        vcPayload.clear();
+        const auto lPushRun = [&](uchar nVal, size_t nRunLength) {
+            vcPayload.push_back(nVal);
+            while(nRunLength>=0x80) {
+                vcPayload.push_back(uchar(nRunLength|0x80));
+                nRunLength >>= 7;
+            }
+            vcPayload.push_back(uchar(nRunLength));
+        };
+        uchar nCurrVal = oImage.at<uchar>(0,0);
+        size_t nCurrRunLength = 0;
+        for(int nRowIdx=0; nRowIdx<oImage.rows; ++nRowIdx) {
+            const uchar* pRow = oImage.ptr<uchar>(nRowIdx);
+            for(int nColIdx=0; nColIdx<oImage.cols; ++nColIdx) {
+                if(pRow[nColIdx]!=nCurrVal) {
+                    lPushRun(nCurrVal,nCurrRunLength);
+                    nCurrVal = pRow[nColIdx];
+                    nCurrRunLength = 0;
+                }
+                ++nCurrRunLength;
+            }
+        }
+        lPushRun(nCurrVal,nCurrRunLength);
+    }
+
+    /// decodes an RLE payload created by 'encodeRLE' into a pre-allocated (continuous) 8-bit single-channel image
+    void decodeRLE(const std::vector<uchar>& vcPayload, cv::Mat& oImage) {
+        lvDbgAssert(oImage.type()==CV_8UC1 && oImage.isContinuous());
+        uchar* pCurrData = oImage.data;
+        uchar* const pEndData = oImage.data+oImage.total();
+        size_t nPayloadIdx = 0;
+        while(nPayloadIdx<vcPayload.size()) {
+            const uchar nVal = vcPayload[nPayloadIdx++];
+            size_t nRunLength = 0;
+            for(size_t nShift=0; nPayloadIdx<vcPayload.size(); nShift+=7) {
+                const uchar nByte = vcPayload[nPayloadIdx++];
+                nRunLength |= size_t(nByte&0x7F)<<nShift;
+                if(!(nByte&0x80))
+                    break;
+            }
+            lvAssert_(nRunLength<=size_t(pEndData-pCurrData),"corrupted RLE payload (run overflows packet)");
+            std::fill_n(pCurrData,nRunLength,nVal);
+            pCurrData += nRunLength;
+        }
+        lvAssert_(pCurrData==pEndData,"corrupted RLE payload (packet underflow)");
+    }
+
+    /// container header magic & version (each chunk then holds: [idx:u64][rows:i32][cols:i32][payload size:u64][payload], in native byte order)
+    const std::array<char,4> g_acContainerMagic = {'L','V','R','L'};
+    const uint32_t g_nContainerVersion = 1;
+
+} // anonymous namespace
+
+void lv::IDataArchiver_<lv::NotArray>::save(const cv::Mat& oOutput, size_t nIdx, int nFlags) {
     const auto pLoader = shared_from_this_cast<const IIDataLoader>(true);
     if(pLoader->getOutputPacketType()==ImagePacket) {
-        lvAssert_(!getDatasetInfo()->getOutputNameSuffix().empty(),"data archiver requires image packet output name suffix (i.e. file extension)");
-        std::stringstream sOutputFilePath;
-        sOutputFilePath << getOutputPath() << getDatasetInfo()->getOutputNamePrefix() << getOutputName(nIdx) << getDatasetInfo()->getOutputNameSuffix();
-        cv::Mat oOutputClone = oOutput.clone();
+        if(nFlags==-1)
+            nFlags = 0;
         // automatically gray-out zones outside ROI if output is binary image mask with 1:1 mapping (e.g. segmentation)
-        if(pLoader->getGTPacketType()==ImagePacket && pLoader->getGTMappingType()==PixelMapping && oOutput.type()==CV_8UC1 && (cv::countNonZero(oOutput==UCHAR_MAX)+cv::countNonZero(oOutput==0))==oOutput.size().area()) {
+        const bool bIsBinaryMask = pLoader->getGTPacketType()==ImagePacket && pLoader->getGTMappingType()==PixelMapping && oOutput.type()==CV_8UC1 && ((nFlags&Archiver_BinaryMask) || isBinaryMask(oOutput));
+        cv::Mat oOutputFinal = oOutput;
+        if(bIsBinaryMask) {
             const cv::Mat& oROI = pLoader->getGTROI(nIdx);
-            if(!oROI.empty() && oROI.size()==oOutputClone.size()) {
-                cv::bitwise_or(oOutputClone,UCHAR_MAX/2,oOutputClone,oROI==0);
-                cv::bitwise_and(oOutputClone,UCHAR_MAX/2,oOutputClone,oROI==0);
+            if(!oROI.empty() && oROI.size()==oOutput.size()) {
+                oOutputFinal = oOutput.clone();
+                oOutputFinal.setTo(UCHAR_MAX/2,oROI==0);
             }
         }
-        const std::vector<int> vnComprParams = {cv::IMWRITE_PNG_COMPRESSION,9};
-        cv::imwrite(sOutputFilePath.str(),oOutputClone,vnComprParams);
+        if(nFlags&Archiver_Container) {
+            lvAssert_(oOutputFinal.type()==CV_8UC1,"data archiver container only supports 8-bit single-channel image packets");
+            thread_local std::vector<uchar> s_vcPayload;
+            encodeRLE(oOutputFinal,s_vcPayload);
+            std::mutex_lock_guard sync_lock(m_oContainerMutex);
+            if(!m_oContainerStream.is_open()) {
+                m_oContainerStream.open(getContainerPath(),std::ios::out|std::ios::binary|std::ios::trunc);
+                lvAssert_(m_oContainerStream.is_open(),"could not open data archiver container file for writing");
+                m_oContainerStream.write(g_acContainerMagic.data(),g_acContainerMagic.size());
+                m_oContainerStream.write((const char*)&g_nContainerVersion,sizeof(g_nContainerVersion));
+                m_mContainerIndex.clear();
+            }
+            const uint64_t nChunkIdx = nIdx, nPayloadSize = s_vcPayload.size();
+            const int32_t nRows = oOutputFinal.rows, nCols = oOutputFinal.cols;
+            m_mContainerIndex[nIdx] = m_oContainerStream.tellp();
+            m_oContainerStream.write((const char*)&nChunkIdx,sizeof(nChunkIdx));
+            m_oContainerStream.write((const char*)&nRows,sizeof(nRows));
+            m_oContainerStream.write((const char*)&nCols,sizeof(nCols));
+            m_oContainerStream.write((const char*)&nPayloadSize,sizeof(nPayloadSize));
+            m_oContainerStream.write((const char*)s_vcPayload.data(),s_vcPayload.size());
+            lvAssert_(m_oContainerStream.good(),"failed to write packet to data archiver container file");
+        }
+        else {
+            lvAssert_(!getDatasetInfo()->getOutputNameSuffix().empty(),"data archiver requires image packet output name suffix (i.e. file extension)");
+            std::stringstream sOutputFilePath;
+            sOutputFilePath << getOutputPath() << getDatasetInfo()->getOutputNamePrefix() << getOutputName(nIdx) << getDatasetInfo()->getOutputNameSuffix();
+            // max compression is very slow to encode for little gain on masks; default = fast deflate, w/ run-length strategy for masks
+            const std::vector<int> vnComprParams = (nFlags&Archiver_MaxCompression)?
+                std::vector<int>{cv::IMWRITE_PNG_COMPRESSION,9}:
+                std::vector<int>{cv::IMWRITE_PNG_COMPRESSION,DATAARCHIVER_FAST_PNG_COMPRESSION,cv::IMWRITE_PNG_STRATEGY,bIsBinaryMask?cv::IMWRITE_PNG_STRATEGY_RLE:cv::IMWRITE_PNG_STRATEGY_DEFAULT};
+            cv::imwrite(sOutputFilePath.str(),oOutputFinal,vnComprParams);
+        }
     }
     else {
         // @@@@ save to YML/bin file?
@@ -1168,6 +2269,51 @@ void lv::IDataArchiver_<lv::NotArray>::save(const cv::Mat& oOutput, size_t nIdx,
 cv::Mat lv::IDataArchiver_<lv::NotArray>::load(size_t nIdx, int nFlags) {
     const auto pLoader = shared_from_this_cast<const IIDataLoader>(true);
     if(pLoader->getOutputPacketType()==ImagePacket) {
+        if(nFlags!=-1 && (nFlags&Archiver_Container)) {
+            std::mutex_lock_guard sync_lock(m_oContainerMutex);
+            if(m_oContainerStream.is_open())
+                m_oContainerStream.flush();
+            std::ifstream oContainerStream(getContainerPath(),std::ios::in|std::ios::binary);
+            if(!oContainerStream.is_open())
+                return cv::Mat();
+            if(m_mContainerIndex.empty()) { // container was written by another instance; scan chunk headers once to rebuild the index
+                std::array<char,4> acMagic;
+                uint32_t nVersion;
+                oContainerStream.read(acMagic.data(),acMagic.size());
+                oContainerStream.read((char*)&nVersion,sizeof(nVersion));
+                lvAssert_(oContainerStream.good() && acMagic==g_acContainerMagic && nVersion==g_nContainerVersion,"bad data archiver container file header");
+                while(true) {
+                    const std::streamoff nChunkOffset = oContainerStream.tellg();
+                    uint64_t nChunkIdx,nPayloadSize;
+                    int32_t nRows,nCols;
+                    oContainerStream.read((char*)&nChunkIdx,sizeof(nChunkIdx));
+                    oContainerStream.read((char*)&nRows,sizeof(nRows));
+                    oContainerStream.read((char*)&nCols,sizeof(nCols));
+                    oContainerStream.read((char*)&nPayloadSize,sizeof(nPayloadSize));
+                    if(!oContainerStream.good())
+                        break;
+                    m_mContainerIndex[(size_t)nChunkIdx] = nChunkOffset;
+                    oContainerStream.seekg((std::streamoff)nPayloadSize,std::ios::cur);
+                }
+                oContainerStream.clear();
+            }
+            if(!m_mContainerIndex.count(nIdx))
+                return cv::Mat();
+            oContainerStream.seekg(m_mContainerIndex[nIdx]);
+            uint64_t nChunkIdx,nPayloadSize;
+            int32_t nRows,nCols;
+            oContainerStream.read((char*)&nChunkIdx,sizeof(nChunkIdx));
+            oContainerStream.read((char*)&nRows,sizeof(nRows));
+            oContainerStream.read((char*)&nCols,sizeof(nCols));
+            oContainerStream.read((char*)&nPayloadSize,sizeof(nPayloadSize));
+            lvAssert_(oContainerStream.good() && nChunkIdx==nIdx && nRows>0 && nCols>0,"bad data archiver container chunk header");
+            std::vector<uchar> vcPayload((size_t)nPayloadSize);
+            oContainerStream.read((char*)vcPayload.data(),vcPayload.size());
+            lvAssert_(oContainerStream.good(),"failed to read packet from data archiver container file");
+            cv::Mat oPacket(nRows,nCols,CV_8UC1);
+            decodeRLE(vcPayload,oPacket);
+            return oPacket;
+        }
         lvAssert_(!getDatasetInfo()->getOutputNameSuffix().empty(),"data archiver requires packet output name suffix (i.e. file extension)");
         std::stringstream sOutputFilePath;
         sOutputFilePath << getOutputPath() << getDatasetInfo()->getOutputNamePrefix() << getOutputName(nIdx) << getDatasetInfo()->getOutputNameSuffix();
@@ -1179,6 +2325,10 @@ cv::Mat lv::IDataArchiver_<lv::NotArray>::load(size_t nIdx, int nFlags) {
     }
 }
 
+std::string lv::IDataArchiver_<lv::NotArray>::getContainerPath() const {
+    return getOutputPath()+getDatasetInfo()->getOutputNamePrefix()+DATAARCHIVER_CONTAINER_NAME;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void lv::IDataArchiver_<lv::Array>::saveArray(const std::vector<cv::Mat>& /*vOutput*/, size_t /*nIdx*/, int /*nFlags*/) {
@@ -1278,18 +2428,19 @@ void lv::IAsyncDataConsumer_<lv::DatasetEval_BinaryClassifier,lv::GLSL>::post_ap
     }
     if(getDatasetInfo()->isSavingOutput() || m_pAlgo->m_pDisplayHelper || m_lDataCallback) {
         cv::Mat oLastOutput,oLastDebug;
-        m_pAlgo->fetchLastOutput(oLastOutput);
+        // outputs are paired w/ their input/gt below, so the fetch waits for the latest frame instead of returning an older one
+        m_pAlgo->fetchLastOutput(oLastOutput,true);
         if(m_pAlgo->m_pDisplayHelper && m_pEvalAlgo && m_pEvalAlgo->m_bUsingDebug)
-            m_pEvalAlgo->fetchLastDebug(oLastDebug);
+            m_pEvalAlgo->fetchLastDebug(oLastDebug,true);
         else if(m_pAlgo->m_pDisplayHelper && m_pAlgo->m_bUsingDebug)
-            m_pAlgo->fetchLastDebug(oLastDebug);
+            m_pAlgo->fetchLastDebug(oLastDebug,true);
         else
             oLastDebug = oLastOutput.clone();
         countOutput(m_nLastIdx);
         if(m_lDataCallback)
             m_lDataCallback(m_oLastInput,oLastDebug,oLastOutput,m_oLastGT,m_pLoader->getGTROI(m_nLastIdx),m_nLastIdx);
         if(getDatasetInfo()->isSavingOutput() && !oLastOutput.empty())
-            save(oLastOutput,m_nLastIdx);
+            save(oLastOutput,m_nLastIdx,Archiver_BinaryMask);
         if(m_pAlgo->m_pDisplayHelper && m_pLoader->getGTPacketType()==ImagePacket && m_pLoader->getGTMappingType()==PixelMapping) {
             getColoredMasks(oLastOutput,oLastDebug,m_oLastGT,m_pLoader->getGTROI(m_nLastIdx));
             m_pAlgo->m_pDisplayHelper->display(m_oLastInput,oLastDebug,oLastOutput,m_nLastIdx);
@@ -177,33 +177,23 @@ public:
         // note: this function is used to threshold an LBSP pattern based on a predefined lookup array (see LBSP_16bits_dbcross_lookup for more information)
         // @@@ todo: use array template to unroll loops & allow any descriptor size here
         lvDbgAssert_(anVals,"need to provide a valid pixel pointer");
-#if (!HAVE_SSE4_1 && !HAVE_SSE2)
+#if !HAVE_SSE2
         desc_t nDesc = 0;
         lv::unroll<LBSP::DESC_SIZE_BITS>([&](int n) {
             nDesc |= (lv::L1dist(anVals[n],nRef) > nThreshold) << n;
         });
         return nDesc;
-#else //(HAVE_SSE4_1 || HAVE_SSE2)
+#else //HAVE_SSE2
         static_assert(LBSP::DESC_SIZE_BITS==16,"current sse impl can only manage 16-byte chunks");
         // @@@@ send <16byte back to non-sse, and >16 to loop via template enableif?
         lvDbgAssert_(((uintptr_t)(&anVals[0])&15)==0,"pixel pointer must be 16-byte aligned");
         __m128i _anInputVals = _mm_load_si128((__m128i*)&anVals[0]); // @@@@@ load? or just cast?
         __m128i _anRefVals = _mm_set1_epi8(nRef);
-#if HAVE_SSE4_1
+        // unsigned byte min/max are part of sse2, so portable builds get the same (short) sequence as native ones
         __m128i _anDistVals = _mm_sub_epi8(_mm_max_epu8(_anInputVals,_anRefVals),_mm_min_epu8(_anInputVals,_anRefVals));
         __m128i _abCmpRes = _mm_cmpgt_epi8(_mm_xor_si128(_anDistVals,_mm_set1_epi8(uchar(0x80))),_mm_set1_epi8(uchar(nThreshold^0x80)));
-#else //HAVE_SSE2
-        __m128i _anBitFlipper = _mm_set1_epi8(uchar(0x80));
-        __m128i _anDistVals = _mm_xor_si128(_anInputVals,_anBitFlipper);
-        _anRefVals = _mm_xor_si128(_anRefVals,_anBitFlipper);
-        __m128i _abCmpRes = _mm_cmpgt_epi8(_anDistVals,_anRefVals);
-        __m128i _anDistVals1 = _mm_sub_epi8(_anDistVals,_anRefVals);
-        __m128i _anDistVals2 = _mm_sub_epi8(_anRefVals,_anDistVals);
-        _anDistVals = _mm_or_si128(_mm_and_si128(_abCmpRes,_anDistVals1),_mm_andnot_si128(_abCmpRes,_anDistVals2));
-        _abCmpRes = _mm_cmpgt_epi8(_mm_xor_si128(_anDistVals,_anBitFlipper),_mm_set1_epi8(uchar(nThreshold^0x80)));
-#endif //HAVE_SSE2
         return (desc_t)_mm_movemask_epi8(_abCmpRes);
-#endif //(HAVE_SSE4_1 || HAVE_SSE2)
+#endif //HAVE_SSE2
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP gradient computation function (mixes rel+abs, returns max-channel only)
@@ -86,6 +86,16 @@ using IEdgeDetector_GLSL = IEdgeDetector_<lv::GLSL>;
 // IEdgeDetector_<lv::OpenCL> will not compile here, missing impl
 #endif //HAVE_OPENCL
 
+template<>
+struct IEdgeDetector_<lv::CPUThreaded> :
+        public lv::IParallelAlgo_CPUThreaded,
+        public IIEdgeDetector {
+    /// required for derived class destruction from this interface
+    virtual ~IEdgeDetector_() {}
+};
+
+using IEdgeDetector_CPUThreaded = IEdgeDetector_<lv::CPUThreaded>;
+
 template<>
 struct IEdgeDetector_<lv::NonParallel> :
         public lv::NonParallelAlgo,
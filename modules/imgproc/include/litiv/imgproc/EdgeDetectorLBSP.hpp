@@ -29,12 +29,15 @@
 /// defines the default value for the threshold passed to EdgeDetectorLBSP::apply_threshold
 #define EDGLBSP_DEFAULT_DET_THRESHOLD ((double)EDGLBSP_DEFAULT_DET_THRESHOLD_INTEGER/LBSP::MAX_GRAD_MAG)
 
-class EdgeDetectorLBSP : public IEdgeDetector {
+/// LBSP-based edge detector; the lv::CPUThreaded impl splits the threshold sweep of 'apply' over the shared thread pool
+template<lv::ParallelAlgoType eImpl>
+class EdgeDetectorLBSP_ : public IEdgeDetector_<eImpl> {
+    static_assert(eImpl==lv::NonParallel || eImpl==lv::CPUThreaded,"missing LBSP edge detector impl for this parallel algo type");
 public:
     /// full constructor
-    EdgeDetectorLBSP(size_t nLevels=EDGLBSP_DEFAULT_LEVEL_COUNT,
-                     double dHystLowThrshFactor=EDGLBSP_DEFAULT_HYST_LOW_THRSH_FACT,
-                     bool bNormalizeOutput=false);
+    EdgeDetectorLBSP_(size_t nLevels=EDGLBSP_DEFAULT_LEVEL_COUNT,
+                      double dHystLowThrshFactor=EDGLBSP_DEFAULT_HYST_LOW_THRSH_FACT,
+                      bool bNormalizeOutput=false);
     /// returns the default edge detection threshold value used in 'apply'
     virtual double getDefaultThreshold() const {return EDGLBSP_DEFAULT_DET_THRESHOLD;}
     /// thresholded edge detection function; the edge detection threshold should be between 0 and 1 (will use default otherwise)
@@ -56,21 +59,29 @@ protected:
     std::vector<std::aligned_vector<uchar,32>> m_vvuInputPyrMaps;
     /// pre-allocated image pyramid LUT maps for multi-scale LBSP computation
     std::vector<std::aligned_vector<uchar,32>> m_vvuLBSPLookupMaps;
-    /// pre-allocated image gradient reconstruction map
-    std::aligned_vector<uchar,32> m_vuLBSPGradMapData;
-    /// pre-allocated image edge reconstruction map
-    std::aligned_vector<uchar,32> m_vuEdgeTempMaskData;
+    /// pre-allocated image gradient reconstruction maps (one per scheduler tile)
+    std::vector<std::aligned_vector<uchar,32>> m_vvuLBSPGradMapData;
+    /// pre-allocated image edge reconstruction maps (one per scheduler tile)
+    std::vector<std::aligned_vector<uchar,32>> m_vvuEdgeTempMaskData;
     /// multi-level image map size lookup list
     std::vector<cv::Size> m_voMapSizeList;
-    /// hysteresis recursive search stack
-    std::vector<uchar*> m_vuHystStack;
+    /// hysteresis recursive search stacks (one per scheduler tile)
+    std::vector<std::vector<uchar*>> m_vvuHystStack;
+    /// scratch memory for per-call temporaries (blurred input, per-tile edge masks)
+    lv::FrameArena m_oFrameArena;
 
     /// internal lookup/pyramiding function w/ explicit definitions for 1 to 4 channels
     template<size_t nChannels>
     void apply_internal_lookup(const cv::Mat& oInputImg);
     void apply_internal_lookup(const cv::Mat& oInputImg, size_t nChannels);
-    /// internal thresholding function w/ explicit definitions for 1 to 4 channels
+    /// internal thresholding function w/ explicit definitions for 1 to 4 channels (uses the pre-allocated buffers of the given tile)
     template<size_t nChannels>
-    void apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold);
-    void apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold, size_t nChannels);
+    void apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold, size_t nTileIdx);
+    void apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold, size_t nChannels, size_t nTileIdx);
+
+    /// members inherited from the (dependent) base interfaces, used unqualified by the impl
+    using IEdgeDetector_<eImpl>::m_nROIBorderSize;
 };
+
+using EdgeDetectorLBSP_CPUThreaded = EdgeDetectorLBSP_<lv::CPUThreaded>;
+using EdgeDetectorLBSP = EdgeDetectorLBSP_<lv::NonParallel>;
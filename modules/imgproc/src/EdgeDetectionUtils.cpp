@@ -28,7 +28,7 @@ void IEdgeDetector_GLSL::getLatestEdgeMask(cv::OutputArray _oLastEdgeMask) {
     cv::Mat oLastEdgeMask = _oLastEdgeMask.getMat();
     lvAssert_(GLImageProcAlgo::m_bFetchingOutput || GLImageProcAlgo::setOutputFetching(true),"algo not initialized with mat output support")
     if(GLImageProcAlgo::m_nInternalFrameIdx>0)
-        GLImageProcAlgo::fetchLastOutput(oLastEdgeMask);
+        GLImageProcAlgo::fetchLastOutput(oLastEdgeMask,true); // always the previous frame, regardless of pbo transfer timing
     else
         oLastEdgeMask = cv::Scalar_<uchar>(0);
 }
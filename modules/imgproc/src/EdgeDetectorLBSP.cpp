@@ -23,22 +23,27 @@
 #define USE_MIN_GRAD_ORIENT       1
 #define USE_3_AXIS_ORIENT         1
 
-EdgeDetectorLBSP::EdgeDetectorLBSP(size_t nLevels, double dHystLowThrshFactor, bool bNormalizeOutput) :
+template<lv::ParallelAlgoType eImpl>
+EdgeDetectorLBSP_<eImpl>::EdgeDetectorLBSP_(size_t nLevels, double dHystLowThrshFactor, bool bNormalizeOutput) :
         m_nLevels(nLevels),
         m_dHystLowThrshFactor(dHystLowThrshFactor),
         m_dGaussianKernelSigma(0),
         m_bNormalizeOutput(bNormalizeOutput),
         m_vvuInputPyrMaps(std::max(nLevels,size_t(1))-1),
         m_vvuLBSPLookupMaps(nLevels),
-        m_voMapSizeList(nLevels) {
+        m_voMapSizeList(nLevels),
+        m_vvuLBSPGradMapData(1),
+        m_vvuEdgeTempMaskData(1),
+        m_vvuHystStack(1) {
     lvAssert_(m_dHystLowThrshFactor>0 && m_dHystLowThrshFactor<1,"lower hysteresis threshold factor must be between 0 and 1");
     lvAssert_(m_dGaussianKernelSigma>=0,"gaussian smoothing kernel sigma must be non-negative");
     m_nROIBorderSize = LBSP::PATCH_SIZE/2;
     lvAssert_(m_nLevels>0,"number of pyramid levels must be positive");
 }
 
+template<lv::ParallelAlgoType eImpl>
 template<size_t nChannels>
-void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg) {
+void EdgeDetectorLBSP_<eImpl>::apply_internal_lookup(const cv::Mat& oInputImg) {
     lvAssert_(!oInputImg.empty() && oInputImg.isContinuous(),"input image must be non-empty and continuous");
     const int nOrigType = CV_8UC(int(nChannels));
     lvDbgAssert(m_nROIBorderSize==LBSP::PATCH_SIZE/2);
@@ -142,12 +147,8 @@ void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg) {
     }
 }
 
-template void EdgeDetectorLBSP::apply_internal_lookup<1>(const cv::Mat&);
-template void EdgeDetectorLBSP::apply_internal_lookup<2>(const cv::Mat&);
-template void EdgeDetectorLBSP::apply_internal_lookup<3>(const cv::Mat&);
-template void EdgeDetectorLBSP::apply_internal_lookup<4>(const cv::Mat&);
-
-void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg, size_t nChannels) {
+template<lv::ParallelAlgoType eImpl>
+void EdgeDetectorLBSP_<eImpl>::apply_internal_lookup(const cv::Mat& oInputImg, size_t nChannels) {
     if(nChannels==1)
         apply_internal_lookup<1>(oInputImg);
     else if(nChannels==2)
@@ -160,10 +161,15 @@ void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg, size_t nC
         CV_Error(-1,"Unexpected channel count");
 }
 
+template<lv::ParallelAlgoType eImpl>
 template<size_t nChannels>
-void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold) {
+void EdgeDetectorLBSP_<eImpl>::apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold, size_t nTileIdx) {
     lvAssert_(!oInputImg.empty() && oInputImg.isContinuous(),"input image must be non-empty and continuous");
     lvAssert_(!oEdgeMask.empty() && oEdgeMask.isContinuous(),"output mask must be non-empty and continuous");
+    lvDbgAssert(nTileIdx<m_vvuLBSPGradMapData.size() && nTileIdx<m_vvuEdgeTempMaskData.size() && nTileIdx<m_vvuHystStack.size());
+    std::aligned_vector<uchar,32>& vuLBSPGradMapData = m_vvuLBSPGradMapData[nTileIdx];
+    std::aligned_vector<uchar,32>& vuEdgeTempMaskData = m_vvuEdgeTempMaskData[nTileIdx];
+    std::vector<uchar*>& vuHystStack = m_vvuHystStack[nTileIdx];
     const int nOrigType = CV_8UC(int(nChannels));
     const size_t nColLUTStep = LBSP::DESC_SIZE_BITS*nChannels;
     const uchar nHystHighThreshold = nDetThreshold;
@@ -175,26 +181,26 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
     const size_t nGradMapRowStep = oMapSize.width*nGradMapColStep;
     constexpr size_t nEdgeMapColStep = 1; // 1ch (label)
     const size_t nEdgeMapRowStep = oMapSize.width*nEdgeMapColStep;
-    m_vuLBSPGradMapData.resize(oMapSize.height*nGradMapRowStep);
-    m_vuEdgeTempMaskData.resize(oMapSize.height*nEdgeMapRowStep);
-    cv::Mat oGradMap(oMapSize,CV_8UC4,m_vuLBSPGradMapData.data());
-    cv::Mat oEdgeTempMask(oMapSize,CV_8UC1,m_vuEdgeTempMaskData.data());
-    std::fill(m_vuLBSPGradMapData.data(),m_vuLBSPGradMapData.data()+nGradMapRowStep*nNMSHalfWinSize,0);
-    std::fill(m_vuLBSPGradMapData.data()+(oMapSize.height-nNMSHalfWinSize)*nGradMapRowStep,m_vuLBSPGradMapData.data()+oMapSize.height*nGradMapRowStep,0);
-    std::fill(m_vuEdgeTempMaskData.data(),m_vuEdgeTempMaskData.data()+nEdgeMapRowStep*nNMSHalfWinSize,1);
-    std::fill(m_vuEdgeTempMaskData.data()+(oMapSize.height-nNMSHalfWinSize)*nEdgeMapRowStep,m_vuEdgeTempMaskData.data()+oMapSize.height*nEdgeMapRowStep,1);
+    vuLBSPGradMapData.resize(oMapSize.height*nGradMapRowStep);
+    vuEdgeTempMaskData.resize(oMapSize.height*nEdgeMapRowStep);
+    cv::Mat oGradMap(oMapSize,CV_8UC4,vuLBSPGradMapData.data());
+    cv::Mat oEdgeTempMask(oMapSize,CV_8UC1,vuEdgeTempMaskData.data());
+    std::fill(vuLBSPGradMapData.data(),vuLBSPGradMapData.data()+nGradMapRowStep*nNMSHalfWinSize,0);
+    std::fill(vuLBSPGradMapData.data()+(oMapSize.height-nNMSHalfWinSize)*nGradMapRowStep,vuLBSPGradMapData.data()+oMapSize.height*nGradMapRowStep,0);
+    std::fill(vuEdgeTempMaskData.data(),vuEdgeTempMaskData.data()+nEdgeMapRowStep*nNMSHalfWinSize,1);
+    std::fill(vuEdgeTempMaskData.data()+(oMapSize.height-nNMSHalfWinSize)*nEdgeMapRowStep,vuEdgeTempMaskData.data()+oMapSize.height*nEdgeMapRowStep,1);
 #if USE_MIN_GRAD_ORIENT
     static_assert(nGradMapColStep==4,"Need 32-bit chunks to copy (see lines with uint32_t)");
     constexpr uint32_t nDefaultGradMapVal4Ch = (CHAR_MAX<<24)|(CHAR_MAX<<16)|(UCHAR_MAX)<<8;
-    std::fill((uint32_t*)(m_vuLBSPGradMapData.data()+nGradMapRowStep*nNMSHalfWinSize+nGradMapColStep*nNMSHalfWinSize),(uint32_t*)(m_vuLBSPGradMapData.data()+(oMapSize.height-nNMSHalfWinSize)*nGradMapRowStep-nNMSHalfWinSize*nGradMapColStep),nDefaultGradMapVal4Ch);
+    std::fill((uint32_t*)(vuLBSPGradMapData.data()+nGradMapRowStep*nNMSHalfWinSize+nGradMapColStep*nNMSHalfWinSize),(uint32_t*)(vuLBSPGradMapData.data()+(oMapSize.height-nNMSHalfWinSize)*nGradMapRowStep-nNMSHalfWinSize*nGradMapColStep),nDefaultGradMapVal4Ch);
     const auto lAbsCharComp = [](char a, char b){return std::abs(a)<std::abs(b);};
 #else //(!USE_MIN_GRAD_ORIENT)
     oGradMap(cv::Rect(nNMSHalfWinSize,nNMSHalfWinSize,m_voMapSizeList.back().width,m_voMapSizeList.back().height)) = cv::Scalar_<uchar>(0,0,UCHAR_MAX,0);
 #endif //(!USE_MIN_GRAD_ORIENT)
-    size_t nCurrHystStackSize = std::max(std::max((size_t)1<<10,(size_t)oMapSize.area()/8),m_vuHystStack.size());
-    m_vuHystStack.resize(nCurrHystStackSize);
-    uchar** pauHystStack_top = &m_vuHystStack[0];
-    uchar** pauHystStack_bottom = &m_vuHystStack[0];
+    size_t nCurrHystStackSize = std::max(std::max((size_t)1<<10,(size_t)oMapSize.area()/8),vuHystStack.size());
+    vuHystStack.resize(nCurrHystStackSize);
+    uchar** pauHystStack_top = &vuHystStack[0];
+    uchar** pauHystStack_bottom = &vuHystStack[0];
     auto stack_push = [&](uchar* pAddr) {
         lvDbgAssert(pAddr>=oEdgeTempMask.datastart+nEdgeMapRowStep*nNMSHalfWinSize);
         lvDbgAssert(pAddr<oEdgeTempMask.dataend-nEdgeMapRowStep*nNMSHalfWinSize);
@@ -208,8 +214,8 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
         if(ptrdiff_t(pauHystStack_top-pauHystStack_bottom)+nPotentialSize>nCurrHystStackSize) {
             const ptrdiff_t nUsedHystStackSize = pauHystStack_top-pauHystStack_bottom;
             nCurrHystStackSize = std::max(nCurrHystStackSize*2,nUsedHystStackSize+nPotentialSize);
-            m_vuHystStack.resize(nCurrHystStackSize);
-            pauHystStack_bottom = &m_vuHystStack[0];
+            vuHystStack.resize(nCurrHystStackSize);
+            pauHystStack_bottom = &vuHystStack[0];
             pauHystStack_top = pauHystStack_bottom+nUsedHystStackSize;
         }
     };
@@ -356,62 +362,97 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
             oEdgeMaskData[nColIter] = (uchar)-(*(anEdgeTempMaskData+nColIter*nEdgeMapColStep)>>1);
 }
 
-template void EdgeDetectorLBSP::apply_internal_threshold<1>(const cv::Mat&, cv::Mat&, uchar);
-template void EdgeDetectorLBSP::apply_internal_threshold<2>(const cv::Mat&, cv::Mat&, uchar);
-template void EdgeDetectorLBSP::apply_internal_threshold<3>(const cv::Mat&, cv::Mat&, uchar);
-template void EdgeDetectorLBSP::apply_internal_threshold<4>(const cv::Mat&, cv::Mat&, uchar);
-
-void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold, size_t nChannels) {
+template<lv::ParallelAlgoType eImpl>
+void EdgeDetectorLBSP_<eImpl>::apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold, size_t nChannels, size_t nTileIdx) {
     if(nChannels==1)
-        apply_internal_threshold<1>(oInputImg,oEdgeMask,nDetThreshold);
+        apply_internal_threshold<1>(oInputImg,oEdgeMask,nDetThreshold,nTileIdx);
     else if(nChannels==2)
-        apply_internal_threshold<2>(oInputImg,oEdgeMask,nDetThreshold);
+        apply_internal_threshold<2>(oInputImg,oEdgeMask,nDetThreshold,nTileIdx);
     else if(nChannels==3)
-        apply_internal_threshold<3>(oInputImg,oEdgeMask,nDetThreshold);
+        apply_internal_threshold<3>(oInputImg,oEdgeMask,nDetThreshold,nTileIdx);
     else if(nChannels==4)
-        apply_internal_threshold<4>(oInputImg,oEdgeMask,nDetThreshold);
+        apply_internal_threshold<4>(oInputImg,oEdgeMask,nDetThreshold,nTileIdx);
     else
         CV_Error(-1,"Unexpected channel count");
 }
 
-void EdgeDetectorLBSP::apply_threshold(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask, double dDetThreshold) {
+template<lv::ParallelAlgoType eImpl>
+void EdgeDetectorLBSP_<eImpl>::apply_threshold(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask, double dDetThreshold) {
     cv::Mat oInputImg = _oInputImage.getMat();
     lvAssert_(!oInputImg.empty() && oInputImg.isContinuous(),"input image must be non-empty and continuous");
     lvAssert_(oInputImg.depth()==CV_8U,"input image depth must be 8U")
+    lv::FrameArena::Scope oArenaScope(m_oFrameArena);
     if(m_dGaussianKernelSigma>0) {
         const int nDefaultKernelSize = int(8*ceil(m_dGaussianKernelSigma));
         const int nRealKernelSize = nDefaultKernelSize%2==0?nDefaultKernelSize+1:nDefaultKernelSize;
-        oInputImg = oInputImg.clone();
-        cv::GaussianBlur(oInputImg,oInputImg,cv::Size(nRealKernelSize,nRealKernelSize),m_dGaussianKernelSigma,m_dGaussianKernelSigma);
+        cv::Mat oBlurredInputImg = cv::getArenaMat(m_oFrameArena,oInputImg.size(),oInputImg.type());
+        cv::GaussianBlur(oInputImg,oBlurredInputImg,cv::Size(nRealKernelSize,nRealKernelSize),m_dGaussianKernelSigma,m_dGaussianKernelSigma);
+        oInputImg = oBlurredInputImg;
     }
     _oEdgeMask.create(oInputImg.size(),CV_8UC1);
     cv::Mat oEdgeMask = _oEdgeMask.getMat();
     if(dDetThreshold<0||dDetThreshold>1)
         dDetThreshold = getDefaultThreshold();
     const uchar nDetThreshold = (uchar)(dDetThreshold*LBSP::MAX_GRAD_MAG);
-    apply_internal_lookup(oInputImg,oInputImg.channels());
-    apply_internal_threshold(oInputImg,oEdgeMask,nDetThreshold,oInputImg.channels());
+    // both passes are compiled once per simd level, so that the inline LBSP helpers use the best instruction set available at runtime
+    lv::invokeForSIMDLevel(lv::getSIMDLevel(),[&]() {
+        apply_internal_lookup(oInputImg,oInputImg.channels());
+        apply_internal_threshold(oInputImg,oEdgeMask,nDetThreshold,oInputImg.channels(),0);
+    });
 }
 
-void EdgeDetectorLBSP::apply(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask) {
+template<lv::ParallelAlgoType eImpl>
+void EdgeDetectorLBSP_<eImpl>::apply(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask) {
     cv::Mat oInputImg = _oInputImage.getMat();
     lvAssert_(!oInputImg.empty() && oInputImg.isContinuous(),"input image must be non-empty and continuous");
     lvAssert_(oInputImg.depth()==CV_8U,"input image depth must be 8U")
+    lv::FrameArena::Scope oArenaScope(m_oFrameArena);
     if(m_dGaussianKernelSigma>0) {
         const int nDefaultKernelSize = int(8*ceil(m_dGaussianKernelSigma));
         const int nRealKernelSize = nDefaultKernelSize%2==0?nDefaultKernelSize+1:nDefaultKernelSize;
-        oInputImg = oInputImg.clone();
-        cv::GaussianBlur(oInputImg,oInputImg,cv::Size(nRealKernelSize,nRealKernelSize),m_dGaussianKernelSigma,m_dGaussianKernelSigma);
+        cv::Mat oBlurredInputImg = cv::getArenaMat(m_oFrameArena,oInputImg.size(),oInputImg.type());
+        cv::GaussianBlur(oInputImg,oBlurredInputImg,cv::Size(nRealKernelSize,nRealKernelSize),m_dGaussianKernelSigma,m_dGaussianKernelSigma);
+        oInputImg = oBlurredInputImg;
     }
-    apply_internal_lookup(oInputImg,oInputImg.channels());
+    // both passes are compiled once per simd level, so that the inline LBSP helpers use the best instruction set available at runtime
+    const lv::SIMDLevel eSIMDLevel = lv::getSIMDLevel();
+    lv::invokeForSIMDLevel(eSIMDLevel,[&]() {
+        apply_internal_lookup(oInputImg,oInputImg.channels());
+    });
     _oEdgeMask.create(oInputImg.size(),CV_8UC1);
     cv::Mat oEdgeMask = _oEdgeMask.getMat();
     oEdgeMask = cv::Scalar_<uchar>(0);
-    cv::Mat oTempEdgeMask = oEdgeMask.clone();
-    for(size_t nCurrThreshold=0; nCurrThreshold<LBSP::MAX_GRAD_MAG; ++nCurrThreshold) {
-        apply_internal_threshold(oInputImg,oTempEdgeMask,uchar(nCurrThreshold),oInputImg.channels());
-        oEdgeMask += oTempEdgeMask/double(LBSP::MAX_GRAD_MAG);
+    // each tile sweeps its own threshold range with its own buffers; partial (saturated) sums are merged afterwards
+    const size_t nTileCount = std::max(this->getTileCount(LBSP::MAX_GRAD_MAG),size_t(1));
+    if(m_vvuHystStack.size()<nTileCount) {
+        m_vvuLBSPGradMapData.resize(nTileCount);
+        m_vvuEdgeTempMaskData.resize(nTileCount);
+        m_vvuHystStack.resize(nTileCount);
+    }
+    // the arena is not thread-safe, so all tile buffers are carved out here, before dispatching the tiles
+    std::arena_vector<cv::Mat> voTileEdgeMasks(nTileCount,cv::Mat(),m_oFrameArena), voTempEdgeMasks(nTileCount,cv::Mat(),m_oFrameArena);
+    for(size_t nTileIdx=0; nTileIdx<nTileCount; ++nTileIdx) {
+        voTileEdgeMasks[nTileIdx] = (nTileIdx==0)?oEdgeMask:cv::getArenaMat(m_oFrameArena,oInputImg.size(),CV_8UC1);
+        voTempEdgeMasks[nTileIdx] = cv::getArenaMat(m_oFrameArena,oInputImg.size(),CV_8UC1);
     }
+    this->processTiles(LBSP::MAX_GRAD_MAG,1,[&](size_t nTileIdx, size_t nThresholdBegin, size_t nThresholdEnd) {
+        cv::Mat& oTileEdgeMask = voTileEdgeMasks[nTileIdx];
+        cv::Mat& oTempEdgeMask = voTempEdgeMasks[nTileIdx];
+        if(nTileIdx>0)
+            oTileEdgeMask = cv::Scalar_<uchar>(0);
+        for(size_t nCurrThreshold=nThresholdBegin; nCurrThreshold<nThresholdEnd; ++nCurrThreshold) {
+            lv::invokeForSIMDLevel(eSIMDLevel,[&]() {
+                apply_internal_threshold(oInputImg,oTempEdgeMask,uchar(nCurrThreshold),oInputImg.channels(),nTileIdx);
+            });
+            // same result as adding oTempEdgeMask/MAX_GRAD_MAG (the temp mask is binary), without the matrix expression temporary
+            cv::addWeighted(oTileEdgeMask,1.0,oTempEdgeMask,1.0/LBSP::MAX_GRAD_MAG,0.0,oTileEdgeMask);
+        }
+    });
+    for(size_t nTileIdx=1; nTileIdx<nTileCount; ++nTileIdx)
+        oEdgeMask += voTileEdgeMasks[nTileIdx];
     if(m_bNormalizeOutput)
         cv::normalize(oEdgeMask,oEdgeMask,0,UCHAR_MAX,cv::NORM_MINMAX);
 }
+
+template class EdgeDetectorLBSP_<lv::CPUThreaded>;
+template class EdgeDetectorLBSP_<lv::NonParallel>;
@@ -281,25 +281,6 @@ namespace lv {
         return vfResult;
     }
 
-    template<size_t nWorkers>
-    struct WorkerPool {
-        static_assert(nWorkers>0,"Worker pool must have at least one work thread");
-        WorkerPool();
-        ~WorkerPool();
-        template<typename Tfunc, typename... Targs>
-        std::future<std::result_of_t<Tfunc(Targs...)>> queueTask(Tfunc&& lTaskEntryPoint, Targs&&... args);
-    protected:
-        std::queue<std::function<void()>> m_qTasks;
-        std::vector<std::thread> m_vhWorkers;
-        std::mutex m_oSyncMutex;
-        std::condition_variable m_oSyncVar;
-        std::atomic_bool m_bIsActive;
-    private:
-        void entry();
-        WorkerPool(const WorkerPool&) = delete;
-        WorkerPool& operator=(const WorkerPool&) = delete;
-    };
-
     template<size_t nWordBitSize, typename Tr>
     constexpr inline std::enable_if_t<nWordBitSize==1,Tr> expand_bits(const Tr& nBits, int=0) {
         return nBits;
@@ -335,6 +316,33 @@ namespace lv {
         std::chrono::high_resolution_clock::time_point m_nTick;
     };
 
+    /// small & fast xorshift128+ pseudo-random number generator (not for crypto); unlike rand(), each instance owns its state, so
+    /// parallel code can give one to every thread/tile and stay both race-free and reproducible
+    struct FastRNG {
+        /// initializes the generator state from a seed (expanded via splitmix64, so close seeds still give unrelated sequences)
+        explicit FastRNG(uint64_t nSeed=0) {seed(nSeed);}
+        /// resets the generator state from a seed (see constructor)
+        inline void seed(uint64_t nSeed) {
+            for(uint64_t& nState : m_anState) {
+                uint64_t z = (nSeed += 0x9E3779B97F4A7C15ull);
+                z = (z^(z>>30))*0xBF58476D1CE4E5B9ull;
+                z = (z^(z>>27))*0x94D049BB133111EBull;
+                nState = z^(z>>31);
+            }
+        }
+        /// returns the next 32-bit pseudo-random value (upper bits of the xorshift128+ output, which are the most random ones)
+        inline uint32_t operator()() {
+            uint64_t s1 = m_anState[0];
+            const uint64_t s0 = m_anState[1];
+            m_anState[0] = s0;
+            s1 ^= s1<<23;
+            m_anState[1] = s1^s0^(s1>>17)^(s0>>26);
+            return uint32_t((m_anState[1]+s0)>>32);
+        }
+    private:
+        std::array<uint64_t,2> m_anState;
+    };
+
     inline std::string getTimeStamp() {
         std::time_t tNow = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
         char acBuffer[128];
@@ -514,47 +522,3 @@ namespace std { // extending std
     using mutex_unique_lock = unique_lock<mutex>;
 
 } // namespace std
-
-template<size_t nWorkers>
-lv::WorkerPool<nWorkers>::WorkerPool() : m_bIsActive(true) {
-    lv::unroll<nWorkers>([this](size_t){m_vhWorkers.emplace_back(std::bind(&WorkerPool::entry,this));});
-}
-
-template<size_t nWorkers>
-lv::WorkerPool<nWorkers>::~WorkerPool() {
-    m_bIsActive = false;
-    m_oSyncVar.notify_all();
-    for(std::thread& oWorker : m_vhWorkers)
-        oWorker.join();
-}
-
-template<size_t nWorkers>
-template<typename Tfunc, typename... Targs>
-std::future<std::result_of_t<Tfunc(Targs...)>> lv::WorkerPool<nWorkers>::queueTask(Tfunc&& lTaskEntryPoint, Targs&&... args) {
-    using task_return_t = std::result_of_t<Tfunc(Targs...)>;
-    using task_t = std::packaged_task<task_return_t()>;
-    // http://stackoverflow.com/questions/28179817/how-can-i-store-generic-packaged-tasks-in-a-container
-    std::shared_ptr<task_t> pSharableTask = std::make_shared<task_t>(std::bind(std::forward<Tfunc>(lTaskEntryPoint),std::forward<Targs>(args)...));
-    std::future<task_return_t> oTaskRes = pSharableTask->get_future();
-    {
-        std::mutex_lock_guard sync_lock(m_oSyncMutex);
-        m_qTasks.emplace([pSharableTask](){(*pSharableTask)();}); // lambda keeps a copy of the task in the queue
-    }
-    m_oSyncVar.notify_one();
-    return oTaskRes;
-}
-
-template<size_t nWorkers>
-void lv::WorkerPool<nWorkers>::entry() {
-    std::mutex_unique_lock sync_lock(m_oSyncMutex);
-    while(m_bIsActive || !m_qTasks.empty()) {
-        if(m_qTasks.empty())
-            m_oSyncVar.wait(sync_lock);
-        if(!m_qTasks.empty()) {
-            std::function<void()> task = std::move(m_qTasks.front());
-            m_qTasks.pop();
-            std::unlock_guard<std::mutex_unique_lock> oUnlock(sync_lock);
-            task();
-        }
-    }
-}
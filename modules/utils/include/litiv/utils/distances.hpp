@@ -93,6 +93,9 @@ namespace lv {
         }
     }
 
+    /// computes the L1 distance between two float arrays (bulk simd version dispatched at runtime; sums in the same order as the templated impl, so results are identical)
+    float L1dist_bulk(const float* const a, const float* const b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+
     /// computes the L1 distance between two opencv vectors
     template<int nChannels, typename T>
     inline auto L1dist(const cv::Vec<T,nChannels>& a, const cv::Vec<T,nChannels>& b) -> decltype(L1dist<nChannels,T>(T(),T())) {
@@ -451,7 +454,31 @@ namespace lv {
         return _mm_popcnt_u64((uint64)x);
     }
 
-#else //(!HAVE_POPCNT)
+#elif (defined(__GNUC__) || defined(__clang__))
+
+    /// computes the population count of a 2- or 4-byte vector using bit-parallel sums (compilers turn this into popcnt in kernels dispatched via lv::invokeForSIMDLevel)
+    template<typename T>
+    inline std::enable_if_t<(sizeof(T)==2 || sizeof(T)==4),size_t> popcount(const T x) {
+        static_assert(std::is_integral<T>::value,"type must be integral");
+        uint32_t v = (uint32_t)(std::make_unsigned_t<T>)x;
+        v = v-((v>>1)&0x55555555u);
+        v = (v&0x33333333u)+((v>>2)&0x33333333u);
+        v = (v+(v>>4))&0x0F0F0F0Fu;
+        return size_t((v*0x01010101u)>>24);
+    }
+
+    /// computes the population count of an 8-byte vector using bit-parallel sums (compilers turn this into popcnt in kernels dispatched via lv::invokeForSIMDLevel)
+    template<typename T>
+    inline std::enable_if_t<(sizeof(T)==8),size_t> popcount(const T x) {
+        static_assert(std::is_integral<T>::value,"type must be integral");
+        uint64_t v = (uint64_t)x;
+        v = v-((v>>1)&0x5555555555555555ull);
+        v = (v&0x3333333333333333ull)+((v>>2)&0x3333333333333333ull);
+        v = (v+(v>>4))&0x0F0F0F0F0F0F0F0Full;
+        return size_t((v*0x0101010101010101ull)>>56);
+    }
+
+#else //(!HAVE_POPCNT && !(defined(__GNUC__) || defined(__clang__)))
 
     /// computes the population count of an N-byte vector using an 8-bit popcount LUT
     template<typename T>
@@ -463,7 +490,7 @@ namespace lv {
         return nResult;
     }
 
-#endif //(!HAVE_POPCNT)
+#endif //(!HAVE_POPCNT && !(defined(__GNUC__) || defined(__clang__)))
 
     /// computes the population count of a (nChannels*N)-byte vector
     template<size_t nChannels, typename T>
@@ -522,6 +549,36 @@ namespace lv {
         return hdist<nChannels>(a,b.data());
     }
 
+    /// computes the hamming distance between two generic arrays of (nChannels*N)-byte vectors
+    template<size_t nChannels, typename T>
+    inline size_t hdist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) {
+        size_t nResult = 0;
+        size_t nTotElements = nElements*nChannels;
+        if(m) {
+            for(size_t n=0,i=0; n<nTotElements; n+=nChannels,++i)
+                if(m[i])
+                    nResult += hdist<nChannels>(a+n,b+n);
+        }
+        else {
+            for(size_t n=0; n<nTotElements; n+=nChannels)
+                nResult += hdist<nChannels>(a+n,b+n);
+        }
+        return nResult;
+    }
+
+    /// computes the hamming distance between two generic arrays of (nChannels*N)-byte vectors
+    template<typename T>
+    inline size_t hdist(const T* const a, const T* const b, size_t nElements, size_t nChannels, const uchar* m=NULL) {
+        lvAssert_(nChannels>0 && nChannels<=4,"non-templated distance function only defined for 1 to 4 channels");
+        switch(nChannels) {
+            case 1: return hdist<1>(a,b,nElements,m);
+            case 2: return hdist<2>(a,b,nElements,m);
+            case 3: return hdist<3>(a,b,nElements,m);
+            case 4: return hdist<4>(a,b,nElements,m);
+            default: return 0;
+        }
+    }
+
     /// computes the gradient magnitude distance between two (nChannels*N)-byte vectors
     template<size_t nChannels, typename T>
     inline size_t gdist(const T* const a, const T* const b) {
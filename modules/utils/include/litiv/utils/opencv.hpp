@@ -88,31 +88,47 @@ namespace cv { // extending cv
         getRandSamplePosition<7,7>(s_anSamplesInitPattern,s_nSamplesInitPatternTot,nSampleCoord_X,nSampleCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize);
     }
 
-    /// returns a random neighbor position for the specified pixel position, given a predefined neighborhood; also guards against out-of-bounds values via image/border size check.
-    template<int nNeighborCount>
+    /// returns a random neighbor position for the specified pixel position, given a predefined neighborhood & random number generator; also guards against out-of-bounds values via image/border size check.
+    template<int nNeighborCount, typename TRNG>
     inline void getRandNeighborPosition(const std::array<std::array<int,2>,nNeighborCount>& anNeighborPattern,
                                                int& nNeighborCoord_X,int& nNeighborCoord_Y,
                                                const int nOrigCoord_X,const int nOrigCoord_Y,
-                                               const int nBorderSize,const cv::Size& oImageSize) {
-        int r = rand()%nNeighborCount;
+                                               const int nBorderSize,const cv::Size& oImageSize,TRNG&& oRNG) {
+        int r = int(oRNG()%nNeighborCount);
         nNeighborCoord_X = nOrigCoord_X+anNeighborPattern[r][0];
         nNeighborCoord_Y = nOrigCoord_Y+anNeighborPattern[r][1];
         clampImageCoords(nNeighborCoord_X,nNeighborCoord_Y,nBorderSize,oImageSize);
     }
 
-    /// returns a random neighbor position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-    inline void getRandNeighborPosition_3x3(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+    /// returns a random neighbor position for the specified pixel position, given a predefined neighborhood; also guards against out-of-bounds values via image/border size check.
+    template<int nNeighborCount>
+    inline void getRandNeighborPosition(const std::array<std::array<int,2>,nNeighborCount>& anNeighborPattern,
+                                               int& nNeighborCoord_X,int& nNeighborCoord_Y,
+                                               const int nOrigCoord_X,const int nOrigCoord_Y,
+                                               const int nBorderSize,const cv::Size& oImageSize) {
+        getRandNeighborPosition<nNeighborCount>(anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,[](){return rand();});
+    }
+
+    /// returns a random neighbor position for the specified pixel position using the given random number generator; also guards against out-of-bounds values via image/border size check.
+    template<typename TRNG>
+    inline void getRandNeighborPosition_3x3(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize,TRNG&& oRNG) {
         typedef std::array<int,2> Nb;
         static const std::array<std::array<int,2>,8> s_anNeighborPattern ={
                 Nb{-1, 1},Nb{0, 1},Nb{1, 1},
                 Nb{-1, 0},         Nb{1, 0},
                 Nb{-1,-1},Nb{0,-1},Nb{1,-1},
         };
-        getRandNeighborPosition<8>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize);
+        getRandNeighborPosition<8>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,oRNG);
     }
 
     /// returns a random neighbor position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-    inline void getRandNeighborPosition_5x5(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+    inline void getRandNeighborPosition_3x3(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+        getRandNeighborPosition_3x3(nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,[](){return rand();});
+    }
+
+    /// returns a random neighbor position for the specified pixel position using the given random number generator; also guards against out-of-bounds values via image/border size check.
+    template<typename TRNG>
+    inline void getRandNeighborPosition_5x5(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize,TRNG&& oRNG) {
         typedef std::array<int,2> Nb;
         static const std::array<std::array<int,2>,24> s_anNeighborPattern ={
                 Nb{-2, 2},Nb{-1, 2},Nb{0, 2},Nb{1, 2},Nb{2, 2},
@@ -121,7 +137,12 @@ namespace cv { // extending cv
                 Nb{-2,-1},Nb{-1,-1},Nb{0,-1},Nb{1,-1},Nb{2,-1},
                 Nb{-2,-2},Nb{-1,-2},Nb{0,-2},Nb{1,-2},Nb{2,-2},
         };
-        getRandNeighborPosition<24>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize);
+        getRandNeighborPosition<24>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,oRNG);
+    }
+
+    /// returns a random neighbor position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
+    inline void getRandNeighborPosition_5x5(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+        getRandNeighborPosition_5x5(nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,[](){return rand();});
     }
 
     /// writes a given text string on an image using the original cv::putText (this function only acts as a simplification wrapper)
@@ -181,11 +202,20 @@ namespace cv { // extending cv
         cv::Size m_oLastDisplaySize;
         bool m_bContinuousUpdates;
         bool m_bFirstDisplay;
+        cv::Mat m_oDepthBuffer; ///< reused for depth conversions of displayed images
+        cv::Mat m_oColorBuffer; ///< reused for color conversions of displayed images
+        cv::Mat m_oDisplayBuffer; ///< reused for the final (tiled) image shown in the window
         std::function<void(int,int,int,int)> m_oMouseEventCallback;
         void onMouseEventCallback(int nEvent, int x, int y, int nFlags);
         static void onMouseEvent(int nEvent, int x, int y, int nFlags, void* pData);
     };
 
+    /// returns a continuous matrix header pointing to (uninitialized) frame arena memory; it does not own its data, and is only valid until the arena is rewound
+    inline cv::Mat getArenaMat(lv::FrameArena& oArena, const cv::Size& oSize, int nType) {
+        const size_t nRowStep = size_t(oSize.width)*CV_ELEM_SIZE(nType);
+        return cv::Mat(oSize,nType,oArena.allocate(nRowStep*size_t(oSize.height)),nRowStep);
+    }
+
     /// returns an always-empty-mat by reference
     inline const cv::Mat& emptyMat() {
         static const cv::Mat s_oEmptyMat = cv::Mat();
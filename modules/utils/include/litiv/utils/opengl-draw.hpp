@@ -56,19 +56,29 @@ private:
 };
 
 struct GLPixelBufferObject {
-    GLPixelBufferObject(const cv::Mat& oInitBufferData, GLenum eBufferTarget, GLenum eBufferUsage);
+    /// if persistent mapping is requested and ARB_buffer_storage is available, the buffer storage is immutable and stays mapped (reallocs are ignored)
+    GLPixelBufferObject(const cv::Mat& oInitBufferData, GLenum eBufferTarget, GLenum eBufferUsage, bool bUsePersistentMapping=false);
     ~GLPixelBufferObject();
     inline GLuint getPBOId() const {return m_nPBO;}
     inline int type() const {return m_nFrameType;}
     inline cv::Size size() const {return m_oFrameSize;}
+    inline bool isPersistentlyMapped() const {return m_pPersistentClientPtr!=nullptr;}
+    /// waits for the last fence (if any) before copying the given data to the buffer
     bool updateBuffer(const cv::Mat& oBufferData, bool bRealloc=false, bool bRebindAll=false);
+    /// waits for the last fence (if any) before copying the buffer's data to the given mat
     bool fetchBuffer(cv::Mat& oBufferData, bool bRebindAll=false);
+    /// inserts a fence after the gpu commands queued so far (should be called right after queueing a transfer to/from this buffer)
+    void insertFence();
+    /// returns whether the gpu commands queued before the last fence are done, optionally blocking until they are
+    bool checkFence(bool bWait);
     const GLenum m_eBufferTarget;
     const GLenum m_eBufferUsage;
 private:
     GLPixelBufferObject& operator=(const GLPixelBufferObject&) = delete;
     GLPixelBufferObject(const GLPixelBufferObject&) = delete;
     GLuint m_nPBO;
+    GLsync m_pFence;
+    void* m_pPersistentClientPtr;
     const int m_nBufferSize;
     const int m_nFrameType;
     const cv::Size m_oFrameSize;
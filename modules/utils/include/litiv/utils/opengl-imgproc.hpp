@@ -20,11 +20,15 @@
 #include "litiv/utils/opengl-shaders.hpp"
 
 #define GLUTILS_IMGPROC_DEFAULT_WORKGROUP           glm::uvec2(12,8)
+#define GLUTILS_IMGPROC_DEFAULT_WORKGROUP_AUTOTUNING 0 // defines whether algos time candidate work group sizes over their first frames by default (see setWorkGroupSizeAutoTuning)
+#define GLUTILS_IMGPROC_WORKGROUP_TUNING_FRAMES     4 // number of timed frames per work group size candidate (after one warm-up frame)
 #define GLUTILS_IMGPROC_DEFAULT_LAYER_COUNT         2
 #define GLUTILS_IMGPROC_TEXTURE_ARRAY_SIZE          4
 #define GLUTILS_IMGPROC_USE_TEXTURE_ARRAYS          0
-#define GLUTILS_IMGPROC_USE_DOUBLE_PBO_INPUT        0
-#define GLUTILS_IMGPROC_USE_DOUBLE_PBO_OUTPUT       1
+#define GLUTILS_IMGPROC_USE_PBO_INPUT               0
+#define GLUTILS_IMGPROC_USE_PBO_OUTPUT              1
+#define GLUTILS_IMGPROC_PBO_RING_SIZE               3 // number of pbos cycled through for transfers; fetched outputs may lag by up to N-1 frames
+#define GLUTILS_IMGPROC_USE_PERSISTENT_PBOS         1 // keeps pbos mapped for their whole lifetime when ARB_buffer_storage is available
 #define GLUTILS_IMGPROC_USE_PBO_UPDATE_REALLOC      1 // @@@@@ unused?
 
 // @@@@ switch all 'frames' for 'images'?
@@ -48,8 +52,20 @@ public:
     inline GLuint getSSBOId(size_t n) const {lvAssert(n<m_nSSBOs); return m_vnSSBO[n];}
     inline size_t getTextureBinding(size_t nLayer, size_t eTexID) const {return (m_bUsingTexArrays?0:nLayer)*m_nTextures+eTexID;}
 
-    size_t fetchLastOutput(cv::Mat& oOutput) const;
-    size_t fetchLastDebug(cv::Mat& oDebug) const;
+    /// sets the work group size used to generate & dispatch all compute stages (rebuilds the shaders if the algo is already initialized)
+    void setWorkGroupSize(const glm::uvec2& vWorkGroupSize);
+    /// returns the work group size currently used to generate & dispatch all compute stages
+    inline const glm::uvec2& getWorkGroupSize() const {return m_vWorkGroupSize;}
+    /// toggles work group size auto-tuning; if no size is cached for this algo/frame size/device, candidates are timed over the first frames, and the fastest is kept (and cached)
+    void setWorkGroupSizeAutoTuning(bool bAutoTune);
+    /// returns whether work group size candidates are still being timed
+    inline bool isTuningWorkGroupSize() const {return m_nCurrWorkGroupSizeCandidate!=size_t(-1);}
+
+    /// copies the latest output whose transfer is done to the given mat without stalling (unless none is, or if required), and returns its frame index
+    /// (callers that ignore the returned index and expect the previous frame's output must set bWaitForLatest)
+    size_t fetchLastOutput(cv::Mat& oOutput, bool bWaitForLatest=false) const;
+    /// copies the latest debug image whose transfer is done to the given mat without stalling (unless none is, or if required), and returns its frame index
+    size_t fetchLastDebug(cv::Mat& oDebug, bool bWaitForLatest=false) const;
 
     const size_t m_nLevels;
     const size_t m_nComputeStages;
@@ -67,7 +83,6 @@ public:
     const bool m_bUsingTexArrays;
     const bool m_bUsingTimers;
     const bool m_bUsingIntegralFormat;
-    const glm::uvec2 m_vDefaultWorkGroupSize; // make dynamic? @@@@@
 
     enum ImageDefaultLayoutList {
         Image_OutputBinding,
@@ -114,6 +129,7 @@ protected:
 
     bool m_bUsingDisplay;
     bool m_bGLInitialized;
+    glm::uvec2 m_vWorkGroupSize;
     cv::Size m_oFrameSize;
     size_t m_nInternalFrameIdx;
     size_t m_nLastOutputInternalIdx, m_nLastDebugInternalIdx;
@@ -130,9 +146,11 @@ protected:
     std::unique_ptr<GLDynamicTexture2DArray> m_pDebugArray;
     std::unique_ptr<GLDynamicTexture2DArray> m_pOutputArray;
     std::vector<std::unique_ptr<GLShader>> m_vpImgProcShaders;
-    std::unique_ptr<GLPixelBufferObject> m_apInputPBOs[2];
-    std::unique_ptr<GLPixelBufferObject> m_apDebugPBOs[2];
-    std::unique_ptr<GLPixelBufferObject> m_apOutputPBOs[2];
+    std::array<std::unique_ptr<GLPixelBufferObject>,GLUTILS_IMGPROC_PBO_RING_SIZE> m_apInputPBOs;
+    std::array<std::unique_ptr<GLPixelBufferObject>,GLUTILS_IMGPROC_PBO_RING_SIZE> m_apDebugPBOs;
+    std::array<std::unique_ptr<GLPixelBufferObject>,GLUTILS_IMGPROC_PBO_RING_SIZE> m_apOutputPBOs;
+    std::array<size_t,GLUTILS_IMGPROC_PBO_RING_SIZE> m_anDebugPBOFrameIdxs; ///< internal frame index fetched in each debug pbo (-1 if none)
+    std::array<size_t,GLUTILS_IMGPROC_PBO_RING_SIZE> m_anOutputPBOFrameIdxs; ///< internal frame index fetched in each output pbo (-1 if none)
     std::unique_ptr<GLTexture2D> m_pROITexture;
     std::unique_ptr<GLTexture2D> m_apCustomTextures[3];
     GLScreenBillboard m_oDisplayBillboard;
@@ -141,6 +159,12 @@ protected:
     const int m_nDebugType;
 
     virtual void dispatch(size_t nStage, GLShader& oShader);
+    /// (re)generates and links all compute stage shaders using the current work group size
+    void initialize_shaders();
+    /// picks the cached work group size for this algo/frame size/device, or starts timing candidates if none was found/buildable (if auto-tuning is enabled); returns whether the shaders were built
+    bool initialize_workgroup_tuning();
+    /// times the dispatches of the last frame (if still tuning), and moves on to the next work group size candidate when needed
+    void update_workgroup_tuning();
     static const char* getCurrTextureLayerUniformName();
     static const char* getLastTextureLayerUniformName();
     static const char* getFrameIndexUniformName();
@@ -152,6 +176,12 @@ private:
     std::vector<GLuint> m_vnSSBO;
     std::vector<GLuint> m_vnACBO;
     int m_nInputType;
+    bool m_bAutoTuningWorkGroupSize;
+    std::vector<glm::uvec2> m_vvWorkGroupSizeCandidates;
+    std::vector<GLuint64> m_vnWorkGroupSizeCandidateTimes; ///< total dispatch time of each candidate (in ns), or UINT64_MAX if it could not be built
+    size_t m_nCurrWorkGroupSizeCandidate; ///< index of the candidate currently being timed (-1 if not tuning)
+    size_t m_nCurrWorkGroupSizeTuningFrame;
+    std::array<GLuint,2> m_anWorkGroupSizeTuningQueries; ///< timestamp queries issued around the dispatch loop while tuning
 };
 
 class GLImageProcEvaluatorAlgo : public GLImageProcAlgo {
@@ -19,6 +19,9 @@
 
 #include "litiv/utils/opengl-draw.hpp"
 
+#define GLUTILS_SHADER_USE_BINARY_CACHE 1 // defines whether linked programs should be cached on disk (and reloaded from there) via glGetProgramBinary/glProgramBinary
+#define GLUTILS_SHADER_BINARY_CACHE_ENV_VAR "LITIV_GL_SHADER_CACHE_DIR" // env variable used to override the program binary cache directory (default: $XDG_CACHE_HOME/litiv/shaders or ~/.cache/litiv/shaders; "none" disables the cache)
+
 // @@@@ rewrite all classes as part of lv::gl namespace?
 
 class GLShader {
@@ -54,6 +57,9 @@ public:
     bool isEmpty()     {return m_bIsEmpty;}
     GLuint getProgID() {return m_nProgID;}
 
+    /// returns the on-disk cache directory used for program binaries (with a trailing slash), or an empty string if caching is disabled/impossible
+    static const std::string& getBinaryCacheDirPath();
+
     //static const char* getDefaultVertexAttribVarName(GLVertex::VertexAttribList eVar); @@@@ todo?
 
     static std::string getVertexShaderSource_PassThrough(bool bPassNormals, bool bPassColors, bool bPassTexCoords);
@@ -55,18 +55,52 @@ struct glutWindowDeleter {
     typedef glutHandle pointer;
 };
 #endif //HAVE_FREEGLUT
+#if HAVE_EGL
+// keeps eglplatform.h from pulling in the X11 headers (and their macros) on linux
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+struct eglSurfaceDeleter {
+    eglSurfaceDeleter(EGLDisplay pDisplay=EGL_NO_DISPLAY) : m_pDisplay(pDisplay) {}
+    void operator()(EGLSurface pSurface) {
+        eglDestroySurface(m_pDisplay,pSurface);
+    }
+    EGLDisplay m_pDisplay;
+};
+struct eglContextDeleter {
+    eglContextDeleter(EGLDisplay pDisplay=EGL_NO_DISPLAY) : m_pDisplay(pDisplay) {}
+    void operator()(EGLContext pContext) {
+        eglDestroyContext(m_pDisplay,pContext);
+    }
+    EGLDisplay m_pDisplay;
+};
+#endif //HAVE_EGL
+
+#define GLUTILS_CONTEXT_BACKEND_ENV_VAR "LITIV_GL_CONTEXT" // env variable used to force the backend of auto-selected contexts ("window" or "headless")
 
 namespace lv {
 
     namespace gl {
 
+        /// backends an opengl context can be created with
+        enum ContextBackend {
+            ContextBackend_Auto, ///< windowed if a display is available (or if EGL is disabled), and headless otherwise; can be forced via the LITIV_GL_CONTEXT env variable
+            ContextBackend_Window, ///< GLFW or FREEGLUT window (hidden by default)
+            ContextBackend_Headless, ///< EGL context rendering to a pbuffer (or to nothing, if surfaceless), e.g. for display-less machines w/ Mesa llvmpipe
+        };
+
         class Context {
         public:
             Context(const cv::Size& oWinSize,
                     const std::string& sWinName,
                     bool bHide=true,
                     size_t nGLVerMajor=TARGET_GL_VER_MAJOR,
-                    size_t nGLVerMinor=TARGET_GL_VER_MINOR);
+                    size_t nGLVerMinor=TARGET_GL_VER_MINOR,
+                    ContextBackend eBackend=ContextBackend_Auto);
+            ~Context();
+            /// returns the backend the context was actually created with (never 'ContextBackend_Auto')
+            ContextBackend getBackend() const {return m_eBackend;}
             void setAsActive();
             void setWindowVisibility(bool bVal);
             void setWindowSize(const cv::Size& oSize, bool bUpdateViewport=true);
@@ -77,19 +111,28 @@ namespace lv {
             static void initGLEW(size_t nGLVerMajor, size_t nGLVerMinor);
 
         private:
+            static std::mutex s_oErrorMessageMutex;
+            static std::string s_sLatestErrorMessage;
 #if HAVE_GLFW
             std::unique_ptr<GLFWwindow,glfwWindowDeleter> m_pWindowHandle;
-            static std::mutex s_oGLFWErrorMessageMutex;
-            static std::string s_sLatestGLFWErrorMessage;
             static void onGLFWErrorCallback(int nCode, const char* acMessage) {
                 std::stringstream ssStr;
                 ssStr << "code: " << nCode << ", message: " << acMessage;
-                std::lock_guard<std::mutex> oLock(s_oGLFWErrorMessageMutex);
-                s_sLatestGLFWErrorMessage = ssStr.str();
+                std::lock_guard<std::mutex> oLock(s_oErrorMessageMutex);
+                s_sLatestErrorMessage = ssStr.str();
             }
 #elif HAVE_FREEGLUT
             std::unique_ptr<glutHandle,glutWindowDeleter> m_oWindowHandle;
 #endif //HAVE_FREEGLUT
+#if HAVE_EGL
+            EGLConfig m_pEGLConfig;
+            std::unique_ptr<void,eglContextDeleter> m_pEGLContext;
+            std::unique_ptr<void,eglSurfaceDeleter> m_pEGLSurface; ///< null if the context is surfaceless
+            /// returns the display shared by all headless contexts (initialized on first call, and terminated at exit)
+            static EGLDisplay getEGLDisplay();
+            static void onEGLError(const char* acFuncName);
+#endif //HAVE_EGL
+            const ContextBackend m_eBackend;
             const size_t m_nGLVerMajor;
             const size_t m_nGLVerMinor;
             static std::once_flag s_oInitFlag;
@@ -41,6 +41,26 @@
 #include <x86intrin.h>
 #endif //(!defined(_MSC_VER))
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_SIMD_DISPATCH 1
+#define lvSIMDTarget(sTarget) __attribute__((target(sTarget)))
+#define lvSIMDFlatten(sTarget) __attribute__((target(sTarget),flatten))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define HAVE_SIMD_DISPATCH 1
+#define lvSIMDTarget(sTarget) // msvc emits any intrinsic regardless of its /arch flag
+#define lvSIMDFlatten(sTarget) // msvc cannot compile a frame for another instruction set (inline helpers keep their portable paths there)
+#else //(!x86 target)
+#define HAVE_SIMD_DISPATCH 0
+#define lvSIMDTarget(sTarget)
+#define lvSIMDFlatten(sTarget)
+#endif //(!x86 target)
+
+#define PARALLELUTILS_TILES_PER_THREAD 4 // number of tiles a range is split into per available thread (for load balancing)
+#define PARALLELUTILS_WORKER_QUEUE_SIZE 256 // capacity of each worker's task ring buffer (tasks that do not fit anywhere run on the pushing thread)
+#define PARALLELUTILS_TASK_SLAB_BLOCK_SIZE 256 // size of the blocks queued tasks (and their shared states) are allocated from, in bytes (larger requests go to the heap)
+#define PARALLELUTILS_TASK_SLAB_CHUNK_SIZE 64 // number of blocks a per-thread task slab grows by when it runs out of free blocks
+#define PARALLELUTILS_SIMD_LEVEL_ENV_VAR "LITIV_SIMD_LEVEL" // env variable used to lower the simd level picked at runtime (e.g. for benchmarking)
+
 namespace lv {
 
     enum ParallelAlgoType {
@@ -53,17 +73,146 @@ namespace lv {
 #if HAVE_OPENCL
         OpenCL,
 #endif //HAVE_OPENCL
+        CPUThreaded,
         NonParallel
     };
 
+    /// simd instruction set levels that kernels can be dispatched to at runtime (each level implies the ones before it)
+    enum SIMDLevel {
+        SIMDLevel_None,
+        SIMDLevel_SSE2,
+        SIMDLevel_SSE4_1, ///< also implies SSSE3 and POPCNT
+        SIMDLevel_AVX2,
+        SIMDLevel_AVX512BW,
+        nSIMDLevelsCount
+    };
+
+    /// returns the highest simd level supported by both the cpu and os (queried once via cpuid)
+    SIMDLevel getSupportedSIMDLevel();
+    /// returns the simd level kernels should dispatch to (the supported level, unless lowered via the LITIV_SIMD_LEVEL env variable)
+    SIMDLevel getSIMDLevel();
+    /// returns the name of a simd level, as expected in the LITIV_SIMD_LEVEL env variable (e.g. "sse4_1")
+    const char* getSIMDLevelName(SIMDLevel eLevel);
+
+    /// default (specializable) forward declaration of the non-owning callable reference
+    template<typename TSignature>
+    struct FuncRef;
+
+    /// non-owning reference to a callable object (e.g. a lambda passed as a temporary); unlike std::function, it never allocates, but it must not outlive its target
+    template<typename TReturn, typename... TArgs>
+    struct FuncRef<TReturn(TArgs...)> {
+        /// binds the reference to the given callable object (which is neither copied nor moved)
+        template<typename TFunc, typename=std::enable_if_t<!std::is_same<std::decay_t<TFunc>,FuncRef>::value>>
+        FuncRef(TFunc&& lFunc) :
+                m_pObj((void*)std::addressof(lFunc)),
+                m_pfCall([](void* pObj, TArgs... args) -> TReturn {return (*(std::remove_reference_t<TFunc>*)pObj)(std::forward<TArgs>(args)...);}) {}
+        /// calls the referenced object with the given arguments
+        inline TReturn operator()(TArgs... args) const {return m_pfCall(m_pObj,std::forward<TArgs>(args)...);}
+    private:
+        void* m_pObj;
+        TReturn (*m_pfCall)(void*, TArgs...);
+    };
+
+    /// work-stealing CPU thread pool w/ runtime-sized workers; each worker owns a fixed-size task ring from which it pops the newest tasks while idle
+    /// threads steal the oldest ones, and threads waiting on a 'parallel_for' call help process the pending tasks of their own call instead of blocking
+    struct ThreadPool {
+        /// 1d tile processing function signature (called once per tile, with its index and [nBegin,nEnd) range)
+        using TileFunc = FuncRef<void(size_t /*nTileIdx*/, size_t /*nBegin*/, size_t /*nEnd*/)>;
+        /// 2d tile processing function signature (called once per tile, with its row-major index and region)
+        using TileFunc2D = FuncRef<void(size_t /*nTileIdx*/, const cv::Rect& /*oTile*/)>;
+        /// starts the given number of worker threads, optionally pinning each one to its own core (w/ no workers, all tasks run on the calling thread)
+        ThreadPool(size_t nWorkers, bool bPinWorkers=false);
+        /// processes all remaining tasks, and joins the workers
+        ~ThreadPool();
+        /// returns the process-wide pool instance (one worker per extra hardware thread, started on first use)
+        static ThreadPool& get();
+        /// returns the number of worker threads
+        inline size_t getWorkerCount() const {return m_vpWorkers.size();}
+        /// returns the number of threads tiles can be processed on (including the calling thread)
+        inline size_t getThreadCount() const {return m_vpWorkers.size()+1;}
+        /// returns the number of tiles a [0,nCount) range will be split into by 'parallel_for' (never more than nCount/nMinTileSize)
+        size_t getTileCount(size_t nCount, size_t nMinTileSize=1) const;
+        /// calls lTileFunc once per tile of [0,nCount), and blocks until all tiles are done (the first exception thrown by a tile is rethrown here)
+        void parallel_for(size_t nCount, size_t nMinTileSize, TileFunc lTileFunc);
+        /// calls lTileFunc once per oTileSize-sized tile of an oSize region (border tiles may be smaller), and blocks until all tiles are done
+        void parallel_for(const cv::Size& oSize, const cv::Size& oTileSize, TileFunc2D lTileFunc);
+        /// queues a single task for asynchronous execution, and returns its future (runs it immediately on the calling thread if the pool has no workers, or if all task rings are full)
+        template<typename Tfunc, typename... Targs>
+        std::future<std::result_of_t<Tfunc(Targs...)>> queueTask(Tfunc&& lTaskEntryPoint, Targs&&... args);
+    private:
+        /// allocates a block from the calling thread's task slab (blocks freed by other threads are recycled lazily; oversized requests go to the heap)
+        static void* allocTaskBlock(size_t nSize);
+        /// returns a block to the task slab it was allocated from (may be called from any thread, even after the allocating thread has exited)
+        static void freeTaskBlock(void* pBlock);
+        /// stateless allocator used to place the shared states of queued tasks in task slab blocks
+        template<typename T>
+        struct TaskAllocator {
+            using value_type = T;
+            TaskAllocator() = default;
+            template<typename U>
+            TaskAllocator(const TaskAllocator<U>&) {}
+            inline T* allocate(size_t n) {return (T*)allocTaskBlock(n*sizeof(T));}
+            inline void deallocate(T* p, size_t) {freeTaskBlock(p);}
+            template<typename U>
+            inline bool operator==(const TaskAllocator<U>&) const {return true;}
+            template<typename U>
+            inline bool operator!=(const TaskAllocator<U>&) const {return false;}
+        };
+        /// type-erased task, stored by value in the worker rings (tile tasks only point to a job owned by the waiting thread, so they allocate nothing)
+        struct Task {
+            void (*pfEntry)(void* /*pData*/, size_t /*nArg*/);
+            void* pData;
+            size_t nArg;
+        };
+        /// per-worker task ring buffer & thread handle
+        struct Worker {
+            std::mutex oMutex;
+            std::array<Task,PARALLELUTILS_WORKER_QUEUE_SIZE> aTasks;
+            size_t nFirstTaskIdx; ///< ring index of the oldest task
+            size_t nTaskCount; ///< number of tasks currently in the ring
+            std::thread hThread;
+        };
+        /// tile range shared by all tasks of a 'parallel_for' call, owned by the calling thread
+        struct RangeJob;
+        /// runs a single tile of a range job, and signals the waiting thread if it was the last one
+        static void runRangeTile(void* pJob, size_t nTileIdx);
+        /// splits the tiles of a range job in tasks, processes them w/ the help of the workers, and rethrows the first tile exception (if any)
+        void processRangeJob(RangeJob& oJob);
+        /// pushes the tasks {pfEntry,pData,nFirstArg+n} for n in [0,nTasks) to the calling worker's ring (or spreads them over all rings for external threads),
+        /// wakes up idle workers, and runs the tasks that did not fit anywhere on the calling thread
+        void pushTasks(void (*pfEntry)(void*,size_t), void* pData, size_t nFirstArg, size_t nTasks);
+        /// pops a task from the given worker's ring (if valid), or steals one from another worker; returns false if all rings are empty
+        bool popTask(size_t nWorkerIdx, Task& oTask);
+        /// pops any pending task that belongs to the given job (i.e. w/ the same data pointer); returns false if none is left in the rings
+        bool popJobTask(const void* pData, Task& oTask);
+        /// worker thread entry point; processes tasks until the pool is destroyed and all rings are empty
+        void entry(size_t nWorkerIdx, bool bPinWorker);
+        std::vector<std::unique_ptr<Worker>> m_vpWorkers;
+        std::mutex m_oSleepMutex;
+        std::condition_variable m_oSleepCondVar;
+        std::mutex m_oDoneMutex;
+        std::condition_variable m_oDoneCondVar;
+        std::atomic<ptrdiff_t> m_nQueuedTasks; ///< may briefly go negative, as tasks are counted after being pushed
+        std::atomic_size_t m_nNextWorkerIdx; ///< round-robin index used to distribute tasks pushed by external threads
+        bool m_bIsActive;
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+    };
+
     struct IIParallelAlgo {
         /// returns whether the algorithm is implemented for parallel processing or not
         virtual bool isParallel() = 0;
         /// returns which type of parallel implementation is used in this algo
         virtual ParallelAlgoType getParallelAlgoType() = 0;
+        /// returns the number of heap allocations made so far inside 'processTiles' calls, on all threads (always zero if PLATFORMUTILS_COUNT_HEAP_ALLOCS is disabled)
+        inline size_t getTileHeapAllocCount() const {return m_nTileHeapAllocCount;}
     public:
         // #### for debug purposes only ####
         cv::DisplayHelperPtr m_pDisplayHelper;
+    protected:
+        IIParallelAlgo() : m_nTileHeapAllocCount(0) {}
+        /// heap allocations made inside 'processTiles' calls so far (only updated if PLATFORMUTILS_COUNT_HEAP_ALLOCS is enabled)
+        size_t m_nTileHeapAllocCount;
     };
 
     template<ParallelAlgoType eImpl>
@@ -100,11 +249,67 @@ namespace lv {
     using IParallelAlgo_OpenCL = IParallelAlgo_<OpenCL>;
 #endif //HAVE_CUDA
 
+    template<>
+    struct IParallelAlgo_<CPUThreaded> : public IIParallelAlgo {
+        IParallelAlgo_() {}
+        virtual bool isParallel() {return true;}
+        virtual ParallelAlgoType getParallelAlgoType() {return CPUThreaded;}
+        /// returns the number of tiles a [0,nCount) range will be split into by 'processTiles'
+        inline size_t getTileCount(size_t nCount, size_t nMinTileSize=1) const {return ThreadPool::get().getTileCount(nCount,nMinTileSize);}
+        /// processes all tiles of a [0,nCount) range on the shared thread pool (blocks until done; tiles must not write outside their own range unless synchronized)
+        inline void processTiles(size_t nCount, size_t nMinTileSize, ThreadPool::TileFunc lTileFunc) {
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            const size_t nInitHeapAllocCount = GetHeapAllocCount(); // allocations made by the workers are added to the calling thread's count
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            ThreadPool::get().parallel_for(nCount,nMinTileSize,lTileFunc);
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            m_nTileHeapAllocCount += GetHeapAllocCount()-nInitHeapAllocCount;
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+        }
+        /// processes all oTileSize-sized tiles of an oSize region on the shared thread pool (blocks until done)
+        inline void processTiles(const cv::Size& oSize, const cv::Size& oTileSize, ThreadPool::TileFunc2D lTileFunc) {
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            const size_t nInitHeapAllocCount = GetHeapAllocCount(); // allocations made by the workers are added to the calling thread's count
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            ThreadPool::get().parallel_for(oSize,oTileSize,lTileFunc);
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            m_nTileHeapAllocCount += GetHeapAllocCount()-nInitHeapAllocCount;
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+        }
+    };
+    using IParallelAlgo_CPUThreaded = IParallelAlgo_<CPUThreaded>;
+
     template<>
     struct IParallelAlgo_<NonParallel> : public IIParallelAlgo {
         IParallelAlgo_() {}
         virtual bool isParallel() {return false;}
         virtual ParallelAlgoType getParallelAlgoType() {return NonParallel;}
+        /// returns the number of tiles a [0,nCount) range will be split into by 'processTiles' (always one, for interface compat w/ CPUThreaded)
+        inline size_t getTileCount(size_t nCount, size_t /*nMinTileSize*/=1) const {return nCount?1:0;}
+        /// processes the whole [0,nCount) range as a single tile on the calling thread (for interface compat w/ CPUThreaded)
+        template<typename TFunc>
+        inline void processTiles(size_t nCount, size_t /*nMinTileSize*/, TFunc&& lTileFunc) {
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            const size_t nInitHeapAllocCount = GetHeapAllocCount();
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            if(nCount)
+                lTileFunc(size_t(0),size_t(0),nCount);
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            m_nTileHeapAllocCount += GetHeapAllocCount()-nInitHeapAllocCount;
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+        }
+        /// processes the whole oSize region as a single tile on the calling thread (for interface compat w/ CPUThreaded)
+        template<typename TFunc>
+        inline void processTiles(const cv::Size& oSize, const cv::Size& /*oTileSize*/, TFunc&& lTileFunc) {
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            const size_t nInitHeapAllocCount = GetHeapAllocCount();
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            if(oSize.area()>0)
+                lTileFunc(size_t(0),cv::Rect(cv::Point(),oSize));
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+            m_nTileHeapAllocCount += GetHeapAllocCount()-nInitHeapAllocCount;
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+        }
     };
     using NonParallelAlgo = IParallelAlgo_<NonParallel>;
 
@@ -128,36 +333,115 @@ namespace lv {
         _mm_store_si128(anBuffer,_mm_set1_epi8((char)nVal));
     }
 
-    inline __m128i mult_32si(const __m128i& a, const __m128i& b) {
 #if HAVE_SSE4_1
-        return _mm_mullo_epi32(a, b);
+    /// simd level the inline helpers assume when none is given (i.e. outside of kernels dispatched via 'invokeForSIMDLevel')
+    constexpr SIMDLevel s_eStaticSIMDLevel = SIMDLevel_SSE4_1;
 #else //(!HAVE_SSE4_1)
-        return _mm_unpacklo_epi32(_mm_shuffle_epi32(_mm_mul_epu32(a,b),_MM_SHUFFLE(0,0,2,0)),_mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_si128(a,4),_mm_srli_si128(b,4)),_MM_SHUFFLE(0,0,2,0)));
+    /// simd level the inline helpers assume when none is given (i.e. outside of kernels dispatched via 'invokeForSIMDLevel')
+    constexpr SIMDLevel s_eStaticSIMDLevel = SIMDLevel_SSE2;
 #endif //(!HAVE_SSE4_1)
+
+#if HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+    /// multiplies the 32-bit integers of the provided arrays, keeping the low 32 bits (sse4.1 version)
+    lvSIMDTarget("sse4.1") inline __m128i mult_32si_sse41(const __m128i& a, const __m128i& b) {
+        return _mm_mullo_epi32(a,b);
     }
+#endif //HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
 
+    /// multiplies the 32-bit integers of the provided arrays, keeping the low 32 bits (kernels dispatched via 'invokeForSIMDLevel' can pass their level)
+    template<SIMDLevel eLevel=s_eStaticSIMDLevel>
+    inline __m128i mult_32si(const __m128i& a, const __m128i& b) {
+#if HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+        if(eLevel>=SIMDLevel_SSE4_1)
+            return mult_32si_sse41(a,b);
+#endif //HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(_mm_mul_epu32(a,b),_MM_SHUFFLE(0,0,2,0)),_mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_si128(a,4),_mm_srli_si128(b,4)),_MM_SHUFFLE(0,0,2,0)));
+    }
+
+#if HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+    /// returns the 32-bit integer at the given position of the provided array (sse4.1 version)
     template<int nPos>
+    lvSIMDTarget("sse4.1") inline int extract_32si_sse41(const __m128i& anBuffer) {
+        return _mm_extract_epi32(anBuffer,nPos);
+    }
+#endif //HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+
+    /// returns the 32-bit integer at the given position of the provided array (kernels dispatched via 'invokeForSIMDLevel' can pass their level)
+    template<int nPos, SIMDLevel eLevel=s_eStaticSIMDLevel>
     inline int extract_32si(const __m128i& anBuffer) {
         static_assert(nPos>=0 && nPos<4,"Integer position out of bounds");
-#if HAVE_SSE4_1
-        return _mm_extract_epi32(anBuffer,nPos);
-#else //(!HAVE_SSE4_1)
-        return _mm_extract_epi16(anBuffer,nPos*2)+_mm_extract_epi16(anBuffer,nPos*2+1)<<16;
-#endif //(!HAVE_SSE4_1)
+#if HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+        if(eLevel>=SIMDLevel_SSE4_1)
+            return extract_32si_sse41<nPos>(anBuffer);
+#endif //HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+        return _mm_extract_epi16(anBuffer,nPos*2)|(_mm_extract_epi16(anBuffer,nPos*2+1)<<16);
     }
 #endif //HAVE_SSE2
 
-#if HAVE_SSE4_1
-    /// returns the maximum value of the provided 16-unsigned-byte array
-    inline uchar hmax_16ub(const __m128i& anBuffer) {
+#if HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+    /// returns the maximum value of the provided 16-unsigned-byte array (in portable builds, only call from kernels dispatched for SIMDLevel_SSE4_1 or above)
+    lvSIMDTarget("sse4.1") inline uchar hmax_16ub(const __m128i& anBuffer) {
         __m128i _anTmp = _mm_sub_epi8(_mm_set1_epi8(char(CHAR_MAX)),anBuffer);
         return uchar(char(CHAR_MAX)-_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_min_epu8(_anTmp,_mm_srli_epi16(_anTmp,8)))));
     }
 
-    /// returns the minimum value of the provided 16-unsigned-byte array
-    inline uchar hmin_16ub(const __m128i& anBuffer) {
+    /// returns the minimum value of the provided 16-unsigned-byte array (in portable builds, only call from kernels dispatched for SIMDLevel_SSE4_1 or above)
+    lvSIMDTarget("sse4.1") inline uchar hmin_16ub(const __m128i& anBuffer) {
         return uchar(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_min_epu8(anBuffer,_mm_srli_epi16(anBuffer,8)))));
     }
-#endif //HAVE_SSE4_1
+#endif //HAVE_SSE4_1 || HAVE_SIMD_DISPATCH
+
+#if HAVE_SIMD_DISPATCH
+    /// calls 'lFunc(args...)' from a frame compiled for sse4.1+popcnt (see 'invokeForSIMDLevel')
+    template<typename TFunc, typename... Targs>
+    lvSIMDFlatten("sse4.1,popcnt") void invokeForSIMDLevel_sse41(TFunc& lFunc, Targs&&... args) {
+        lFunc(std::forward<Targs>(args)...);
+    }
+
+    /// calls 'lFunc(args...)' from a frame compiled for avx2+popcnt (see 'invokeForSIMDLevel')
+    template<typename TFunc, typename... Targs>
+    lvSIMDFlatten("avx2,popcnt") void invokeForSIMDLevel_avx2(TFunc& lFunc, Targs&&... args) {
+        lFunc(std::forward<Targs>(args)...);
+    }
+#endif //HAVE_SIMD_DISPATCH
+
+    /// calls 'lFunc(args...)' from a frame compiled for the instruction sets of 'eLevel' (pick it once per call via getSIMDLevel, outside the hot loops); the
+    /// call is flattened, so the inline helpers it uses (popcount/hdist, LBSP thresholding, ...) and its loops get those instruction sets even in portable
+    /// builds (avx512bw reuses the avx2 frame, as per-pixel code does not benefit from it)
+    template<typename TFunc, typename... Targs>
+    inline void invokeForSIMDLevel(SIMDLevel eLevel, TFunc&& lFunc, Targs&&... args) {
+#if HAVE_SIMD_DISPATCH
+        if(eLevel>=SIMDLevel_AVX2)
+            invokeForSIMDLevel_avx2(lFunc,std::forward<Targs>(args)...);
+        else if(eLevel>=SIMDLevel_SSE4_1)
+            invokeForSIMDLevel_sse41(lFunc,std::forward<Targs>(args)...);
+        else
+#endif //HAVE_SIMD_DISPATCH
+            lFunc(std::forward<Targs>(args)...);
+    }
 
 } // namespace lv
+
+template<typename Tfunc, typename... Targs>
+std::future<std::result_of_t<Tfunc(Targs...)>> lv::ThreadPool::queueTask(Tfunc&& lTaskEntryPoint, Targs&&... args) {
+    using task_return_t = std::result_of_t<Tfunc(Targs...)>;
+    using task_t = std::packaged_task<task_return_t()>;
+    // the packaged task and its shared state both live in slab blocks; the task is released by the thread that runs it, and exceptions are forwarded to the future
+    void* pTaskBlock = allocTaskBlock(sizeof(task_t));
+    task_t* pTask;
+    try {
+        pTask = new(pTaskBlock) task_t(std::allocator_arg,TaskAllocator<char>(),std::bind(std::forward<Tfunc>(lTaskEntryPoint),std::forward<Targs>(args)...));
+    }
+    catch(...) {
+        freeTaskBlock(pTaskBlock);
+        throw;
+    }
+    std::future<task_return_t> oTaskRes = pTask->get_future();
+    pushTasks([](void* pData, size_t) {
+        task_t* pTask = (task_t*)pData;
+        (*pTask)();
+        pTask->~task_t();
+        freeTaskBlock(pTask);
+    },pTask,0,1);
+    return oTaskRes;
+}
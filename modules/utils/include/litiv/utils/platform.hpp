@@ -24,6 +24,7 @@
 #include <comdef.h>
 #include <stdint.h>
 #include <direct.h>
+#include <sys/stat.h>
 #include <psapi.h>
 template<class T>
 void SafeRelease(T **ppT) {if(*ppT) {(*ppT)->Release();*ppT = nullptr;}}
@@ -40,6 +41,10 @@ void SafeRelease(T **ppT) {if(*ppT) {(*ppT)->Release();*ppT = nullptr;}}
 #endif //(!defined(_MSC_VER))
 #include "litiv/utils/cxx.hpp"
 
+#define PLATFORMUTILS_FRAMEARENA_DEFAULT_ALIGN 64 // default alignment of frame arena allocations (one cache line, also fits avx512 loads)
+#define PLATFORMUTILS_FRAMEARENA_MIN_BLOCK_SIZE (size_t(1)<<16) // minimum size of the memory blocks requested by frame arenas
+#define PLATFORMUTILS_COUNT_HEAP_ALLOCS HAVE_HEAP_ALLOC_COUNTER // if enabled (via the USE_HEAP_ALLOC_COUNTER cmake option), the global operator new is replaced to count heap allocations per thread (see lv::GetHeapAllocCount)
+
 namespace lv {
 
     std::string GetCurrentWorkDirPath();
@@ -48,9 +53,14 @@ namespace lv {
     void GetSubDirsFromDir(const std::string& sDirPath, std::vector<std::string>& vsSubDirPaths);
     void FilterFilePaths(std::vector<std::string>& vsFilePaths, const std::vector<std::string>& vsRemoveTokens, const std::vector<std::string>& vsKeepTokens);
     bool CreateDirIfNotExist(const std::string& sDirPath);
+    bool GetFileInfo(const std::string& sFilePath, size_t& nFileSize, int64_t& nLastWriteTime);
     std::fstream CreateBinFileWithPrealloc(const std::string& sFilePath, size_t nPreallocBytes, bool bZeroInit=false);
     void RegisterAllConsoleSignals(void(*lHandler)(int));
     size_t GetCurrentPhysMemBytesUsed();
+    /// returns the number of global operator new calls made by the calling thread so far (always zero if PLATFORMUTILS_COUNT_HEAP_ALLOCS is disabled)
+    size_t GetHeapAllocCount();
+    /// adds allocations made on the calling thread's behalf by other threads (e.g. by thread pool workers) to its count
+    void AddToHeapAllocCount(size_t nAllocCount);
 
     template<typename T, std::size_t nByteAlign>
     class AlignedMemAllocator {
@@ -108,6 +118,67 @@ namespace lv {
         bool operator==(const AlignedMemAllocator<T,nByteAlign>& other) const {return true;}
     };
 
+    /// bump allocator for per-frame scratch buffers; memory is only reclaimed when the arena is rewound (via 'reset' or a 'Scope'), and
+    /// blocks are merged on full resets, so once the arena is warmed up, a frame needs no heap allocation (not thread-safe)
+    class FrameArena {
+    public:
+        /// rewinds the arena to its construction-time state when destroyed (scopes must be nested; the outermost one fully resets the arena)
+        struct Scope {
+            explicit Scope(FrameArena& oArena);
+            ~Scope();
+        private:
+            FrameArena& m_oArena;
+            const size_t m_nBlockIdx,m_nBlockOffset;
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        };
+        /// default constructor; reserves nInitBytes up front if non-null (otherwise, the first block is allocated on demand)
+        explicit FrameArena(size_t nInitBytes=0);
+        /// returns a pointer to nBytes of uninitialized memory aligned to nByteAlign (which must be a power of two)
+        void* allocate(size_t nBytes, size_t nByteAlign=PLATFORMUTILS_FRAMEARENA_DEFAULT_ALIGN);
+        /// rewinds all allocations; if they spilled over several blocks, the blocks are merged so that the same allocations will fit in one
+        void reset();
+        /// returns the number of bytes currently handed out (including alignment padding and skipped block tails)
+        size_t getUsedBytes() const;
+        /// returns the total number of bytes held by the arena
+        size_t getCapacity() const;
+        /// returns the number of blocks allocated on the heap since construction (should stop increasing once processing reaches a steady state)
+        inline size_t getHeapAllocCount() const {return m_nHeapAllocCount;}
+        /// returns the calling thread's own arena (for code that cannot own one, e.g. const getters which might be called concurrently)
+        static FrameArena& getThreadLocal();
+    private:
+        /// appends a new block large enough for nMinBytes, and makes it current
+        void addBlock(size_t nMinBytes);
+        std::vector<std::vector<uchar,AlignedMemAllocator<uchar,PLATFORMUTILS_FRAMEARENA_DEFAULT_ALIGN>>> m_vvuBlocks;
+        size_t m_nCurrBlockIdx,m_nCurrBlockOffset;
+        size_t m_nScopeDepth;
+        size_t m_nHeapAllocCount;
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+    };
+
+    /// stl allocator adapter drawing memory from a frame arena (deallocation is a no-op; memory is reclaimed when the arena is rewound)
+    template<typename T, std::size_t nByteAlign=PLATFORMUTILS_FRAMEARENA_DEFAULT_ALIGN>
+    class FrameArenaAllocator {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        template<typename T2> struct rebind {typedef FrameArenaAllocator<T2,nByteAlign> other;};
+    public:
+        inline FrameArenaAllocator(FrameArena& oArena) noexcept : m_pArena(&oArena) {}
+        template<typename T2> inline FrameArenaAllocator(const FrameArenaAllocator<T2,nByteAlign>& oOther) noexcept : m_pArena(oOther.getArena()) {}
+        inline pointer allocate(size_type n) {return reinterpret_cast<pointer>(m_pArena->allocate(n*sizeof(value_type),std::max(nByteAlign,alignof(value_type))));}
+        inline void deallocate(pointer, size_type) noexcept {}
+        inline FrameArena* getArena() const noexcept {return m_pArena;}
+        bool operator!=(const FrameArenaAllocator<T,nByteAlign>& other) const {return !(*this==other);}
+        bool operator==(const FrameArenaAllocator<T,nByteAlign>& other) const {return m_pArena==other.m_pArena;}
+    private:
+        FrameArena* m_pArena;
+    };
+
     template<typename T>
     inline bool isnan(T dVal) {
 #ifdef _MSC_VER // needed for portability...
@@ -255,6 +326,9 @@ namespace std { // extending std
     template<typename T, size_t N>
     using aligned_vector = vector<T,lv::AlignedMemAllocator<T,N>>;
 
+    template<typename T, size_t N=PLATFORMUTILS_FRAMEARENA_DEFAULT_ALIGN>
+    using arena_vector = vector<T,lv::FrameArenaAllocator<T,N>>;
+
 #if !defined(_MSC_VER) && __cplusplus<=201103L // make_unique is missing from C++11 (at least on GCC)
     template<typename T, typename... Targs>
     inline std::enable_if_t<!std::is_array<T>::value,std::unique_ptr<T>> make_unique(Targs&&... args) {
@@ -0,0 +1,105 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/utils/distances.hpp"
+
+namespace {
+
+    /// float ops only compute per-scalar distances w/ simd, as these must then be summed in the same order as the templated impl to stay bit-exact
+    struct L1Op_32f {
+        static float dist(float a, float b) {return lv::L1dist(a,b);}
+#if HAVE_SIMD_DISPATCH
+        lvSIMDTarget("sse4.1") static __m128 dist128(const __m128& a, const __m128& b) {return _mm_andnot_ps(_mm_set1_ps(-0.0f),_mm_sub_ps(a,b));}
+        lvSIMDTarget("avx2") static __m256 dist256(const __m256& a, const __m256& b) {return _mm256_andnot_ps(_mm256_set1_ps(-0.0f),_mm256_sub_ps(a,b));}
+#endif //HAVE_SIMD_DISPATCH
+    };
+
+    /// adds the per-scalar distances of each unmasked element to the result, summing channels first (same order as the templated impl)
+    inline void accumulateOrdered_32f(const float* afDists, size_t nElements, size_t nChannels, const uchar* m, float& fResult) {
+        for(size_t nElemIdx=0; nElemIdx<nElements; ++nElemIdx, afDists+=nChannels) {
+            if(m && !m[nElemIdx])
+                continue;
+            float fElemDist = 0;
+            for(size_t c=0; c<nChannels; ++c)
+                fElemDist += afDists[c];
+            fResult += fElemDist;
+        }
+    }
+
+#if HAVE_SIMD_DISPATCH
+
+    /// processes all full 16-element blocks of floats w/ 128-bit registers (accumulating in order), and returns the number of processed elements
+    template<typename TOp>
+    lvSIMDTarget("sse4.1") size_t orderedbulkdist_32f_sse41(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m, float& fResult) {
+        constexpr size_t nBlockSize = 16;
+        const size_t nRegsPerBlock = nChannels*nBlockSize/4;
+        alignas(16) std::array<float,nBlockSize*4> afDists;
+        const size_t nBlocks = nElements/nBlockSize;
+        for(size_t nBlockIdx=0; nBlockIdx<nBlocks; ++nBlockIdx, a+=nBlockSize*nChannels, b+=nBlockSize*nChannels) {
+            for(size_t nRegIdx=0; nRegIdx<nRegsPerBlock; ++nRegIdx)
+                _mm_store_ps(afDists.data()+nRegIdx*4,TOp::dist128(_mm_loadu_ps(a+nRegIdx*4),_mm_loadu_ps(b+nRegIdx*4)));
+            accumulateOrdered_32f(afDists.data(),nBlockSize,nChannels,m?m+nBlockIdx*nBlockSize:nullptr,fResult);
+        }
+        return nBlocks*nBlockSize;
+    }
+
+    /// processes all full 32-element blocks of floats w/ 256-bit registers (accumulating in order), and returns the number of processed elements
+    template<typename TOp>
+    lvSIMDTarget("avx2") size_t orderedbulkdist_32f_avx2(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m, float& fResult) {
+        constexpr size_t nBlockSize = 32;
+        const size_t nRegsPerBlock = nChannels*nBlockSize/8;
+        alignas(32) std::array<float,nBlockSize*4> afDists;
+        const size_t nBlocks = nElements/nBlockSize;
+        for(size_t nBlockIdx=0; nBlockIdx<nBlocks; ++nBlockIdx, a+=nBlockSize*nChannels, b+=nBlockSize*nChannels) {
+            for(size_t nRegIdx=0; nRegIdx<nRegsPerBlock; ++nRegIdx)
+                _mm256_store_ps(afDists.data()+nRegIdx*8,TOp::dist256(_mm256_loadu_ps(a+nRegIdx*8),_mm256_loadu_ps(b+nRegIdx*8)));
+            accumulateOrdered_32f(afDists.data(),nBlockSize,nChannels,m?m+nBlockIdx*nBlockSize:nullptr,fResult);
+        }
+        return nBlocks*nBlockSize;
+    }
+
+#endif //HAVE_SIMD_DISPATCH
+
+    /// runs the widest simd kernel available at runtime over all full blocks, and carries the (ordered) sum through the scalar tail
+    template<typename TOp>
+    float orderedbulkdist_32f(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m) {
+        lvAssert_(nChannels>0 && nChannels<=4,"non-templated distance function only defined for 1 to 4 channels");
+        float fResult = 0;
+        size_t nProcessed = 0;
+#if HAVE_SIMD_DISPATCH
+        const lv::SIMDLevel eSIMDLevel = lv::getSIMDLevel();
+        if(eSIMDLevel>=lv::SIMDLevel_AVX2)
+            nProcessed = orderedbulkdist_32f_avx2<TOp>(a,b,nElements,nChannels,m,fResult);
+        else if(eSIMDLevel>=lv::SIMDLevel_SSE4_1)
+            nProcessed = orderedbulkdist_32f_sse41<TOp>(a,b,nElements,nChannels,m,fResult);
+#endif //HAVE_SIMD_DISPATCH
+        for(size_t nElemIdx=nProcessed; nElemIdx<nElements; ++nElemIdx) {
+            if(m && !m[nElemIdx])
+                continue;
+            float fElemDist = 0;
+            for(size_t c=0; c<nChannels; ++c)
+                fElemDist += TOp::dist(a[nElemIdx*nChannels+c],b[nElemIdx*nChannels+c]);
+            fResult += fElemDist;
+        }
+        return fResult;
+    }
+
+} // anonymous namespace
+
+float lv::L1dist_bulk(const float* const a, const float* const b, size_t nElements, size_t nChannels, const uchar* m) {
+    return orderedbulkdist_32f<L1Op_32f>(a,b,nElements,nChannels,m);
+}
@@ -18,6 +18,41 @@
 #include "litiv/utils/opencv.hpp"
 #include "litiv/utils/platform.hpp"
 
+namespace {
+
+    /// returns an 8UC3 version of the given 8u/16u/32f image, using the provided buffers only if a conversion is needed
+    inline const cv::Mat& convertToBYTE3(const cv::Mat& oImage, cv::Mat& oDepthBuffer, cv::Mat& oColorBuffer) {
+        const cv::Mat* pImageBYTE = &oImage;
+        if(oImage.depth()==CV_16U) {
+            oImage.convertTo(oDepthBuffer,CV_8U,double(UCHAR_MAX)/(USHRT_MAX));
+            pImageBYTE = &oDepthBuffer;
+        }
+        else if(oImage.depth()==CV_32F) {
+            oImage.convertTo(oDepthBuffer,CV_8U,double(UCHAR_MAX));
+            pImageBYTE = &oDepthBuffer;
+        }
+        if(pImageBYTE->channels()==1) {
+            cv::cvtColor(*pImageBYTE,oColorBuffer,cv::COLOR_GRAY2BGR);
+            return oColorBuffer;
+        }
+        else if(pImageBYTE->channels()==4) {
+            cv::cvtColor(*pImageBYTE,oColorBuffer,cv::COLOR_BGRA2BGR);
+            return oColorBuffer;
+        }
+        return *pImageBYTE;
+    }
+
+    /// copies (or resizes) the given 8UC3 image into the preallocated tile (which may be a submat of a larger display buffer)
+    inline void copyToTile(const cv::Mat& oImageBYTE3, cv::Mat& oTile) {
+        lvDbgAssert(oImageBYTE3.type()==CV_8UC3 && oTile.type()==CV_8UC3);
+        if(oImageBYTE3.size()==oTile.size())
+            oImageBYTE3.copyTo(oTile);
+        else
+            cv::resize(oImageBYTE3,oTile,oTile.size()); // tile size & type match, so no reallocation occurs
+    }
+
+} // anonymous namespace
+
 cv::DisplayHelperPtr cv::DisplayHelper::create(const std::string& sDisplayName, const std::string& sDebugFSDirPath, const cv::Size& oMaxSize, int nWindowFlags) {
     struct DisplayHelperWrapper : public DisplayHelper {
         DisplayHelperWrapper(const std::string& sDisplayName, const std::string& sDebugFSDirPath, const cv::Size& oMaxSize, int nWindowFlags) :
@@ -44,28 +79,23 @@ cv::DisplayHelper::~DisplayHelper() {
 
 void cv::DisplayHelper::display(const cv::Mat& oImage, size_t nIdx) {
     lvAssert_(!oImage.empty() && (oImage.type()==CV_8UC1 || oImage.type()==CV_8UC3 || oImage.type()==CV_8UC4),"image to display must be non-empty, and of type 8UC1/8UC3/8UC4");
-    cv::Mat oImageBYTE3;
-    if(oImage.channels()==1)
-        cv::cvtColor(oImage,oImageBYTE3,cv::COLOR_GRAY2BGR);
-    else if(oImage.channels()==4)
-        cv::cvtColor(oImage,oImageBYTE3,cv::COLOR_BGRA2BGR);
-    else
-        oImageBYTE3 = oImage.clone();
+    const cv::Mat& oImageBYTE3 = convertToBYTE3(oImage,m_oDepthBuffer,m_oColorBuffer);
     cv::Size oCurrDisplaySize;
     if(m_oMaxDisplaySize.area()>0 && (oImageBYTE3.cols>m_oMaxDisplaySize.width || oImageBYTE3.rows>m_oMaxDisplaySize.height)) {
         if(oImageBYTE3.cols>m_oMaxDisplaySize.width && oImageBYTE3.cols>oImageBYTE3.rows)
             oCurrDisplaySize = cv::Size(m_oMaxDisplaySize.width,int(m_oMaxDisplaySize.width*(float(oImageBYTE3.rows)/oImageBYTE3.cols)));
         else
             oCurrDisplaySize = cv::Size(int(m_oMaxDisplaySize.height*(float(oImageBYTE3.cols)/oImageBYTE3.rows)),m_oMaxDisplaySize.height);
-        cv::resize(oImageBYTE3,oImageBYTE3,oCurrDisplaySize);
     }
     else
         oCurrDisplaySize = oImageBYTE3.size();
+    m_oDisplayBuffer.create(oCurrDisplaySize,CV_8UC3);
+    copyToTile(oImageBYTE3,m_oDisplayBuffer);
     std::stringstream sstr;
     sstr << "Image #" << nIdx;
-    putText(oImageBYTE3,sstr.str(),cv::Scalar_<uchar>(0,0,255));
+    putText(m_oDisplayBuffer,sstr.str(),cv::Scalar_<uchar>(0,0,255));
     if(m_bFirstDisplay) {
-        putText(oImageBYTE3,"[Press space to continue]",cv::Scalar_<uchar>(0,0,255),true,cv::Point2i(oImageBYTE3.cols/2-40,15));
+        putText(m_oDisplayBuffer,"[Press space to continue]",cv::Scalar_<uchar>(0,0,255),true,cv::Point2i(m_oDisplayBuffer.cols/2-40,15));
         m_bFirstDisplay = false;
     }
     std::mutex_lock_guard oLock(m_oEventMutex);
@@ -73,54 +103,41 @@ void cv::DisplayHelper::display(const cv::Mat& oImage, size_t nIdx) {
     const cv::Size& oLastDbgSize = m_oLatestMouseEvent.oDisplaySize;
     if(oDbgPt.x>=0 && oDbgPt.y>=0 && oDbgPt.x<oLastDbgSize.width && oDbgPt.y<oLastDbgSize.height) {
         const cv::Point2i oDbgPt_rescaled(int(oCurrDisplaySize.width*(float(oDbgPt.x)/oLastDbgSize.width)),int(oCurrDisplaySize.height*(float(oDbgPt.y)/oLastDbgSize.height)));
-        cv::circle(oImageBYTE3,oDbgPt_rescaled,5,cv::Scalar(255,255,255));
+        cv::circle(m_oDisplayBuffer,oDbgPt_rescaled,5,cv::Scalar(255,255,255));
     }
-    cv::imshow(m_sDisplayName,oImageBYTE3);
+    cv::imshow(m_sDisplayName,m_oDisplayBuffer);
     m_oLastDisplaySize = oCurrDisplaySize;
 }
+
 void cv::DisplayHelper::display(const cv::Mat& oInputImg, const cv::Mat& oDebugImg, const cv::Mat& oOutputImg, size_t nIdx) {
     lvAssert_(!oInputImg.empty() && (oInputImg.type()==CV_8UC1 || oInputImg.type()==CV_8UC3 || oInputImg.type()==CV_8UC4),"input image must be 8UC1/8UC3/8UC4");
     lvAssert_(!oDebugImg.empty() && (oDebugImg.type()==CV_8UC1 || oDebugImg.type()==CV_8UC3 || oDebugImg.type()==CV_8UC4),"debug image must be 8UC1/8UC3/8UC4");
     lvAssert_(!oOutputImg.empty() && (oOutputImg.type()==CV_8UC1 || oOutputImg.type()==CV_8UC3 || oOutputImg.type()==CV_8UC4),"output image must be 8UC1/8UC3/8UC4");
     lvAssert_(oOutputImg.size()==oInputImg.size() && oDebugImg.size()==oInputImg.size(),"all provided mat sizes must match");
-    cv::Mat oInputImgBYTE3, oDebugImgBYTE3, oOutputImgBYTE3;
-    if(oInputImg.channels()==1)
-        cv::cvtColor(oInputImg,oInputImgBYTE3,cv::COLOR_GRAY2BGR);
-    else if(oInputImg.channels()==4)
-        cv::cvtColor(oInputImg,oInputImgBYTE3,cv::COLOR_BGRA2BGR);
-    else
-        oInputImgBYTE3 = oInputImg.clone();
-    if(oDebugImg.channels()==1)
-        cv::cvtColor(oDebugImg,oDebugImgBYTE3,cv::COLOR_GRAY2BGR);
-    else if(oDebugImg.channels()==4)
-        cv::cvtColor(oDebugImg,oDebugImgBYTE3,cv::COLOR_BGRA2BGR);
-    else
-        oDebugImgBYTE3 = oDebugImg.clone();
-    if(oOutputImg.channels()==1)
-        cv::cvtColor(oOutputImg,oOutputImgBYTE3,cv::COLOR_GRAY2BGR);
-    else if(oOutputImg.channels()==4)
-        cv::cvtColor(oOutputImg,oDebugImgBYTE3,cv::COLOR_BGRA2BGR);
-    else
-        oOutputImgBYTE3 = oOutputImg.clone();
     cv::Size oCurrDisplaySize;
-    if(m_oMaxDisplaySize.area()>0 && (oOutputImgBYTE3.cols*3>m_oMaxDisplaySize.width || oOutputImgBYTE3.rows>m_oMaxDisplaySize.height)) {
-        if(oOutputImgBYTE3.cols*3>m_oMaxDisplaySize.width && oOutputImgBYTE3.cols>oOutputImgBYTE3.rows)
-            oCurrDisplaySize = cv::Size((m_oMaxDisplaySize.width/3),int((m_oMaxDisplaySize.width/3)*(float(oOutputImgBYTE3.rows)/oOutputImgBYTE3.cols)));
+    if(m_oMaxDisplaySize.area()>0 && (oOutputImg.cols*3>m_oMaxDisplaySize.width || oOutputImg.rows>m_oMaxDisplaySize.height)) {
+        if(oOutputImg.cols*3>m_oMaxDisplaySize.width && oOutputImg.cols>oOutputImg.rows)
+            oCurrDisplaySize = cv::Size((m_oMaxDisplaySize.width/3),int((m_oMaxDisplaySize.width/3)*(float(oOutputImg.rows)/oOutputImg.cols)));
         else
-            oCurrDisplaySize = cv::Size(int(m_oMaxDisplaySize.height*(float(oOutputImgBYTE3.cols)/oOutputImgBYTE3.rows)),m_oMaxDisplaySize.height);
-        cv::resize(oInputImgBYTE3,oInputImgBYTE3,oCurrDisplaySize);
-        cv::resize(oDebugImgBYTE3,oDebugImgBYTE3,oCurrDisplaySize);
-        cv::resize(oOutputImgBYTE3,oOutputImgBYTE3,oCurrDisplaySize);
+            oCurrDisplaySize = cv::Size(int(m_oMaxDisplaySize.height*(float(oOutputImg.cols)/oOutputImg.rows)),m_oMaxDisplaySize.height);
     }
     else
-        oCurrDisplaySize = oOutputImgBYTE3.size();
+        oCurrDisplaySize = oOutputImg.size();
+    // all three images are converted & resized directly into their tile of the reused display buffer (no intermediate clones or concats)
+    m_oDisplayBuffer.create(oCurrDisplaySize.height,oCurrDisplaySize.width*3,CV_8UC3);
+    cv::Mat oInputTile = m_oDisplayBuffer.colRange(0,oCurrDisplaySize.width);
+    cv::Mat oDebugTile = m_oDisplayBuffer.colRange(oCurrDisplaySize.width,oCurrDisplaySize.width*2);
+    cv::Mat oOutputTile = m_oDisplayBuffer.colRange(oCurrDisplaySize.width*2,oCurrDisplaySize.width*3);
+    copyToTile(convertToBYTE3(oInputImg,m_oDepthBuffer,m_oColorBuffer),oInputTile);
+    copyToTile(convertToBYTE3(oDebugImg,m_oDepthBuffer,m_oColorBuffer),oDebugTile);
+    copyToTile(convertToBYTE3(oOutputImg,m_oDepthBuffer,m_oColorBuffer),oOutputTile);
     std::stringstream sstr;
     sstr << "Input #" << nIdx;
-    putText(oInputImgBYTE3,sstr.str(),cv::Scalar_<uchar>(0,0,255));
-    putText(oDebugImgBYTE3,"Debug",cv::Scalar_<uchar>(0,0,255));
-    putText(oOutputImgBYTE3,"Output",cv::Scalar_<uchar>(0,0,255));
+    putText(oInputTile,sstr.str(),cv::Scalar_<uchar>(0,0,255));
+    putText(oDebugTile,"Debug",cv::Scalar_<uchar>(0,0,255));
+    putText(oOutputTile,"Output",cv::Scalar_<uchar>(0,0,255));
     if(m_bFirstDisplay) {
-        putText(oDebugImgBYTE3,"[Press space to continue]",cv::Scalar_<uchar>(0,0,255),true,cv::Point2i(oDebugImgBYTE3.cols/2-100,15),1,1.0);
+        putText(oDebugTile,"[Press space to continue]",cv::Scalar_<uchar>(0,0,255),true,cv::Point2i(oDebugTile.cols/2-100,15),1,1.0);
         m_bFirstDisplay = false;
     }
     std::mutex_lock_guard oLock(m_oEventMutex);
@@ -128,15 +145,12 @@ void cv::DisplayHelper::display(const cv::Mat& oInputImg, const cv::Mat& oDebugI
     const cv::Size& oLastDisplaySize = m_oLatestMouseEvent.oDisplaySize;
     if(oDisplayPt.x>=0 && oDisplayPt.y>=0 && oDisplayPt.x<oLastDisplaySize.width && oDisplayPt.y<oLastDisplaySize.height) {
         const cv::Point2i oDisplayPt_rescaled(int(oCurrDisplaySize.width*(float(oDisplayPt.x%(oLastDisplaySize.width/3))/(oLastDisplaySize.width/3))),int(oCurrDisplaySize.height*(float(oDisplayPt.y)/oLastDisplaySize.height)));
-        cv::circle(oInputImgBYTE3,oDisplayPt_rescaled,5,cv::Scalar(255,255,255));
-        cv::circle(oDebugImgBYTE3,oDisplayPt_rescaled,5,cv::Scalar(255,255,255));
-        cv::circle(oOutputImgBYTE3,oDisplayPt_rescaled,5,cv::Scalar(255,255,255));
+        cv::circle(oInputTile,oDisplayPt_rescaled,5,cv::Scalar(255,255,255));
+        cv::circle(oDebugTile,oDisplayPt_rescaled,5,cv::Scalar(255,255,255));
+        cv::circle(oOutputTile,oDisplayPt_rescaled,5,cv::Scalar(255,255,255));
     }
-    cv::Mat displayH;
-    cv::hconcat(oInputImgBYTE3,oDebugImgBYTE3,displayH);
-    cv::hconcat(displayH,oOutputImgBYTE3,displayH);
-    cv::imshow(m_sDisplayName,displayH);
-    m_oLastDisplaySize = displayH.size();
+    cv::imshow(m_sDisplayName,m_oDisplayBuffer);
+    m_oLastDisplaySize = m_oDisplayBuffer.size();
 }
 
 void cv::DisplayHelper::display(const std::vector<std::vector<std::pair<cv::Mat,std::string>>>& vvImageNamePairs, const cv::Size& oSuggestedTileSize) {
@@ -167,47 +181,26 @@ void cv::DisplayHelper::display(const std::vector<std::vector<std::pair<cv::Mat,
     std::mutex_lock_guard oLock(m_oEventMutex);
     const cv::Point2i& oDisplayPt = m_oLatestMouseEvent.oPosition;
     const cv::Size& oLastDisplaySize = m_oLatestMouseEvent.oDisplaySize;
-    cv::Mat oOutput;
+    // each image is converted & resized directly into its tile of the reused display buffer (no intermediate clones or concats)
+    m_oDisplayBuffer.create(oFinalDisplaySize,CV_8UC3);
     for(size_t nRowIdx=0; nRowIdx<nRowCount; ++nRowIdx) {
-        cv::Mat oOutputRow;
         for(size_t nColIdx=0; nColIdx<nColCount; ++nColIdx) {
-            const cv::Mat& oImage = vvImageNamePairs[nRowIdx][nColIdx].first;
-            cv::Mat oImageBYTE3;
-            if(oImage.depth()==CV_16U)
-                oImage.convertTo(oImageBYTE3,CV_8U,double(UCHAR_MAX)/(USHRT_MAX));
-            else if(oImage.depth()==CV_32F)
-                oImage.convertTo(oImageBYTE3,CV_8U,double(UCHAR_MAX));
-            else
-                oImageBYTE3 = oImage.clone();
-            if(oImageBYTE3.channels()==1)
-                cv::cvtColor(oImageBYTE3,oImageBYTE3,cv::COLOR_GRAY2BGR);
-            else if(oImageBYTE3.channels()==4)
-                cv::cvtColor(oImageBYTE3,oImageBYTE3,cv::COLOR_BGRA2BGR);
-            if(oImageBYTE3.size()!=oNewTileSize)
-                cv::resize(oImageBYTE3,oImageBYTE3,oNewTileSize);
+            cv::Mat oTile = m_oDisplayBuffer(cv::Rect(int(nColIdx*oNewTileSize.width),int(nRowIdx*oNewTileSize.height),oNewTileSize.width,oNewTileSize.height));
+            copyToTile(convertToBYTE3(vvImageNamePairs[nRowIdx][nColIdx].first,m_oDepthBuffer,m_oColorBuffer),oTile);
             if(!vvImageNamePairs[nRowIdx][nColIdx].second.empty())
-                putText(oImageBYTE3,vvImageNamePairs[nRowIdx][nColIdx].second,cv::Scalar_<uchar>(0,0,255));
+                putText(oTile,vvImageNamePairs[nRowIdx][nColIdx].second,cv::Scalar_<uchar>(0,0,255));
             if(oDisplayPt.x>=0 && oDisplayPt.y>=0 && oDisplayPt.x<oLastDisplaySize.width && oDisplayPt.y<oLastDisplaySize.height && oLastDisplaySize==oFinalDisplaySize) {
                 const cv::Point2i oDisplayPt_raw(oDisplayPt.x%oNewTileSize.width,oDisplayPt.y%oNewTileSize.height);
-                cv::circle(oImageBYTE3,oDisplayPt_raw,5,cv::Scalar(255,255,255));
+                cv::circle(oTile,oDisplayPt_raw,5,cv::Scalar(255,255,255));
             }
-            if(oOutputRow.empty())
-                oOutputRow = oImageBYTE3;
-            else
-                cv::hconcat(oOutputRow,oImageBYTE3,oOutputRow);
         }
-        if(oOutput.empty())
-            oOutput = oOutputRow;
-        else
-            cv::vconcat(oOutput,oOutputRow,oOutput);
     }
     if(m_bFirstDisplay) {
-        putText(oOutput,"[Press space to continue]",cv::Scalar_<uchar>(0,0,255),true,cv::Point2i(oOutput.cols/2-100,15),1,1.0);
+        putText(m_oDisplayBuffer,"[Press space to continue]",cv::Scalar_<uchar>(0,0,255),true,cv::Point2i(m_oDisplayBuffer.cols/2-100,15),1,1.0);
         m_bFirstDisplay = false;
     }
-    lvAssert(oOutput.size()==oFinalDisplaySize);
-    cv::imshow(m_sDisplayName,oOutput);
-    m_oLastDisplaySize = oOutput.size();
+    cv::imshow(m_sDisplayName,m_oDisplayBuffer);
+    m_oLastDisplaySize = m_oDisplayBuffer.size();
 }
 
 int cv::DisplayHelper::waitKey(int nDefaultSleepDelay) {
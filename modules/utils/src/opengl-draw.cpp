@@ -25,9 +25,11 @@ GLVertexArrayObject::~GLVertexArrayObject() {
     glDeleteVertexArrays(1,&m_nVAO);
 }
 
-GLPixelBufferObject::GLPixelBufferObject(const cv::Mat& oInitBufferData, GLenum eBufferTarget, GLenum eBufferUsage) :
+GLPixelBufferObject::GLPixelBufferObject(const cv::Mat& oInitBufferData, GLenum eBufferTarget, GLenum eBufferUsage, bool bUsePersistentMapping) :
         m_eBufferTarget(eBufferTarget),
         m_eBufferUsage(eBufferUsage),
+        m_pFence(nullptr),
+        m_pPersistentClientPtr(nullptr),
         m_nBufferSize(oInitBufferData.rows*oInitBufferData.cols*oInitBufferData.channels()*lv::gl::getByteSizeFromMatDepth(oInitBufferData.depth())),
         m_nFrameType(oInitBufferData.type()),
         m_oFrameSize(oInitBufferData.size()) {
@@ -35,17 +37,33 @@ GLPixelBufferObject::GLPixelBufferObject(const cv::Mat& oInitBufferData, GLenum
     lvAssert(m_nBufferSize>0);
     glGenBuffers(1,&m_nPBO);
     glBindBuffer(m_eBufferTarget,m_nPBO);
-    glBufferData(m_eBufferTarget,m_nBufferSize,(m_eBufferTarget==GL_PIXEL_PACK_BUFFER)?nullptr:oInitBufferData.data,m_eBufferUsage);
+    const GLvoid* pInitData = (m_eBufferTarget==GL_PIXEL_PACK_BUFFER)?nullptr:oInitBufferData.data;
+    if(bUsePersistentMapping && glBufferStorage) {
+        // coherent mapping: gpu writes are visible to the client once a fence placed after them is signaled (and vice-versa)
+        const GLbitfield nMapFlags = GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT|((m_eBufferTarget==GL_PIXEL_PACK_BUFFER)?GL_MAP_READ_BIT:GL_MAP_WRITE_BIT);
+        glBufferStorage(m_eBufferTarget,m_nBufferSize,pInitData,nMapFlags);
+        m_pPersistentClientPtr = glMapBufferRange(m_eBufferTarget,0,m_nBufferSize,nMapFlags);
+        lvAssert_(m_pPersistentClientPtr,"could not persistently map pixel buffer object");
+    }
+    else
+        glBufferData(m_eBufferTarget,m_nBufferSize,pInitData,m_eBufferUsage);
     glBindBuffer(m_eBufferTarget,0);
 }
 
 GLPixelBufferObject::~GLPixelBufferObject() {
-    glDeleteBuffers(1,&m_nPBO);
+    if(m_pFence)
+        glDeleteSync(m_pFence);
+    glDeleteBuffers(1,&m_nPBO); // also unmaps persistent storage
 }
 
 bool GLPixelBufferObject::updateBuffer(const cv::Mat& oBufferData, bool bRealloc, bool bRebindAll) {
     lvDbgAssert(m_eBufferTarget==GL_PIXEL_UNPACK_BUFFER);
     lvDbgAssert(oBufferData.type()==m_nFrameType && oBufferData.size()==m_oFrameSize && oBufferData.isContinuous());
+    checkFence(true);
+    if(m_pPersistentClientPtr) {
+        memcpy(m_pPersistentClientPtr,oBufferData.data,m_nBufferSize);
+        return true;
+    }
     glBindBuffer(m_eBufferTarget,m_nPBO);
     if(bRealloc)
         glBufferData(m_eBufferTarget,m_nBufferSize,nullptr,m_eBufferUsage);
@@ -62,6 +80,11 @@ bool GLPixelBufferObject::updateBuffer(const cv::Mat& oBufferData, bool bRealloc
 bool GLPixelBufferObject::fetchBuffer(cv::Mat& oBufferData, bool bRebindAll) {
     lvDbgAssert(m_eBufferTarget==GL_PIXEL_PACK_BUFFER);
     lvDbgAssert(oBufferData.type()==m_nFrameType && oBufferData.size()==m_oFrameSize && oBufferData.isContinuous());
+    checkFence(true);
+    if(m_pPersistentClientPtr) {
+        memcpy(oBufferData.data,m_pPersistentClientPtr,m_nBufferSize);
+        return true;
+    }
     glBindBuffer(m_eBufferTarget,m_nPBO);
     void* pBufferClientPtr = glMapBuffer(m_eBufferTarget,GL_READ_ONLY);
     if(pBufferClientPtr) {
@@ -73,6 +96,27 @@ bool GLPixelBufferObject::fetchBuffer(cv::Mat& oBufferData, bool bRebindAll) {
     return pBufferClientPtr!=nullptr;
 }
 
+void GLPixelBufferObject::insertFence() {
+    if(m_pFence)
+        glDeleteSync(m_pFence);
+    m_pFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+}
+
+bool GLPixelBufferObject::checkFence(bool bWait) {
+    if(!m_pFence)
+        return true;
+    GLenum eWaitRes;
+    do // flushing makes sure the fence can eventually be signaled, even if nothing else gets queued
+        eWaitRes = glClientWaitSync(m_pFence,GL_SYNC_FLUSH_COMMANDS_BIT,bWait?GLuint64(1000000000):GLuint64(0));
+    while(bWait && eWaitRes==GL_TIMEOUT_EXPIRED);
+    lvAssert_(eWaitRes!=GL_WAIT_FAILED,"pixel buffer object fence wait failed");
+    if(eWaitRes==GL_TIMEOUT_EXPIRED)
+        return false;
+    glDeleteSync(m_pFence);
+    m_pFence = nullptr;
+    return true;
+}
+
 GLTexture::GLTexture() {
     glGenTextures(1,&m_nTex);
 }
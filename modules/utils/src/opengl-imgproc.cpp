@@ -16,6 +16,115 @@
 // limitations under the License.
 
 #include "litiv/utils/opengl-imgproc.hpp"
+#include <typeinfo>
+#include <limits>
+
+namespace {
+
+    /// work group sizes timed (on top of the algo's current size) when auto-tuning
+    const std::array<glm::uvec2,9> s_avWorkGroupSizeCandidates = {
+        glm::uvec2(8,8),glm::uvec2(16,8),glm::uvec2(8,16),glm::uvec2(16,16),glm::uvec2(32,4),
+        glm::uvec2(32,8),glm::uvec2(64,4),glm::uvec2(32,16),glm::uvec2(64,8),
+    };
+
+    /// returns whether the given work group size respects the current device's compute limits for the given frame size
+    bool isWorkGroupSizeSupported(const glm::uvec2& vWorkGroupSize, const cv::Size& oFrameSize) {
+        if(vWorkGroupSize.x==0 || vWorkGroupSize.y==0)
+            return false;
+        const std::array<int,3> anMaxWorkGroupSize = lv::gl::getIntegerVal<3>(GL_MAX_COMPUTE_WORK_GROUP_SIZE);
+        const std::array<int,3> anMaxWorkGroupCount = lv::gl::getIntegerVal<3>(GL_MAX_COMPUTE_WORK_GROUP_COUNT);
+        return anMaxWorkGroupSize[0]>=(int)vWorkGroupSize.x && anMaxWorkGroupSize[1]>=(int)vWorkGroupSize.y &&
+               (size_t)lv::gl::getIntegerVal<1>(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS)>=size_t(vWorkGroupSize.x*vWorkGroupSize.y) &&
+               anMaxWorkGroupCount[0]>=(int)ceil((float)oFrameSize.width/vWorkGroupSize.x) && anMaxWorkGroupCount[1]>=(int)ceil((float)oFrameSize.height/vWorkGroupSize.y);
+    }
+
+    /// returns the key under which the tuned work group size of an algo is cached (algo type, frame size, and device/driver strings)
+    std::string getWorkGroupSizeCacheKey(const GLImageProcAlgo& oAlgo, const cv::Size& oFrameSize) {
+        std::stringstream ssKey;
+        ssKey << typeid(oAlgo).name() << "|" << oFrameSize.width << "x" << oFrameSize.height;
+        for(GLenum eDriverString : {GL_VENDOR,GL_RENDERER,GL_VERSION}) {
+            const char* acDriverString = (const char*)glGetString(eDriverString);
+            ssKey << "|" << (acDriverString?acDriverString:"");
+        }
+        return ssKey.str();
+    }
+
+    /// process-wide tuned work group sizes, mirrored in a text file next to the program binary cache (if available)
+    struct WorkGroupSizeCache {
+        std::mutex oMutex;
+        std::map<std::string,glm::uvec2> mvWorkGroupSizes;
+        bool bLoaded = false;
+        static std::string getFilePath() {
+            const std::string& sDirPath = GLShader::getBinaryCacheDirPath();
+            return sDirPath.empty()?std::string():sDirPath+"workgroups.txt";
+        }
+        void load() { // should be called w/ mutex locked
+            if(bLoaded)
+                return;
+            bLoaded = true;
+            const std::string sFilePath = getFilePath();
+            std::ifstream ssFile(sFilePath);
+            std::string sLine;
+            while(!sFilePath.empty() && ssFile.is_open() && std::getline(ssFile,sLine)) {
+                // line format: '<key>\t<x> <y>'; later lines override earlier ones
+                const size_t nSeparatorPos = sLine.rfind('\t');
+                glm::uvec2 vWorkGroupSize;
+                if(nSeparatorPos!=std::string::npos && (std::istringstream(sLine.substr(nSeparatorPos+1)) >> vWorkGroupSize.x >> vWorkGroupSize.y))
+                    mvWorkGroupSizes[sLine.substr(0,nSeparatorPos)] = vWorkGroupSize;
+            }
+        }
+        bool get(const std::string& sKey, glm::uvec2& vWorkGroupSize) {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            load();
+            auto pSizeIter = mvWorkGroupSizes.find(sKey);
+            if(pSizeIter==mvWorkGroupSizes.end())
+                return false;
+            vWorkGroupSize = pSizeIter->second;
+            return true;
+        }
+        void set(const std::string& sKey, const glm::uvec2& vWorkGroupSize) {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            load();
+            mvWorkGroupSizes[sKey] = vWorkGroupSize;
+            const std::string sFilePath = getFilePath();
+            if(!sFilePath.empty()) {
+                std::ofstream ssFile(sFilePath,std::ios::out|std::ios::app);
+                if(ssFile.is_open())
+                    ssFile << sKey << "\t" << vWorkGroupSize.x << " " << vWorkGroupSize.y << "\n";
+            }
+        }
+        static WorkGroupSizeCache& get() {
+            static WorkGroupSizeCache s_oCache;
+            return s_oCache;
+        }
+    };
+
+    /// fetches the latest pbo of the ring whose transfer is done (or the oldest pending one, if none is), and returns its frame index
+    size_t fetchLatestPBO(const std::array<std::unique_ptr<GLPixelBufferObject>,GLUTILS_IMGPROC_PBO_RING_SIZE>& apPBOs,
+                          const std::array<size_t,GLUTILS_IMGPROC_PBO_RING_SIZE>& anPBOFrameIdxs,
+                          cv::Mat& oOutput, bool bWaitForLatest) {
+        size_t nLatestPBO=size_t(-1), nLatestReadyPBO=size_t(-1), nOldestPBO=size_t(-1);
+        for(size_t nPBOIter=0; nPBOIter<GLUTILS_IMGPROC_PBO_RING_SIZE; ++nPBOIter) {
+            const size_t nFrameIdx = anPBOFrameIdxs[nPBOIter];
+            if(nFrameIdx==size_t(-1))
+                continue;
+            if(nLatestPBO==size_t(-1) || nFrameIdx>anPBOFrameIdxs[nLatestPBO])
+                nLatestPBO = nPBOIter;
+            if(nOldestPBO==size_t(-1) || nFrameIdx<anPBOFrameIdxs[nOldestPBO])
+                nOldestPBO = nPBOIter;
+            if(!bWaitForLatest && (nLatestReadyPBO==size_t(-1) || nFrameIdx>anPBOFrameIdxs[nLatestReadyPBO]) && apPBOs[nPBOIter]->checkFence(false))
+                nLatestReadyPBO = nPBOIter;
+        }
+        if(nLatestPBO==size_t(-1)) {
+            oOutput = cv::Scalar::all(0);
+            return size_t(-1);
+        }
+        const size_t nFetchedPBO = bWaitForLatest?nLatestPBO:(nLatestReadyPBO!=size_t(-1))?nLatestReadyPBO:nOldestPBO;
+        apPBOs[nFetchedPBO]->fetchBuffer(oOutput,true);
+        return anPBOFrameIdxs[nFetchedPBO];
+    }
+
+} // anonymous namespace
 
 GLImageProcAlgo::GLImageProcAlgo( size_t nLevels, size_t nComputeStages, size_t nExtraSSBOs, size_t nExtraACBOs, size_t nExtraImages, size_t nExtraTextures,
                                   int nOutputType, int nDebugType, bool bUseInput, bool bUseDisplay, bool bUseTimers, bool bUseIntegralFormat) :
@@ -26,18 +135,18 @@ GLImageProcAlgo::GLImageProcAlgo( size_t nLevels, size_t nComputeStages, size_t
         m_nImages(GLImageProcAlgo::nImageDefaultBindingsCount+nExtraImages),
         m_nTextures(GLImageProcAlgo::nTextureDefaultBindingsCount+nExtraTextures),
         m_nSxSDisplayCount(size_t(nOutputType>=0)+size_t(nDebugType>=0)+size_t(bUseInput)),
-        m_bUsingOutputPBOs(nOutputType>=0&&GLUTILS_IMGPROC_USE_DOUBLE_PBO_OUTPUT),
-        m_bUsingDebugPBOs(nDebugType>=0&&GLUTILS_IMGPROC_USE_DOUBLE_PBO_OUTPUT),
-        m_bUsingInputPBOs(bUseInput&&GLUTILS_IMGPROC_USE_DOUBLE_PBO_INPUT),
+        m_bUsingOutputPBOs(nOutputType>=0&&GLUTILS_IMGPROC_USE_PBO_OUTPUT),
+        m_bUsingDebugPBOs(nDebugType>=0&&GLUTILS_IMGPROC_USE_PBO_OUTPUT),
+        m_bUsingInputPBOs(bUseInput&&GLUTILS_IMGPROC_USE_PBO_INPUT),
         m_bUsingOutput(nOutputType>=0),
         m_bUsingDebug(nDebugType>=0),
         m_bUsingInput(bUseInput),
         m_bUsingTexArrays(GLUTILS_IMGPROC_USE_TEXTURE_ARRAYS&&nLevels==1), /// && levels==1??? @@@@
         m_bUsingTimers(bUseTimers),
         m_bUsingIntegralFormat(bUseIntegralFormat),
-        m_vDefaultWorkGroupSize(GLUTILS_IMGPROC_DEFAULT_WORKGROUP),
         m_bUsingDisplay(bUseDisplay),
         m_bGLInitialized(false),
+        m_vWorkGroupSize(GLUTILS_IMGPROC_DEFAULT_WORKGROUP),
         m_nInternalFrameIdx(size_t(-1)),
         m_nLastOutputInternalIdx(size_t(-1)),
         m_nLastDebugInternalIdx(size_t(-1)),
@@ -50,16 +159,20 @@ GLImageProcAlgo::GLImageProcAlgo( size_t nLevels, size_t nComputeStages, size_t
         m_nNextPBO(1),
         m_nOutputType(nOutputType),
         m_nDebugType(nDebugType),
-        m_nInputType(-1) {
+        m_nInputType(-1),
+        m_bAutoTuningWorkGroupSize(GLUTILS_IMGPROC_DEFAULT_WORKGROUP_AUTOTUNING),
+        m_nCurrWorkGroupSizeCandidate(size_t(-1)),
+        m_nCurrWorkGroupSizeTuningFrame(0) {
     static_assert(GLUTILS_IMGPROC_DEFAULT_LAYER_COUNT>1,"texture arrays must have at least one layer each");
+    static_assert(GLUTILS_IMGPROC_PBO_RING_SIZE>1,"pbo rings must have at least two buffers each");
     lvAssert_(m_nLevels>0,"textures must have at least one level each");
     lvAssert_(m_nComputeStages>0,"image processing pipeline must have at least one compute stage");
     if(m_bUsingTexArrays && !glGetTextureSubImage && (m_bUsingDebugPBOs || m_bUsingOutputPBOs))
         lvError("missing impl for texture arrays pbo fetch when glGetTextureSubImage is not available");
     const std::array<int,3> anMaxWorkGroupSize = lv::gl::getIntegerVal<3>(GL_MAX_COMPUTE_WORK_GROUP_SIZE);
-    if(anMaxWorkGroupSize[0]<(int)m_vDefaultWorkGroupSize.x || anMaxWorkGroupSize[1]<(int)m_vDefaultWorkGroupSize.y)
-        lvError_("workgroup size limit is too small for the current impl (curr=[%d,%d], req=[%d,%d])",anMaxWorkGroupSize[0],anMaxWorkGroupSize[1],(int)m_vDefaultWorkGroupSize.x,(int)m_vDefaultWorkGroupSize.y);
-    const size_t nCurrComputeStageInvocs = m_vDefaultWorkGroupSize.x*m_vDefaultWorkGroupSize.y;
+    if(anMaxWorkGroupSize[0]<(int)m_vWorkGroupSize.x || anMaxWorkGroupSize[1]<(int)m_vWorkGroupSize.y)
+        lvError_("workgroup size limit is too small for the current impl (curr=[%d,%d], req=[%d,%d])",anMaxWorkGroupSize[0],anMaxWorkGroupSize[1],(int)m_vWorkGroupSize.x,(int)m_vWorkGroupSize.y);
+    const size_t nCurrComputeStageInvocs = m_vWorkGroupSize.x*m_vWorkGroupSize.y;
     lvAssert_(nCurrComputeStageInvocs>0,"work group size dimensions must be non-null");
     if((size_t)lv::gl::getIntegerVal<1>(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS)<nCurrComputeStageInvocs)
         lvError_("compute invoc limit is too small for the current impl (curr=%lu, req=%lu)",(size_t)lv::gl::getIntegerVal<1>(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS),nCurrComputeStageInvocs);
@@ -75,6 +188,7 @@ GLImageProcAlgo::GLImageProcAlgo( size_t nLevels, size_t nComputeStages, size_t
         lvError("atomic bo bindings limit is too small for the current impl");
     if(m_bUsingTimers)
         glGenQueries((GLsizei)m_nGLTimers.size(),m_nGLTimers.data());
+    glGenQueries((GLsizei)m_anWorkGroupSizeTuningQueries.size(),m_anWorkGroupSizeTuningQueries.data());
     if(m_nSSBOs) {
         m_vnSSBO.resize(m_nSSBOs);
         glGenBuffers((GLsizei)m_nSSBOs,m_vnSSBO.data());
@@ -88,6 +202,7 @@ GLImageProcAlgo::GLImageProcAlgo( size_t nLevels, size_t nComputeStages, size_t
 GLImageProcAlgo::~GLImageProcAlgo() {
     if(m_bUsingTimers)
         glDeleteQueries((GLsizei)m_nGLTimers.size(),m_nGLTimers.data());
+    glDeleteQueries((GLsizei)m_anWorkGroupSizeTuningQueries.size(),m_anWorkGroupSizeTuningQueries.data());
     if(m_nACBOs)
         glDeleteBuffers((GLsizei)m_nACBOs,m_vnACBO.data());
     if(m_nSSBOs)
@@ -110,17 +225,20 @@ void GLImageProcAlgo::initialize_gl(const cv::Mat& oInitInput, const cv::Mat& oR
         m_nInputType = oInitInput.type();
     }
     m_oFrameSize = oROI.size();
+    const bool bShadersInitialized = initialize_workgroup_tuning();
     const std::array<int,3> anMaxWorkGroupCount = lv::gl::getIntegerVal<3>(GL_MAX_COMPUTE_WORK_GROUP_COUNT);
-    if(anMaxWorkGroupCount[0]<(int)ceil((float)m_oFrameSize.width/m_vDefaultWorkGroupSize.x) || anMaxWorkGroupCount[1]<(int)ceil((float)m_oFrameSize.height/m_vDefaultWorkGroupSize.y))
+    if(anMaxWorkGroupCount[0]<(int)ceil((float)m_oFrameSize.width/m_vWorkGroupSize.x) || anMaxWorkGroupCount[1]<(int)ceil((float)m_oFrameSize.height/m_vWorkGroupSize.y))
         lvError("workgroup count dispatch limit is too small for the current impl");
-    for(size_t nPBOIter=0; nPBOIter<2; ++nPBOIter) {
+    for(size_t nPBOIter=0; nPBOIter<GLUTILS_IMGPROC_PBO_RING_SIZE; ++nPBOIter) {
         if(m_bUsingOutputPBOs)
-            m_apOutputPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(cv::Mat(m_oFrameSize,m_nOutputType),GL_PIXEL_PACK_BUFFER,GL_STREAM_READ);
+            m_apOutputPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(cv::Mat(m_oFrameSize,m_nOutputType),GL_PIXEL_PACK_BUFFER,GL_STREAM_READ,GLUTILS_IMGPROC_USE_PERSISTENT_PBOS);
         if(m_bUsingDebugPBOs)
-            m_apDebugPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(cv::Mat(m_oFrameSize,m_nDebugType),GL_PIXEL_PACK_BUFFER,GL_STREAM_READ);
+            m_apDebugPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(cv::Mat(m_oFrameSize,m_nDebugType),GL_PIXEL_PACK_BUFFER,GL_STREAM_READ,GLUTILS_IMGPROC_USE_PERSISTENT_PBOS);
         if(m_bUsingInputPBOs)
-            m_apInputPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(oInitInput,GL_PIXEL_UNPACK_BUFFER,GL_STREAM_DRAW);
+            m_apInputPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(oInitInput,GL_PIXEL_UNPACK_BUFFER,GL_STREAM_DRAW,GLUTILS_IMGPROC_USE_PERSISTENT_PBOS);
     }
+    m_anOutputPBOFrameIdxs.fill(size_t(-1));
+    m_anDebugPBOFrameIdxs.fill(size_t(-1));
     if(m_bUsingTexArrays) {
         if(m_bUsingOutput) {
             m_pOutputArray = std::make_unique<GLDynamicTexture2DArray>(1,std::vector<cv::Mat>(GLUTILS_IMGPROC_DEFAULT_LAYER_COUNT,cv::Mat(m_oFrameSize,m_nOutputType)),m_bUsingIntegralFormat);
@@ -174,19 +292,16 @@ void GLImageProcAlgo::initialize_gl(const cv::Mat& oInitInput, const cv::Mat& oR
             }
         }
     }
+    if(m_bUsingInputPBOs)
+        m_apInputPBOs[m_nCurrPBO]->insertFence();
     m_pROITexture = std::make_unique<GLTexture2D>(1,oROI,m_bUsingIntegralFormat);
     m_pROITexture->bindToImage(GLImageProcAlgo::Image_ROIBinding,0,GL_READ_ONLY);
     if(!m_bUsingOutputPBOs && m_bUsingOutput)
         m_oLastOutput = cv::Mat(m_oFrameSize,m_nOutputType);
     if(!m_bUsingDebugPBOs && m_bUsingDebug)
         m_oLastDebug = cv::Mat(m_oFrameSize,m_nDebugType);
-    m_vpImgProcShaders.resize(m_nComputeStages);
-    for(size_t nCurrStageIter=0; nCurrStageIter<m_nComputeStages; ++nCurrStageIter) {
-        m_vpImgProcShaders[nCurrStageIter] = std::make_unique<GLShader>();
-        m_vpImgProcShaders[nCurrStageIter]->addSource(getComputeShaderSource(nCurrStageIter),GL_COMPUTE_SHADER);
-        if(!m_vpImgProcShaders[nCurrStageIter]->link())
-            lvError("Could not link image processing shader");
-    }
+    if(!bShadersInitialized)
+        initialize_shaders();
     m_oDisplayShader.clear();
     m_oDisplayShader.addSource(this->getVertexShaderSource(),GL_VERTEX_SHADER);
     m_oDisplayShader.addSource(this->getFragmentShaderSource(),GL_FRAGMENT_SHADER);
@@ -204,7 +319,7 @@ void GLImageProcAlgo::apply_gl(const cv::Mat& oNextInput, bool bRebindAll) {
     m_nCurrLayer = m_nNextLayer;
     ++m_nNextLayer %= GLUTILS_IMGPROC_DEFAULT_LAYER_COUNT;
     m_nCurrPBO = m_nNextPBO;
-    ++m_nNextPBO %= 2;
+    ++m_nNextPBO %= GLUTILS_IMGPROC_PBO_RING_SIZE;
     if(bRebindAll) {
         for(size_t nSSBOIter=GLImageProcAlgo::nStorageBufferDefaultBindingsCount; nSSBOIter<m_nSSBOs; ++nSSBOIter)
             glBindBufferBase(GL_SHADER_STORAGE_BUFFER,(GLuint)nSSBOIter,m_vnSSBO[nSSBOIter]);
@@ -268,6 +383,8 @@ void GLImageProcAlgo::apply_gl(const cv::Mat& oNextInput, bool bRebindAll) {
         glEndQuery(GL_TIME_ELAPSED);
         glBeginQuery(GL_TIME_ELAPSED,m_nGLTimers[GLImageProcAlgo::GLTimer_ComputeDispatch]);
     }
+    if(isTuningWorkGroupSize())
+        glQueryCounter(m_anWorkGroupSizeTuningQueries[0],GL_TIMESTAMP);
     for(size_t nCurrStageIter=0; nCurrStageIter<m_nComputeStages; ++nCurrStageIter) {
         lvAssert(m_vpImgProcShaders[nCurrStageIter]->activate());
         m_vpImgProcShaders[nCurrStageIter]->setUniform1ui(getCurrTextureLayerUniformName(),(GLuint)m_nCurrLayer);
@@ -275,6 +392,8 @@ void GLImageProcAlgo::apply_gl(const cv::Mat& oNextInput, bool bRebindAll) {
         m_vpImgProcShaders[nCurrStageIter]->setUniform1ui(getFrameIndexUniformName(),(GLuint)m_nInternalFrameIdx);
         dispatch(nCurrStageIter,*m_vpImgProcShaders[nCurrStageIter]); // add timer for stage? can reuse the same @@@@
     }
+    if(isTuningWorkGroupSize())
+        glQueryCounter(m_anWorkGroupSizeTuningQueries[1],GL_TIMESTAMP);
     if(m_bUsingTimers)
         glEndQuery(GL_TIME_ELAPSED);
     if(m_bUsingInputPBOs) {
@@ -286,6 +405,7 @@ void GLImageProcAlgo::apply_gl(const cv::Mat& oNextInput, bool bRebindAll) {
             m_vpInputArray[m_nNextLayer]->bindToSampler((GLuint)getTextureBinding(m_nNextLayer,GLImageProcAlgo::Texture_InputBinding));
             m_vpInputArray[m_nNextLayer]->updateTexture(*m_apInputPBOs[m_nNextPBO],bRebindAll);
         }
+        m_apInputPBOs[m_nNextPBO]->insertFence(); // the pbo will only be overwritten once the upload is done
     }
     if(m_bFetchingDebug) {
         m_nLastDebugInternalIdx = m_nInternalFrameIdx;
@@ -299,6 +419,8 @@ void GLImageProcAlgo::apply_gl(const cv::Mat& oNextInput, bool bRebindAll) {
                 m_vpDebugArray[m_nCurrLayer]->bindToSampler((GLuint)getTextureBinding(m_nCurrLayer,GLImageProcAlgo::Texture_DebugBinding));
                 m_vpDebugArray[m_nCurrLayer]->fetchTexture(*m_apDebugPBOs[m_nNextPBO],bRebindAll);
             }
+            m_apDebugPBOs[m_nNextPBO]->insertFence();
+            m_anDebugPBOFrameIdxs[m_nNextPBO] = m_nInternalFrameIdx;
         }
         else {
             if(m_bUsingTexArrays) {
@@ -324,6 +446,8 @@ void GLImageProcAlgo::apply_gl(const cv::Mat& oNextInput, bool bRebindAll) {
                 m_vpOutputArray[m_nCurrLayer]->bindToSampler((GLuint)getTextureBinding(m_nCurrLayer,GLImageProcAlgo::Texture_OutputBinding));
                 m_vpOutputArray[m_nCurrLayer]->fetchTexture(*m_apOutputPBOs[m_nNextPBO],bRebindAll);
             }
+            m_apOutputPBOs[m_nNextPBO]->insertFence();
+            m_anOutputPBOFrameIdxs[m_nNextPBO] = m_nInternalFrameIdx;
         }
         else {
             if(m_bUsingTexArrays) {
@@ -375,31 +499,118 @@ void GLImageProcAlgo::apply_gl(const cv::Mat& oNextInput, bool bRebindAll) {
         std::cout << " tot=" << nGLTimerValTot*1.e-6 << "ms" << std::endl;
     }
     ++m_nInternalFrameIdx;
+    if(isTuningWorkGroupSize())
+        update_workgroup_tuning();
 }
 
-size_t GLImageProcAlgo::fetchLastOutput(cv::Mat& oOutput) const {
+size_t GLImageProcAlgo::fetchLastOutput(cv::Mat& oOutput, bool bWaitForLatest) const {
     lvAssert_(m_bFetchingOutput,"algo is not configured for cpu-side output mat fetching");
     oOutput.create(m_oFrameSize,m_nOutputType);
     if(m_bUsingOutputPBOs)
-        m_apOutputPBOs[m_nNextPBO]->fetchBuffer(oOutput,true);
-    else
-        m_oLastOutput.copyTo(oOutput);
+        return fetchLatestPBO(m_apOutputPBOs,m_anOutputPBOFrameIdxs,oOutput,bWaitForLatest);
+    m_oLastOutput.copyTo(oOutput);
     return m_nLastOutputInternalIdx;
 }
 
-size_t GLImageProcAlgo::fetchLastDebug(cv::Mat& oDebug) const {
+size_t GLImageProcAlgo::fetchLastDebug(cv::Mat& oDebug, bool bWaitForLatest) const {
     lvAssert_(m_bFetchingDebug,"algo is not configured for cpu-side debug mat fetching");
     oDebug.create(m_oFrameSize,m_nDebugType);
     if(m_bUsingDebugPBOs)
-        m_apDebugPBOs[m_nNextPBO]->fetchBuffer(oDebug,true);
-    else
-        m_oLastDebug.copyTo(oDebug);
+        return fetchLatestPBO(m_apDebugPBOs,m_anDebugPBOFrameIdxs,oDebug,bWaitForLatest);
+    m_oLastDebug.copyTo(oDebug);
     return m_nLastDebugInternalIdx;
 }
 
+void GLImageProcAlgo::setWorkGroupSize(const glm::uvec2& vWorkGroupSize) {
+    lvAssert_(!isTuningWorkGroupSize(),"work group size cannot be changed while it is being auto-tuned");
+    lvAssert_(isWorkGroupSizeSupported(vWorkGroupSize,m_oFrameSize),"work group size is not supported by the current device");
+    m_vWorkGroupSize = vWorkGroupSize;
+    if(m_bGLInitialized)
+        initialize_shaders();
+}
+
+void GLImageProcAlgo::setWorkGroupSizeAutoTuning(bool bAutoTune) {
+    lvAssert_(!m_bGLInitialized,"work group size auto-tuning must be toggled before initializing the algo");
+    m_bAutoTuningWorkGroupSize = bAutoTune;
+}
+
+void GLImageProcAlgo::initialize_shaders() {
+    // shaders are only swapped in once all stages are linked, so a failed rebuild leaves the current ones untouched
+    std::vector<std::unique_ptr<GLShader>> vpImgProcShaders(m_nComputeStages);
+    for(size_t nCurrStageIter=0; nCurrStageIter<m_nComputeStages; ++nCurrStageIter) {
+        vpImgProcShaders[nCurrStageIter] = std::make_unique<GLShader>();
+        vpImgProcShaders[nCurrStageIter]->addSource(getComputeShaderSource(nCurrStageIter),GL_COMPUTE_SHADER);
+        if(!vpImgProcShaders[nCurrStageIter]->link())
+            lvError("Could not link image processing shader");
+    }
+    m_vpImgProcShaders = std::move(vpImgProcShaders);
+}
+
+bool GLImageProcAlgo::initialize_workgroup_tuning() {
+    m_nCurrWorkGroupSizeCandidate = size_t(-1);
+    if(!m_bAutoTuningWorkGroupSize)
+        return false;
+    const std::string sCacheKey = getWorkGroupSizeCacheKey(*this,m_oFrameSize);
+    glm::uvec2 vCachedWorkGroupSize;
+    if(WorkGroupSizeCache::get().get(sCacheKey,vCachedWorkGroupSize) && isWorkGroupSizeSupported(vCachedWorkGroupSize,m_oFrameSize)) {
+        // the cache key does not capture all algo params (e.g. channel count, shared mem usage), so the cached size might not build here
+        const glm::uvec2 vFallbackWorkGroupSize = (m_vWorkGroupSize!=vCachedWorkGroupSize)?m_vWorkGroupSize:GLUTILS_IMGPROC_DEFAULT_WORKGROUP;
+        m_vWorkGroupSize = vCachedWorkGroupSize;
+        try {
+            initialize_shaders();
+            return true;
+        }
+        catch(const lv::Exception&) {
+            while(glGetError()!=GL_NO_ERROR);
+            std::cerr << "Warning: could not build shaders with cached work group size [" << m_vWorkGroupSize.x << "," << m_vWorkGroupSize.y << "], retuning." << std::endl;
+            m_vWorkGroupSize = vFallbackWorkGroupSize;
+        }
+    }
+    // the current size comes first, as it is the only one that is known to build for this algo
+    m_vvWorkGroupSizeCandidates.assign(1,m_vWorkGroupSize);
+    for(const glm::uvec2& vWorkGroupSize : s_avWorkGroupSizeCandidates)
+        if(vWorkGroupSize!=m_vWorkGroupSize && isWorkGroupSizeSupported(vWorkGroupSize,m_oFrameSize))
+            m_vvWorkGroupSizeCandidates.push_back(vWorkGroupSize);
+    m_vnWorkGroupSizeCandidateTimes.assign(m_vvWorkGroupSizeCandidates.size(),0);
+    m_nCurrWorkGroupSizeCandidate = 0;
+    m_nCurrWorkGroupSizeTuningFrame = 0;
+    return false;
+}
+
+void GLImageProcAlgo::update_workgroup_tuning() {
+    lvDbgAssert(isTuningWorkGroupSize() && m_nCurrWorkGroupSizeCandidate<m_vvWorkGroupSizeCandidates.size());
+    if(m_nCurrWorkGroupSizeTuningFrame++>0) { // first frame of each candidate is a warm-up
+        // note: this stalls until the dispatches are done, but only while tuning
+        GLuint64 nDispatchStartTime=0, nDispatchEndTime=0;
+        glGetQueryObjectui64v(m_anWorkGroupSizeTuningQueries[0],GL_QUERY_RESULT,&nDispatchStartTime);
+        glGetQueryObjectui64v(m_anWorkGroupSizeTuningQueries[1],GL_QUERY_RESULT,&nDispatchEndTime);
+        m_vnWorkGroupSizeCandidateTimes[m_nCurrWorkGroupSizeCandidate] += nDispatchEndTime-nDispatchStartTime;
+    }
+    if(m_nCurrWorkGroupSizeTuningFrame<=GLUTILS_IMGPROC_WORKGROUP_TUNING_FRAMES)
+        return;
+    m_nCurrWorkGroupSizeTuningFrame = 0;
+    while(++m_nCurrWorkGroupSizeCandidate<m_vvWorkGroupSizeCandidates.size()) {
+        m_vWorkGroupSize = m_vvWorkGroupSizeCandidates[m_nCurrWorkGroupSizeCandidate];
+        try {
+            initialize_shaders();
+            return;
+        }
+        catch(const lv::Exception&) {
+            // shaders that failed to compile are destroyed w/o having been attached, which leaves detach errors behind
+            while(glGetError()!=GL_NO_ERROR);
+            std::cerr << "Warning: could not build shaders with work group size [" << m_vWorkGroupSize.x << "," << m_vWorkGroupSize.y << "], skipping it." << std::endl;
+            m_vnWorkGroupSizeCandidateTimes[m_nCurrWorkGroupSizeCandidate] = std::numeric_limits<GLuint64>::max();
+        }
+    }
+    m_nCurrWorkGroupSizeCandidate = size_t(-1);
+    m_vWorkGroupSize = m_vvWorkGroupSizeCandidates[std::min_element(m_vnWorkGroupSizeCandidateTimes.begin(),m_vnWorkGroupSizeCandidateTimes.end())-m_vnWorkGroupSizeCandidateTimes.begin()];
+    initialize_shaders();
+    WorkGroupSizeCache::get().set(getWorkGroupSizeCacheKey(*this,m_oFrameSize),m_vWorkGroupSize);
+}
+
 void GLImageProcAlgo::dispatch(size_t nStage, GLShader&) {
     lvAssert_(nStage<m_nComputeStages,"required compute stage does not exist");
-    glDispatchCompute((GLuint)ceil((float)m_oFrameSize.width/m_vDefaultWorkGroupSize.x),(GLuint)ceil((float)m_oFrameSize.height/m_vDefaultWorkGroupSize.y),1);
+    glDispatchCompute((GLuint)ceil((float)m_oFrameSize.width/m_vWorkGroupSize.x),(GLuint)ceil((float)m_oFrameSize.height/m_vWorkGroupSize.y),1);
 }
 
 const char* GLImageProcAlgo::getCurrTextureLayerUniformName() {
@@ -597,12 +808,14 @@ void GLImageProcEvaluatorAlgo::initialize_gl(const cv::Mat& oInitGT, const cv::M
     lvAssert_(oInitGT.type()==m_nGroundtruthType && oInitGT.size()==oROI.size() && oInitGT.isContinuous(),"provided init gt mat must match original type/size, and be continuous");
     m_bGLInitialized = false;
     m_oFrameSize = oROI.size();
-    for(size_t nPBOIter=0; nPBOIter<2; ++nPBOIter) {
+    const bool bShadersInitialized = initialize_workgroup_tuning();
+    for(size_t nPBOIter=0; nPBOIter<GLUTILS_IMGPROC_PBO_RING_SIZE; ++nPBOIter) {
         if(m_bUsingDebugPBOs)
-            m_apDebugPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(cv::Mat(m_oFrameSize,m_nDebugType),GL_PIXEL_PACK_BUFFER,GL_STREAM_READ);
+            m_apDebugPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(cv::Mat(m_oFrameSize,m_nDebugType),GL_PIXEL_PACK_BUFFER,GL_STREAM_READ,GLUTILS_IMGPROC_USE_PERSISTENT_PBOS);
         if(m_bUsingInputPBOs)
-            m_apInputPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(oInitGT,GL_PIXEL_UNPACK_BUFFER,GL_STREAM_DRAW);
+            m_apInputPBOs[nPBOIter] = std::make_unique<GLPixelBufferObject>(oInitGT,GL_PIXEL_UNPACK_BUFFER,GL_STREAM_DRAW,GLUTILS_IMGPROC_USE_PERSISTENT_PBOS);
     }
+    m_anDebugPBOFrameIdxs.fill(size_t(-1));
     if(m_bUsingTexArrays) {
         if(m_bUsingDebug) {
             m_pDebugArray = std::make_unique<GLDynamicTexture2DArray>(1,std::vector<cv::Mat>(GLUTILS_IMGPROC_DEFAULT_LAYER_COUNT,cv::Mat(m_oFrameSize,m_nDebugType)),m_bUsingIntegralFormat);
@@ -643,17 +856,14 @@ void GLImageProcEvaluatorAlgo::initialize_gl(const cv::Mat& oInitGT, const cv::M
             }
         }
     }
+    if(m_bUsingInputPBOs)
+        m_apInputPBOs[m_nCurrPBO]->insertFence();
     m_pROITexture = std::make_unique<GLTexture2D>(1,oROI,m_bUsingIntegralFormat);
     m_pROITexture->bindToImage(GLImageProcAlgo::Image_ROIBinding,0,GL_READ_ONLY);
     if(!m_bUsingDebugPBOs && m_bUsingDebug)
         m_oLastDebug = cv::Mat(m_oFrameSize,m_nDebugType);
-    m_vpImgProcShaders.resize(m_nComputeStages);
-    for(size_t nCurrStageIter=0; nCurrStageIter<m_nComputeStages; ++nCurrStageIter) {
-        m_vpImgProcShaders[nCurrStageIter] = std::make_unique<GLShader>();
-        m_vpImgProcShaders[nCurrStageIter]->addSource(getComputeShaderSource(nCurrStageIter),GL_COMPUTE_SHADER);
-        if(!m_vpImgProcShaders[nCurrStageIter]->link())
-            lvError("Could not link image processing shader");
-    }
+    if(!bShadersInitialized)
+        initialize_shaders();
     m_oDisplayShader.clear();
     m_oDisplayShader.addSource(this->getVertexShaderSource(),GL_VERTEX_SHADER);
     m_oDisplayShader.addSource(this->getFragmentShaderSource(),GL_FRAGMENT_SHADER);
@@ -689,7 +899,7 @@ void GLImageProcEvaluatorAlgo::apply_gl(const cv::Mat& oNextGT, bool bRebindAll)
     m_nCurrLayer = m_nNextLayer;
     ++m_nNextLayer %= GLUTILS_IMGPROC_DEFAULT_LAYER_COUNT;
     m_nCurrPBO = m_nNextPBO;
-    ++m_nNextPBO %= 2;
+    ++m_nNextPBO %= GLUTILS_IMGPROC_PBO_RING_SIZE;
     if(m_nCurrEvalBufferOffsetPtr+m_nEvalBufferFrameSize>m_nCurrEvalBufferSize) {
         glBindBuffer(GL_ATOMIC_COUNTER_BUFFER,getACBOId(GLImageProcAlgo::AtomicCounterBuffer_EvalBinding));
         glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER,0,m_nCurrEvalBufferSize,m_oEvalQueryBuffer.data+m_nCurrEvalBufferOffsetBlock);
@@ -733,6 +943,8 @@ void GLImageProcEvaluatorAlgo::apply_gl(const cv::Mat& oNextGT, bool bRebindAll)
         m_pParent->m_vpOutputArray[m_pParent->m_nCurrLayer]->bindToImage(GLImageProcAlgo::Image_OutputBinding,0,GL_READ_ONLY);
     }
     m_pROITexture->bindToImage(GLImageProcAlgo::Image_ROIBinding,0,GL_READ_ONLY);
+    if(isTuningWorkGroupSize())
+        glQueryCounter(m_anWorkGroupSizeTuningQueries[0],GL_TIMESTAMP);
     for(size_t nCurrStageIter=0; nCurrStageIter<m_nComputeStages; ++nCurrStageIter) {
         lvAssert(m_vpImgProcShaders[nCurrStageIter]->activate());
         m_vpImgProcShaders[nCurrStageIter]->setUniform1ui(getCurrTextureLayerUniformName(),(GLuint)m_nCurrLayer);
@@ -740,6 +952,8 @@ void GLImageProcEvaluatorAlgo::apply_gl(const cv::Mat& oNextGT, bool bRebindAll)
         m_vpImgProcShaders[nCurrStageIter]->setUniform1ui(getFrameIndexUniformName(),(GLuint)m_nInternalFrameIdx);
         dispatch(nCurrStageIter,*m_vpImgProcShaders[nCurrStageIter]);
     }
+    if(isTuningWorkGroupSize())
+        glQueryCounter(m_anWorkGroupSizeTuningQueries[1],GL_TIMESTAMP);
     if(m_bUsingInputPBOs) {
         if(m_bUsingTexArrays) {
             m_pInputArray->bindToSamplerArray(GLImageProcAlgo::Texture_GTBinding);
@@ -749,6 +963,7 @@ void GLImageProcEvaluatorAlgo::apply_gl(const cv::Mat& oNextGT, bool bRebindAll)
             m_vpInputArray[m_nNextLayer]->bindToSampler((GLuint)getTextureBinding(m_nNextLayer,GLImageProcAlgo::Texture_GTBinding));
             m_vpInputArray[m_nNextLayer]->updateTexture(*m_apInputPBOs[m_nNextPBO],bRebindAll);
         }
+        m_apInputPBOs[m_nNextPBO]->insertFence(); // the pbo will only be overwritten once the upload is done
     }
     if(m_bFetchingDebug) {
         m_nLastDebugInternalIdx = m_nInternalFrameIdx;
@@ -762,6 +977,8 @@ void GLImageProcEvaluatorAlgo::apply_gl(const cv::Mat& oNextGT, bool bRebindAll)
                 m_vpDebugArray[m_nCurrLayer]->bindToSampler((GLuint)getTextureBinding(m_nCurrLayer,GLImageProcAlgo::Texture_DebugBinding));
                 m_vpDebugArray[m_nCurrLayer]->fetchTexture(*m_apDebugPBOs[m_nNextPBO],bRebindAll);
             }
+            m_apDebugPBOs[m_nNextPBO]->insertFence();
+            m_anDebugPBOFrameIdxs[m_nNextPBO] = m_nInternalFrameIdx;
         }
         else {
             if(m_bUsingTexArrays) {
@@ -788,6 +1005,8 @@ void GLImageProcEvaluatorAlgo::apply_gl(const cv::Mat& oNextGT, bool bRebindAll)
     }
     m_pParent->m_pROITexture->bindToImage(GLImageProcAlgo::Image_ROIBinding,0,GL_READ_ONLY);
     ++m_nInternalFrameIdx;
+    if(isTuningWorkGroupSize())
+        update_workgroup_tuning();
 }
 
 GLImagePassThroughAlgo::GLImagePassThroughAlgo(int nFrameType, bool bUseDisplay, bool bUseTimers, bool bUseIntegralFormat) :
@@ -797,7 +1016,7 @@ GLImagePassThroughAlgo::GLImagePassThroughAlgo(int nFrameType, bool bUseDisplay,
 
 std::string GLImagePassThroughAlgo::getComputeShaderSource(size_t nStage) const {
     lvAssert_(nStage<m_nComputeStages,"required compute stage does not exist");
-    return GLShader::getComputeShaderSource_PassThrough_ImgLoadCopy(m_vDefaultWorkGroupSize,lv::gl::getInternalFormatFromMatType(m_nOutputType,m_bUsingIntegralFormat),GLImageProcAlgo::Image_InputBinding,GLImageProcAlgo::Image_OutputBinding,m_bUsingIntegralFormat);
+    return GLShader::getComputeShaderSource_PassThrough_ImgLoadCopy(m_vWorkGroupSize,lv::gl::getInternalFormatFromMatType(m_nOutputType,m_bUsingIntegralFormat),GLImageProcAlgo::Image_InputBinding,GLImageProcAlgo::Image_OutputBinding,m_bUsingIntegralFormat);
 }
 
 /* @@@@ CLEANUP REQUIRED, NEED TO RE-VALIDATE WITH NEW PROJ STRUCTURE
@@ -816,7 +1035,7 @@ BinaryMedianFilter::BinaryMedianFilter( size_t nKernelSize, size_t nBorderSize,
     lvAssert(m_nBorderSize<(m_oFrameSize.width-m_nKernelSize) && m_nBorderSize<(m_oFrameSize.height-m_nKernelSize));
     int nMaxComputeInvocs;@@@@ recheck for new workgroup sizes?
     glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS,&nMaxComputeInvocs);
-    const size_t nCurrComputeStageInvocs = m_vDefaultWorkGroupSize.x*m_vDefaultWorkGroupSize.y;
+    const size_t nCurrComputeStageInvocs = m_vWorkGroupSize.x*m_vWorkGroupSize.y;
     lvAssert(nCurrComputeStageInvocs>0 && nCurrComputeStageInvocs<nMaxComputeInvocs);
     lvAssert(m_nTransposeBlockSize*m_nTransposeBlockSize>0 && m_nTransposeBlockSize*m_nTransposeBlockSize<nMaxComputeInvocs);
     int nMaxWorkGroupCount_X, nMaxWorkGroupCount_Y;
@@ -862,7 +1081,7 @@ BinaryMedianFilter::BinaryMedianFilter( size_t nKernelSize, size_t nBorderSize,
              "#define imgHeight " << m_oFrameSize.height << "\n"
              "#define halfkernelarea " << (m_nKernelSize*m_nKernelSize)/2 << "\n";
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ssSrc << "layout(local_size_x=" << m_vDefaultWorkGroupSize.x << ",local_size_y=" << m_vDefaultWorkGroupSize.y << ") in;\n"
+    ssSrc << "layout(local_size_x=" << m_vWorkGroupSize.x << ",local_size_y=" << m_vWorkGroupSize.y << ") in;\n"
              "layout(binding=" << BinaryMedianFilter::Image_PPSAccumulator_T << ", " << acAccumInternalFormatName << ") readonly uniform uimage2D imgInput;\n"
              "layout(binding=" << GLImageProcAlgo::Image_OutputBinding << ") writeonly uniform uimage2D imgOutput;\n";
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -879,7 +1098,7 @@ BinaryMedianFilter::BinaryMedianFilter( size_t nKernelSize, size_t nBorderSize,
              "}\n";
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     m_vsComputeShaderSources.push_back(ssSrc.str());
-    m_vvComputeShaderDispatchSizes.push_back(glm::uvec3((GLuint)ceil((float)m_oFrameSize.width/m_vDefaultWorkGroupSize.x),(GLuint)ceil((float)m_oFrameSize.height/m_vDefaultWorkGroupSize.y),1));
+    m_vvComputeShaderDispatchSizes.push_back(glm::uvec3((GLuint)ceil((float)m_oFrameSize.width/m_vWorkGroupSize.x),(GLuint)ceil((float)m_oFrameSize.height/m_vWorkGroupSize.y),1));
     lvAssert((int)m_vsComputeShaderSources.size()==m_nComputeStages && (int)m_vvComputeShaderDispatchSizes.size()==m_nComputeStages);
 }
 
@@ -16,9 +16,155 @@
 // limitations under the License.
 
 #include "litiv/utils/opengl-shaders.hpp"
+#include <random>
+
+#if GLUTILS_SHADER_USE_BINARY_CACHE
+namespace {
+
+    constexpr uint32_t s_nProgramBinaryMagic = 0x4250564C; // 'LVPB'
+    constexpr uint32_t s_nProgramBinaryFileVersion = 1;
+
+    /// header written at the start of all cached program binary files
+    struct ProgramBinaryHeader {
+        uint32_t nMagic;
+        uint32_t nFileVersion;
+        uint64_t nKeyHash; ///< hash of the full key (sources+driver), double-checked on load to catch collisions/stale files
+        uint32_t nBinaryFormat;
+        uint32_t nBinaryLength;
+    };
+
+    /// 64-bit FNV-1a hash, chained via the seed parameter
+    uint64_t hashBytes(const void* pData, size_t nBytes, uint64_t nSeed=0xCBF29CE484222325ULL) {
+        const uchar* pBytes = (const uchar*)pData;
+        for(size_t nByteIdx=0; nByteIdx<nBytes; ++nByteIdx)
+            nSeed = (nSeed^pBytes[nByteIdx])*0x100000001B3ULL;
+        return nSeed;
+    }
+
+    /// returns whether the current context can save/load program binaries at all
+    bool isBinaryCacheSupported() {
+        if(GLShader::getBinaryCacheDirPath().empty() || !glProgramBinary || !glGetProgramBinary)
+            return false;
+        GLint nBinaryFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS,&nBinaryFormats);
+        return glGetError()==GL_NO_ERROR && nBinaryFormats>0;
+    }
+
+    /// returns the cache key hash for the given sources, salted w/ the driver identification strings (so that updates invalidate old binaries)
+    uint64_t getBinaryCacheKeyHash(const std::map<GLuint,std::string>& mShaderSources, uint64_t nSeed) {
+        for(GLenum eDriverString : {GL_VENDOR,GL_RENDERER,GL_VERSION,GL_SHADING_LANGUAGE_VERSION}) {
+            const char* acDriverString = (const char*)glGetString(eDriverString);
+            if(acDriverString)
+                nSeed = hashBytes(acDriverString,strlen(acDriverString)+1,nSeed);
+        }
+        for(const auto& oSrcPair : mShaderSources) {
+            GLint nShaderType = 0;
+            glGetShaderiv(oSrcPair.first,GL_SHADER_TYPE,&nShaderType);
+            nSeed = hashBytes(&nShaderType,sizeof(nShaderType),nSeed);
+            nSeed = hashBytes(oSrcPair.second.c_str(),oSrcPair.second.size()+1,nSeed);
+        }
+        return nSeed;
+    }
+
+    /// returns the cache file path for the given sources, and fills in the key hash that must be found in its header
+    std::string getBinaryCacheFilePath(const std::map<GLuint,std::string>& mShaderSources, uint64_t& nKeyHash) {
+        // the file name and the header check use two different seeds, so that a file name collision alone cannot load a bad binary
+        nKeyHash = getBinaryCacheKeyHash(mShaderSources,0x84222325CBF29CE4ULL);
+        std::stringstream ssFileName;
+        ssFileName << std::hex << std::setfill('0') << std::setw(16) << getBinaryCacheKeyHash(mShaderSources,0xCBF29CE484222325ULL) << ".bin";
+        return GLShader::getBinaryCacheDirPath()+ssFileName.str();
+    }
+
+    /// tries to load the given program from its cached binary; on any mismatch/failure, the program is left unlinked and false is returned
+    bool loadProgramBinary(GLuint nProgID, const std::string& sFilePath, uint64_t nKeyHash) {
+        std::ifstream ssFile(sFilePath,std::ios::in|std::ios::binary);
+        if(!ssFile.is_open())
+            return false;
+        ProgramBinaryHeader oHeader;
+        if(!ssFile.read((char*)&oHeader,sizeof(oHeader)) || oHeader.nMagic!=s_nProgramBinaryMagic ||
+           oHeader.nFileVersion!=s_nProgramBinaryFileVersion || oHeader.nKeyHash!=nKeyHash || oHeader.nBinaryLength==0)
+            return false;
+        std::vector<char> vcBinary(oHeader.nBinaryLength);
+        if(!ssFile.read(vcBinary.data(),(std::streamsize)vcBinary.size()))
+            return false;
+        glProgramBinary(nProgID,(GLenum)oHeader.nBinaryFormat,vcBinary.data(),(GLsizei)vcBinary.size());
+        // unsupported formats raise GL_INVALID_ENUM instead of failing the link; both are treated as cache misses
+        GLint nLinked = GL_FALSE;
+        if(glGetError()==GL_NO_ERROR)
+            glGetProgramiv(nProgID,GL_LINK_STATUS,&nLinked);
+        return nLinked==GL_TRUE;
+    }
+
+    /// saves the binary of the given (linked) program to the cache; failures are silently ignored (the program will just be recompiled next time)
+    void saveProgramBinary(GLuint nProgID, const std::string& sFilePath, uint64_t nKeyHash) {
+        GLint nBinaryLength = 0;
+        glGetProgramiv(nProgID,GL_PROGRAM_BINARY_LENGTH,&nBinaryLength);
+        if(glGetError()!=GL_NO_ERROR || nBinaryLength<=0)
+            return;
+        std::vector<char> vcBinary((size_t)nBinaryLength);
+        GLenum eBinaryFormat = 0;
+        glGetProgramBinary(nProgID,nBinaryLength,&nBinaryLength,&eBinaryFormat,vcBinary.data());
+        if(glGetError()!=GL_NO_ERROR || nBinaryLength<=0)
+            return;
+        const ProgramBinaryHeader oHeader = {s_nProgramBinaryMagic,s_nProgramBinaryFileVersion,nKeyHash,(uint32_t)eBinaryFormat,(uint32_t)nBinaryLength};
+        // write to a uniquely-named temp file first, then rename it, so that concurrent runs never read partial binaries
+        std::stringstream ssTempFilePath;
+        ssTempFilePath << sFilePath << ".tmp" << std::hex << std::random_device()();
+        {
+            std::ofstream ssFile(ssTempFilePath.str(),std::ios::out|std::ios::binary|std::ios::trunc);
+            if(!ssFile.is_open())
+                return;
+            ssFile.write((const char*)&oHeader,sizeof(oHeader));
+            ssFile.write(vcBinary.data(),(std::streamsize)nBinaryLength);
+            if(!ssFile) {
+                ssFile.close();
+                std::remove(ssTempFilePath.str().c_str());
+                return;
+            }
+        }
+        if(std::rename(ssTempFilePath.str().c_str(),sFilePath.c_str())!=0)
+            std::remove(ssTempFilePath.str().c_str());
+    }
+
+} // anonymous namespace
+#endif //GLUTILS_SHADER_USE_BINARY_CACHE
 
 GLShader* GLShader::s_pCurrActiveShader = nullptr;
 
+const std::string& GLShader::getBinaryCacheDirPath() {
+    static const std::string s_sCacheDirPath = [](){
+        std::string sDirPath;
+        const char* acOverride = std::getenv(GLUTILS_SHADER_BINARY_CACHE_ENV_VAR);
+        if(acOverride && *acOverride) {
+            std::string sOverrideLower(acOverride);
+            std::transform(sOverrideLower.begin(),sOverrideLower.end(),sOverrideLower.begin(),tolower);
+            if(sOverrideLower=="none")
+                return std::string();
+            sDirPath = lv::AddDirSlashIfMissing(acOverride);
+        }
+        else {
+            const char* acXDGCacheHome = std::getenv("XDG_CACHE_HOME");
+            const char* acHome = std::getenv("HOME");
+            if(acXDGCacheHome && *acXDGCacheHome)
+                sDirPath = lv::AddDirSlashIfMissing(acXDGCacheHome);
+            else if(acHome && *acHome)
+                sDirPath = lv::AddDirSlashIfMissing(acHome)+".cache/";
+            else
+                return std::string();
+            lv::CreateDirIfNotExist(sDirPath);
+            sDirPath += "litiv/";
+            lv::CreateDirIfNotExist(sDirPath);
+            sDirPath += "shaders/";
+        }
+        if(!lv::CreateDirIfNotExist(sDirPath)) {
+            std::cerr << "Warning: could not create program binary cache directory at '" << sDirPath << "', shaders will be recompiled on every run." << std::endl;
+            return std::string();
+        }
+        return sDirPath;
+    }();
+    return s_sCacheDirPath;
+}
+
 bool GLShader::useShaderProgram(GLShader* pNewShader) {
     if(pNewShader) {
         if(pNewShader->m_bIsActive && s_pCurrActiveShader==pNewShader)
@@ -64,6 +210,8 @@ GLShader::~GLShader() {
             removeSource(m_mShaderSources.begin()->first);
         glDeleteProgram(m_nProgID);
     }
+    if(s_pCurrActiveShader==this)
+        s_pCurrActiveShader = nullptr;
 }
 
 GLuint GLShader::addSource(const std::string& sSource, GLenum eType) {
@@ -130,10 +278,32 @@ bool GLShader::compile() {
 bool GLShader::link(bool bDiscardSources) {
     if(!m_nProgID)
         return true;
-    if(!compile() && !m_bIsEmpty)
-        return false;
     if(m_bIsLinked && m_bIsEmpty)
         return true;
+#if GLUTILS_SHADER_USE_BINARY_CACHE
+    const bool bUseBinaryCache = !m_bIsEmpty && isBinaryCacheSupported();
+    uint64_t nBinaryCacheKeyHash = 0;
+    const std::string sBinaryCacheFilePath = bUseBinaryCache?getBinaryCacheFilePath(m_mShaderSources,nBinaryCacheKeyHash):std::string();
+    if(bUseBinaryCache && loadProgramBinary(m_nProgID,sBinaryCacheFilePath,nBinaryCacheKeyHash)) {
+        // sources are still attached (but never compiled) so that removeSource can detach them as usual
+        for(auto oSrcIter=m_mShaderSources.begin(); oSrcIter!=m_mShaderSources.end(); ++oSrcIter) {
+            glAttachShader(m_nProgID,oSrcIter->first);
+            glErrorCheck;
+        }
+        m_mShaderUniformLocations.clear();
+        if(bDiscardSources) {
+            while(!m_mShaderSources.empty())
+                removeSource(m_mShaderSources.begin()->first);
+        }
+        return (m_bIsLinked=true);
+    }
+    if(bUseBinaryCache) {
+        glProgramParameteri(m_nProgID,GL_PROGRAM_BINARY_RETRIEVABLE_HINT,GL_TRUE);
+        glErrorCheck;
+    }
+#endif //GLUTILS_SHADER_USE_BINARY_CACHE
+    if(!compile() && !m_bIsEmpty)
+        return false;
     for(auto oSrcIter=m_mShaderSources.begin(); oSrcIter!=m_mShaderSources.end(); ++oSrcIter) {
         glAttachShader(m_nProgID,oSrcIter->first);
         glErrorCheck;
@@ -150,7 +320,11 @@ bool GLShader::link(bool bDiscardSources) {
         glGetProgramInfoLog(m_nProgID, nLogSize, &nLogSize, &vcLog[0]);
         lvError_("shader link error in program #%d:\n%s\n",m_nProgID,&vcLog[0]);
     }
-    else if(bDiscardSources) {
+#if GLUTILS_SHADER_USE_BINARY_CACHE
+    if(bUseBinaryCache)
+        saveProgramBinary(m_nProgID,sBinaryCacheFilePath,nBinaryCacheKeyHash);
+#endif //GLUTILS_SHADER_USE_BINARY_CACHE
+    if(bDiscardSources) {
         while(!m_mShaderSources.empty())
             removeSource(m_mShaderSources.begin()->first);
     }
@@ -17,17 +17,137 @@
 
 #include "litiv/utils/opengl.hpp"
 
-std::mutex lv::gl::Context::s_oGLFWErrorMessageMutex;
-std::string lv::gl::Context::s_sLatestGLFWErrorMessage;
+std::mutex lv::gl::Context::s_oErrorMessageMutex;
+std::string lv::gl::Context::s_sLatestErrorMessage;
 std::once_flag lv::gl::Context::s_oInitFlag;
 
+#if HAVE_EGL
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif //ndef(EGL_PLATFORM_SURFACELESS_MESA)
+#endif //HAVE_EGL
+
+namespace {
+
+    bool isEnvVarSet(const char* acName) {
+        const char* acValue = std::getenv(acName);
+        return acValue && *acValue;
+    }
+
+    lv::gl::ContextBackend resolveContextBackend(lv::gl::ContextBackend eBackend) {
+        using namespace lv::gl;
+        if(eBackend==ContextBackend_Auto && isEnvVarSet(GLUTILS_CONTEXT_BACKEND_ENV_VAR)) {
+            std::string sOverrideLower(std::getenv(GLUTILS_CONTEXT_BACKEND_ENV_VAR));
+            std::transform(sOverrideLower.begin(),sOverrideLower.end(),sOverrideLower.begin(),tolower);
+            if(sOverrideLower=="window")
+                eBackend = ContextBackend_Window;
+            else if(sOverrideLower=="headless")
+                eBackend = ContextBackend_Headless;
+            else
+                std::cerr << "Warning: unknown " GLUTILS_CONTEXT_BACKEND_ENV_VAR " value '" << sOverrideLower << "' (should be 'window' or 'headless'), using auto-selection instead." << std::endl;
+        }
+        if(eBackend==ContextBackend_Auto) {
+#if (HAVE_GLFW || HAVE_FREEGLUT) && HAVE_EGL && defined(__linux__)
+            eBackend = (isEnvVarSet("DISPLAY") || isEnvVarSet("WAYLAND_DISPLAY"))?ContextBackend_Window:ContextBackend_Headless;
+#elif (HAVE_GLFW || HAVE_FREEGLUT)
+            eBackend = ContextBackend_Window;
+#else //!(HAVE_GLFW || HAVE_FREEGLUT)
+            eBackend = ContextBackend_Headless;
+#endif //!(HAVE_GLFW || HAVE_FREEGLUT)
+        }
+        lvAssert_(eBackend!=ContextBackend_Window || (HAVE_GLFW || HAVE_FREEGLUT),"framework was built without a window manager (GLFW or FREEGLUT), only headless contexts are available");
+        lvAssert_(eBackend!=ContextBackend_Headless || HAVE_EGL,"framework was built without EGL, headless contexts are unavailable");
+        return eBackend;
+    }
+
+#if HAVE_EGL
+
+    bool hasEGLExtension(EGLDisplay pDisplay, const char* acExtName) {
+        const char* acExtList = eglQueryString(pDisplay,EGL_EXTENSIONS); // client extension query returns null if unsupported
+        if(!acExtList)
+            return false;
+        const std::string sExtList = std::string(" ")+acExtList+" ";
+        return sExtList.find(std::string(" ")+acExtName+" ")!=std::string::npos;
+    }
+
+    EGLSurface createEGLPbuffer(EGLDisplay pDisplay, EGLConfig pConfig, const cv::Size& oSize) {
+        const EGLint anPbufferAttribs[] = {
+            EGL_WIDTH,oSize.width,
+            EGL_HEIGHT,oSize.height,
+            EGL_NONE,
+        };
+        return eglCreatePbufferSurface(pDisplay,pConfig,anPbufferAttribs);
+    }
+
+#endif //HAVE_EGL
+
+} // anonymous namespace
+
 lv::gl::Context::Context(const cv::Size& oWinSize,
                          const std::string& sWinName,
                          bool bHide,
                          size_t nGLVerMajor,
-                         size_t nGLVerMinor) :
+                         size_t nGLVerMinor,
+                         ContextBackend eBackend) :
+        m_eBackend(resolveContextBackend(eBackend)),
         m_nGLVerMajor(nGLVerMajor),
         m_nGLVerMinor(nGLVerMinor) {
+#if HAVE_EGL
+    if(m_eBackend==ContextBackend_Headless) {
+        const EGLDisplay pDisplay = getEGLDisplay();
+        if(!eglBindAPI(EGL_OPENGL_API))
+            onEGLError("eglBindAPI");
+        // pbuffer configs are preferred (they provide a default framebuffer), but surfaceless-only platforms do not always expose them
+        const bool bSurfacelessSupported = hasEGLExtension(pDisplay,"EGL_KHR_surfaceless_context");
+        EGLint nConfigCount = 0;
+        for(EGLint nSurfaceType : {EGL_PBUFFER_BIT,0}) {
+            const EGLint anConfigAttribs[] = {
+                EGL_SURFACE_TYPE,nSurfaceType,
+                EGL_RENDERABLE_TYPE,EGL_OPENGL_BIT,
+                EGL_RED_SIZE,8,
+                EGL_GREEN_SIZE,8,
+                EGL_BLUE_SIZE,8,
+                EGL_ALPHA_SIZE,8,
+                EGL_DEPTH_SIZE,24,
+                EGL_NONE,
+            };
+            if(eglChooseConfig(pDisplay,anConfigAttribs,&m_pEGLConfig,1,&nConfigCount) && nConfigCount>0)
+                break;
+            if(!bSurfacelessSupported)
+                break;
+        }
+        if(nConfigCount<1)
+            onEGLError("eglChooseConfig");
+        std::vector<EGLint> vnContextAttribs = {
+            EGL_CONTEXT_MAJOR_VERSION_KHR,int(nGLVerMajor),
+            EGL_CONTEXT_MINOR_VERSION_KHR,int(nGLVerMinor),
+        };
+        if(nGLVerMajor>3 || (nGLVerMajor==3 && nGLVerMinor>=2))
+            vnContextAttribs.insert(vnContextAttribs.end(),{EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR,EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR});
+        vnContextAttribs.push_back(EGL_NONE);
+        m_pEGLContext = std::unique_ptr<void,eglContextDeleter>(eglCreateContext(pDisplay,m_pEGLConfig,EGL_NO_CONTEXT,vnContextAttribs.data()),eglContextDeleter(pDisplay));
+        if(m_pEGLContext.get()==EGL_NO_CONTEXT) {
+            m_pEGLContext.release();
+            onEGLError("eglCreateContext");
+        }
+        EGLint nSurfaceType = 0;
+        eglGetConfigAttrib(pDisplay,m_pEGLConfig,EGL_SURFACE_TYPE,&nSurfaceType);
+        if(nSurfaceType&EGL_PBUFFER_BIT) {
+            m_pEGLSurface = std::unique_ptr<void,eglSurfaceDeleter>(createEGLPbuffer(pDisplay,m_pEGLConfig,oWinSize),eglSurfaceDeleter(pDisplay));
+            if(m_pEGLSurface.get()==EGL_NO_SURFACE) {
+                m_pEGLSurface.release();
+                if(!bSurfacelessSupported)
+                    onEGLError("eglCreatePbufferSurface");
+            }
+        }
+        if(!eglMakeCurrent(pDisplay,m_pEGLSurface.get(),m_pEGLSurface.get(),m_pEGLContext.get()))
+            onEGLError("eglMakeCurrent");
+        UNUSED(sWinName);
+        UNUSED(bHide);
+        initGLEW(m_nGLVerMajor,m_nGLVerMinor);
+        return;
+    }
+#endif //HAVE_EGL
 #if HAVE_GLFW
     std::call_once(s_oInitFlag,[](){
         glfwSetErrorCallback(onGLFWErrorCallback);
@@ -64,7 +184,54 @@ lv::gl::Context::Context(const cv::Size& oWinSize,
     initGLEW(m_nGLVerMajor,m_nGLVerMinor);
 }
 
+lv::gl::Context::~Context() {
+#if HAVE_EGL
+    if(m_pEGLContext && eglGetCurrentContext()==m_pEGLContext.get())
+        eglMakeCurrent(getEGLDisplay(),EGL_NO_SURFACE,EGL_NO_SURFACE,EGL_NO_CONTEXT);
+#endif //HAVE_EGL
+}
+
+#if HAVE_EGL
+
+EGLDisplay lv::gl::Context::getEGLDisplay() {
+    static const EGLDisplay s_pDisplay = [](){
+        EGLDisplay pDisplay = EGL_NO_DISPLAY;
+        // mesa's surfaceless platform needs neither a display server nor a gpu (e.g. w/ llvmpipe); other drivers use their default display
+        if(hasEGLExtension(EGL_NO_DISPLAY,"EGL_MESA_platform_surfaceless")) {
+            const auto pfGetPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if(pfGetPlatformDisplay)
+                pDisplay = pfGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,EGL_DEFAULT_DISPLAY,nullptr);
+        }
+        if(pDisplay==EGL_NO_DISPLAY)
+            pDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if(pDisplay==EGL_NO_DISPLAY)
+            onEGLError("eglGetDisplay");
+        if(!eglInitialize(pDisplay,nullptr,nullptr))
+            onEGLError("eglInitialize");
+        std::atexit([](){eglTerminate(getEGLDisplay());});
+        return pDisplay;
+    }();
+    return s_pDisplay;
+}
+
+void lv::gl::Context::onEGLError(const char* acFuncName) {
+    const EGLint nErrorCode = eglGetError();
+    {
+        std::lock_guard<std::mutex> oLock(s_oErrorMessageMutex);
+        s_sLatestErrorMessage = cv::format("function: %s, code: 0x%04X",acFuncName,(uint)nErrorCode);
+    }
+    lvError_("EGL call '%s' failed for headless context [code=0x%04X]",acFuncName,(uint)nErrorCode);
+}
+
+#endif //HAVE_EGL
+
 void lv::gl::Context::setAsActive() {
+#if HAVE_EGL
+    if(m_eBackend==ContextBackend_Headless) {
+        eglMakeCurrent(getEGLDisplay(),m_pEGLSurface.get(),m_pEGLSurface.get(),m_pEGLContext.get());
+        return;
+    }
+#endif //HAVE_EGL
 #if HAVE_GLFW
     glfwMakeContextCurrent(m_pWindowHandle.get());
 #elif HAVE_FREEGLUT
@@ -73,6 +240,8 @@ void lv::gl::Context::setAsActive() {
 }
 
 void lv::gl::Context::setWindowVisibility(bool bVal) {
+    if(m_eBackend==ContextBackend_Headless)
+        return; // there is no window to show
 #if HAVE_GLFW
     if(bVal)
         glfwShowWindow(m_pWindowHandle.get());
@@ -84,55 +253,85 @@ void lv::gl::Context::setWindowVisibility(bool bVal) {
             glutShowWindow();
         else
             glutHideWindow();
-#endif //HAVE_FREEGLUT
+#else //!(HAVE_GLFW || HAVE_FREEGLUT)
+    UNUSED(bVal);
+#endif //!(HAVE_GLFW || HAVE_FREEGLUT)
 }
 
 void lv::gl::Context::setWindowSize(const cv::Size& oSize, bool bUpdateViewport) {
+#if HAVE_EGL
+    if(m_eBackend==ContextBackend_Headless) {
+        if(m_pEGLSurface) {
+            // pbuffers cannot be resized, so a new one replaces the old one (which is released once unbound)
+            const EGLDisplay pDisplay = getEGLDisplay();
+            std::unique_ptr<void,eglSurfaceDeleter> pNewSurface(createEGLPbuffer(pDisplay,m_pEGLConfig,oSize),eglSurfaceDeleter(pDisplay));
+            if(pNewSurface.get()==EGL_NO_SURFACE) {
+                pNewSurface.release();
+                onEGLError("eglCreatePbufferSurface");
+            }
+            if(eglGetCurrentContext()==m_pEGLContext.get() && !eglMakeCurrent(pDisplay,pNewSurface.get(),pNewSurface.get(),m_pEGLContext.get()))
+                onEGLError("eglMakeCurrent");
+            m_pEGLSurface = std::move(pNewSurface);
+        }
+    }
+    else
+#endif //HAVE_EGL
+    {
 #if HAVE_GLFW
-    glfwSetWindowSize(m_pWindowHandle.get(),oSize.width,oSize.height);
+        glfwSetWindowSize(m_pWindowHandle.get(),oSize.width,oSize.height);
 #elif HAVE_FREEGLUT
-    glutSetWindow(m_oWindowHandle.get().m_nHandle);
-        glutReshapeWindow(oSize.width,oSize.height);
+        glutSetWindow(m_oWindowHandle.get().m_nHandle);
+            glutReshapeWindow(oSize.width,oSize.height);
 #endif //HAVE_FREEGLUT
+    }
     if(bUpdateViewport)
         glViewport(0,0,oSize.width,oSize.height);
 }
 
-std::string lv::gl::Context::getLatestErrorMessage() { // also clears the latest error message
-#if HAVE_GLFW
-    std::lock_guard<std::mutex> oLock(s_oGLFWErrorMessageMutex);
+std::string lv::gl::Context::getLatestErrorMessage() { // also clears the latest error message (glut gives no custom error messages...)
+    std::lock_guard<std::mutex> oLock(s_oErrorMessageMutex);
     std::string sErrMsg;
-    std::swap(sErrMsg,s_sLatestGLFWErrorMessage);
+    std::swap(sErrMsg,s_sLatestErrorMessage);
     return sErrMsg;
-#elif HAVE_FREEGLUT
-    return std::string(); // glut gives no custom error messages...
-#endif //HAVE_FREEGLUT
 }
 
 bool lv::gl::Context::pollEventsAndCheckIfShouldClose() {
+    if(m_eBackend==ContextBackend_Headless)
+        return false; // no window events to poll, and nothing can request a close
 #if HAVE_GLFW
     glfwPollEvents();
     return glfwWindowShouldClose(m_pWindowHandle.get())!=0;
 #elif HAVE_FREEGLUT
     return glutGetWindow()!=0; // not ideal, but there is nothing else...
-#endif //HAVE_FREEGLUT
+#else //!(HAVE_GLFW || HAVE_FREEGLUT)
+    return false;
+#endif //!(HAVE_GLFW || HAVE_FREEGLUT)
 }
 
 bool lv::gl::Context::getKeyPressed(char nKeyID) {
+    if(m_eBackend==ContextBackend_Headless)
+        return false;
 #if HAVE_GLFW
     return glfwGetKey(m_pWindowHandle.get(),nKeyID)==GLFW_PRESS; // will not capture special keys (need custom define)
 #elif HAVE_FREEGLUT
     return false; // seriously, ditch glut
-#endif //HAVE_FREEGLUT
+#else //!(HAVE_GLFW || HAVE_FREEGLUT)
+    UNUSED(nKeyID);
+    return false;
+#endif //!(HAVE_GLFW || HAVE_FREEGLUT)
 }
 
 void lv::gl::Context::swapBuffers(int nClearFlags) {
+    if(m_eBackend==ContextBackend_Headless)
+        glFlush(); // pbuffer & surfaceless targets have no back buffer to present
+    else {
 #if HAVE_GLFW
-    glfwSwapBuffers(m_pWindowHandle.get());
+        glfwSwapBuffers(m_pWindowHandle.get());
 #elif HAVE_FREEGLUT
-    glutSetWindow(m_oWindowHandle.get().m_nHandle);
-        glutSwapBuffers();
+        glutSetWindow(m_oWindowHandle.get().m_nHandle);
+            glutSwapBuffers();
 #endif //HAVE_FREEGLUT
+    }
     if(nClearFlags!=0)
         glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
 }
@@ -141,7 +340,12 @@ void lv::gl::Context::initGLEW(size_t nGLVerMajor, size_t nGLVerMinor) {
     glErrorCheck;
     glewExperimental = GLEW_EXPERIMENTAL?GL_TRUE:GL_FALSE;
     const GLenum glewerrn = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // glx-based glew builds (>=2.1) cannot find a display for egl contexts, but still load all core/ext entry points
+    if(glewerrn!=GLEW_OK && glewerrn!=GLEW_ERROR_NO_GLX_DISPLAY)
+#else //ndef(GLEW_ERROR_NO_GLX_DISPLAY)
     if(glewerrn!=GLEW_OK)
+#endif //ndef(GLEW_ERROR_NO_GLX_DISPLAY)
         lvError_("Failed to init GLEW [code=%d, msg=%s]",glewerrn,glewGetErrorString(glewerrn));
     const GLenum errn = glGetError();
     // see glew init GL_INVALID_ENUM bug discussion at https://www.opengl.org/wiki/OpenGL_Loading_Library
@@ -0,0 +1,479 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/utils/parallel.hpp"
+#if HAVE_SIMD_DISPATCH && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif //HAVE_SIMD_DISPATCH && !defined(_MSC_VER)
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif //defined(__linux__)
+
+namespace {
+
+#if HAVE_SIMD_DISPATCH
+    /// fills the eax/ebx/ecx/edx registers returned by cpuid for the given leaf & subleaf
+    inline void getCPUID(uint nLeaf, uint nSubLeaf, std::array<uint,4>& anRegs) {
+#if defined(_MSC_VER)
+        int anRawRegs[4];
+        __cpuidex(anRawRegs,int(nLeaf),int(nSubLeaf));
+        for(size_t n=0; n<4; ++n)
+            anRegs[n] = uint(anRawRegs[n]);
+#else //(!defined(_MSC_VER))
+        __cpuid_count(nLeaf,nSubLeaf,anRegs[0],anRegs[1],anRegs[2],anRegs[3]);
+#endif //(!defined(_MSC_VER))
+    }
+
+    /// returns the lower half of the extended control register (i.e. the register states saved by the os)
+    inline uint64_t getXCR0() {
+#if defined(_MSC_VER)
+        return uint64_t(_xgetbv(0));
+#else //(!defined(_MSC_VER))
+        uint nLow,nHigh;
+        __asm__ __volatile__("xgetbv" : "=a"(nLow), "=d"(nHigh) : "c"(0));
+        return (uint64_t(nHigh)<<32)|nLow;
+#endif //(!defined(_MSC_VER))
+    }
+
+    /// queries cpuid (and the os-enabled register states for avx & avx512) to find the highest usable simd level
+    lv::SIMDLevel querySupportedSIMDLevel() {
+        std::array<uint,4> anRegs;
+        getCPUID(0,0,anRegs);
+        const uint nMaxLeaf = anRegs[0];
+        if(nMaxLeaf<1)
+            return lv::SIMDLevel_None;
+        getCPUID(1,0,anRegs);
+        const uint nFeatures_ECX = anRegs[2], nFeatures_EDX = anRegs[3];
+        if(!(nFeatures_EDX&(1u<<26)))
+            return lv::SIMDLevel_None;
+        const bool bHasSSE4_1 = (nFeatures_ECX&(1u<<9)) && (nFeatures_ECX&(1u<<19)) && (nFeatures_ECX&(1u<<23)); // ssse3, sse4.1, popcnt
+        if(!bHasSSE4_1)
+            return lv::SIMDLevel_SSE2;
+        const bool bOSSavesYMM = (nFeatures_ECX&(1u<<27)) && (nFeatures_ECX&(1u<<28)) && (getXCR0()&0x6)==0x6; // osxsave, avx, xmm+ymm states
+        if(!bOSSavesYMM || nMaxLeaf<7)
+            return lv::SIMDLevel_SSE4_1;
+        getCPUID(7,0,anRegs);
+        const uint nExtFeatures_EBX = anRegs[1];
+        if(!(nExtFeatures_EBX&(1u<<5)))
+            return lv::SIMDLevel_SSE4_1;
+        const bool bOSSavesZMM = (getXCR0()&0xE6)==0xE6; // xmm+ymm+opmask+zmm states
+        if(!bOSSavesZMM || !(nExtFeatures_EBX&(1u<<16)) || !(nExtFeatures_EBX&(1u<<30))) // avx512f, avx512bw
+            return lv::SIMDLevel_AVX2;
+        return lv::SIMDLevel_AVX512BW;
+    }
+#endif //HAVE_SIMD_DISPATCH
+
+} // anonymous namespace
+
+lv::SIMDLevel lv::getSupportedSIMDLevel() {
+#if HAVE_SIMD_DISPATCH
+    static const SIMDLevel s_eLevel = querySupportedSIMDLevel();
+    return s_eLevel;
+#else //(!HAVE_SIMD_DISPATCH)
+    return SIMDLevel_None;
+#endif //(!HAVE_SIMD_DISPATCH)
+}
+
+lv::SIMDLevel lv::getSIMDLevel() {
+    static const SIMDLevel s_eLevel = [](){
+        const SIMDLevel eSupportedLevel = getSupportedSIMDLevel();
+        const char* sOverride = std::getenv(PARALLELUTILS_SIMD_LEVEL_ENV_VAR);
+        if(!sOverride || !*sOverride)
+            return eSupportedLevel;
+        std::string sOverrideLower(sOverride);
+        std::transform(sOverrideLower.begin(),sOverrideLower.end(),sOverrideLower.begin(),tolower);
+        for(int nLevel=SIMDLevel_None; nLevel<nSIMDLevelsCount; ++nLevel) {
+            if(sOverrideLower==getSIMDLevelName(SIMDLevel(nLevel))) {
+                if(nLevel>eSupportedLevel)
+                    std::cerr << "Warning: " PARALLELUTILS_SIMD_LEVEL_ENV_VAR "='" << sOverride << "' is not supported on this machine, using '" << getSIMDLevelName(eSupportedLevel) << "' instead." << std::endl;
+                return std::min(SIMDLevel(nLevel),eSupportedLevel);
+            }
+        }
+        std::cerr << "Warning: unknown " PARALLELUTILS_SIMD_LEVEL_ENV_VAR " value '" << sOverride << "', using '" << getSIMDLevelName(eSupportedLevel) << "' instead." << std::endl;
+        return eSupportedLevel;
+    }();
+    return s_eLevel;
+}
+
+const char* lv::getSIMDLevelName(SIMDLevel eLevel) {
+    static const std::array<const char*,nSIMDLevelsCount> s_asNames = {"none","sse2","sse4_1","avx2","avx512bw"};
+    lvAssert_(eLevel>=SIMDLevel_None && eLevel<nSIMDLevelsCount,"unknown simd level");
+    return s_asNames[eLevel];
+}
+
+struct lv::ThreadPool::RangeJob {
+    ThreadPool* pPool;
+    const TileFunc* plTileFunc;
+    const TileFunc2D* plTileFunc2D;
+    size_t nCount,nTiles;
+    cv::Size oSize,oTileSize;
+    int nTilesPerRow;
+    std::atomic_size_t nRemainingTiles;
+    std::mutex oExceptionMutex;
+    std::exception_ptr pException;
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    std::thread::id oOwnerThreadID;
+    std::atomic_size_t nForeignHeapAllocCount; ///< heap allocations made by the tiles that ran on other threads than the owner's
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+};
+
+namespace {
+
+    /// pool owning the current thread (if it is a worker), used so nested calls push tasks to their own ring
+    thread_local lv::ThreadPool* tl_pCurrPool = nullptr;
+    /// index of the current thread in its pool's worker list (only valid if tl_pCurrPool is set)
+    thread_local size_t tl_nCurrWorkerIdx = 0;
+
+    /// pins the calling thread to the given core index (wrapped around the number of available cores)
+    void pinCurrentThread(size_t nCoreIdx) {
+        const size_t nCores = std::max(std::thread::hardware_concurrency(),1u);
+        nCoreIdx %= nCores;
+#if defined(_MSC_VER)
+        if(nCoreIdx<sizeof(DWORD_PTR)*8)
+            SetThreadAffinityMask(GetCurrentThread(),DWORD_PTR(1)<<nCoreIdx);
+#elif defined(__linux__)
+        cpu_set_t oCoreSet;
+        CPU_ZERO(&oCoreSet);
+        CPU_SET(nCoreIdx,&oCoreSet);
+        pthread_setaffinity_np(pthread_self(),sizeof(cpu_set_t),&oCoreSet);
+#else //(!defined(_MSC_VER) && !defined(__linux__))
+        // thread affinity is only a scheduling hint on other platforms; leave it to the os
+        UNUSED(nCoreIdx);
+#endif //(!defined(_MSC_VER) && !defined(__linux__))
+    }
+
+} // anonymous namespace
+
+namespace {
+
+    /// per-thread slab of fixed-size task blocks; the owner thread pops from its local free list, while other threads push the blocks they
+    /// release to a lock-free remote list that the owner takes over in one exchange once its local list runs dry (so there is no aba issue)
+    struct TaskSlab {
+        /// block header, placed right before the payload (an invalid owner means the block was allocated on the heap)
+        struct alignas(std::max_align_t) Block {
+            TaskSlab* pOwner;
+            Block* pNext;
+        };
+        static constexpr size_t s_nPayloadSize = PARALLELUTILS_TASK_SLAB_BLOCK_SIZE-sizeof(Block);
+        static_assert(PARALLELUTILS_TASK_SLAB_BLOCK_SIZE>sizeof(Block) && (PARALLELUTILS_TASK_SLAB_BLOCK_SIZE%alignof(Block))==0,"bad task slab block size");
+        TaskSlab() : pLocalFreeList(nullptr),pRemoteFreeList(nullptr),nRefCount(1) {}
+        /// pops a block from the local free list (refilled from the remote list, or grown by one chunk if both are empty)
+        Block* pop() {
+            if(!pLocalFreeList)
+                pLocalFreeList = pRemoteFreeList.exchange(nullptr,std::memory_order_acquire);
+            if(!pLocalFreeList) {
+                vaChunks.emplace_back(new char[PARALLELUTILS_TASK_SLAB_BLOCK_SIZE*PARALLELUTILS_TASK_SLAB_CHUNK_SIZE]);
+                for(size_t nBlockIdx=0; nBlockIdx<PARALLELUTILS_TASK_SLAB_CHUNK_SIZE; ++nBlockIdx) {
+                    Block* pBlock = (Block*)(vaChunks.back().get()+nBlockIdx*PARALLELUTILS_TASK_SLAB_BLOCK_SIZE);
+                    pBlock->pOwner = this;
+                    pBlock->pNext = pLocalFreeList;
+                    pLocalFreeList = pBlock;
+                }
+            }
+            Block* pBlock = pLocalFreeList;
+            pLocalFreeList = pBlock->pNext;
+            ++nRefCount;
+            return pBlock;
+        }
+        /// pushes a block back to the local (owner thread) or remote (any other thread) free list
+        void push(Block* pBlock, bool bIsOwnerThread) {
+            if(bIsOwnerThread) {
+                pBlock->pNext = pLocalFreeList;
+                pLocalFreeList = pBlock;
+            }
+            else {
+                Block* pHead = pRemoteFreeList.load(std::memory_order_relaxed);
+                do pBlock->pNext = pHead;
+                while(!pRemoteFreeList.compare_exchange_weak(pHead,pBlock,std::memory_order_release,std::memory_order_relaxed));
+            }
+            release();
+        }
+        /// drops one reference (held by each used block, plus one by the owner thread); the last one deletes the slab
+        void release() {
+            if(nRefCount.fetch_sub(1,std::memory_order_acq_rel)==1)
+                delete this;
+        }
+        std::vector<std::unique_ptr<char[]>> vaChunks; ///< only aligned on max_align_t via new[], which is all blocks need
+        Block* pLocalFreeList;
+        std::atomic<Block*> pRemoteFreeList;
+        std::atomic_size_t nRefCount;
+    };
+
+    /// task slab owned by the current thread (if it ever allocated a task block), used to route freed blocks to the local free list
+    thread_local TaskSlab* tl_pCurrTaskSlab = nullptr;
+
+    /// owner handle of the calling thread's task slab (blocks still in use when the thread exits keep their slab alive)
+    struct TaskSlabHandle {
+        TaskSlabHandle() : pSlab(new TaskSlab()) {tl_pCurrTaskSlab = pSlab;}
+        ~TaskSlabHandle() {tl_pCurrTaskSlab = nullptr; pSlab->release();}
+        TaskSlab* const pSlab;
+    };
+
+} // anonymous namespace
+
+void* lv::ThreadPool::allocTaskBlock(size_t nSize) {
+    TaskSlab::Block* pBlock;
+    if(nSize>TaskSlab::s_nPayloadSize) {
+        pBlock = (TaskSlab::Block*)::operator new(sizeof(TaskSlab::Block)+nSize);
+        pBlock->pOwner = nullptr;
+    }
+    else {
+        thread_local TaskSlabHandle tl_oTaskSlab; // only created on threads that queue tasks
+        pBlock = tl_oTaskSlab.pSlab->pop();
+    }
+    return pBlock+1;
+}
+
+void lv::ThreadPool::freeTaskBlock(void* pData) {
+    TaskSlab::Block* pBlock = ((TaskSlab::Block*)pData)-1;
+    if(!pBlock->pOwner)
+        ::operator delete(pBlock);
+    else
+        pBlock->pOwner->push(pBlock,pBlock->pOwner==tl_pCurrTaskSlab);
+}
+
+lv::ThreadPool::ThreadPool(size_t nWorkers, bool bPinWorkers) :
+        m_nQueuedTasks(0),
+        m_nNextWorkerIdx(0),
+        m_bIsActive(true) {
+    // all rings must exist before any worker starts stealing
+    for(size_t nWorkerIdx=0; nWorkerIdx<nWorkers; ++nWorkerIdx) {
+        m_vpWorkers.push_back(std::make_unique<Worker>());
+        m_vpWorkers.back()->nFirstTaskIdx = m_vpWorkers.back()->nTaskCount = 0;
+    }
+    for(size_t nWorkerIdx=0; nWorkerIdx<nWorkers; ++nWorkerIdx)
+        m_vpWorkers[nWorkerIdx]->hThread = std::thread(&ThreadPool::entry,this,nWorkerIdx,bPinWorkers);
+}
+
+lv::ThreadPool::~ThreadPool() {
+    {
+        std::mutex_lock_guard oLock(m_oSleepMutex);
+        m_bIsActive = false;
+    }
+    m_oSleepCondVar.notify_all();
+    for(auto& pWorker : m_vpWorkers)
+        pWorker->hThread.join();
+}
+
+lv::ThreadPool& lv::ThreadPool::get() {
+    static ThreadPool s_oPool(std::max(std::thread::hardware_concurrency(),1u)-1);
+    return s_oPool;
+}
+
+size_t lv::ThreadPool::getTileCount(size_t nCount, size_t nMinTileSize) const {
+    if(nCount==0)
+        return 0;
+    const size_t nMaxTileCount = std::max(nCount/std::max(nMinTileSize,size_t(1)),size_t(1));
+    return std::min(getThreadCount()*PARALLELUTILS_TILES_PER_THREAD,nMaxTileCount);
+}
+
+void lv::ThreadPool::parallel_for(size_t nCount, size_t nMinTileSize, TileFunc lTileFunc) {
+    const size_t nTiles = getTileCount(nCount,nMinTileSize);
+    if(nTiles<=1 || m_vpWorkers.empty()) {
+        // no need to involve the workers; keeps tile indices consistent with getTileCount
+        for(size_t nTileIdx=0; nTileIdx<nTiles; ++nTileIdx)
+            lTileFunc(nTileIdx,(nCount*nTileIdx)/nTiles,(nCount*(nTileIdx+1))/nTiles);
+        return;
+    }
+    RangeJob oJob;
+    oJob.plTileFunc = &lTileFunc;
+    oJob.plTileFunc2D = nullptr;
+    oJob.nCount = nCount;
+    oJob.nTiles = nTiles;
+    processRangeJob(oJob);
+}
+
+void lv::ThreadPool::parallel_for(const cv::Size& oSize, const cv::Size& oTileSize, TileFunc2D lTileFunc) {
+    lvAssert_(oTileSize.width>0 && oTileSize.height>0,"tile size must be strictly positive");
+    if(oSize.area()<=0)
+        return;
+    const int nTilesPerRow = (oSize.width+oTileSize.width-1)/oTileSize.width;
+    const int nTilesPerCol = (oSize.height+oTileSize.height-1)/oTileSize.height;
+    const size_t nTiles = size_t(nTilesPerRow)*size_t(nTilesPerCol);
+    if(nTiles==1 || m_vpWorkers.empty()) {
+        for(size_t nTileIdx=0; nTileIdx<nTiles; ++nTileIdx) {
+            const cv::Point oTileOrigin(int(nTileIdx%nTilesPerRow)*oTileSize.width,int(nTileIdx/nTilesPerRow)*oTileSize.height);
+            lTileFunc(nTileIdx,cv::Rect(oTileOrigin,oTileSize)&cv::Rect(cv::Point(),oSize));
+        }
+        return;
+    }
+    RangeJob oJob;
+    oJob.plTileFunc = nullptr;
+    oJob.plTileFunc2D = &lTileFunc;
+    oJob.nTiles = nTiles;
+    oJob.oSize = oSize;
+    oJob.oTileSize = oTileSize;
+    oJob.nTilesPerRow = nTilesPerRow;
+    processRangeJob(oJob);
+}
+
+void lv::ThreadPool::runRangeTile(void* pJob, size_t nTileIdx) {
+    RangeJob& oJob = *(RangeJob*)pJob;
+    ThreadPool& oPool = *oJob.pPool;
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    const size_t nInitHeapAllocCount = lv::GetHeapAllocCount();
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    try {
+        if(oJob.plTileFunc)
+            (*oJob.plTileFunc)(nTileIdx,(oJob.nCount*nTileIdx)/oJob.nTiles,(oJob.nCount*(nTileIdx+1))/oJob.nTiles);
+        else {
+            const cv::Point oTileOrigin(int(nTileIdx%oJob.nTilesPerRow)*oJob.oTileSize.width,int(nTileIdx/oJob.nTilesPerRow)*oJob.oTileSize.height);
+            (*oJob.plTileFunc2D)(nTileIdx,cv::Rect(oTileOrigin,oJob.oTileSize)&cv::Rect(cv::Point(),oJob.oSize));
+        }
+    }
+    catch(...) {
+        std::mutex_lock_guard oLock(oJob.oExceptionMutex);
+        if(!oJob.pException)
+            oJob.pException = std::current_exception();
+    }
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    if(std::this_thread::get_id()!=oJob.oOwnerThreadID)
+        oJob.nForeignHeapAllocCount += lv::GetHeapAllocCount()-nInitHeapAllocCount;
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    // the job may be released by its owner as soon as the last tile is accounted for, so it cannot be touched past this point
+    if(oJob.nRemainingTiles.fetch_sub(1)==1) {
+        {
+            std::mutex_lock_guard oLock(oPool.m_oDoneMutex);
+        }
+        oPool.m_oDoneCondVar.notify_all();
+    }
+}
+
+void lv::ThreadPool::processRangeJob(RangeJob& oJob) {
+    lvDbgAssert(oJob.nTiles>1);
+    oJob.pPool = this;
+    oJob.nRemainingTiles = oJob.nTiles;
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    oJob.oOwnerThreadID = std::this_thread::get_id();
+    oJob.nForeignHeapAllocCount = 0;
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    pushTasks(&ThreadPool::runRangeTile,&oJob,1,oJob.nTiles-1);
+    runRangeTile(&oJob,0);
+    // the calling thread only helps with the pending tiles of its own job; any other task it would pick up could outlast this job by far, and
+    // nested calls cannot deadlock either way, as each waiting thread can always run the queued tiles it waits on by itself
+    Task oTask;
+    while(oJob.nRemainingTiles.load()>0 && popJobTask(&oJob,oTask))
+        oTask.pfEntry(oTask.pData,oTask.nArg);
+    if(oJob.nRemainingTiles.load()>0) {
+        std::mutex_unique_lock oLock(m_oDoneMutex);
+        m_oDoneCondVar.wait(oLock,[&](){return oJob.nRemainingTiles.load()==0;});
+    }
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    // allocations made by the workers on this job's behalf are accounted to the calling thread, so per-call checks stay meaningful
+    lv::AddToHeapAllocCount(oJob.nForeignHeapAllocCount.load());
+#endif //PLATFORMUTILS_COUNT_HEAP_ALLOCS
+    if(oJob.pException)
+        std::rethrow_exception(oJob.pException);
+}
+
+void lv::ThreadPool::pushTasks(void (*pfEntry)(void*,size_t), void* pData, size_t nFirstArg, size_t nTasks) {
+    const size_t nWorkers = m_vpWorkers.size();
+    size_t nNextArg = nFirstArg;
+    const size_t nEndArg = nFirstArg+nTasks;
+    if(nWorkers>0 && nTasks>0) {
+        // nested calls from a worker keep their tasks local (idle workers will steal the oldest ones), while external calls hand out contiguous
+        // task chunks to the workers in round-robin order; tasks that do not fit in a full ring spill over to the next ones
+        const bool bIsNested = (tl_pCurrPool==this);
+        const size_t nFirstWorkerIdx = bIsNested?tl_nCurrWorkerIdx:m_nNextWorkerIdx.fetch_add(std::min(nTasks,nWorkers));
+        for(size_t nOffset=0; nOffset<nWorkers && nNextArg<nEndArg; ++nOffset) {
+            Worker& oWorker = *m_vpWorkers[(nFirstWorkerIdx+nOffset)%nWorkers];
+            const size_t nRemainingWorkers = bIsNested?1:std::min(nWorkers-nOffset,nEndArg-nNextArg);
+            const size_t nChunkSize = (nEndArg-nNextArg+nRemainingWorkers-1)/nRemainingWorkers;
+            std::mutex_lock_guard oLock(oWorker.oMutex);
+            const size_t nPushedTasks = std::min(nChunkSize,oWorker.aTasks.size()-oWorker.nTaskCount);
+            for(size_t nTaskIdx=0; nTaskIdx<nPushedTasks; ++nTaskIdx)
+                oWorker.aTasks[(oWorker.nFirstTaskIdx+oWorker.nTaskCount++)%oWorker.aTasks.size()] = Task{pfEntry,pData,nNextArg++};
+        }
+        if(nNextArg>nFirstArg) {
+            {
+                std::mutex_lock_guard oLock(m_oSleepMutex);
+                m_nQueuedTasks += ptrdiff_t(nNextArg-nFirstArg);
+            }
+            m_oSleepCondVar.notify_all();
+        }
+    }
+    // tasks that could not be queued (no workers, or all rings full) run right away on the calling thread
+    while(nNextArg<nEndArg)
+        pfEntry(pData,nNextArg++);
+}
+
+bool lv::ThreadPool::popTask(size_t nWorkerIdx, Task& oTask) {
+    const size_t nWorkers = m_vpWorkers.size();
+    if(nWorkerIdx<nWorkers) {
+        // own ring first, newest task first (its data is most likely still in cache)
+        Worker& oWorker = *m_vpWorkers[nWorkerIdx];
+        std::mutex_lock_guard oLock(oWorker.oMutex);
+        if(oWorker.nTaskCount>0) {
+            oTask = oWorker.aTasks[(oWorker.nFirstTaskIdx+--oWorker.nTaskCount)%oWorker.aTasks.size()];
+            --m_nQueuedTasks;
+            return true;
+        }
+    }
+    for(size_t nOffset=1; nOffset<=nWorkers; ++nOffset) {
+        Worker& oVictim = *m_vpWorkers[(nWorkerIdx+nOffset)%nWorkers];
+        std::mutex_lock_guard oLock(oVictim.oMutex);
+        if(oVictim.nTaskCount>0) {
+            oTask = oVictim.aTasks[oVictim.nFirstTaskIdx];
+            oVictim.nFirstTaskIdx = (oVictim.nFirstTaskIdx+1)%oVictim.aTasks.size();
+            --oVictim.nTaskCount;
+            --m_nQueuedTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool lv::ThreadPool::popJobTask(const void* pData, Task& oTask) {
+    const size_t nWorkers = m_vpWorkers.size();
+    const size_t nFirstWorkerIdx = (tl_pCurrPool==this)?tl_nCurrWorkerIdx:0;
+    for(size_t nOffset=0; nOffset<nWorkers; ++nOffset) {
+        Worker& oWorker = *m_vpWorkers[(nFirstWorkerIdx+nOffset)%nWorkers];
+        std::mutex_lock_guard oLock(oWorker.oMutex);
+        // newest tasks first, as nested jobs push theirs last; later tasks are shifted down to fill the gap
+        for(size_t nTaskOffset=oWorker.nTaskCount; nTaskOffset>0; --nTaskOffset) {
+            const size_t nTaskIdx = (oWorker.nFirstTaskIdx+nTaskOffset-1)%oWorker.aTasks.size();
+            if(oWorker.aTasks[nTaskIdx].pData==pData) {
+                oTask = oWorker.aTasks[nTaskIdx];
+                for(size_t nNextTaskOffset=nTaskOffset; nNextTaskOffset<oWorker.nTaskCount; ++nNextTaskOffset)
+                    oWorker.aTasks[(oWorker.nFirstTaskIdx+nNextTaskOffset-1)%oWorker.aTasks.size()] = oWorker.aTasks[(oWorker.nFirstTaskIdx+nNextTaskOffset)%oWorker.aTasks.size()];
+                --oWorker.nTaskCount;
+                --m_nQueuedTasks;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void lv::ThreadPool::entry(size_t nWorkerIdx, bool bPinWorker) {
+    tl_pCurrPool = this;
+    tl_nCurrWorkerIdx = nWorkerIdx;
+    if(bPinWorker)
+        pinCurrentThread(nWorkerIdx+1); // core #0 is left to the main thread
+    Task oTask;
+    while(true) {
+        if(popTask(nWorkerIdx,oTask)) {
+            oTask.pfEntry(oTask.pData,oTask.nArg);
+            continue;
+        }
+        std::mutex_unique_lock oLock(m_oSleepMutex);
+        if(!m_bIsActive && m_nQueuedTasks.load()<=0)
+            break;
+        m_oSleepCondVar.wait(oLock,[&](){return m_nQueuedTasks.load()>0 || !m_bIsActive;});
+    }
+}
@@ -176,6 +176,21 @@ bool lv::CreateDirIfNotExist(const std::string& sDirPath) {
 #endif //(!defined(_MSC_VER))
 }
 
+bool lv::GetFileInfo(const std::string& sFilePath, size_t& nFileSize, int64_t& nLastWriteTime) {
+#if defined(_MSC_VER)
+    struct _stat64 st;
+    if(_stat64(sFilePath.c_str(),&st)!=0)
+        return false;
+#else //(!defined(_MSC_VER))
+    struct stat st;
+    if(stat(sFilePath.c_str(),&st)!=0)
+        return false;
+#endif //(!defined(_MSC_VER))
+    nFileSize = size_t(st.st_size);
+    nLastWriteTime = int64_t(st.st_mtime);
+    return true;
+}
+
 std::fstream lv::CreateBinFileWithPrealloc(const std::string & sFilePath, size_t nPreallocBytes, bool bZeroInit) {
     std::fstream ssFile(sFilePath,std::ios::out|std::ios::in|std::ios::ate|std::ios::binary);
     if(!ssFile.is_open())
@@ -225,3 +240,133 @@ size_t lv::GetCurrentPhysMemBytesUsed() {
     return size_t(nMemUsed*sysconf(_SC_PAGESIZE));
 #endif //ndef(_MSC_VER)
 }
+
+#if PLATFORMUTILS_COUNT_HEAP_ALLOCS
+
+namespace {
+
+    /// number of global operator new calls made by the current thread (plus those added via lv::AddToHeapAllocCount)
+    thread_local size_t tl_nHeapAllocCount = 0;
+
+} // anonymous namespace
+
+// note: with msvc, this replacement only covers the module it is linked in (e.g. not allocations made inside opencv dlls)
+void* operator new(size_t nBytes) {
+    ++tl_nHeapAllocCount;
+    void* pData = std::malloc(nBytes?nBytes:1);
+    if(!pData)
+        throw std::bad_alloc();
+    return pData;
+}
+
+void operator delete(void* pData) noexcept {
+    std::free(pData);
+}
+
+void operator delete(void* pData, size_t) noexcept {
+    std::free(pData);
+}
+
+size_t lv::GetHeapAllocCount() {
+    return tl_nHeapAllocCount;
+}
+
+void lv::AddToHeapAllocCount(size_t nAllocCount) {
+    tl_nHeapAllocCount += nAllocCount;
+}
+
+#else //(!PLATFORMUTILS_COUNT_HEAP_ALLOCS)
+
+size_t lv::GetHeapAllocCount() {
+    return size_t(0);
+}
+
+void lv::AddToHeapAllocCount(size_t) {}
+
+#endif //(!PLATFORMUTILS_COUNT_HEAP_ALLOCS)
+
+lv::FrameArena& lv::FrameArena::getThreadLocal() {
+    thread_local FrameArena s_oArena;
+    return s_oArena;
+}
+
+lv::FrameArena::Scope::Scope(FrameArena& oArena) :
+        m_oArena(oArena),
+        m_nBlockIdx(oArena.m_nCurrBlockIdx),
+        m_nBlockOffset(oArena.m_nCurrBlockOffset) {
+    ++m_oArena.m_nScopeDepth;
+}
+
+lv::FrameArena::Scope::~Scope() {
+    lvDbgAssert(m_oArena.m_nScopeDepth>0);
+    if(--m_oArena.m_nScopeDepth==0)
+        m_oArena.reset();
+    else {
+        m_oArena.m_nCurrBlockIdx = m_nBlockIdx;
+        m_oArena.m_nCurrBlockOffset = m_nBlockOffset;
+    }
+}
+
+lv::FrameArena::FrameArena(size_t nInitBytes) :
+        m_nCurrBlockIdx(0),
+        m_nCurrBlockOffset(0),
+        m_nScopeDepth(0),
+        m_nHeapAllocCount(0) {
+    if(nInitBytes>0) {
+        addBlock(nInitBytes);
+        m_nCurrBlockIdx = 0;
+    }
+}
+
+void* lv::FrameArena::allocate(size_t nBytes, size_t nByteAlign) {
+    lvDbgAssert(nByteAlign>0 && (nByteAlign&(nByteAlign-1))==0);
+    if(nBytes==0)
+        nBytes = 1; // keeps returned pointers distinct
+    while(m_nCurrBlockIdx<m_vvuBlocks.size()) {
+        auto& vuCurrBlock = m_vvuBlocks[m_nCurrBlockIdx];
+        const uintptr_t nCurrAddr = uintptr_t(vuCurrBlock.data())+m_nCurrBlockOffset;
+        const size_t nPadding = size_t((nByteAlign-(nCurrAddr&(nByteAlign-1)))&(nByteAlign-1));
+        if(m_nCurrBlockOffset+nPadding+nBytes<=vuCurrBlock.size()) {
+            m_nCurrBlockOffset += nPadding+nBytes;
+            return (void*)(nCurrAddr+nPadding);
+        }
+        // the tail of this block is skipped until the next rewind
+        ++m_nCurrBlockIdx;
+        m_nCurrBlockOffset = 0;
+    }
+    addBlock(nBytes+nByteAlign);
+    return allocate(nBytes,nByteAlign);
+}
+
+void lv::FrameArena::reset() {
+    lvDbgAssert_(m_nScopeDepth==0,"cannot fully reset a frame arena while one of its scopes is alive");
+    if(m_vvuBlocks.size()>1) {
+        const size_t nTotBytes = getCapacity();
+        m_vvuBlocks.clear();
+        addBlock(nTotBytes);
+    }
+    m_nCurrBlockIdx = 0;
+    m_nCurrBlockOffset = 0;
+}
+
+size_t lv::FrameArena::getUsedBytes() const {
+    size_t nUsedBytes = 0;
+    for(size_t nBlockIdx=0; nBlockIdx<m_nCurrBlockIdx && nBlockIdx<m_vvuBlocks.size(); ++nBlockIdx)
+        nUsedBytes += m_vvuBlocks[nBlockIdx].size();
+    return nUsedBytes+m_nCurrBlockOffset;
+}
+
+size_t lv::FrameArena::getCapacity() const {
+    size_t nTotBytes = 0;
+    for(const auto& vuBlock : m_vvuBlocks)
+        nTotBytes += vuBlock.size();
+    return nTotBytes;
+}
+
+void lv::FrameArena::addBlock(size_t nMinBytes) {
+    const size_t nLastBlockSize = m_vvuBlocks.empty()?size_t(0):m_vvuBlocks.back().size();
+    m_vvuBlocks.emplace_back(std::max(std::max(nMinBytes,nLastBlockSize*2),PLATFORMUTILS_FRAMEARENA_MIN_BLOCK_SIZE));
+    m_nCurrBlockIdx = m_vvuBlocks.size()-1;
+    m_nCurrBlockOffset = 0;
+    ++m_nHeapAllocCount;
+}
@@ -86,6 +86,8 @@ protected:
     cv::Mat m_oLastFGMask;
     /// copy of latest pixel intensities (used when refreshing model)
     cv::Mat m_oLastColorFrame;
+    /// scratch memory for the temporaries of (non-const) processing calls; const getters use lv::FrameArena::getThreadLocal instead, as they may run concurrently
+    lv::FrameArena m_oFrameArena;
 
 private:
     IIBackgroundSubtractor& operator=(const IIBackgroundSubtractor&) = delete;
@@ -135,6 +137,16 @@ using IBackgroundSubtractor_GLSL = IBackgroundSubtractor_<lv::GLSL>;
 // IBackgroundSubtractor_<lv::OpenCL> will not compile here, missing impl
 #endif //HAVE_OPENCL
 
+template<>
+struct IBackgroundSubtractor_<lv::CPUThreaded> :
+        public lv::IParallelAlgo_CPUThreaded,
+        public IIBackgroundSubtractor {
+    /// required for derived class destruction from this interface
+    virtual ~IBackgroundSubtractor_() {}
+};
+
+using IBackgroundSubtractor_CPUThreaded = IBackgroundSubtractor_<lv::CPUThreaded>;
+
 template<>
 struct IBackgroundSubtractor_<lv::NonParallel> :
         public lv::NonParallelAlgo,
@@ -42,12 +42,12 @@ struct IBackgroundSubtractorLBSP_ : public IBackgroundSubtractor_<eImpl> {
     virtual void getBackgroundDescriptorsImage(cv::OutputArray oBGDescImg) const = 0;
 
 protected:
-    /// default impl constructor (defined here as MSVC is very prude with template-class-template-cstor-definitions)
+    /// default (cpu) impl constructor (defined here as MSVC is very prude with template-class-template-cstor-definitions)
     template<lv::ParallelAlgoType eImplTemp = eImpl>
     IBackgroundSubtractorLBSP_(float fRelLBSPThreshold=BGSLBSP_DEFAULT_LBSP_REL_SIMILARITY_THRESHOLD,
                                size_t nLBSPThresholdOffset=BGSLBSP_DEFAULT_LBSP_OFFSET_SIMILARITY_THRESHOLD,
                                int nDefaultMedianBlurKernelSize=BGSLBSP_DEFAULT_MEDIAN_BLUR_KERNEL_SIZE,
-                               std::enable_if_t<eImplTemp==lv::NonParallel>* /*pUnused*/=0) :
+                               std::enable_if_t<eImplTemp==lv::NonParallel || eImplTemp==lv::CPUThreaded>* /*pUnused*/=0) :
             m_nLBSPThresholdOffset(nLBSPThresholdOffset),
             m_fRelLBSPThreshold(fRelLBSPThreshold),
             m_nDefaultMedianBlurKernelSize(nDefaultMedianBlurKernelSize) {
@@ -109,4 +109,5 @@ using IBackgroundSubtractorLBSP_GLSL = IBackgroundSubtractorLBSP_<lv::GLSL>;
 #if HAVE_OPENCL
 //using IBackgroundSubtractorLBSP_OpenCL = IBackgroundSubtractorLBSP_<lv::OpenCL>;
 #endif //HAVE_OPENCL
+using IBackgroundSubtractorLBSP_CPUThreaded = IBackgroundSubtractorLBSP_<lv::CPUThreaded>;
 using IBackgroundSubtractorLBSP = IBackgroundSubtractorLBSP_<lv::NonParallel>;
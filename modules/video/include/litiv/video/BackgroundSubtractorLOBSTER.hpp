@@ -70,6 +70,9 @@ protected:
 using IBackgroundSubtractorLOBSTER = IBackgroundSubtractorLOBSTER_<lv::NonParallel>;
 template<>
 IBackgroundSubtractorLOBSTER::IBackgroundSubtractorLOBSTER_(size_t nDescDistThreshold, size_t nColorDistThreshold, size_t nBGSamples, size_t nRequiredBGSamples, size_t nLBSPThresholdOffset, float fRelLBSPThreshold);
+using IBackgroundSubtractorLOBSTER_CPUThreaded = IBackgroundSubtractorLOBSTER_<lv::CPUThreaded>;
+template<>
+IBackgroundSubtractorLOBSTER_CPUThreaded::IBackgroundSubtractorLOBSTER_(size_t nDescDistThreshold, size_t nColorDistThreshold, size_t nBGSamples, size_t nRequiredBGSamples, size_t nLBSPThresholdOffset, float fRelLBSPThreshold);
 #if HAVE_GLSL
 using IBackgroundSubtractorLOBSTER_GLSL = IBackgroundSubtractorLOBSTER_<lv::GLSL>;
 template<>
@@ -130,11 +133,13 @@ using BackgroundSubtractorLOBSTER_GLSL = BackgroundSubtractorLOBSTER_<lv::GLSL>;
 // BackgroundSubtractorLOBSTER_<lv::OpenCL> will not compile here, missing impl
 #endif //HAVE_OPENCL
 
-template<>
-struct BackgroundSubtractorLOBSTER_<lv::NonParallel> : public IBackgroundSubtractorLOBSTER {
+/// default (cpu) impl, shared by lv::NonParallel and lv::CPUThreaded (the latter splits the pixel loop into scheduler tiles)
+template<lv::ParallelAlgoType eImpl>
+struct BackgroundSubtractorLOBSTER_ : public IBackgroundSubtractorLOBSTER_<eImpl> {
+    static_assert(eImpl==lv::NonParallel || eImpl==lv::CPUThreaded,"missing LOBSTER impl for this parallel algo type");
 public:
     /// full constructor
-    using IBackgroundSubtractorLOBSTER::IBackgroundSubtractorLOBSTER;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::IBackgroundSubtractorLOBSTER_;
     /// refreshes all samples based on the last analyzed frame
     void refreshModel(float fSamplesRefreshFrac, bool bForceFGUpdate=false);
     /// (re)initiaization method; needs to be called before starting background subtraction
@@ -151,6 +156,37 @@ protected:
     std::vector<cv::Mat> m_voBGColorSamples;
     /// background model descriptors samples
     std::vector<cv::Mat> m_voBGDescSamples;
+    /// model update of a neighbor pixel lying outside the span of the tile that drew it (deferred until all tiles are joined)
+    struct NeighborUpdate {
+        size_t nPxIter; ///< image index of the neighbor pixel
+        size_t nSampleIdx; ///< index of the neighbor's model sample to overwrite
+        std::array<ushort,3> anDesc; ///< descriptor(s) written in the sample
+        std::array<uchar,3> anColor; ///< color(s) written in the sample
+    };
+    /// per-tile deferred neighbor updates of the current frame (cleared, but never released, between frames)
+    std::vector<std::vector<NeighborUpdate>> m_vvoTileNeighborUpdates;
+
+    /// members inherited from the (dependent) base interfaces, used unqualified by the impl
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_anLBSPThreshold_8bitLUT;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_bInitialized;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_bModelInitialized;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nBGSamples;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nColorDistThreshold;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nDefaultMedianBlurKernelSize;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nDescDistThreshold;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nFrameIdx;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nImgChannels;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nImgType;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nRequiredBGSamples;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nTotPxCount;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_nTotRelevantPxCount;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_oImgSize;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_oLastColorFrame;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_oLastDescFrame;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_oLastFGMask;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_vnPxIdxLUT;
+    using IBackgroundSubtractorLOBSTER_<eImpl>::m_voPxInfoLUT;
 };
 
+using BackgroundSubtractorLOBSTER_CPUThreaded = BackgroundSubtractorLOBSTER_<lv::CPUThreaded>;
 using BackgroundSubtractorLOBSTER = BackgroundSubtractorLOBSTER_<lv::NonParallel>;
@@ -36,17 +36,16 @@
     Note: both grayscale and RGB/BGR images may be used with this extractor (parameters are adjusted automatically).
     For optimal grayscale results, use CV_8UC1 frames instead of CV_8UC3.
 
-    For now, only the algorithm's default CPU implementation is offered here.
+    For now, only CPU implementations are offered here; lv::NonParallel runs on the calling thread, and lv::CPUThreaded
+    splits the per-pixel model update into tiles processed by the shared lv::ThreadPool.
 
     For more details on the different parameters or on the algorithm itself, see P.-L. St-Charles et al.,
     "Flexible Background Subtraction With Self-Balanced Local Sensitivity", in CVPRW 2014, or "SuBSENSE: A Universal
     Change Detection Method With Local Adaptive Sensitivity", in IEEE Trans. Image Processing vol.24 no.1, 2015.
  */
 template<lv::ParallelAlgoType eImpl>
-struct BackgroundSubtractorSuBSENSE_;
-
-template<>
-struct BackgroundSubtractorSuBSENSE_<lv::NonParallel> : public IBackgroundSubtractorLBSP {
+struct BackgroundSubtractorSuBSENSE_ : public IBackgroundSubtractorLBSP_<eImpl> {
+    static_assert(eImpl==lv::NonParallel || eImpl==lv::CPUThreaded,"SuBSENSE only offers cpu-based impls");
 public:
     /// full constructor
     BackgroundSubtractorSuBSENSE_(size_t nDescDistThresholdOffset=BGSSUBSENSE_DEFAULT_DESC_DIST_THRESHOLD_OFFSET,
@@ -130,6 +129,44 @@ protected:
     cv::Mat m_oCurrRawFGBlinkMask;
     cv::Mat m_oLastRawFGBlinkMask;
     cv::Mat m_oMorphExStructElement;
+
+    /// model update of a neighbor pixel lying outside the span of the tile that drew it (deferred until all tiles are joined)
+    struct NeighborUpdate {
+        size_t nPxIter; ///< image index of the neighbor pixel
+        size_t nSampleIdx; ///< index of the neighbor's model sample to overwrite
+        bool bForced; ///< whether the update happens regardless of the neighbor's ghost detection state
+        std::array<ushort,3> anDesc; ///< descriptor(s) written in the sample
+        std::array<uchar,3> anColor; ///< color(s) written in the sample
+    };
+    /// per-tile non-zero descriptor counts of the current frame (kept here to avoid reallocating them every frame)
+    std::vector<size_t> m_vnTileNonZeroDescCounts;
+    /// per-tile deferred neighbor updates of the current frame (cleared, but never released, between frames)
+    std::vector<std::vector<NeighborUpdate>> m_vvoTileNeighborUpdates;
+
+    /// members inherited from the (dependent) base interfaces, used unqualified by the impl
+    using IBackgroundSubtractorLBSP_<eImpl>::m_anLBSPThreshold_8bitLUT;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_bAutoModelResetEnabled;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_bInitialized;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_bModelInitialized;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_fRelLBSPThreshold;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nDefaultMedianBlurKernelSize;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nFrameIdx;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nFramesSinceLastReset;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nImgChannels;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nImgType;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nLBSPThresholdOffset;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nModelResetCooldown;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nOrigROIPxCount;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nTotPxCount;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_nTotRelevantPxCount;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_oImgSize;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_oLastColorFrame;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_oLastDescFrame;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_oLastFGMask;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_pDisplayHelper;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_vnPxIdxLUT;
+    using IBackgroundSubtractorLBSP_<eImpl>::m_voPxInfoLUT;
 };
 
+using BackgroundSubtractorSuBSENSE_CPUThreaded = BackgroundSubtractorSuBSENSE_<lv::CPUThreaded>;
 using BackgroundSubtractorSuBSENSE = BackgroundSubtractorSuBSENSE_<lv::NonParallel>;
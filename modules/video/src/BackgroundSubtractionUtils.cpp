@@ -163,7 +163,7 @@ void IBackgroundSubtractor_GLSL::getLatestForegroundMask(cv::OutputArray _oLastF
     _oLastFGMask.create(m_oImgSize,CV_8UC1);
     cv::Mat oLastFGMask = _oLastFGMask.getMat();
     if(GLImageProcAlgo::m_nInternalFrameIdx>0)
-        GLImageProcAlgo::fetchLastOutput(oLastFGMask);
+        GLImageProcAlgo::fetchLastOutput(oLastFGMask,true); // always the previous frame, regardless of pbo transfer timing
     else
         oLastFGMask = cv::Scalar_<uchar>(0);
 }
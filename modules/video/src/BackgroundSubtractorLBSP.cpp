@@ -99,4 +99,5 @@ template struct IBackgroundSubtractorLBSP_<lv::GLSL>;
 //template struct IBackgroundSubtractorLBSP_<lv::OpenCL>;
 #endif //HAVE_OPENCL
 
+template struct IBackgroundSubtractorLBSP_<lv::CPUThreaded>;
 template struct IBackgroundSubtractorLBSP_<lv::NonParallel>;
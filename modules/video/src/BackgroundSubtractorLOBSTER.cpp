@@ -17,6 +17,9 @@
 
 #include "litiv/video/BackgroundSubtractorLOBSTER.hpp"
 
+// local define used to specify the minimum number of model pixels per tile when splitting the update loop (cpu-threaded impl)
+#define BGSLOBSTER_MIN_TILE_PX_COUNT (size_t(4096))
+
 template<>
 IBackgroundSubtractorLOBSTER::IBackgroundSubtractorLOBSTER_(size_t nDescDistThreshold, size_t nColorDistThreshold, size_t nBGSamples,
                                                             size_t nRequiredBGSamples, size_t nLBSPThresholdOffset, float fRelLBSPThreshold) :
@@ -29,6 +32,18 @@ IBackgroundSubtractorLOBSTER::IBackgroundSubtractorLOBSTER_(size_t nDescDistThre
     lvAssert_(m_nColorDistThreshold>0 || m_nDescDistThreshold>0,"distance thresholds must be positive values");
 }
 
+template<>
+IBackgroundSubtractorLOBSTER_CPUThreaded::IBackgroundSubtractorLOBSTER_(size_t nDescDistThreshold, size_t nColorDistThreshold, size_t nBGSamples,
+                                                                       size_t nRequiredBGSamples, size_t nLBSPThresholdOffset, float fRelLBSPThreshold) :
+        IBackgroundSubtractorLBSP_CPUThreaded(fRelLBSPThreshold,nLBSPThresholdOffset),
+        m_nColorDistThreshold(nColorDistThreshold),
+        m_nDescDistThreshold(nDescDistThreshold),
+        m_nBGSamples(nBGSamples),
+        m_nRequiredBGSamples(nRequiredBGSamples) {
+    lvAssert_(m_nBGSamples>0 && m_nRequiredBGSamples<=m_nBGSamples,"algo cannot require more sample matches than sample count in model");
+    lvAssert_(m_nColorDistThreshold>0 || m_nDescDistThreshold>0,"distance thresholds must be positive values");
+}
+
 #if HAVE_GLSL
 template<>
 IBackgroundSubtractorLOBSTER_GLSL::IBackgroundSubtractorLOBSTER_(size_t nDescDistThreshold, size_t nColorDistThreshold, size_t nBGSamples,
@@ -138,7 +153,7 @@ std::string BackgroundSubtractorLOBSTER_GLSL::getComputeShaderSource_LOBSTER() c
     ssSrc << "#define NB_SAMPLES              " << m_nBGSamples << "\n"
              "#define NB_REQ_SAMPLES          " << m_nRequiredBGSamples << "\n"
              "#define MODEL_STEP_SIZE         " << m_oFrameSize.width << "\n"
-             "layout(local_size_x=" << m_vDefaultWorkGroupSize.x << ",local_size_y=" << m_vDefaultWorkGroupSize.y << ") in;\n"
+             "layout(local_size_x=" << m_vWorkGroupSize.x << ",local_size_y=" << m_vWorkGroupSize.y << ") in;\n"
              "layout(binding=" << GLImageProcAlgo::Image_ROIBinding << ", r8ui) readonly uniform uimage2D mROI;\n"
              "layout(binding=" << GLImageProcAlgo::Image_InputBinding << ", " << (m_nImgChannels==4?"rgba8ui":"r8ui") << ") readonly uniform uimage2D mInput;\n"
 #if BGSLOBSTER_GLSL_USE_DEBUG
@@ -151,7 +166,7 @@ std::string BackgroundSubtractorLOBSTER_GLSL::getComputeShaderSource_LOBSTER() c
              GLShader::getShaderFunctionSource_urand_tinymt32() <<
              GLShader::getShaderFunctionSource_getRandNeighbor3x3(0,m_oFrameSize) <<
              IBackgroundSubtractorLBSP_GLSL::getLBSPThresholdLUTShaderSource() <<
-             LBSP::getShaderFunctionSource(m_nImgChannels,BGSLOBSTER_GLSL_USE_SHAREDMEM,m_vDefaultWorkGroupSize) <<
+             LBSP::getShaderFunctionSource(m_nImgChannels,BGSLOBSTER_GLSL_USE_SHAREDMEM,m_vWorkGroupSize) <<
 #if !BGSLOBSTER_GLSL_USE_SHAREDMEM
              "#define lbsp(t,ref,vCoords) lbsp(t,ref,mInput,vCoords)\n"
 #endif //(!BGSLOBSTER_GLSL_USE_SHAREDMEM)
@@ -176,10 +191,10 @@ std::string BackgroundSubtractorLOBSTER_GLSL::getComputeShaderSource_LOBSTER() c
              "    preload_data(mInput);\n"
              "    barrier();\n"
              //"        if(uvec2(gl_LocalInvocationID.xy)==uvec2(0,0)) {\n"
-             //"            for(int y=0; y<" << m_vDefaultWorkGroupSize.y+(LBSP::PATCH_SIZE/2)*2 << "; ++y) {\n"
-             //"                for(int x=0; x<" << m_vDefaultWorkGroupSize.x+(LBSP::PATCH_SIZE/2)*2 << "; ++x) {\n"
+             //"            for(int y=0; y<" << m_vWorkGroupSize.y+(LBSP::PATCH_SIZE/2)*2 << "; ++y) {\n"
+             //"                for(int x=0; x<" << m_vWorkGroupSize.x+(LBSP::PATCH_SIZE/2)*2 << "; ++x) {\n"
              //"                    ivec2 globalcoord = ivec2(gl_GlobalInvocationID.xy)-ivec2(gl_LocalInvocationID.xy)-ivec2("<<(LBSP::PATCH_SIZE/2)<<")+ivec2(x,y);\n"
-             //"                    if(x<"<<(LBSP::PATCH_SIZE/2)<<" || y<"<<(LBSP::PATCH_SIZE/2)<<" || x>="<<m_vDefaultWorkGroupSize.x<<" || y>="<<m_vDefaultWorkGroupSize.y<<")\n"
+             //"                    if(x<"<<(LBSP::PATCH_SIZE/2)<<" || y<"<<(LBSP::PATCH_SIZE/2)<<" || x>="<<m_vWorkGroupSize.x<<" || y>="<<m_vWorkGroupSize.y<<")\n"
              //"                    imageStore(mDebug,globalcoord,avLBSPData[y][x]);\n"//imageLoad(mInput,globalcoord)
              //"                }\n"
              //"            }\n"
@@ -282,10 +297,10 @@ std::string BackgroundSubtractorLOBSTER_GLSL::getComputeShaderSource_PostProc()
     std::stringstream ssSrc;
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ssSrc << "#version 430\n"
-             "layout(local_size_x=" << m_vDefaultWorkGroupSize.x << ",local_size_y=" << m_vDefaultWorkGroupSize.y << ") in;\n"
+             "layout(local_size_x=" << m_vWorkGroupSize.x << ",local_size_y=" << m_vWorkGroupSize.y << ") in;\n"
              //"layout(binding=" << GLImageProcAlgo::Image_ROIBinding << ", r8ui) readonly uniform uimage2D mROI;\n"
              "layout(binding=" << GLImageProcAlgo::Image_OutputBinding << ", r8ui) uniform uimage2D mOutput;\n" <<
-             GLShader::getComputeShaderFunctionSource_BinaryMedianBlur(size_t(m_nDefaultMedianBlurKernelSize),BGSLOBSTER_GLSL_USE_SHAREDMEM,m_vDefaultWorkGroupSize);
+             GLShader::getComputeShaderFunctionSource_BinaryMedianBlur(size_t(m_nDefaultMedianBlurKernelSize),BGSLOBSTER_GLSL_USE_SHAREDMEM,m_vWorkGroupSize);
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ssSrc << "void main() {\n"
              "    ivec2 vImgCoords = ivec2(gl_GlobalInvocationID.xy);\n"
@@ -325,7 +340,7 @@ void BackgroundSubtractorLOBSTER_GLSL::dispatch(size_t nStage, GLShader& oShader
     }
     else //nStage==1 && BGSLOBSTER_GLSL_USE_POSTPROC
         glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-    glDispatchCompute((GLuint)ceil((float)m_oFrameSize.width/m_vDefaultWorkGroupSize.x),(GLuint)ceil((float)m_oFrameSize.height/m_vDefaultWorkGroupSize.y),1);
+    glDispatchCompute((GLuint)ceil((float)m_oFrameSize.width/m_vWorkGroupSize.x),(GLuint)ceil((float)m_oFrameSize.height/m_vWorkGroupSize.y),1);
 }
 
 void BackgroundSubtractorLOBSTER_GLSL::getBackgroundImage(cv::OutputArray oBGImg) const {
@@ -407,7 +422,8 @@ template struct BackgroundSubtractorLOBSTER_<lv::GLSL>;
 //template struct BackgroundSubtractorLOBSTER_<lv::OpenCL>;
 #endif //HAVE_OPENCL
 
-void BackgroundSubtractorLOBSTER::refreshModel(float fSamplesRefreshFrac, bool bForceFGUpdate) {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorLOBSTER_<eImpl>::refreshModel(float fSamplesRefreshFrac, bool bForceFGUpdate) {
     lvDbgExceptionWatch;
     // == refresh
     lvAssert_(m_bInitialized,"algo must be initialized first");
@@ -439,10 +455,11 @@ void BackgroundSubtractorLOBSTER::refreshModel(float fSamplesRefreshFrac, bool b
     }
 }
 
-void BackgroundSubtractorLOBSTER::initialize(const cv::Mat& oInitImg, const cv::Mat& oROI) {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorLOBSTER_<eImpl>::initialize(const cv::Mat& oInitImg, const cv::Mat& oROI) {
     lvDbgExceptionWatch;
     // == init
-    IBackgroundSubtractorLBSP::initialize_common(oInitImg,oROI);
+    IBackgroundSubtractorLBSP_<eImpl>::initialize_common(oInitImg,oROI);
     m_voBGColorSamples.resize(m_nBGSamples);
     m_voBGDescSamples.resize(m_nBGSamples);
     for(size_t s=0; s<m_nBGSamples; ++s) {
@@ -456,7 +473,8 @@ void BackgroundSubtractorLOBSTER::initialize(const cv::Mat& oInitImg, const cv::
     m_bModelInitialized = true;
 }
 
-void BackgroundSubtractorLOBSTER::apply(cv::InputArray _oInputImg, cv::OutputArray _oFGMask, double dLearningRate) {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorLOBSTER_<eImpl>::apply(cv::InputArray _oInputImg, cv::OutputArray _oFGMask, double dLearningRate) {
     lvDbgExceptionWatch;
     // == process_sync
     lvAssert_(m_bInitialized && m_bModelInitialized,"algo & model must be initialized first");
@@ -468,122 +486,166 @@ void BackgroundSubtractorLOBSTER::apply(cv::InputArray _oInputImg, cv::OutputArr
     cv::Mat oCurrFGMask = _oFGMask.getMat();
     oCurrFGMask = cv::Scalar_<uchar>(0);
     const size_t nLearningRate = std::isinf(dLearningRate)?SIZE_MAX:(size_t)ceil(dLearningRate);
-    if(m_nImgChannels==1) {
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nDescIter = nPxIter*2;
-            const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
-            const uchar nCurrColor = oInputImg.data[nPxIter];
-            alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
-            LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
-            size_t nGoodSamplesCount=0, nModelIdx=0;
-            while(nGoodSamplesCount<m_nRequiredBGSamples && nModelIdx<m_nBGSamples) {
-                const uchar nBGColor = m_voBGColorSamples[nModelIdx].data[nPxIter];
-                {
-                    const size_t nColorDist = lv::L1dist(nCurrColor,nBGColor);
-                    if(nColorDist>m_nColorDistThreshold/2)
-                        goto failedcheck1ch;
-                    const ushort nCurrInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
-                    const size_t nDescDist = lv::hdist(nCurrInputDesc,*((ushort*)(m_voBGDescSamples[nModelIdx].data+nDescIter)));
-                    if(nDescDist>m_nDescDistThreshold)
-                        goto failedcheck1ch;
-                    nGoodSamplesCount++;
-                }
-                failedcheck1ch:
-                nModelIdx++;
-            }
-            if(nGoodSamplesCount<m_nRequiredBGSamples)
-                oCurrFGMask.data[nPxIter] = UCHAR_MAX;
-            else {
-                if((rand()%nLearningRate)==0) {
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort& nRandInputDesc = *((ushort*)(m_voBGDescSamples[nSampleModelIdx].data+nDescIter));
-                    nRandInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
-                    m_voBGColorSamples[nSampleModelIdx].data[nPxIter] = nCurrColor;
+    ++m_nFrameIdx;
+    m_vvoTileNeighborUpdates.resize(this->getTileCount(m_nTotRelevantPxCount,BGSLOBSTER_MIN_TILE_PX_COUNT));
+    for(std::vector<NeighborUpdate>& voNeighborUpdates : m_vvoTileNeighborUpdates)
+        voNeighborUpdates.reserve(size_t(m_oImgSize.width+1)*2); // only px on the first/last row of a span can reach out of it
+    // the tile body is compiled once per simd level so that the inline LBSP/popcount helpers use the best instruction set available at runtime
+    const lv::SIMDLevel eSIMDLevel = lv::getSIMDLevel();
+    const auto lProcessTile = [&](size_t nTileIdx, size_t nModelIterBegin, size_t nModelIterEnd) {
+        // each tile draws from its own generator (seeded from the frame & tile indices), and only updates the model of its own px span right
+        // away; neighbor updates reaching into another tile's span are deferred until all tiles are joined, as that tile might be running too
+        lv::FastRNG oRNG((uint64_t(m_nFrameIdx)<<32)^nTileIdx);
+        const size_t nTileSpanBegin = nModelIterBegin==0?0:m_vnPxIdxLUT[nModelIterBegin];
+        const size_t nTileSpanEnd = nModelIterEnd==m_nTotRelevantPxCount?m_nTotPxCount:m_vnPxIdxLUT[nModelIterEnd];
+        std::vector<NeighborUpdate>& voNeighborUpdates = m_vvoTileNeighborUpdates[nTileIdx];
+        voNeighborUpdates.clear();
+        if(m_nImgChannels==1) {
+            for(size_t nModelIter=nModelIterBegin; nModelIter<nModelIterEnd; ++nModelIter) {
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                const size_t nDescIter = nPxIter*2;
+                const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
+                const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
+                const uchar nCurrColor = oInputImg.data[nPxIter];
+                alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
+                LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
+                size_t nGoodSamplesCount=0, nModelIdx=0;
+                while(nGoodSamplesCount<m_nRequiredBGSamples && nModelIdx<m_nBGSamples) {
+                    const uchar nBGColor = m_voBGColorSamples[nModelIdx].data[nPxIter];
+                    {
+                        const size_t nColorDist = lv::L1dist(nCurrColor,nBGColor);
+                        if(nColorDist>m_nColorDistThreshold/2)
+                            goto failedcheck1ch;
+                        const ushort nCurrInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
+                        const size_t nDescDist = lv::hdist(nCurrInputDesc,*((ushort*)(m_voBGDescSamples[nModelIdx].data+nDescIter)));
+                        if(nDescDist>m_nDescDistThreshold)
+                            goto failedcheck1ch;
+                        nGoodSamplesCount++;
+                    }
+                    failedcheck1ch:
+                    nModelIdx++;
                 }
-                if((rand()%nLearningRate)==0) {
-                    int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort& nRandInputDesc = m_voBGDescSamples[nSampleModelIdx].at<ushort>(nSampleImgCoord_Y,nSampleImgCoord_X);
-                    nRandInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
-                    m_voBGColorSamples[nSampleModelIdx].at<uchar>(nSampleImgCoord_Y,nSampleImgCoord_X) = nCurrColor;
+                if(nGoodSamplesCount<m_nRequiredBGSamples)
+                    oCurrFGMask.data[nPxIter] = UCHAR_MAX;
+                else {
+                    if((oRNG()%nLearningRate)==0) {
+                        const size_t nSampleModelIdx = oRNG()%m_nBGSamples;
+                        ushort& nRandInputDesc = *((ushort*)(m_voBGDescSamples[nSampleModelIdx].data+nDescIter));
+                        nRandInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+                        m_voBGColorSamples[nSampleModelIdx].data[nPxIter] = nCurrColor;
+                    }
+                    if((oRNG()%nLearningRate)==0) {
+                        int nSampleImgCoord_Y, nSampleImgCoord_X;
+                        cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oRNG);
+                        const size_t nSampleModelIdx = oRNG()%m_nBGSamples;
+                        const size_t nSamplePxIter = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                        const ushort nCurrIntraDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+                        if(nSamplePxIter<nTileSpanBegin || nSamplePxIter>=nTileSpanEnd)
+                            voNeighborUpdates.push_back(NeighborUpdate{nSamplePxIter,nSampleModelIdx,{nCurrIntraDesc,0,0},{nCurrColor,0,0}});
+                        else {
+                            m_voBGDescSamples[nSampleModelIdx].at<ushort>(nSampleImgCoord_Y,nSampleImgCoord_X) = nCurrIntraDesc;
+                            m_voBGColorSamples[nSampleModelIdx].at<uchar>(nSampleImgCoord_Y,nSampleImgCoord_X) = nCurrColor;
+                        }
+                    }
                 }
             }
         }
-    }
-    else { //m_nImgChannels==3
-        const size_t nCurrDescDistThreshold = m_nDescDistThreshold*3;
-        const size_t nCurrColorDistThreshold = m_nColorDistThreshold*3;
-        const size_t nCurrSCDescDistThreshold = nCurrDescDistThreshold/2;
-        const size_t nCurrSCColorDistThreshold = nCurrColorDistThreshold/2;
-        const size_t desc_row_step = m_voBGDescSamples[0].step.p[0];
-        const size_t img_row_step = m_voBGColorSamples[0].step.p[0];
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
-            const size_t nPxIterRGB = nPxIter*3;
-            const size_t nDescIterRGB = nPxIterRGB*2;
-            const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
-            alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
-            LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
-            size_t nGoodSamplesCount=0, nModelIdx=0;
-            while(nGoodSamplesCount<m_nRequiredBGSamples && nModelIdx<m_nBGSamples) {
-                const ushort* const anBGDesc = (ushort*)(m_voBGDescSamples[nModelIdx].data+nDescIterRGB);
-                const uchar* const anBGColor = m_voBGColorSamples[nModelIdx].data+nPxIterRGB;
-                size_t nTotColorDist = 0;
-                size_t nTotDescDist = 0;
-                for(size_t c=0;c<3; ++c) {
-                    const size_t nColorDist = lv::L1dist(anCurrColor[c],anBGColor[c]);
-                    if(nColorDist>nCurrSCColorDistThreshold)
-                        goto failedcheck3ch;
-                    const ushort nCurrInputDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
-                    const size_t nDescDist = lv::hdist(nCurrInputDesc,anBGDesc[c]);
-                    if(nDescDist>nCurrSCDescDistThreshold)
-                        goto failedcheck3ch;
-                    nTotColorDist += nColorDist;
-                    nTotDescDist += nDescDist;
-                }
-                if(nTotDescDist<=nCurrDescDistThreshold && nTotColorDist<=nCurrColorDistThreshold)
-                    nGoodSamplesCount++;
-                failedcheck3ch:
-                nModelIdx++;
-            }
-            if(nGoodSamplesCount<m_nRequiredBGSamples)
-                oCurrFGMask.data[nPxIter] = UCHAR_MAX;
-            else {
-                if((rand()%nLearningRate)==0) {
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort* anRandInputDesc = ((ushort*)(m_voBGDescSamples[nSampleModelIdx].data+nDescIterRGB));
-                    for(size_t c=0; c<3; ++c) {
-                        *(m_voBGColorSamples[nSampleModelIdx].data+nPxIterRGB+c) = anCurrColor[c];
-                        anRandInputDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+        else { //m_nImgChannels==3
+            const size_t nCurrDescDistThreshold = m_nDescDistThreshold*3;
+            const size_t nCurrColorDistThreshold = m_nColorDistThreshold*3;
+            const size_t nCurrSCDescDistThreshold = nCurrDescDistThreshold/2;
+            const size_t nCurrSCColorDistThreshold = nCurrColorDistThreshold/2;
+            const size_t desc_row_step = m_voBGDescSamples[0].step.p[0];
+            const size_t img_row_step = m_voBGColorSamples[0].step.p[0];
+            for(size_t nModelIter=nModelIterBegin; nModelIter<nModelIterEnd; ++nModelIter) {
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
+                const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
+                const size_t nPxIterRGB = nPxIter*3;
+                const size_t nDescIterRGB = nPxIterRGB*2;
+                const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
+                alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
+                LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
+                size_t nGoodSamplesCount=0, nModelIdx=0;
+                while(nGoodSamplesCount<m_nRequiredBGSamples && nModelIdx<m_nBGSamples) {
+                    const ushort* const anBGDesc = (ushort*)(m_voBGDescSamples[nModelIdx].data+nDescIterRGB);
+                    const uchar* const anBGColor = m_voBGColorSamples[nModelIdx].data+nPxIterRGB;
+                    size_t nTotColorDist = 0;
+                    size_t nTotDescDist = 0;
+                    for(size_t c=0;c<3; ++c) {
+                        const size_t nColorDist = lv::L1dist(anCurrColor[c],anBGColor[c]);
+                        if(nColorDist>nCurrSCColorDistThreshold)
+                            goto failedcheck3ch;
+                        const ushort nCurrInputDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
+                        const size_t nDescDist = lv::hdist(nCurrInputDesc,anBGDesc[c]);
+                        if(nDescDist>nCurrSCDescDistThreshold)
+                            goto failedcheck3ch;
+                        nTotColorDist += nColorDist;
+                        nTotDescDist += nDescDist;
                     }
+                    if(nTotDescDist<=nCurrDescDistThreshold && nTotColorDist<=nCurrColorDistThreshold)
+                        nGoodSamplesCount++;
+                    failedcheck3ch:
+                    nModelIdx++;
                 }
-                if((rand()%nLearningRate)==0) {
-                    int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort* anRandInputDesc = ((ushort*)(m_voBGDescSamples[nSampleModelIdx].data + desc_row_step*nSampleImgCoord_Y + 6*nSampleImgCoord_X));
-                    for(size_t c=0; c<3; ++c) {
-                        *(m_voBGColorSamples[nSampleModelIdx].data+img_row_step*nSampleImgCoord_Y+3*nSampleImgCoord_X+c) = anCurrColor[c];
-                        anRandInputDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                if(nGoodSamplesCount<m_nRequiredBGSamples)
+                    oCurrFGMask.data[nPxIter] = UCHAR_MAX;
+                else {
+                    if((oRNG()%nLearningRate)==0) {
+                        const size_t nSampleModelIdx = oRNG()%m_nBGSamples;
+                        ushort* anRandInputDesc = ((ushort*)(m_voBGDescSamples[nSampleModelIdx].data+nDescIterRGB));
+                        for(size_t c=0; c<3; ++c) {
+                            *(m_voBGColorSamples[nSampleModelIdx].data+nPxIterRGB+c) = anCurrColor[c];
+                            anRandInputDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                        }
+                    }
+                    if((oRNG()%nLearningRate)==0) {
+                        int nSampleImgCoord_Y, nSampleImgCoord_X;
+                        cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oRNG);
+                        const size_t nSampleModelIdx = oRNG()%m_nBGSamples;
+                        const size_t nSamplePxIter = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                        std::array<ushort,3> anCurrIntraDesc;
+                        for(size_t c=0; c<3; ++c)
+                            anCurrIntraDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                        if(nSamplePxIter<nTileSpanBegin || nSamplePxIter>=nTileSpanEnd)
+                            voNeighborUpdates.push_back(NeighborUpdate{nSamplePxIter,nSampleModelIdx,anCurrIntraDesc,{anCurrColor[0],anCurrColor[1],anCurrColor[2]}});
+                        else {
+                            ushort* anRandInputDesc = ((ushort*)(m_voBGDescSamples[nSampleModelIdx].data + desc_row_step*nSampleImgCoord_Y + 6*nSampleImgCoord_X));
+                            for(size_t c=0; c<3; ++c) {
+                                *(m_voBGColorSamples[nSampleModelIdx].data+img_row_step*nSampleImgCoord_Y+3*nSampleImgCoord_X+c) = anCurrColor[c];
+                                anRandInputDesc[c] = anCurrIntraDesc[c];
+                            }
+                        }
                     }
                 }
             }
         }
+    };
+    this->processTiles(m_nTotRelevantPxCount,BGSLOBSTER_MIN_TILE_PX_COUNT,[&](size_t nTileIdx, size_t nModelIterBegin, size_t nModelIterEnd) {
+        lv::invokeForSIMDLevel(eSIMDLevel,lProcessTile,nTileIdx,nModelIterBegin,nModelIterEnd);
+    });
+    // deferred cross-tile neighbor updates are applied in tile order, so the result only depends on the tile count
+    for(const std::vector<NeighborUpdate>& voNeighborUpdates : m_vvoTileNeighborUpdates) {
+        for(const NeighborUpdate& oUpdate : voNeighborUpdates) {
+            for(size_t c=0; c<m_nImgChannels; ++c) {
+                *((ushort*)(m_voBGDescSamples[oUpdate.nSampleIdx].data+(oUpdate.nPxIter*m_nImgChannels+c)*2)) = oUpdate.anDesc[c];
+                m_voBGColorSamples[oUpdate.nSampleIdx].data[oUpdate.nPxIter*m_nImgChannels+c] = oUpdate.anColor[c];
+            }
+        }
     }
     cv::medianBlur(oCurrFGMask,m_oLastFGMask,m_nDefaultMedianBlurKernelSize);
     m_oLastFGMask.copyTo(oCurrFGMask);
     oInputImg.copyTo(m_oLastColorFrame);
 }
 
-void BackgroundSubtractorLOBSTER::getBackgroundImage(cv::OutputArray oBGImg) const {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorLOBSTER_<eImpl>::getBackgroundImage(cv::OutputArray oBGImg) const {
     lvDbgExceptionWatch;
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGImg = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    lv::FrameArena& oArena = lv::FrameArena::getThreadLocal();
+    lv::FrameArena::Scope oArenaScope(oArena);
+    cv::Mat oAvgBGImg = cv::getArenaMat(oArena,m_oImgSize,CV_32FC((int)m_nImgChannels));
+    oAvgBGImg = cv::Scalar::all(0);
     for(size_t s=0; s<m_nBGSamples; ++s) {
         for(int y=0; y<m_oImgSize.height; ++y) {
             for(int x=0; x<m_oImgSize.width; ++x) {
@@ -599,11 +661,15 @@ void BackgroundSubtractorLOBSTER::getBackgroundImage(cv::OutputArray oBGImg) con
     oAvgBGImg.convertTo(oBGImg,CV_8U);
 }
 
-void BackgroundSubtractorLOBSTER::getBackgroundDescriptorsImage(cv::OutputArray oBGDescImg) const {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorLOBSTER_<eImpl>::getBackgroundDescriptorsImage(cv::OutputArray oBGDescImg) const {
     static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     lvDbgExceptionWatch;
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGDesc = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    lv::FrameArena& oArena = lv::FrameArena::getThreadLocal();
+    lv::FrameArena::Scope oArenaScope(oArena);
+    cv::Mat oAvgBGDesc = cv::getArenaMat(oArena,m_oImgSize,CV_32FC((int)m_nImgChannels));
+    oAvgBGDesc = cv::Scalar::all(0);
     for(size_t n=0; n<m_voBGDescSamples.size(); ++n) {
         for(int y=0; y<m_oImgSize.height; ++y) {
             for(int x=0; x<m_oImgSize.width; ++x) {
@@ -619,4 +685,5 @@ void BackgroundSubtractorLOBSTER::getBackgroundDescriptorsImage(cv::OutputArray
     oAvgBGDesc.convertTo(oBGDescImg,CV_16U);
 }
 
+template struct BackgroundSubtractorLOBSTER_<lv::CPUThreaded>;
 template struct BackgroundSubtractorLOBSTER_<lv::NonParallel>;
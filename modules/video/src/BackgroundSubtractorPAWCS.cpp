@@ -1476,17 +1476,23 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
     cv::resize(oInputImg,m_oDownSampledFrame_MotionAnalysis,m_oDownSampledFrameSize_MotionAnalysis,0,0,cv::INTER_AREA);
     cv::accumulateWeighted(m_oDownSampledFrame_MotionAnalysis,m_oMeanDownSampledLastDistFrame_LT,fRollAvgFactor_LT);
     cv::accumulateWeighted(m_oDownSampledFrame_MotionAnalysis,m_oMeanDownSampledLastDistFrame_ST,fRollAvgFactor_ST);
-    const float fCurrMeanL1DistRatio = lv::L1dist((float*)m_oMeanDownSampledLastDistFrame_LT.data,(float*)m_oMeanDownSampledLastDistFrame_ST.data,m_oMeanDownSampledLastDistFrame_LT.total(),m_nImgChannels,m_oDownSampledROI_MotionAnalysis.data)/m_nDownSampledROIPxCount;
+    const float fCurrMeanL1DistRatio = lv::L1dist_bulk((float*)m_oMeanDownSampledLastDistFrame_LT.data,(float*)m_oMeanDownSampledLastDistFrame_ST.data,m_oMeanDownSampledLastDistFrame_LT.total(),m_nImgChannels,m_oDownSampledROI_MotionAnalysis.data)/m_nDownSampledROIPxCount;
     if(!m_bAutoModelResetEnabled && fCurrMeanL1DistRatio>=FRAMELEVEL_MIN_L1DIST_THRES*2)
         m_bAutoModelResetEnabled = true;
     if(m_bAutoModelResetEnabled || m_bUsingMovingCamera) {
         if((m_nFrameIdx%DEFAULT_BOOTSTRAP_WIN_SIZE)==0) {
-            cv::Mat oCurrBackgroundImg, oDownSampledBackgroundImg;
+            // all temporaries are preallocated (with their final size & type) in the frame arena, so opencv does not reallocate them
+            lv::FrameArena::Scope oArenaScope(m_oFrameArena);
+            cv::Mat oCurrBackgroundImg = cv::getArenaMat(m_oFrameArena,m_oImgSize,CV_8UC((int)m_nImgChannels));
+            cv::Mat oDownSampledBackgroundImg = cv::getArenaMat(m_oFrameArena,m_oDownSampledFrameSize_MotionAnalysis,CV_8UC((int)m_nImgChannels));
+            cv::Mat oDownSampledBackgroundImg_32F = cv::getArenaMat(m_oFrameArena,m_oDownSampledFrameSize_MotionAnalysis,CV_32FC((int)m_nImgChannels));
+            cv::Mat oDownSampledROIMask = cv::getArenaMat(m_oFrameArena,m_oDownSampledROI_MotionAnalysis.size(),CV_8UC1);
             getBackgroundImage(oCurrBackgroundImg);
             cv::resize(oCurrBackgroundImg,oDownSampledBackgroundImg,m_oDownSampledFrameSize_MotionAnalysis,0,0,cv::INTER_AREA);
-            cv::Mat oDownSampledBackgroundImg_32F; oDownSampledBackgroundImg.convertTo(oDownSampledBackgroundImg_32F,CV_32F);
-            const float fCurrModelL1DistRatio = lv::L1dist((float*)m_oMeanDownSampledLastDistFrame_LT.data,(float*)oDownSampledBackgroundImg_32F.data,m_oMeanDownSampledLastDistFrame_LT.total(),m_nImgChannels,cv::Mat(m_oDownSampledROI_MotionAnalysis==UCHAR_MAX).data)/m_nDownSampledROIPxCount;
-            const float fCurrModelCDistRatio = lv::cdist((float*)m_oMeanDownSampledLastDistFrame_LT.data,(float*)oDownSampledBackgroundImg_32F.data,m_oMeanDownSampledLastDistFrame_LT.total(),m_nImgChannels,cv::Mat(m_oDownSampledROI_MotionAnalysis==UCHAR_MAX).data)/m_nDownSampledROIPxCount;
+            oDownSampledBackgroundImg.convertTo(oDownSampledBackgroundImg_32F,CV_32F);
+            cv::compare(m_oDownSampledROI_MotionAnalysis,UCHAR_MAX,oDownSampledROIMask,cv::CMP_EQ);
+            const float fCurrModelL1DistRatio = lv::L1dist_bulk((float*)m_oMeanDownSampledLastDistFrame_LT.data,(float*)oDownSampledBackgroundImg_32F.data,m_oMeanDownSampledLastDistFrame_LT.total(),m_nImgChannels,oDownSampledROIMask.data)/m_nDownSampledROIPxCount;
+            const float fCurrModelCDistRatio = lv::cdist((float*)m_oMeanDownSampledLastDistFrame_LT.data,(float*)oDownSampledBackgroundImg_32F.data,m_oMeanDownSampledLastDistFrame_LT.total(),m_nImgChannels,oDownSampledROIMask.data)/m_nDownSampledROIPxCount;
             if(m_bUsingMovingCamera && fCurrModelL1DistRatio<FRAMELEVEL_MIN_L1DIST_THRES/4 && fCurrModelCDistRatio<FRAMELEVEL_MIN_CDIST_THRES/4) {
                 if(m_pDisplayHelper) m_pDisplayHelper->m_oDebugFS << m_pDisplayHelper->m_sDisplayName << "{:" << "deactivated low offset mode at" << (int)m_nFrameIdx << "}";
                 m_nLocalWordWeightOffset = DEFAULT_LWORD_WEIGHT_OFFSET;
@@ -1525,7 +1531,10 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
 
 void BackgroundSubtractorPAWCS::getBackgroundImage(cv::OutputArray backgroundImage) const { // @@@ add option to reconstruct from gwords?
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGImg = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    lv::FrameArena& oArena = lv::FrameArena::getThreadLocal();
+    lv::FrameArena::Scope oArenaScope(oArena);
+    cv::Mat oAvgBGImg = cv::getArenaMat(oArena,m_oImgSize,CV_32FC((int)m_nImgChannels));
+    oAvgBGImg = cv::Scalar::all(0);
     for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
         const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
         const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
@@ -1561,7 +1570,10 @@ void BackgroundSubtractorPAWCS::getBackgroundImage(cv::OutputArray backgroundIma
 void BackgroundSubtractorPAWCS::getBackgroundDescriptorsImage(cv::OutputArray backgroundDescImage) const { // @@@ add option to reconstruct from gwords?
     static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGDescImg = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    lv::FrameArena& oArena = lv::FrameArena::getThreadLocal();
+    lv::FrameArena::Scope oArenaScope(oArena);
+    cv::Mat oAvgBGDescImg = cv::getArenaMat(oArena,m_oImgSize,CV_32FC((int)m_nImgChannels));
+    oAvgBGDescImg = cv::Scalar::all(0);
     for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
         const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
         const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
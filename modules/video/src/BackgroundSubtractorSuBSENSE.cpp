@@ -53,15 +53,18 @@
 #define STAB_COLOR_DIST_OFFSET (m_nMinColorDistThreshold/5)
 // local define used to specify the desc dist threshold offset used for unstable regions
 #define UNSTAB_DESC_DIST_OFFSET (m_nDescDistThresholdOffset)
+// local define used to specify the minimum number of model pixels per tile when splitting the update loop (cpu-threaded impl)
+#define BGSSUBSENSE_MIN_TILE_PX_COUNT (size_t(4096))
 
 static const size_t s_nColorMaxDataRange_1ch = UCHAR_MAX;
 static const size_t s_nDescMaxDataRange_1ch = LBSP::DESC_SIZE_BITS;
 static const size_t s_nColorMaxDataRange_3ch = s_nColorMaxDataRange_1ch*3;
 static const size_t s_nDescMaxDataRange_3ch = s_nDescMaxDataRange_1ch*3;
 
-BackgroundSubtractorSuBSENSE::BackgroundSubtractorSuBSENSE_(size_t nDescDistThresholdOffset, size_t nMinColorDistThreshold, size_t nBGSamples,
-                                                            size_t nRequiredBGSamples, size_t nSamplesForMovingAvgs, float fRelLBSPThreshold) :
-        IBackgroundSubtractorLBSP(fRelLBSPThreshold),
+template<lv::ParallelAlgoType eImpl>
+BackgroundSubtractorSuBSENSE_<eImpl>::BackgroundSubtractorSuBSENSE_(size_t nDescDistThresholdOffset, size_t nMinColorDistThreshold, size_t nBGSamples,
+                                                                    size_t nRequiredBGSamples, size_t nSamplesForMovingAvgs, float fRelLBSPThreshold) :
+        IBackgroundSubtractorLBSP_<eImpl>(fRelLBSPThreshold),
         m_nMinColorDistThreshold(nMinColorDistThreshold),
         m_nDescDistThresholdOffset(nDescDistThresholdOffset),
         m_nBGSamples(nBGSamples),
@@ -77,7 +80,8 @@ BackgroundSubtractorSuBSENSE::BackgroundSubtractorSuBSENSE_(size_t nDescDistThre
     lvAssert_(m_nMinColorDistThreshold>0 || m_nDescDistThresholdOffset>0,"distance thresholds must be positive values");
 }
 
-void BackgroundSubtractorSuBSENSE::refreshModel(float fSamplesRefreshFrac, bool bForceFGUpdate) {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorSuBSENSE_<eImpl>::refreshModel(float fSamplesRefreshFrac, bool bForceFGUpdate) {
     // == refresh
     lvAssert_(m_bInitialized,"algo must be initialized first");
     lvAssert_(fSamplesRefreshFrac>0.0f && fSamplesRefreshFrac<=1.0f,"model refresh must be given as a non-null fraction");
@@ -104,9 +108,10 @@ void BackgroundSubtractorSuBSENSE::refreshModel(float fSamplesRefreshFrac, bool
     }
 }
 
-void BackgroundSubtractorSuBSENSE::initialize(const cv::Mat& oInitImg, const cv::Mat& oROI) {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorSuBSENSE_<eImpl>::initialize(const cv::Mat& oInitImg, const cv::Mat& oROI) {
     // == init
-    IBackgroundSubtractorLBSP::initialize_common(oInitImg,oROI);
+    IBackgroundSubtractorLBSP_<eImpl>::initialize_common(oInitImg,oROI);
     m_fLastNonZeroDescRatio = 0.0f;
     const int nTotImgPixels = m_oImgSize.height*m_oImgSize.width;
     if(m_nOrigROIPxCount>=m_nTotPxCount/2 && (int)m_nTotPxCount>=DEFAULT_FRAME_SIZE.area()) {
@@ -185,7 +190,8 @@ void BackgroundSubtractorSuBSENSE::initialize(const cv::Mat& oInitImg, const cv:
     m_bModelInitialized = true;
 }
 
-void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray _fgmask, double learningRateOverride) {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorSuBSENSE_<eImpl>::apply(cv::InputArray _image, cv::OutputArray _fgmask, double learningRateOverride) {
     // == process
     lvAssert_(m_bInitialized && m_bModelInitialized,"algo & model must be initialized first");
     cv::Mat oInputImg = _image.getMat();
@@ -194,292 +200,339 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
     _fgmask.create(m_oImgSize,CV_8UC1);
     cv::Mat oCurrFGMask = _fgmask.getMat();
     memset(oCurrFGMask.data,0,oCurrFGMask.cols*oCurrFGMask.rows);
-    size_t nNonZeroDescCount = 0;
+    const size_t nTileCount = this->getTileCount(m_nTotRelevantPxCount,BGSSUBSENSE_MIN_TILE_PX_COUNT);
+    m_vnTileNonZeroDescCounts.resize(nTileCount);
+    m_vvoTileNeighborUpdates.resize(nTileCount);
+    for(std::vector<NeighborUpdate>& voNeighborUpdates : m_vvoTileNeighborUpdates)
+        voNeighborUpdates.reserve(size_t(m_oImgSize.width+2)*4); // only px within two rows of a span's ends can reach out of it
     const float fRollAvgFactor_LT = 1.0f/std::min(++m_nFrameIdx,m_nSamplesForMovingAvgs);
     const float fRollAvgFactor_ST = 1.0f/std::min(m_nFrameIdx,m_nSamplesForMovingAvgs/4);
-    if(m_nImgChannels==1) {
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nDescIter = nPxIter*2;
-            const size_t nFloatIter = nPxIter*4;
-            const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
-            const uchar nCurrColor = oInputImg.data[nPxIter];
-            size_t nMinDescDist = s_nDescMaxDataRange_1ch;
-            size_t nMinSumDist = s_nColorMaxDataRange_1ch;
-            float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
-            float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
-            float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
-            float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
-            float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
-            float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
-            ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
-            uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
-            const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET))/2;
-            const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
-            alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
-            LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
-            const ushort nCurrIntraDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
-            m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
-            size_t nGoodSamplesCount=0, nSampleIdx=0;
-            while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
-                const uchar& nBGColor = m_voBGColorSamples[nSampleIdx].data[nPxIter];
-                {
-                    const size_t nColorDist = lv::L1dist(nCurrColor,nBGColor);
-                    if(nColorDist>nCurrColorDistThreshold)
-                        goto failedcheck1ch;
-                    const ushort& nBGIntraDesc = *((ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIter));
-                    const size_t nIntraDescDist = lv::hdist(nCurrIntraDesc,nBGIntraDesc);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
-                    const size_t nInterDescDist = lv::hdist(nCurrInterDesc,nBGIntraDesc);
-                    const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
-                    if(nDescDist>nCurrDescDistThreshold)
-                        goto failedcheck1ch;
-                    const size_t nSumDist = std::min((nDescDist/4)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
-                    if(nSumDist>nCurrColorDistThreshold)
-                        goto failedcheck1ch;
-                    if(nMinDescDist>nDescDist)
-                        nMinDescDist = nDescDist;
-                    if(nMinSumDist>nSumDist)
-                        nMinSumDist = nSumDist;
-                    nGoodSamplesCount++;
+    // the tile body is compiled once per simd level so that the inline LBSP/popcount helpers use the best instruction set available at runtime
+    const lv::SIMDLevel eSIMDLevel = lv::getSIMDLevel();
+    const auto lProcessTile = [&](size_t nTileIdx, size_t nModelIterBegin, size_t nModelIterEnd) {
+        size_t nNonZeroDescCount = 0; // kept local to the tile (shared counters would bounce between cores)
+        // each tile draws from its own generator (seeded from the frame & tile indices), and only updates the model of its own px span right
+        // away; neighbor updates reaching into another tile's span are deferred until all tiles are joined, as that tile might be running too
+        lv::FastRNG oRNG((uint64_t(m_nFrameIdx)<<32)^nTileIdx);
+        const size_t nTileSpanBegin = nModelIterBegin==0?0:m_vnPxIdxLUT[nModelIterBegin];
+        const size_t nTileSpanEnd = nModelIterEnd==m_nTotRelevantPxCount?m_nTotPxCount:m_vnPxIdxLUT[nModelIterEnd];
+        std::vector<NeighborUpdate>& voNeighborUpdates = m_vvoTileNeighborUpdates[nTileIdx];
+        voNeighborUpdates.clear();
+        if(m_nImgChannels==1) {
+            for(size_t nModelIter=nModelIterBegin; nModelIter<nModelIterEnd; ++nModelIter) {
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                const size_t nDescIter = nPxIter*2;
+                const size_t nFloatIter = nPxIter*4;
+                const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
+                const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
+                const uchar nCurrColor = oInputImg.data[nPxIter];
+                size_t nMinDescDist = s_nDescMaxDataRange_1ch;
+                size_t nMinSumDist = s_nColorMaxDataRange_1ch;
+                float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
+                float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
+                float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
+                float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
+                float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
+                float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
+                float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
+                float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
+                float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
+                float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
+                ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
+                uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
+                const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET))/2;
+                const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
+                alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
+                LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
+                const ushort nCurrIntraDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+                m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
+                size_t nGoodSamplesCount=0, nSampleIdx=0;
+                while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
+                    const uchar& nBGColor = m_voBGColorSamples[nSampleIdx].data[nPxIter];
+                    {
+                        const size_t nColorDist = lv::L1dist(nCurrColor,nBGColor);
+                        if(nColorDist>nCurrColorDistThreshold)
+                            goto failedcheck1ch;
+                        const ushort& nBGIntraDesc = *((ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIter));
+                        const size_t nIntraDescDist = lv::hdist(nCurrIntraDesc,nBGIntraDesc);
+                        const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
+                        const size_t nInterDescDist = lv::hdist(nCurrInterDesc,nBGIntraDesc);
+                        const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
+                        if(nDescDist>nCurrDescDistThreshold)
+                            goto failedcheck1ch;
+                        const size_t nSumDist = std::min((nDescDist/4)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
+                        if(nSumDist>nCurrColorDistThreshold)
+                            goto failedcheck1ch;
+                        if(nMinDescDist>nDescDist)
+                            nMinDescDist = nDescDist;
+                        if(nMinSumDist>nSumDist)
+                            nMinSumDist = nSumDist;
+                        nGoodSamplesCount++;
+                    }
+                    failedcheck1ch:
+                    nSampleIdx++;
                 }
-                failedcheck1ch:
-                nSampleIdx++;
-            }
-            const float fNormalizedLastDist = ((float)lv::L1dist(nLastColor,nCurrColor)/s_nColorMaxDataRange_1ch+(float)lv::hdist(nLastIntraDesc,nCurrIntraDesc)/s_nDescMaxDataRange_1ch)/2;
-            *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
-            if(nGoodSamplesCount<m_nRequiredBGSamples) {
-                // == foreground
-                const float fNormalizedMinDist = std::min(1.0f,((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
-                oCurrFGMask.data[nPxIter] = UCHAR_MAX;
-                if(m_nModelResetCooldown && (rand()%(size_t)FEEDBACK_T_LOWER)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
-                    m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
+                const float fNormalizedLastDist = ((float)lv::L1dist(nLastColor,nCurrColor)/s_nColorMaxDataRange_1ch+(float)lv::hdist(nLastIntraDesc,nCurrIntraDesc)/s_nDescMaxDataRange_1ch)/2;
+                *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
+                if(nGoodSamplesCount<m_nRequiredBGSamples) {
+                    // == foreground
+                    const float fNormalizedMinDist = std::min(1.0f,((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
+                    *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
+                    *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
+                    oCurrFGMask.data[nPxIter] = UCHAR_MAX;
+                    if(m_nModelResetCooldown && (oRNG()%(size_t)FEEDBACK_T_LOWER)==0) {
+                        const size_t s_rand = oRNG()%m_nBGSamples;
+                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
+                        m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
+                    }
                 }
-            }
-            else {
-                // == background
-                const float fNormalizedMinDist = ((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2;
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
-                const size_t nLearningRate = std::isinf(learningRateOverride)?SIZE_MAX:(learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate));
-                if((rand()%nLearningRate)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
-                    m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
+                else {
+                    // == background
+                    const float fNormalizedMinDist = ((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2;
+                    *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
+                    *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
+                    const size_t nLearningRate = std::isinf(learningRateOverride)?SIZE_MAX:(learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate));
+                    if((oRNG()%nLearningRate)==0) {
+                        const size_t s_rand = oRNG()%m_nBGSamples;
+                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
+                        m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
+                    }
+                    int nSampleImgCoord_Y, nSampleImgCoord_X;
+                    const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
+                    if(bCurrUsing3x3Spread)
+                        cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oRNG);
+                    else
+                        cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oRNG);
+                    const size_t n_rand = oRNG();
+                    const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                    const bool bForcedUpdate = (n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0;
+                    const bool bGhostUpdate = (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0;
+                    if(idx_rand_uchar<nTileSpanBegin || idx_rand_uchar>=nTileSpanEnd) {
+                        if(bForcedUpdate || bGhostUpdate)
+                            voNeighborUpdates.push_back(NeighborUpdate{idx_rand_uchar,oRNG()%m_nBGSamples,bForcedUpdate,{nCurrIntraDesc,0,0},{nCurrColor,0,0}});
+                    }
+                    else {
+                        const size_t idx_rand_flt32 = idx_rand_uchar*4;
+                        const float fRandMeanLastDist = *((float*)(m_oMeanLastDistFrame.data+idx_rand_flt32));
+                        const float fRandMeanRawSegmRes = *((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32));
+                        if(bForcedUpdate || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && bGhostUpdate)) {
+                            const size_t idx_rand_ushrt = idx_rand_uchar*2;
+                            const size_t s_rand = oRNG()%m_nBGSamples;
+                            *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt)) = nCurrIntraDesc;
+                            m_voBGColorSamples[s_rand].data[idx_rand_uchar] = nCurrColor;
+                        }
+                    }
                 }
-                int nSampleImgCoord_Y, nSampleImgCoord_X;
-                const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
-                if(bCurrUsing3x3Spread)
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                else
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                const size_t n_rand = rand();
-                const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
-                const size_t idx_rand_flt32 = idx_rand_uchar*4;
-                const float fRandMeanLastDist = *((float*)(m_oMeanLastDistFrame.data+idx_rand_flt32));
-                const float fRandMeanRawSegmRes = *((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32));
-                if((n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0
-                    || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0)) {
-                    const size_t idx_rand_ushrt = idx_rand_uchar*2;
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt)) = nCurrIntraDesc;
-                    m_voBGColorSamples[s_rand].data[idx_rand_uchar] = nCurrColor;
+                if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
+                    if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
+                        *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
                 }
+                else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
+                    *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
+                if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
+                    *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
+                else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
+                    *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
+                if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
+                    (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
+                else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
+                    (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
+                    if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
+                        (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
+                }
+                if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
+                    (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
+                else {
+                    (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
+                    if((*pfCurrDistThresholdFactor)<1.0f)
+                        (*pfCurrDistThresholdFactor) = 1.0f;
+                }
+                if(lv::popcount(nCurrIntraDesc)>=2)
+                    ++nNonZeroDescCount;
+                nLastIntraDesc = nCurrIntraDesc;
+                nLastColor = nCurrColor;
             }
-            if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
-                if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
-                    *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
-            }
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
-            if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
-                *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
-            if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
-                (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
-            else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
-                (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
-                if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
-                    (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
-            }
-            if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
-                (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
-            else {
-                (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
-                if((*pfCurrDistThresholdFactor)<1.0f)
-                    (*pfCurrDistThresholdFactor) = 1.0f;
-            }
-            if(lv::popcount(nCurrIntraDesc)>=2)
-                ++nNonZeroDescCount;
-            nLastIntraDesc = nCurrIntraDesc;
-            nLastColor = nCurrColor;
         }
-    }
-    else { //m_nImgChannels==3
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
-            const size_t nPxIterRGB = nPxIter*3;
-            const size_t nDescIterRGB = nPxIterRGB*2;
-            const size_t nFloatIter = nPxIter*4;
-            const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
-            size_t nMinTotDescDist=s_nDescMaxDataRange_3ch;
-            size_t nMinTotSumDist=s_nColorMaxDataRange_3ch;
-            float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
-            float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
-            float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
-            float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
-            float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
-            float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
-            ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescIterRGB));
-            uchar* anLastColor = m_oLastColorFrame.data+nPxIterRGB;
-            const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET));
-            const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
-            const size_t nCurrTotColorDistThreshold = nCurrColorDistThreshold*3;
-            const size_t nCurrTotDescDistThreshold = nCurrDescDistThreshold*3;
-            const size_t nCurrSCColorDistThreshold = nCurrTotColorDistThreshold/2;
-            alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
-            LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
-            std::array<ushort,3> anCurrIntraDesc;
-            for(size_t c=0; c<3; ++c)
-                anCurrIntraDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
-            m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
-            size_t nGoodSamplesCount=0, nSampleIdx=0;
-            while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
-                const ushort* const anBGIntraDesc = (ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIterRGB);
-                const uchar* const anBGColor = m_voBGColorSamples[nSampleIdx].data+nPxIterRGB;
-                size_t nTotDescDist = 0;
-                size_t nTotSumDist = 0;
-                for(size_t c=0;c<3; ++c) {
-                    const size_t nColorDist = lv::L1dist(anCurrColor[c],anBGColor[c]);
-                    if(nColorDist>nCurrSCColorDistThreshold)
-                        goto failedcheck3ch;
-                    const size_t nIntraDescDist = lv::hdist(anCurrIntraDesc[c],anBGIntraDesc[c]);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
-                    const size_t nInterDescDist = lv::hdist(nCurrInterDesc,anBGIntraDesc[c]);
-                    const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
-                    const size_t nSumDist = std::min((nDescDist/2)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
-                    if(nSumDist>nCurrSCColorDistThreshold)
+        else { //m_nImgChannels==3
+            for(size_t nModelIter=nModelIterBegin; nModelIter<nModelIterEnd; ++nModelIter) {
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
+                const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
+                const size_t nPxIterRGB = nPxIter*3;
+                const size_t nDescIterRGB = nPxIterRGB*2;
+                const size_t nFloatIter = nPxIter*4;
+                const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
+                size_t nMinTotDescDist=s_nDescMaxDataRange_3ch;
+                size_t nMinTotSumDist=s_nColorMaxDataRange_3ch;
+                float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
+                float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
+                float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
+                float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
+                float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
+                float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
+                float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
+                float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
+                float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
+                float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
+                ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescIterRGB));
+                uchar* anLastColor = m_oLastColorFrame.data+nPxIterRGB;
+                const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET));
+                const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
+                const size_t nCurrTotColorDistThreshold = nCurrColorDistThreshold*3;
+                const size_t nCurrTotDescDistThreshold = nCurrDescDistThreshold*3;
+                const size_t nCurrSCColorDistThreshold = nCurrTotColorDistThreshold/2;
+                alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
+                LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
+                std::array<ushort,3> anCurrIntraDesc;
+                for(size_t c=0; c<3; ++c)
+                    anCurrIntraDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
+                size_t nGoodSamplesCount=0, nSampleIdx=0;
+                while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
+                    const ushort* const anBGIntraDesc = (ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIterRGB);
+                    const uchar* const anBGColor = m_voBGColorSamples[nSampleIdx].data+nPxIterRGB;
+                    size_t nTotDescDist = 0;
+                    size_t nTotSumDist = 0;
+                    for(size_t c=0;c<3; ++c) {
+                        const size_t nColorDist = lv::L1dist(anCurrColor[c],anBGColor[c]);
+                        if(nColorDist>nCurrSCColorDistThreshold)
+                            goto failedcheck3ch;
+                        const size_t nIntraDescDist = lv::hdist(anCurrIntraDesc[c],anBGIntraDesc[c]);
+                        const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
+                        const size_t nInterDescDist = lv::hdist(nCurrInterDesc,anBGIntraDesc[c]);
+                        const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
+                        const size_t nSumDist = std::min((nDescDist/2)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
+                        if(nSumDist>nCurrSCColorDistThreshold)
+                            goto failedcheck3ch;
+                        nTotDescDist += nDescDist;
+                        nTotSumDist += nSumDist;
+                    }
+                    if(nTotDescDist>nCurrTotDescDistThreshold || nTotSumDist>nCurrTotColorDistThreshold)
                         goto failedcheck3ch;
-                    nTotDescDist += nDescDist;
-                    nTotSumDist += nSumDist;
+                    if(nMinTotDescDist>nTotDescDist)
+                        nMinTotDescDist = nTotDescDist;
+                    if(nMinTotSumDist>nTotSumDist)
+                        nMinTotSumDist = nTotSumDist;
+                    nGoodSamplesCount++;
+                    failedcheck3ch:
+                    nSampleIdx++;
                 }
-                if(nTotDescDist>nCurrTotDescDistThreshold || nTotSumDist>nCurrTotColorDistThreshold)
-                    goto failedcheck3ch;
-                if(nMinTotDescDist>nTotDescDist)
-                    nMinTotDescDist = nTotDescDist;
-                if(nMinTotSumDist>nTotSumDist)
-                    nMinTotSumDist = nTotSumDist;
-                nGoodSamplesCount++;
-                failedcheck3ch:
-                nSampleIdx++;
-            }
-            const float fNormalizedLastDist = ((float)lv::L1dist<3>(anLastColor,anCurrColor)/s_nColorMaxDataRange_3ch+(float)lv::hdist<3>(anLastIntraDesc,anCurrIntraDesc)/s_nDescMaxDataRange_3ch)/2;
-            *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
-            if(nGoodSamplesCount<m_nRequiredBGSamples) {
-                // == foreground
-                const float fNormalizedMinDist = std::min(1.0f,((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
-                oCurrFGMask.data[nPxIter] = UCHAR_MAX;
-                if(m_nModelResetCooldown && (rand()%(size_t)FEEDBACK_T_LOWER)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
-                        *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
+                const float fNormalizedLastDist = ((float)lv::L1dist<3>(anLastColor,anCurrColor)/s_nColorMaxDataRange_3ch+(float)lv::hdist<3>(anLastIntraDesc,anCurrIntraDesc)/s_nDescMaxDataRange_3ch)/2;
+                *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
+                if(nGoodSamplesCount<m_nRequiredBGSamples) {
+                    // == foreground
+                    const float fNormalizedMinDist = std::min(1.0f,((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
+                    *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
+                    *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
+                    oCurrFGMask.data[nPxIter] = UCHAR_MAX;
+                    if(m_nModelResetCooldown && (oRNG()%(size_t)FEEDBACK_T_LOWER)==0) {
+                        const size_t s_rand = oRNG()%m_nBGSamples;
+                        for(size_t c=0; c<3; ++c) {
+                            *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
+                            *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
+                        }
                     }
                 }
-            }
-            else {
-                // == background
-                const float fNormalizedMinDist = ((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2;
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
-                const size_t nLearningRate = std::isinf(learningRateOverride)?SIZE_MAX:(learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate));
-                if((rand()%nLearningRate)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
-                        *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
+                else {
+                    // == background
+                    const float fNormalizedMinDist = ((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2;
+                    *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
+                    *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
+                    const size_t nLearningRate = std::isinf(learningRateOverride)?SIZE_MAX:(learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate));
+                    if((oRNG()%nLearningRate)==0) {
+                        const size_t s_rand = oRNG()%m_nBGSamples;
+                        for(size_t c=0; c<3; ++c) {
+                            *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
+                            *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
+                        }
                     }
-                }
-                int nSampleImgCoord_Y, nSampleImgCoord_X;
-                const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
-                if(bCurrUsing3x3Spread)
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                else
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                const size_t n_rand = rand();
-                const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
-                const size_t idx_rand_flt32 = idx_rand_uchar*4;
-                const float fRandMeanLastDist = *((float*)(m_oMeanLastDistFrame.data+idx_rand_flt32));
-                const float fRandMeanRawSegmRes = *((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32));
-                if((n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0
-                    || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0)) {
-                    const size_t idx_rand_uchar_rgb = idx_rand_uchar*3;
-                    const size_t idx_rand_ushrt_rgb = idx_rand_uchar_rgb*2;
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt_rgb+2*c)) = anCurrIntraDesc[c];
-                        *(m_voBGColorSamples[s_rand].data+idx_rand_uchar_rgb+c) = anCurrColor[c];
+                    int nSampleImgCoord_Y, nSampleImgCoord_X;
+                    const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
+                    if(bCurrUsing3x3Spread)
+                        cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oRNG);
+                    else
+                        cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oRNG);
+                    const size_t n_rand = oRNG();
+                    const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                    const bool bForcedUpdate = (n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0;
+                    const bool bGhostUpdate = (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0;
+                    if(idx_rand_uchar<nTileSpanBegin || idx_rand_uchar>=nTileSpanEnd) {
+                        if(bForcedUpdate || bGhostUpdate)
+                            voNeighborUpdates.push_back(NeighborUpdate{idx_rand_uchar,oRNG()%m_nBGSamples,bForcedUpdate,anCurrIntraDesc,{anCurrColor[0],anCurrColor[1],anCurrColor[2]}});
+                    }
+                    else {
+                        const size_t idx_rand_flt32 = idx_rand_uchar*4;
+                        const float fRandMeanLastDist = *((float*)(m_oMeanLastDistFrame.data+idx_rand_flt32));
+                        const float fRandMeanRawSegmRes = *((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32));
+                        if(bForcedUpdate || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && bGhostUpdate)) {
+                            const size_t idx_rand_uchar_rgb = idx_rand_uchar*3;
+                            const size_t idx_rand_ushrt_rgb = idx_rand_uchar_rgb*2;
+                            const size_t s_rand = oRNG()%m_nBGSamples;
+                            for(size_t c=0; c<3; ++c) {
+                                *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt_rgb+2*c)) = anCurrIntraDesc[c];
+                                *(m_voBGColorSamples[s_rand].data+idx_rand_uchar_rgb+c) = anCurrColor[c];
+                            }
+                        }
                     }
                 }
+                if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
+                    if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
+                        *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
+                }
+                else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
+                    *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
+                if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
+                    *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
+                else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
+                    *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
+                if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
+                    (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
+                else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
+                    (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
+                    if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
+                        (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
+                }
+                if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
+                    (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
+                else {
+                    (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
+                    if((*pfCurrDistThresholdFactor)<1.0f)
+                        (*pfCurrDistThresholdFactor) = 1.0f;
+                }
+                if(lv::popcount<3>(anCurrIntraDesc)>=4)
+                    ++nNonZeroDescCount;
+                for(size_t c=0; c<3; ++c) {
+                    anLastIntraDesc[c] = anCurrIntraDesc[c];
+                    anLastColor[c] = anCurrColor[c];
+                }
             }
-            if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
-                if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
-                    *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
-            }
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
-            if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
-                *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
-            if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
-                (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
-            else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
-                (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
-                if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
-                    (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
-            }
-            if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
-                (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
-            else {
-                (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
-                if((*pfCurrDistThresholdFactor)<1.0f)
-                    (*pfCurrDistThresholdFactor) = 1.0f;
-            }
-            if(lv::popcount<3>(anCurrIntraDesc)>=4)
-                ++nNonZeroDescCount;
-            for(size_t c=0; c<3; ++c) {
-                anLastIntraDesc[c] = anCurrIntraDesc[c];
-                anLastColor[c] = anCurrColor[c];
+        }
+        m_vnTileNonZeroDescCounts[nTileIdx] = nNonZeroDescCount;
+    };
+    this->processTiles(m_nTotRelevantPxCount,BGSSUBSENSE_MIN_TILE_PX_COUNT,[&](size_t nTileIdx, size_t nModelIterBegin, size_t nModelIterEnd) {
+        lv::invokeForSIMDLevel(eSIMDLevel,lProcessTile,nTileIdx,nModelIterBegin,nModelIterEnd);
+    });
+    // deferred cross-tile neighbor updates are applied in tile order, so the result only depends on the tile count (ghost checks see end-of-frame values)
+    for(const std::vector<NeighborUpdate>& voNeighborUpdates : m_vvoTileNeighborUpdates) {
+        for(const NeighborUpdate& oUpdate : voNeighborUpdates) {
+            const size_t idx_rand_flt32 = oUpdate.nPxIter*4;
+            if(oUpdate.bForced || (*((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32))>GHOSTDET_S_MIN && *((float*)(m_oMeanLastDistFrame.data+idx_rand_flt32))<GHOSTDET_D_MAX)) {
+                for(size_t c=0; c<m_nImgChannels; ++c) {
+                    *((ushort*)(m_voBGDescSamples[oUpdate.nSampleIdx].data+(oUpdate.nPxIter*m_nImgChannels+c)*2)) = oUpdate.anDesc[c];
+                    m_voBGColorSamples[oUpdate.nSampleIdx].data[oUpdate.nPxIter*m_nImgChannels+c] = oUpdate.anColor[c];
+                }
             }
         }
     }
+    const size_t nNonZeroDescCount = std::accumulate(m_vnTileNonZeroDescCounts.begin(),m_vnTileNonZeroDescCounts.end(),size_t(0));
 #if DISPLAY_SUBSENSE_DEBUG_INFO
     cv::Point2i oDbgPt(-1,-1);
     if(m_pDisplayHelper) {
@@ -611,9 +664,13 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
     }
 }
 
-void BackgroundSubtractorSuBSENSE::getBackgroundImage(cv::OutputArray backgroundImage) const {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorSuBSENSE_<eImpl>::getBackgroundImage(cv::OutputArray backgroundImage) const {
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGImg = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    lv::FrameArena& oArena = lv::FrameArena::getThreadLocal();
+    lv::FrameArena::Scope oArenaScope(oArena);
+    cv::Mat oAvgBGImg = cv::getArenaMat(oArena,m_oImgSize,CV_32FC((int)m_nImgChannels));
+    oAvgBGImg = cv::Scalar::all(0);
     for(size_t s=0; s<m_nBGSamples; ++s) {
         for(int y=0; y<m_oImgSize.height; ++y) {
             for(int x=0; x<m_oImgSize.width; ++x) {
@@ -629,10 +686,14 @@ void BackgroundSubtractorSuBSENSE::getBackgroundImage(cv::OutputArray background
     oAvgBGImg.convertTo(backgroundImage,CV_8U);
 }
 
-void BackgroundSubtractorSuBSENSE::getBackgroundDescriptorsImage(cv::OutputArray backgroundDescImage) const {
+template<lv::ParallelAlgoType eImpl>
+void BackgroundSubtractorSuBSENSE_<eImpl>::getBackgroundDescriptorsImage(cv::OutputArray backgroundDescImage) const {
     static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGDesc = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    lv::FrameArena& oArena = lv::FrameArena::getThreadLocal();
+    lv::FrameArena::Scope oArenaScope(oArena);
+    cv::Mat oAvgBGDesc = cv::getArenaMat(oArena,m_oImgSize,CV_32FC((int)m_nImgChannels));
+    oAvgBGDesc = cv::Scalar::all(0);
     for(size_t n=0; n<m_voBGDescSamples.size(); ++n) {
         for(int y=0; y<m_oImgSize.height; ++y) {
             for(int x=0; x<m_oImgSize.width; ++x) {
@@ -647,3 +708,6 @@ void BackgroundSubtractorSuBSENSE::getBackgroundDescriptorsImage(cv::OutputArray
     }
     oAvgBGDesc.convertTo(backgroundDescImage,CV_16U);
 }
+
+template struct BackgroundSubtractorSuBSENSE_<lv::CPUThreaded>;
+template struct BackgroundSubtractorSuBSENSE_<lv::NonParallel>;